@@ -43,54 +43,83 @@ TwoDARegistry::~TwoDARegistry() {
 }
 
 void TwoDARegistry::clear() {
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	_twodas.clear();
 	_gdas.clear();
 }
 
 const TwoDAFile &TwoDARegistry::get2DA(const Common::UString &name) {
-	TwoDAMap::const_iterator twoda = _twodas.find(name);
-	if (twoda != _twodas.end())
-		// Entry exists => return
-		return *twoda->second;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		TwoDAMap::const_iterator twoda = _twodas.find(name);
+		if (twoda != _twodas.end())
+			// Entry exists => return
+			return *twoda->second;
+	}
 
 	// Entry doesn't exist => load and add
 	std::unique_ptr<TwoDAFile> new2DA = load2DA(name);
-	return *(_twodas[name] = std::move(new2DA));
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// If another thread was faster, keep theirs
+	return *_twodas.emplace(name, std::move(new2DA)).first->second;
 }
 
 const GDAFile &TwoDARegistry::getGDA(const Common::UString &name) {
-	GDAMap::const_iterator gda = _gdas.find(name);
-	if (gda != _gdas.end())
-		// Entry exists => return
-		return *gda->second;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		GDAMap::const_iterator gda = _gdas.find(name);
+		if (gda != _gdas.end())
+			// Entry exists => return
+			return *gda->second;
+	}
 
 	// Entry doesn't exist => load and add
 	std::unique_ptr<GDAFile> newGDA = loadGDA(name);
-	return *(_gdas[name] = std::move(newGDA));
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// If another thread was faster, keep theirs
+	return *_gdas.emplace(name, std::move(newGDA)).first->second;
 }
 
 const GDAFile &TwoDARegistry::getMGDA(const Common::UString &prefix) {
-	GDAMap::const_iterator gda = _gdas.find(prefix);
-	if (gda != _gdas.end())
-		// Entry exists => return
-		return *gda->second;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		GDAMap::const_iterator gda = _gdas.find(prefix);
+		if (gda != _gdas.end())
+			// Entry exists => return
+			return *gda->second;
+	}
 
 	// Entry doesn't exist => load and add
 	std::unique_ptr<GDAFile> newGDA = loadMGDA(prefix);
-	return *(_gdas[prefix] = std::move(newGDA));
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// If another thread was faster, keep theirs
+	return *_gdas.emplace(prefix, std::move(newGDA)).first->second;
 }
 
 void TwoDARegistry::add2DA(const Common::UString &name) {
-	TwoDAMap::iterator twoda = _twodas.find(name);
-	if (twoda != _twodas.end())
-		// Entry exists => remove first
-		_twodas.erase(twoda);
+	// Entry exists => remove first
+	remove2DA(name);
 
 	// Load and add
-	_twodas[name] = load2DA(name);
+	std::unique_ptr<TwoDAFile> twoda = load2DA(name);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_twodas[name] = std::move(twoda);
 }
 
 void TwoDARegistry::remove2DA(const Common::UString &name) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	TwoDAMap::iterator twoda = _twodas.find(name);
 	if (twoda == _twodas.end())
 		// Doesn't exist, nothing to do
@@ -100,26 +129,30 @@ void TwoDARegistry::remove2DA(const Common::UString &name) {
 }
 
 void TwoDARegistry::addGDA(const Common::UString &name) {
-	GDAMap::iterator gda = _gdas.find(name);
-	if (gda != _gdas.end())
-		// Entry exists => remove first
-		_gdas.erase(gda);
+	// Entry exists => remove first
+	removeGDA(name);
 
 	// Load and add
-	_gdas[name] = loadGDA(name);
+	std::unique_ptr<GDAFile> gda = loadGDA(name);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_gdas[name] = std::move(gda);
 }
 
 void TwoDARegistry::addMGDA(const Common::UString &prefix) {
-	GDAMap::iterator gda = _gdas.find(prefix);
-	if (gda != _gdas.end())
-		// Entry exists => remove first
-		_gdas.erase(gda);
+	// Entry exists => remove first
+	removeGDA(prefix);
 
 	// Load and add
-	_gdas[prefix] = loadMGDA(prefix);
+	std::unique_ptr<GDAFile> gda = loadMGDA(prefix);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_gdas[prefix] = std::move(gda);
 }
 
 void TwoDARegistry::removeGDA(const Common::UString &name) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	GDAMap::iterator gda = _gdas.find(name);
 	if (gda == _gdas.end())
 		// Doesn't exist, nothing to do
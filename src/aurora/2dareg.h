@@ -30,6 +30,7 @@
 
 #include "src/common/singleton.h"
 #include "src/common/ustring.h"
+#include "src/common/mutex.h"
 
 namespace Aurora {
 
@@ -56,6 +57,9 @@ class GDAFile;
  *
  *  All 2DA and GDA files are directly and automatically loaded from
  *  the ResourceManager.
+ *
+ *  Getting a 2DA or GDA is thread-safe, so that they can be loaded in
+ *  the background. The files themselves are parsed outside the lock.
  */
 class TwoDARegistry : public Common::Singleton<TwoDARegistry> {
 public:
@@ -92,6 +96,8 @@ private:
 	TwoDAMap _twodas;
 	GDAMap   _gdas;
 
+	std::mutex _mutex;
+
 	std::unique_ptr<TwoDAFile> load2DA(const Common::UString &name);
 	std::unique_ptr<GDAFile>   loadGDA(const Common::UString &name);
 	std::unique_ptr<GDAFile>   loadMGDA(Common::UString prefix);
@@ -308,9 +308,8 @@ void ERFFile::load() {
 void ERFFile::decryptNWNPremium() {
 	assert(_header.encryption == kEncryptionBlowfishNWN);
 
-	_erf->seek(0);
-
-	_erf.reset(decrypt(*_erf, kEncryptionBlowfishNWN, _password));
+	// Decrypt the archive on the fly, only touching what's actually read
+	_erf.reset(new Common::BlowfishEBCDecryptStream(_erf.release(), _password, true));
 
 	_header.encryption = kEncryptionNone;
 }
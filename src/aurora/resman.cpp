@@ -33,6 +33,7 @@
 #include "src/common/readstream.h"
 #include "src/common/filepath.h"
 #include "src/common/readfile.h"
+#include "src/common/mappedfile.h"
 #include "src/common/writefile.h"
 
 #include "src/aurora/resman.h"
@@ -177,6 +178,8 @@ ResourceManager::~ResourceManager() {
 }
 
 void ResourceManager::clear() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	_typeAliases.clear();
 
 	_hasSmall = false;
@@ -292,6 +295,8 @@ ResourceManager::KnownArchive *ResourceManager::findArchive(Common::UString file
 }
 
 bool ResourceManager::hasArchive(const Common::UString &file) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	return findArchive(file) != 0;
 }
 
@@ -316,51 +321,63 @@ void ResourceManager::indexArchive(const Common::UString &file, uint32_t priorit
 	if (changeID)
 		change = newChangeSet(*changeID);
 
-	Common::SeekableReadStream *archiveStream = openArchiveStream(*knownArchive);
+	if (knownArchive->type == kArchiveKEY) {
+		indexKEY(openArchiveStream(*knownArchive), priority, change);
+		return;
+	}
+
+	indexArchive(*knownArchive, openArchive(*knownArchive, password), priority, change);
+}
+
+Archive *ResourceManager::openArchive(const Common::UString &file, const std::vector<byte> &password) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
 
-	std::unique_ptr<Archive> archive;
-	switch (knownArchive->type) {
-		case kArchiveKEY:
-			indexKEY(archiveStream, priority, change);
-			break;
+	KnownArchive *knownArchive = findArchive(file);
+	if (!knownArchive)
+		throw Common::Exception("No such archive file \"%s\"", file.c_str());
+
+	if ((knownArchive->type == kArchiveKEY) || (knownArchive->type == kArchiveBIF))
+		throw Common::Exception("Can't open \"%s\" on its own", file.c_str());
 
+	return openArchive(*knownArchive, password);
+}
+
+Archive *ResourceManager::openArchive(const KnownArchive &knownArchive, const std::vector<byte> &password) {
+	Common::SeekableReadStream *archiveStream = openArchiveStream(knownArchive);
+
+	switch (knownArchive.type) {
 		case kArchiveNDS:
-			archive = std::make_unique<NDSFile>(archiveStream);
-			break;
+			return new NDSFile(archiveStream);
 
 		case kArchiveHERF:
-			archive = std::make_unique<HERFFile>(archiveStream);
-			break;
+			return new HERFFile(archiveStream);
 
 		case kArchiveERF:
-			archive = std::make_unique<ERFFile>(archiveStream, password);
-			break;
+			return new ERFFile(archiveStream, password);
 
 		case kArchiveRIM:
-			archive = std::make_unique<RIMFile>(archiveStream);
-			break;
+			return new RIMFile(archiveStream);
 
 		case kArchiveZIP:
-			archive = std::make_unique<ZIPFile>(archiveStream);
-			break;
+			return new ZIPFile(archiveStream);
 
 		case kArchiveEXE:
-			archive = std::make_unique<PEFile>(archiveStream, _cursorRemap);
-			break;
+			return new PEFile(archiveStream, _cursorRemap);
 
 		case kArchiveNSBTX:
-			archive = std::make_unique<NSBTXFile>(archiveStream);
-			break;
+			return new NSBTXFile(archiveStream);
 
 		default:
-			throw Common::Exception("Invalid archive type %d", knownArchive->type);
+			break;
 	}
 
-	if (archive)
-		indexArchive(*knownArchive, archive.release(), priority, change);
+	delete archiveStream;
+	throw Common::Exception("Invalid archive type %d", knownArchive.type);
 }
 
 void ResourceManager::indexArchive(const Common::UString &file, uint32_t priority, Common::ChangeID *changeID) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	std::vector<byte> password;
 
 	indexArchive(file, priority, password, changeID);
@@ -482,6 +499,8 @@ bool ResourceManager::hasResourceDir(const Common::UString &dir) {
 void ResourceManager::indexResourceFile(const Common::UString &file, uint32_t priority,
                                         Common::ChangeID *changeID) {
 
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	Common::UString path;
 	path = _baseDir.empty() ? file : (_baseDir + "/" + file);
 	path = Common::FilePath::normalize(path, false);
@@ -498,6 +517,8 @@ void ResourceManager::indexResourceFile(const Common::UString &file, uint32_t pr
 
 void ResourceManager::indexResourceDir(const Common::UString &dir, const char *glob, int depth,
                                        uint32_t priority, Common::ChangeID *changeID) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	if (_baseDir.empty())
 		throw Common::Exception("No base data directory set");
 
@@ -529,6 +550,8 @@ void ResourceManager::indexResourceDir(const Common::UString &dir, const char *g
 }
 
 void ResourceManager::undo(Common::ChangeID &changeID) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	Change *change = dynamic_cast<Change *>(changeID.getContent());
 	if (!change || (change->_change == _changes.end()))
 		return;
@@ -612,6 +635,8 @@ void ResourceManager::addTypeAlias(FileType alias, FileType realType) {
 }
 
 void ResourceManager::blacklist(const Common::UString &name, FileType type) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	ResourceMap::iterator resList = _resources.find(getHash(name, type));
 	if (resList == _resources.end())
 		return;
@@ -621,6 +646,8 @@ void ResourceManager::blacklist(const Common::UString &name, FileType type) {
 }
 
 void ResourceManager::declareResource(const Common::UString &name, FileType type) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	bool isSmall = false;
 
 	ResourceMap::iterator resList = _resources.find(getHash(name, type));
@@ -702,6 +729,16 @@ Common::UString ResourceManager::findResourceFile(const Common::UString &name,
 	return "";
 }
 
+uint32_t ResourceManager::getResourceSize(const Common::UString &name, FileType type) const {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	const Resource *res = getRes(name, type);
+	if (!res)
+		return 0xFFFFFFFF;
+
+	return getResourceSize(*res);
+}
+
 uint32_t ResourceManager::getResourceSize(const Resource &res) const {
 	if (res.source == kSourceArchive) {
 		if ((res.archive == 0) || (res.archive->archive == 0) || (res.archiveIndex == 0xFFFFFFFF))
@@ -738,6 +775,8 @@ Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &
 Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &name,
 		const std::vector<FileType> &types, FileType *foundType) const {
 
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	const Resource *res = getRes(name, types);
 	if (!res)
 		return 0;
@@ -750,6 +789,8 @@ Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(uint64_t hash, FileType *type) const {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	const Resource *res = getRes(hash);
 	if (!res)
 		return 0;
@@ -762,6 +803,8 @@ Common::SeekableReadStream *ResourceManager::getResource(uint64_t hash, FileType
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(const Resource &res, bool tryNoCopy) const {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	Common::SeekableReadStream *stream = 0;
 
 	switch (res.source) {
@@ -785,6 +828,44 @@ Common::SeekableReadStream *ResourceManager::getResource(const Resource &res, bo
 	return stream;
 }
 
+std::shared_ptr<const Common::MappedFile> ResourceManager::mapResource(const Common::UString &name,
+		FileType type) const {
+
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	const Resource *res = getRes(name, type);
+	if (!res)
+		return std::shared_ptr<const Common::MappedFile>();
+
+	return mapResource(*res);
+}
+
+std::shared_ptr<const Common::MappedFile> ResourceManager::mapResource(uint64_t hash, FileType *type) const {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	const Resource *res = getRes(hash);
+	if (!res)
+		return std::shared_ptr<const Common::MappedFile>();
+
+	// Return the actually found type
+	if (type)
+		*type = res->type;
+
+	return mapResource(*res);
+}
+
+std::shared_ptr<const Common::MappedFile> ResourceManager::mapResource(const Resource &res) const {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	// Uncompressed loose files can be mapped directly
+	if ((res.source == kSourceFile) && !res.isSmall)
+		return std::make_shared<Common::MappedFile>(res.path);
+
+	std::unique_ptr<Common::SeekableReadStream> stream(getResource(res, true));
+
+	return std::make_shared<Common::MappedFile>(*stream);
+}
+
 Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
 		const Common::UString &name, FileType *foundType) const {
 
@@ -802,6 +883,8 @@ Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
 void ResourceManager::getAvailableResources(FileType type,
 		std::list<ResourceID> &list) const {
 
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
 		if (!r->second.empty() && (r->second.front().type == type)) {
 			list.push_back(ResourceID());
@@ -816,6 +899,8 @@ void ResourceManager::getAvailableResources(FileType type,
 void ResourceManager::getAvailableResources(const std::vector<FileType> &types,
 		std::list<ResourceID> &list) const {
 
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
 		for (std::vector<FileType>::const_iterator t = types.begin(); t != types.end(); ++t) {
 			if (!r->second.empty() && (r->second.front().type == *t)) {
@@ -1016,6 +1101,8 @@ void ResourceManager::addResources(const Common::FileList &files, Change *change
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(uint64_t hash) const {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	ResourceMap::const_iterator r = _resources.find(hash);
 	if ((r == _resources.end()) || r->second.empty() || (r->second.back().priority == 0))
 		return 0;
@@ -1026,6 +1113,8 @@ const ResourceManager::Resource *ResourceManager::getRes(uint64_t hash) const {
 const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name,
 		const std::vector<FileType> &types) const {
 
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	const Resource *result = 0;
 	for (std::vector<FileType>::const_iterator type = types.begin(); type != types.end(); ++type) {
 		const Resource *res = getRes(getHash(name, *type));
@@ -1046,6 +1135,8 @@ const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name, FileType type) const {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	std::vector<FileType> types(1, type);
 
 	return getRes(name, types);
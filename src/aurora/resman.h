@@ -29,6 +29,7 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <memory>
 
 #include "src/common/types.h"
 #include "src/common/ustring.h"
@@ -36,11 +37,13 @@
 #include "src/common/filelist.h"
 #include "src/common/hash.h"
 #include "src/common/changeid.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
 
 namespace Common {
 	class SeekableReadStream;
+	class MappedFile;
 }
 
 namespace Aurora {
@@ -139,6 +142,17 @@ public:
 	 */
 	void indexArchive(const Common::UString &file, uint32_t priority, const std::vector<byte> &password,
 	                  Common::ChangeID *changeID = 0);
+
+	/** Open an archive on its own, without adding its resources to the resource manager.
+	 *
+	 *  This is useful for peeking into an archive before it's indexed. KEY
+	 *  and BIF files can't be opened this way.
+	 *
+	 *  @param file The name of the archive file to open, like for indexArchive().
+	 *  @param password Use this password to decrypt the archive file, if necessary.
+	 *  @return The archive, owned by the caller.
+	 */
+	Archive *openArchive(const Common::UString &file, const std::vector<byte> &password = std::vector<byte>());
 	// '---
 
 	// .--- Directories and files
@@ -256,6 +270,13 @@ public:
 	 */
 	Common::UString findResourceFile(const Common::UString &name, FileType type) const;
 
+	/** Return the size of a resource, or 0xFFFFFFFF if the resource doesn't exist.
+	 *
+	 *  @param name The name (ResRef) of the resource.
+	 *  @param type The resource's type.
+	 */
+	uint32_t getResourceSize(const Common::UString &name, FileType type) const;
+
 	/** Find and return the absolute filesystem file behind a resource.
 	 *
 	 *  If this resources does not exist, or the resource is not a direct file
@@ -321,6 +342,26 @@ public:
 	Common::SeekableReadStream *getResource(const Common::UString &name,
 			const std::vector<FileType> &types, FileType *foundType = 0) const;
 
+	/** Return a resource's whole data, mapped into memory.
+	 *
+	 *  Loose files are memory-mapped directly, so that only the parts that are
+	 *  actually accessed are read from disk. Resources inside archives and
+	 *  compressed resources are read into memory instead.
+	 *
+	 *  @param  name The name (ResRef) of the resource.
+	 *  @param  type The resource's type.
+	 *  @return The mapped resource or 0 if the resource doesn't exist.
+	 */
+	std::shared_ptr<const Common::MappedFile> mapResource(const Common::UString &name, FileType type) const;
+
+	/** Return a resource's whole data, mapped into memory.
+	 *
+	 *  @param  hash The hash of the name and extension of the resource.
+	 *  @param  type If != 0, that's where the type of the resource is stored.
+	 *  @return The mapped resource or 0 if the resource doesn't exist.
+	 */
+	std::shared_ptr<const Common::MappedFile> mapResource(uint64_t hash, FileType *type = 0) const;
+
 	/** Return a resource of a specific type.
 	 *
 	 *  @param  resType The type of the resource.
@@ -497,6 +538,9 @@ private:
 	FileTypeSet  _archiveTypeTypes [kArchiveMAX];  ///< All valid archive types file types.
 	FileTypeList _resourceTypeTypes[kResourceMAX]; ///< All valid resource type file types.
 
+	/** Protects the resources and archives, so that resources can be read from several threads. */
+	mutable std::recursive_mutex _mutex;
+
 
 	void clearResources();
 
@@ -514,6 +558,7 @@ private:
 	                  uint32_t priority, Change *change);
 
 	Common::SeekableReadStream *openArchiveStream(const KnownArchive &archive) const;
+	Archive *openArchive(const KnownArchive &knownArchive, const std::vector<byte> &password);
 	// '---
 
 	// .--- Adding resources
@@ -535,6 +580,8 @@ private:
 
 	Common::SeekableReadStream *getArchiveResource(const Resource &res, bool tryNoCopy = false) const;
 
+	std::shared_ptr<const Common::MappedFile> mapResource(const Resource &res) const;
+
 	uint32_t getResourceSize(const Resource &res) const;
 	// '---
 
@@ -88,6 +88,8 @@ private:
 	AABBNode *_leftChild;  ///< Left child.
 	AABBNode *_rightChild; ///< Right child.
 	int32_t _property;       ///< An arbitrary value of the AABB.
+
+	friend class AABBTree;
 };
 
 } // End of namespace Common
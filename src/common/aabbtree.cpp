@@ -0,0 +1,138 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A flattened tree of axis-aligned bounding boxes.
+ */
+
+#include <cassert>
+
+#include "src/common/aabbnode.h"
+#include "src/common/aabbtree.h"
+
+namespace Common {
+
+AABBTree::AABBTree() {
+}
+
+AABBTree::~AABBTree() {
+}
+
+void AABBTree::build(const std::vector<AABBNode *> &trees) {
+	clear();
+
+	for (std::vector<AABBNode *>::const_iterator t = trees.begin(); t != trees.end(); ++t)
+		if (*t && !(*t)->empty())
+			addNode(**t);
+}
+
+void AABBTree::clear() {
+	_minX.clear();
+	_minY.clear();
+	_minZ.clear();
+	_maxX.clear();
+	_maxY.clear();
+	_maxZ.clear();
+
+	_skip.clear();
+	_property.clear();
+}
+
+size_t AABBTree::size() const {
+	return _skip.size();
+}
+
+bool AABBTree::empty() const {
+	return _skip.empty();
+}
+
+int32_t AABBTree::getProperty(size_t node) const {
+	assert(node < _property.size());
+
+	return _property[node];
+}
+
+void AABBTree::addNode(const AABBNode &node) {
+	const size_t index = _skip.size();
+
+	float minX, minY, minZ, maxX, maxY, maxZ;
+	node.getMin(minX, minY, minZ);
+	node.getMax(maxX, maxY, maxZ);
+
+	_minX.push_back(minX);
+	_minY.push_back(minY);
+	_minZ.push_back(minZ);
+	_maxX.push_back(maxX);
+	_maxY.push_back(maxY);
+	_maxZ.push_back(maxZ);
+
+	_skip.push_back(0);
+	_property.push_back(node.getProperty());
+
+	if (node.hasChildren()) {
+		addNode(*node._leftChild);
+		addNode(*node._rightChild);
+	}
+
+	_skip[index] = _skip.size();
+}
+
+bool AABBTree::isLeaf(size_t node) const {
+	return _skip[node] == (node + 1);
+}
+
+size_t AABBTree::findAt(float x, float y, size_t node) const {
+	const size_t count = _skip.size();
+
+	while (node < count) {
+		if ((x < _minX[node]) || (x > _maxX[node]) || (y < _minY[node]) || (y > _maxY[node])) {
+			node = _skip[node];
+			continue;
+		}
+
+		if (isLeaf(node))
+			return node;
+
+		node++;
+	}
+
+	return count;
+}
+
+size_t AABBTree::findOnSegment(float x1, float y1, float z1, float x2, float y2, float z2, size_t node) const {
+	const size_t count = _skip.size();
+
+	while (node < count) {
+		if (!BoundingBox::isLineIn(_minX[node], _minY[node], _minZ[node], _maxX[node], _maxY[node], _maxZ[node],
+		                           x1, y1, z1, x2, y2, z2)) {
+			node = _skip[node];
+			continue;
+		}
+
+		if (isLeaf(node))
+			return node;
+
+		node++;
+	}
+
+	return count;
+}
+
+} // End of namespace Common
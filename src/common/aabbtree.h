@@ -0,0 +1,97 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A flattened tree of axis-aligned bounding boxes.
+ */
+
+#ifndef COMMON_AABBTREE_H
+#define COMMON_AABBTREE_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+class AABBNode;
+
+/** A read-only, flattened copy of one or more AABBNode trees.
+ *
+ *  The nodes are stored depth-first in contiguous arrays, one array per
+ *  bounding box coordinate. Instead of child pointers, each node knows
+ *  where its subtree ends, so that a query can skip over it when the
+ *  node's box doesn't match.
+ *
+ *  The queries find the leaves in the same order as the original trees'
+ *  getNodes() would, one at a time, so the caller can stop as soon as it
+ *  found what it's looking for:
+ *
+ *  @code
+ *  for (size_t n = tree.findAt(x, y); n < tree.size(); n = tree.findAt(x, y, n + 1))
+ *    doSomething(tree.getProperty(n));
+ *  @endcode
+ */
+class AABBTree {
+public:
+	AABBTree();
+	~AABBTree();
+
+	/** Build the flattened tree out of these trees, in order. Empty trees are ignored. */
+	void build(const std::vector<AABBNode *> &trees);
+	/** Remove all nodes. */
+	void clear();
+
+	/** Return the number of nodes. */
+	size_t size() const;
+	/** Has the tree no nodes? */
+	bool empty() const;
+
+	/** Get the property of a node. */
+	int32_t getProperty(size_t node) const;
+
+	/** Find the next leaf, starting from this node, at a given point in the XY plane.
+	 *
+	 *  @return The index of the leaf, or size() if there's none.
+	 */
+	size_t findAt(float x, float y, size_t node = 0) const;
+	/** Find the next leaf, starting from this node, that goes through a given segment.
+	 *
+	 *  @return The index of the leaf, or size() if there's none.
+	 */
+	size_t findOnSegment(float x1, float y1, float z1, float x2, float y2, float z2, size_t node = 0) const;
+
+private:
+	std::vector<float> _minX, _minY, _minZ;
+	std::vector<float> _maxX, _maxY, _maxZ;
+
+	/** Index of the first node after the node's subtree. For a leaf, that's the next node. */
+	std::vector<uint32_t> _skip;
+
+	std::vector<int32_t> _property; ///< The property of each node.
+
+	void addNode(const AABBNode &node);
+
+	bool isLeaf(size_t node) const;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_AABBTREE_H
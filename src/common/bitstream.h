@@ -28,6 +28,7 @@
 #include <cassert>
 
 #include "src/common/types.h"
+#include "src/common/util.h"
 #include "src/common/disposableptr.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
@@ -61,9 +62,18 @@ public:
 	/** Read a multi-bit value from the bit stream. */
 	virtual uint32_t getBits(size_t n) = 0;
 
+	/** Read a multi-bit value from the bit stream, without consuming the bits.
+	 *
+	 *  Past the end of the stream, the missing bits are returned as 0.
+	 */
+	virtual uint32_t peekBits(size_t n) = 0;
+
 	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
 	virtual void addBit(uint32_t &x, size_t n) = 0;
 
+	/** Are the bits handed out in the order of MSB to LSB? */
+	virtual bool isMSBFirst() const = 0;
+
 protected:
 	BitStream() {
 	}
@@ -182,22 +192,72 @@ public:
 		if (n > 32)
 			throw Exception("Too many bits requested to be read");
 
-		// Read the number of bits
+		// Read the number of bits, taking as many as we can out of the current value at once
 		uint32_t v = 0;
 
-		if (isMSB2LSB) {
-			while (n-- > 0)
-				v = (v << 1) | getBit();
-		} else {
-			for (uint32_t i = 0; i < n; i++)
-				v = (v >> 1) | (((uint32_t) getBit()) << 31);
+		for (size_t got = 0; got < n; ) {
+			if (_inValue == 0)
+				readValue();
+
+			const size_t count = MIN<size_t>(n - got, valueBits - _inValue);
 
-			v >>= (32 - n);
+			if (isMSB2LSB) {
+				v = (uint32_t) ((((uint64_t) v) << count) | (_value >> (64 - count)));
+				_value <<= count;
+			} else {
+				v |= (uint32_t) ((_value & ((1ULL << count) - 1)) << got);
+				_value >>= count;
+			}
+
+			_inValue = (_inValue + count) % valueBits;
+			got += count;
 		}
 
 		return v;
 	}
 
+	/** Read a multi-bit value from the bit stream, without consuming the bits. */
+	uint32_t peekBits(size_t n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		// Start with the bits left in the current value
+		uint64_t value = _value;
+		size_t   have  = (_inValue == 0) ? 0 : (valueBits - _inValue);
+
+		if (have < n) {
+			// Read ahead as many values as we need and have, and seek back
+
+			const size_t streamPos = _stream->pos();
+			const size_t available = size() - MIN(size(), streamPos * 8);
+
+			size_t values = MIN<size_t>((n - have + valueBits - 1) / valueBits, available / valueBits);
+			if (values > 0) {
+				while (values-- > 0) {
+					const uint64_t data = readData();
+
+					if (isMSB2LSB)
+						value |= (data << (64 - valueBits)) >> have;
+					else
+						value |= data << have;
+
+					have = MIN<size_t>(have + valueBits, 64);
+				}
+
+				_stream->seek(streamPos);
+			}
+		}
+
+		// Missing bits past the end of the stream read as 0
+		if (isMSB2LSB)
+			return (uint32_t) (value >> (64 - n));
+
+		return (uint32_t) (value & ((1ULL << n) - 1));
+	}
+
 	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
 	void addBit(uint32_t &x, size_t n) {
 		if (n >= 32)
@@ -209,6 +269,11 @@ public:
 			x = (x & ~(1 << n)) | (getBit() << n);
 	}
 
+	/** Are the bits handed out in the order of MSB to LSB? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
 	/** Rewind the bit stream back to the start. */
 	void rewind() {
 		_stream->seek(0);
@@ -219,8 +284,12 @@ public:
 
 	/** Skip the specified amount of bits. */
 	void skip(size_t n) {
-		while (n-- > 0)
-			getBit();
+		while (n > 0) {
+			const size_t count = MIN<size_t>(n, 32);
+
+			getBits(count);
+			n -= count;
+		}
 	}
 
 	/** Return the stream position in bits. */
@@ -23,8 +23,16 @@
  */
 
 #include <cassert>
+#include <cstring>
 
 #include <memory>
+#include <vector>
+
+#if defined(__MINGW32__ ) && !defined(_GLIBCXX_HAS_GTHREADS)
+	#include "external/mingw-std-threads/mingw.thread.h"
+#else
+	#include <thread>
+#endif
 
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -233,19 +241,16 @@ static const uint32_t S[4][256] = {
 	}
 };
 
-static uint32_t F(const BlowfishContext &ctx, uint32_t x) {
-	const uint16_t d = (uint16_t)(x & 0xFF);
-	x >>= 8;
-	const uint16_t c = (uint16_t)(x & 0xFF);
-	x >>= 8;
-	const uint16_t b = (uint16_t)(x & 0xFF);
-	x >>= 8;
-	const uint16_t a = (uint16_t)(x & 0xFF);
+static inline uint32_t F(const BlowfishContext &ctx, uint32_t x) {
+	const uint8_t a = (x >> 24) & 0xFF;
+	const uint8_t b = (x >> 16) & 0xFF;
+	const uint8_t c = (x >>  8) & 0xFF;
+	const uint8_t d =  x        & 0xFF;
 
 	return ((ctx.S[0][a] + ctx.S[1][b]) ^ ctx.S[2][c]) + ctx.S[3][d];
 }
 
-static void blowfishEnc(BlowfishContext &ctx, uint32_t &xl, uint32_t &xr) {
+static inline void blowfishEnc(const BlowfishContext &ctx, uint32_t &xl, uint32_t &xr) {
 	for (size_t i = 0; i < kRoundCount; i++) {
 		xl = xl ^ ctx.P[i];
 		xr = F(ctx, xl) ^ xr;
@@ -259,7 +264,7 @@ static void blowfishEnc(BlowfishContext &ctx, uint32_t &xl, uint32_t &xr) {
 	xl = xl ^ ctx.P[kRoundCount + 1];
 }
 
-static void blowfishDec(BlowfishContext &ctx, uint32_t &xl, uint32_t &xr) {
+static inline void blowfishDec(const BlowfishContext &ctx, uint32_t &xl, uint32_t &xr) {
 	for (size_t i = kRoundCount + 1; i > 1; i--) {
 		xl = xl ^ ctx.P[i];
 		xr = F(ctx, xl) ^ xr;
@@ -315,7 +320,7 @@ static void blowfishSetKey(BlowfishContext &ctx, const byte *key, size_t keyLeng
 	}
 }
 
-static void blowfishECB(BlowfishContext &ctx, Mode mode, const byte *input, byte *output) {
+static inline void blowfishECB(const BlowfishContext &ctx, Mode mode, const byte *input, byte *output) {
 	uint32_t X0 = READ_BE_UINT32(input);
 	uint32_t X1 = READ_BE_UINT32(input + 4);
 
@@ -336,34 +341,114 @@ static void blowfishECB(BlowfishContext &ctx, Mode mode, const byte *input, byte
 }
 // '--- Blowfish, based on the implementation from mbed TLS ---'
 
+/** Don't give a thread less than this many bytes to work on. */
+static const size_t kMinThreadSize  = 64 * 1024;
+/** Never use more than this many threads for one en-/decryption. */
+static const size_t kMaxThreadCount = 8;
+
+/** Number of blocks blowfishECBInterleaved() works on at once. */
+static const size_t kInterleaveCount = 4;
+
+/** En-/decrypt four consecutive blocks in-place at once.
+ *
+ *  The 16 rounds of one block form one long chain of dependent S-box lookups.
+ *  Interleaving the rounds of independent blocks lets the CPU overlap them.
+ */
+static inline void blowfishECBInterleaved(const BlowfishContext &ctx, Mode mode, byte *data) {
+	uint32_t l0 = READ_BE_UINT32(data +  0), r0 = READ_BE_UINT32(data +  4);
+	uint32_t l1 = READ_BE_UINT32(data +  8), r1 = READ_BE_UINT32(data + 12);
+	uint32_t l2 = READ_BE_UINT32(data + 16), r2 = READ_BE_UINT32(data + 20);
+	uint32_t l3 = READ_BE_UINT32(data + 24), r3 = READ_BE_UINT32(data + 28);
+
+	// The decryption is the encryption with the round keys in reverse order
+	uint32_t p[kRoundCount + 2];
+	for (size_t i = 0; i < (kRoundCount + 2); i++)
+		p[i] = ctx.P[(mode == kModeDecrypt) ? (kRoundCount + 1 - i) : i];
+
+	// Two rounds at a time, so that the halves don't need to be swapped
+	for (size_t i = 0; i < kRoundCount; i += 2) {
+		l0 ^= p[i]; l1 ^= p[i]; l2 ^= p[i]; l3 ^= p[i];
+
+		r0 ^= F(ctx, l0); r1 ^= F(ctx, l1); r2 ^= F(ctx, l2); r3 ^= F(ctx, l3);
+
+		r0 ^= p[i + 1]; r1 ^= p[i + 1]; r2 ^= p[i + 1]; r3 ^= p[i + 1];
+
+		l0 ^= F(ctx, r0); l1 ^= F(ctx, r1); l2 ^= F(ctx, r2); l3 ^= F(ctx, r3);
+	}
+
+	WRITE_BE_UINT32(data +  0, r0 ^ p[kRoundCount + 1]); WRITE_BE_UINT32(data +  4, l0 ^ p[kRoundCount]);
+	WRITE_BE_UINT32(data +  8, r1 ^ p[kRoundCount + 1]); WRITE_BE_UINT32(data + 12, l1 ^ p[kRoundCount]);
+	WRITE_BE_UINT32(data + 16, r2 ^ p[kRoundCount + 1]); WRITE_BE_UINT32(data + 20, l2 ^ p[kRoundCount]);
+	WRITE_BE_UINT32(data + 24, r3 ^ p[kRoundCount + 1]); WRITE_BE_UINT32(data + 28, l3 ^ p[kRoundCount]);
+}
+
+/** En-/decrypt whole blocks in-place. */
+static void blowfishECB(const BlowfishContext &ctx, Mode mode, byte *data, size_t size) {
+	assert((size % kBlockSize) == 0);
+
+	for (; size >= (kInterleaveCount * kBlockSize); data += kInterleaveCount * kBlockSize,
+	                                                 size -= kInterleaveCount * kBlockSize)
+		blowfishECBInterleaved(ctx, mode, data);
+
+	for (; size > 0; data += kBlockSize, size -= kBlockSize)
+		blowfishECB(ctx, mode, data, data);
+}
+
+/** En-/decrypt whole blocks in-place, splitting bigger buffers over several threads.
+ *
+ *  Since the blocks in EBC mode are independent of each other, each thread
+ *  simply works on its own consecutive range of blocks.
+ */
+static void blowfishECBBulk(const BlowfishContext &ctx, Mode mode, byte *data, size_t size) {
+	assert((size % kBlockSize) == 0);
+
+	// Querying the number of cores can be expensive, so only do it once
+	static const size_t kCoreCount = std::thread::hardware_concurrency();
+
+	const size_t threadCount = MIN(MIN(kCoreCount, kMaxThreadCount), size / kMinThreadSize);
+	if (threadCount <= 1) {
+		blowfishECB(ctx, mode, data, size);
+		return;
+	}
+
+	const size_t threadSize = ((size / kBlockSize) / threadCount) * kBlockSize;
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+
+	for (size_t i = 0; i < (threadCount - 1); i++)
+		threads.emplace_back([&ctx, mode, data, threadSize, i]() {
+			blowfishECB(ctx, mode, data + i * threadSize, threadSize);
+		});
+
+	// The calling thread takes the last range, including any remainder
+	const size_t lastStart = (threadCount - 1) * threadSize;
+	blowfishECB(ctx, mode, data + lastStart, size - lastStart);
+
+	for (auto &thread : threads)
+		thread.join();
+}
+
 MemoryReadStream *blowfishEBC(SeekableReadStream &input, const std::vector<byte> &key, Mode mode) {
 	BlowfishContext ctx;
 
 	blowfishSetKey(ctx, &key[0], key.size());
 
-	size_t inputSize = input.size() - input.pos();
+	const size_t inputSize = input.size() - input.pos();
 
 	// Round up to the next multiple of the block size
 	const size_t outputSize = ((inputSize + kBlockSize - 1) / kBlockSize) * kBlockSize;
 
 	std::unique_ptr<byte[]> output = std::make_unique<byte[]>(outputSize);
 
-	byte buffer[kBlockSize];
-	byte *data = output.get();
-	while (inputSize > 0) {
-		const size_t toRead = MIN<size_t>(inputSize, kBlockSize);
-
-		if (input.read(buffer, toRead) != toRead)
-			throw Exception(kReadError);
+	// Read everything in one go, then en-/decrypt in-place
 
-		if (toRead < kBlockSize)
-			std::memset(buffer + toRead, 0, kBlockSize - toRead);
+	if (input.read(output.get(), inputSize) != inputSize)
+		throw Exception(kReadError);
 
-		blowfishECB(ctx, mode, buffer, data);
+	std::memset(output.get() + inputSize, 0, outputSize - inputSize);
 
-		data      += toRead;
-		inputSize -= toRead;
-	}
+	blowfishECBBulk(ctx, mode, output.get(), outputSize);
 
 	return new MemoryReadStream(output.release(), outputSize, true);
 }
@@ -379,4 +464,106 @@ MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vecto
 	return blowfishEBC(input, key, kModeDecrypt);
 }
 
+
+
+BlowfishEBCDecryptStream::BlowfishEBCDecryptStream(SeekableReadStream *parentStream,
+		const std::vector<byte> &key, bool disposeParentStream) :
+		_parentStream(parentStream, disposeParentStream), _context(std::make_unique<BlowfishContext>()),
+		_size(0), _pos(0), _eos(false), _blockIndex(SIZE_MAX) {
+
+	assert(_parentStream);
+
+	_size = _parentStream->size();
+
+	blowfishSetKey(*_context, key.data(), key.size());
+}
+
+BlowfishEBCDecryptStream::~BlowfishEBCDecryptStream() {
+}
+
+bool BlowfishEBCDecryptStream::eos() const {
+	return _eos;
+}
+
+size_t BlowfishEBCDecryptStream::pos() const {
+	return _pos;
+}
+
+size_t BlowfishEBCDecryptStream::size() const {
+	return _size;
+}
+
+size_t BlowfishEBCDecryptStream::seek(ptrdiff_t offset, Origin whence) {
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, 0, _size);
+	if (newPos > _size)
+		throw Exception(kSeekError);
+
+	_pos = newPos;
+	_eos = false;
+
+	return oldPos;
+}
+
+void BlowfishEBCDecryptStream::readBlocks(size_t index, byte *data, size_t count) {
+	const size_t offset = index * kBlockSize;
+	const size_t size   = MIN(count * kBlockSize, _size - offset);
+
+	_parentStream->seek(offset);
+
+	if (_parentStream->read(data, size) != size)
+		throw Exception(kReadError);
+
+	// A partial block at the end is padded with zeros
+	std::memset(data + size, 0, count * kBlockSize - size);
+
+	blowfishECBBulk(*_context, kModeDecrypt, data, count * kBlockSize);
+}
+
+size_t BlowfishEBCDecryptStream::read(void *dataPtr, size_t dataSize) {
+	if (dataSize > (_size - _pos)) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	byte *data = static_cast<byte *>(dataPtr);
+
+	size_t left = dataSize;
+	while (left > 0) {
+		const size_t index     = _pos / kBlockSize;
+		const size_t blockPos  = _pos % kBlockSize;
+
+		if ((blockPos == 0) && (left >= kBlockSize)) {
+			// Aligned whole blocks can be decrypted directly into the output
+
+			const size_t count = left / kBlockSize;
+			readBlocks(index, data, count);
+
+			data += count * kBlockSize;
+			_pos += count * kBlockSize;
+			left -= count * kBlockSize;
+
+			continue;
+		}
+
+		// Partial block: decrypt it into our own buffer, and keep it for the next small read
+
+		if (_blockIndex != index) {
+			_blockIndex = SIZE_MAX;
+
+			readBlocks(index, _block, 1);
+			_blockIndex = index;
+		}
+
+		const size_t n = MIN(left, kBlockSize - blockPos);
+		std::memcpy(data, _block + blockPos, n);
+
+		data += n;
+		_pos += n;
+		left -= n;
+	}
+
+	return dataSize;
+}
+
 } // End of namespace Common
@@ -26,19 +26,67 @@
 #define COMMON_BLOWFISH_H
 
 #include <vector>
+#include <memory>
 
 #include "src/common/types.h"
+#include "src/common/disposableptr.h"
+#include "src/common/readstream.h"
 
 namespace Common {
 
-class SeekableReadStream;
 class MemoryReadStream;
 
+struct BlowfishContext;
+
 /** Encrypt the stream with the Blowfish algorithm in EBC mode. */
 MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key);
 /** Decrypt the stream with the Blowfish algorithm in EBC mode. */
 MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key);
 
+/** A stream decrypting a Blowfish EBC encrypted stream on the fly.
+ *
+ *  Since the blocks in EBC mode are independent of each other, only the
+ *  blocks covering the data actually read are decrypted. This makes it
+ *  possible to, for example, read a few resources out of a big encrypted
+ *  archive without decrypting all of it first.
+ *
+ *  The whole parent stream is decrypted. If its size isn't a multiple of
+ *  the 8 byte block size, the last block is padded with zeros before it
+ *  is decrypted. Manipulating the parent stream directly /will/ mess up
+ *  this stream.
+ */
+class BlowfishEBCDecryptStream : public SeekableReadStream {
+public:
+	BlowfishEBCDecryptStream(SeekableReadStream *parentStream, const std::vector<byte> &key,
+	                         bool disposeParentStream = false);
+	~BlowfishEBCDecryptStream();
+
+	bool eos() const;
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+
+	size_t read(void *dataPtr, size_t dataSize);
+
+private:
+	DisposablePtr<SeekableReadStream> _parentStream;
+
+	std::unique_ptr<BlowfishContext> _context;
+
+	size_t _size;
+	size_t _pos;
+
+	bool _eos;
+
+	byte _block[8];     ///< The last decrypted block.
+	size_t _blockIndex; ///< The index of the last decrypted block, or SIZE_MAX.
+
+	/** Read and decrypt whole blocks, starting with this block index. */
+	void readBlocks(size_t index, byte *data, size_t count);
+};
+
 } // End of namespace Common
 
 #endif // COMMON_BLOWFISH_H
@@ -153,7 +153,7 @@ bool BoundingBox::isIn(float x, float y, float z) const {
 bool BoundingBox::getIntersection(float fDst1, float fDst2,
                                   float x1, float y1, float z1,
                                   float x2, float y2, float z2,
-                                  float &x, float &y, float &z) const {
+                                  float &x, float &y, float &z) {
 
 	if ((fDst1 * fDst2) >= 0.0f)
 		return false;
@@ -168,7 +168,7 @@ bool BoundingBox::getIntersection(float fDst1, float fDst2,
 }
 
 bool BoundingBox::inBox(float x, float y, float z, float minX, float minY, float minZ,
-                        float maxX, float maxY, float maxZ, int axis) const {
+                        float maxX, float maxY, float maxZ, int axis) {
 
 	if (((axis == 1) && (z > minZ) && (z < maxZ) && (y > minY) && (y < maxY)) ||
       ((axis == 2) && (z > minZ) && (z < maxZ) && (x > minX) && (x < maxX)) ||
@@ -188,6 +188,12 @@ bool BoundingBox::isIn(float x1, float y1, float z1, float x2, float y2, float z
 	float maxX, maxY, maxZ;
 	getMax(maxX, maxY, maxZ);
 
+	return isLineIn(minX, minY, minZ, maxX, maxY, maxZ, x1, y1, z1, x2, y2, z2);
+}
+
+bool BoundingBox::isLineIn(float minX, float minY, float minZ, float maxX, float maxY, float maxZ,
+                           float x1, float y1, float z1, float x2, float y2, float z2) {
+
 	if ((x2 < minX) && (x1 < minX)) return false;
 	if ((x2 > maxX) && (x1 > maxX)) return false;
 	if ((y2 < minY) && (y1 < minY)) return false;
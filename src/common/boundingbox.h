@@ -56,6 +56,10 @@ public:
 
 	bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
 
+	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with the box spanning from min to max? */
+	static bool isLineIn(float minX, float minY, float minZ, float maxX, float maxY, float maxZ,
+	                     float x1, float y1, float z1, float x2, float y2, float z2);
+
 	void add(float x, float y, float z);
 	void add(const BoundingBox &box);
 
@@ -88,12 +92,12 @@ private:
 	inline float getCoordMin(int i) const;
 	inline float getCoordMax(int i) const;
 
-	bool getIntersection(float fDst1, float fDst2,
-	                     float x1, float y1, float z1,
-	                     float x2, float y2, float z2,
-	                     float &x, float &y, float &z) const;
-	bool inBox(float x, float y, float z, float minX, float minY, float minZ,
-	           float maxX, float maxY, float maxZ, int axis) const;
+	static bool getIntersection(float fDst1, float fDst2,
+	                            float x1, float y1, float z1,
+	                            float x2, float y2, float z2,
+	                            float &x, float &y, float &z);
+	static bool inBox(float x, float y, float z, float minX, float minY, float minZ,
+	                  float maxX, float maxY, float maxZ, int axis);
 };
 
 } // End of namespace Common
@@ -58,6 +58,20 @@
 #include "src/common/util.h"
 #include "src/common/fft.h"
 
+// SSE is always there on x86-64. AVX is picked at runtime, where the compiler lets us.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+	#define XOREOS_FFT_SSE 1
+
+	#include <xmmintrin.h>
+
+	#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		#define XOREOS_FFT_AVX 1
+		#define XOREOS_FFT_AVX_TARGET __attribute__((target("avx")))
+
+		#include <immintrin.h>
+	#endif
+#endif
+
 namespace Common {
 
 FFT::FFT(int bits, bool inverse) : _bits(bits), _inverse(inverse) {
@@ -268,8 +282,233 @@ static void (* const fft_dispatch[])(Complex*) = {
 	fft2048, fft4096, fft8192, fft16384, fft32768, fft65536,
 };
 
+/* The SIMD versions vectorize the passes, which is where the bulk of the
+ * work happens. They keep the data in the same layout and do the same
+ * calculations as TRANSFORM, on 2 (SSE) or 4 (AVX) consecutive complex
+ * values at once.
+ *
+ * With u = a2 * conj(w) and v = a3 * w, TRANSFORM amounts to
+ *   a0' = a0 + (u + v)
+ *   a2' = a0 - (u + v)
+ *   a1' = a1 - i(u - v)
+ *   a3' = a1 + i(u - v)
+ */
+
+#define DECL_FFT_SIMD(t,n,n2,n4,simd)\
+static void fft##n##simd(Complex *z)\
+{\
+	fft##n2##simd(z);\
+	fft##n4##simd(z+n4*2);\
+	fft##n4##simd(z+n4*3);\
+	pass##simd(z,getCosineTable(t),n4/2);\
+}
+
+#if defined(XOREOS_FFT_SSE)
+
+/** One TRANSFORM on 2 consecutive complex values. */
+static inline void transformSSE(float *z, int o1, int o2, int o3, __m128 wre, __m128 wim) {
+	const __m128 signOdd  = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+	const __m128 signEven = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+
+	const __m128 a0 = _mm_loadu_ps(z);
+	const __m128 a1 = _mm_loadu_ps(z + o1);
+	const __m128 a2 = _mm_loadu_ps(z + o2);
+	const __m128 a3 = _mm_loadu_ps(z + o3);
+
+	const __m128 p2 = _mm_mul_ps(a2, wre);
+	const __m128 q2 = _mm_mul_ps(_mm_shuffle_ps(a2, a2, _MM_SHUFFLE(2, 3, 0, 1)), wim);
+	const __m128 p3 = _mm_mul_ps(a3, wre);
+	const __m128 q3 = _mm_mul_ps(_mm_shuffle_ps(a3, a3, _MM_SHUFFLE(2, 3, 0, 1)), wim);
+
+	const __m128 u = _mm_add_ps(p2, _mm_xor_ps(q2, signOdd));
+	const __m128 v = _mm_add_ps(p3, _mm_xor_ps(q3, signEven));
+
+	const __m128 s = _mm_add_ps(u, v);
+	const __m128 d = _mm_sub_ps(u, v);
+	const __m128 r = _mm_xor_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)), signOdd);
+
+	_mm_storeu_ps(z     , _mm_add_ps(a0, s));
+	_mm_storeu_ps(z + o2, _mm_sub_ps(a0, s));
+	_mm_storeu_ps(z + o1, _mm_add_ps(a1, r));
+	_mm_storeu_ps(z + o3, _mm_sub_ps(a1, r));
+}
+
+/* z[0...8n-1], w[1...2n-1] */
+static void passSSE(Complex *z, const float *wre, unsigned int n) {
+	float *f = reinterpret_cast<float *>(z);
+
+	const int o1 = 2 * 2*n;
+	const int o2 = 2 * 4*n;
+	const int o3 = 2 * 6*n;
+	const float *wim = wre + 2*n;
+
+	// The first value is a TRANSFORM_ZERO
+	transformSSE(f, o1, o2, o3, _mm_setr_ps(1.0f, 1.0f, wre[1], wre[1]), _mm_setr_ps(0.0f, 0.0f, wim[-1], wim[-1]));
+
+	for (unsigned int i = 1; i < n; i++) {
+		f   += 4;
+		wre += 2;
+		wim -= 2;
+
+		const __m128 wr = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(wre));
+		const __m128 wi = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(wim - 1));
+
+		transformSSE(f, o1, o2, o3, _mm_unpacklo_ps(wr, wr), _mm_shuffle_ps(wi, wi, _MM_SHUFFLE(0, 0, 1, 1)));
+	}
+}
+
+#define fft4SSE  fft4
+#define fft8SSE  fft8
+#define fft16SSE fft16
+
+DECL_FFT_SIMD(5, 32,16,8, SSE)
+DECL_FFT_SIMD(6, 64,32,16, SSE)
+DECL_FFT_SIMD(7, 128,64,32, SSE)
+DECL_FFT_SIMD(8, 256,128,64, SSE)
+DECL_FFT_SIMD(9, 512,256,128, SSE)
+DECL_FFT_SIMD(10, 1024,512,256, SSE)
+DECL_FFT_SIMD(11, 2048,1024,512, SSE)
+DECL_FFT_SIMD(12, 4096,2048,1024, SSE)
+DECL_FFT_SIMD(13, 8192,4096,2048, SSE)
+DECL_FFT_SIMD(14, 16384,8192,4096, SSE)
+DECL_FFT_SIMD(15, 32768,16384,8192, SSE)
+DECL_FFT_SIMD(16, 65536,32768,16384, SSE)
+
+static void (* const fft_dispatch_sse[])(Complex*) = {
+	fft4, fft8, fft16, fft32SSE, fft64SSE, fft128SSE, fft256SSE, fft512SSE, fft1024SSE,
+	fft2048SSE, fft4096SSE, fft8192SSE, fft16384SSE, fft32768SSE, fft65536SSE,
+};
+
+#endif // XOREOS_FFT_SSE
+
+#if defined(XOREOS_FFT_AVX)
+
+/** One TRANSFORM on 4 consecutive complex values. */
+XOREOS_FFT_AVX_TARGET
+static inline void transformAVX(float *z, int o1, int o2, int o3, __m256 wre, __m256 wim) {
+	const __m256 signOdd  = _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f);
+	const __m256 signEven = _mm256_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f);
+
+	const __m256 a0 = _mm256_loadu_ps(z);
+	const __m256 a1 = _mm256_loadu_ps(z + o1);
+	const __m256 a2 = _mm256_loadu_ps(z + o2);
+	const __m256 a3 = _mm256_loadu_ps(z + o3);
+
+	const __m256 p2 = _mm256_mul_ps(a2, wre);
+	const __m256 q2 = _mm256_mul_ps(_mm256_permute_ps(a2, _MM_SHUFFLE(2, 3, 0, 1)), wim);
+	const __m256 p3 = _mm256_mul_ps(a3, wre);
+	const __m256 q3 = _mm256_mul_ps(_mm256_permute_ps(a3, _MM_SHUFFLE(2, 3, 0, 1)), wim);
+
+	const __m256 u = _mm256_add_ps(p2, _mm256_xor_ps(q2, signOdd));
+	const __m256 v = _mm256_add_ps(p3, _mm256_xor_ps(q3, signEven));
+
+	const __m256 s = _mm256_add_ps(u, v);
+	const __m256 d = _mm256_sub_ps(u, v);
+	const __m256 r = _mm256_xor_ps(_mm256_permute_ps(d, _MM_SHUFFLE(2, 3, 0, 1)), signOdd);
+
+	_mm256_storeu_ps(z     , _mm256_add_ps(a0, s));
+	_mm256_storeu_ps(z + o2, _mm256_sub_ps(a0, s));
+	_mm256_storeu_ps(z + o1, _mm256_add_ps(a1, r));
+	_mm256_storeu_ps(z + o3, _mm256_sub_ps(a1, r));
+}
+
+/** Duplicate each of 4 twiddle factors for the real and imaginary part. */
+XOREOS_FFT_AVX_TARGET
+static inline __m256 duplicateAVX(__m128 w) {
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(w, w)), _mm_unpackhi_ps(w, w), 1);
+}
+
+/* z[0...8n-1], w[1...2n-1] */
+XOREOS_FFT_AVX_TARGET
+static void passAVX(Complex *z, const float *wre, unsigned int n) {
+	float *f = reinterpret_cast<float *>(z);
+
+	const int o1 = 2 * 2*n;
+	const int o2 = 2 * 4*n;
+	const int o3 = 2 * 6*n;
+	const float *wim = wre + 2*n;
+
+	// The first value is a TRANSFORM_ZERO
+	transformAVX(f, o1, o2, o3, duplicateAVX(_mm_setr_ps(1.0f, wre[1], wre[2], wre[3])),
+	                            duplicateAVX(_mm_setr_ps(0.0f, wim[-1], wim[-2], wim[-3])));
+
+	for (unsigned int i = 2; i < n; i += 2) {
+		f   += 8;
+		wre += 4;
+		wim -= 4;
+
+		const __m128 wi = _mm_loadu_ps(wim - 3);
+
+		transformAVX(f, o1, o2, o3, duplicateAVX(_mm_loadu_ps(wre)),
+		                            duplicateAVX(_mm_shuffle_ps(wi, wi, _MM_SHUFFLE(0, 1, 2, 3))));
+	}
+}
+
+#define fft4AVX  fft4
+#define fft8AVX  fft8
+#define fft16AVX fft16
+
+DECL_FFT_SIMD(5, 32,16,8, AVX)
+DECL_FFT_SIMD(6, 64,32,16, AVX)
+DECL_FFT_SIMD(7, 128,64,32, AVX)
+DECL_FFT_SIMD(8, 256,128,64, AVX)
+DECL_FFT_SIMD(9, 512,256,128, AVX)
+DECL_FFT_SIMD(10, 1024,512,256, AVX)
+DECL_FFT_SIMD(11, 2048,1024,512, AVX)
+DECL_FFT_SIMD(12, 4096,2048,1024, AVX)
+DECL_FFT_SIMD(13, 8192,4096,2048, AVX)
+DECL_FFT_SIMD(14, 16384,8192,4096, AVX)
+DECL_FFT_SIMD(15, 32768,16384,8192, AVX)
+DECL_FFT_SIMD(16, 65536,32768,16384, AVX)
+
+static void (* const fft_dispatch_avx[])(Complex*) = {
+	fft4, fft8, fft16, fft32AVX, fft64AVX, fft128AVX, fft256AVX, fft512AVX, fft1024AVX,
+	fft2048AVX, fft4096AVX, fft8192AVX, fft16384AVX, fft32768AVX, fft65536AVX,
+};
+
+#endif // XOREOS_FFT_AVX
+
+typedef void (* const FFTFunc)(Complex *);
+
+static const FFTFunc *getSIMDDispatch() {
+#if defined(XOREOS_FFT_AVX)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx"))
+		return fft_dispatch_avx;
+#endif
+
+#if defined(XOREOS_FFT_SSE)
+	return fft_dispatch_sse;
+#else
+	return 0;
+#endif
+}
+
+static const FFTFunc *&getDispatch() {
+	static const FFTFunc *dispatch = getSIMDDispatch() ? getSIMDDispatch() : fft_dispatch;
+
+	return dispatch;
+}
+
+bool FFT::hasSIMD() {
+	return getSIMDDispatch() != 0;
+}
+
+bool FFT::setSIMD(bool enable) {
+	if (!enable) {
+		getDispatch() = fft_dispatch;
+		return true;
+	}
+
+	if (!hasSIMD())
+		return false;
+
+	getDispatch() = getSIMDDispatch();
+	return true;
+}
+
 void FFT::calc(Complex *z) {
-	fft_dispatch[_bits - 2](z);
+	getDispatch()[_bits - 2](z);
 }
 
 } // End of namespace Common
@@ -82,6 +82,19 @@ public:
 	 */
 	void calc(Complex *z);
 
+	/** Is there a SIMD version of the FFT for this CPU? */
+	static bool hasSIMD();
+
+	/** Enable or disable the SIMD version of the FFT.
+	 *
+	 *  This affects all FFTs, and with them all transforms built on top
+	 *  of them. If available, the SIMD version is enabled by default. Its
+	 *  results only differ from the generic version in the sign of zeros.
+	 *
+	 *  @return false if enabling failed because the CPU doesn't support it.
+	 */
+	static bool setSIMD(bool enable);
+
 private:
 	int  _bits;
 	bool _inverse;
@@ -24,6 +24,8 @@
 
 #include <cassert>
 
+#include <algorithm>
+
 #include "src/common/huffman.h"
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -31,10 +33,6 @@
 
 namespace Common {
 
-Huffman::Symbol::Symbol(uint32_t c, uint32_t s) : code(c), symbol(s) {
-}
-
-
 Huffman::Huffman(const HuffmanTable &table) {
 	init(table.maxLength, table.codeCount, table.codes, table.lengths, table.symbols);
 }
@@ -62,15 +60,70 @@ void Huffman::init(uint8_t maxLength, size_t codeCount, const uint32_t *codes,
 	_codes.resize(maxLength);
 	_symbols.resize(codeCount);
 
+	std::vector<size_t> counts(maxLength, 0);
+	for (size_t i = 0; i < codeCount; i++)
+		if ((lengths[i] > 0) && (lengths[i] <= maxLength))
+			counts[lengths[i] - 1]++;
+
+	/* Codes of up to 8 bits, or lengths where at least 1 in 16 of all possible
+	 * codes are used, get a direct lookup table. All others are searched. */
+	for (size_t i = 0; i < maxLength; i++)
+		if ((counts[i] > 0) && ((i < 8) || ((1ULL << (i + 1)) <= (counts[i] * 16))))
+			_codes[i].direct.resize(1ULL << (i + 1), -1);
+
 	for (size_t i = 0; i < codeCount; i++) {
 		// The symbol. If none were specified, just assume it's identical to the code index
-		uint32_t symbol = symbols ? symbols[i] : i;
+		_symbols[i] = symbols ? symbols[i] : i;
 
-		// Put the code and symbol into the correct list
-		_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbol));
+		if ((lengths[i] == 0) || (lengths[i] > maxLength))
+			continue;
 
-		// And put the pointer to the symbol/code struct into the symbol list.
-		_symbols[i] = &_codes[lengths[i] - 1].back();
+		CodeTable &table = _codes[lengths[i] - 1];
+
+		if (!table.direct.empty()) {
+			// Codes that don't fit into their length can never be found. The first of duplicate codes wins
+			if ((codes[i] < table.direct.size()) && (table.direct[codes[i]] < 0))
+				table.direct[codes[i]] = i;
+
+		} else
+			table.sorted.push_back(std::make_pair(codes[i], (uint32_t) i));
+	}
+
+	for (std::vector<CodeTable>::iterator t = _codes.begin(); t != _codes.end(); ++t)
+		std::stable_sort(t->sorted.begin(), t->sorted.end(),
+			[](const std::pair<uint32_t, uint32_t> &a, const std::pair<uint32_t, uint32_t> &b) {
+				return a.first < b.first;
+			});
+
+	/* Build the tables to look up short codes at once. Each code fills all entries
+	 * that start with it, for both bit orders. Shorter codes go first and the first
+	 * of duplicate codes wins, just like searching length by length would do. */
+
+	_lookupBits = MIN<size_t>(maxLength, kLookupBits);
+
+	const Lookup empty = { 0, 0 };
+	_lookup[0].resize(1 << _lookupBits, empty);
+	_lookup[1].resize(1 << _lookupBits, empty);
+
+	for (size_t length = 1; length <= _lookupBits; length++) {
+		const uint32_t fill = 1 << (_lookupBits - length);
+
+		for (size_t i = 0; i < codeCount; i++) {
+			if ((lengths[i] != length) || (codes[i] >= (1U << length)))
+				continue;
+
+			const Lookup code = { (uint32_t) i, (uint8_t) length };
+
+			for (uint32_t j = 0; j < fill; j++) {
+				Lookup &lsbFirst = _lookup[0][codes[i] | (j << length)];
+				Lookup &msbFirst = _lookup[1][(codes[i] << (_lookupBits - length)) | j];
+
+				if (lsbFirst.length == 0)
+					lsbFirst = code;
+				if (msbFirst.length == 0)
+					msbFirst = code;
+			}
+		}
 	}
 }
 
@@ -79,18 +132,40 @@ Huffman::~Huffman() {
 
 void Huffman::setSymbols(const uint32_t *symbols) {
 	for (size_t i = 0; i < _symbols.size(); i++)
-		_symbols[i]->symbol = symbols ? *symbols++ : i;
+		_symbols[i] = symbols ? *symbols++ : i;
 }
 
 uint32_t Huffman::getSymbol(BitStream &bits) const {
+	// Short codes can be looked up directly
+	const Lookup &lookup = _lookup[bits.isMSBFirst() ? 1 : 0][bits.peekBits(_lookupBits)];
+	if (lookup.length > 0) {
+		bits.skip(lookup.length);
+		return _symbols[lookup.index];
+	}
+
+	// Otherwise, search through the longer codes bit by bit
 	uint32_t code = 0;
 
 	for (size_t i = 0; i < _codes.size(); i++) {
 		bits.addBit(code, i);
 
-		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-			if (code == cCode->code)
-				return cCode->symbol;
+		const CodeTable &table = _codes[i];
+
+		if (!table.direct.empty()) {
+			const int32_t index = table.direct[code];
+			if (index >= 0)
+				return _symbols[index];
+
+		} else if (!table.sorted.empty()) {
+			std::vector<std::pair<uint32_t, uint32_t>>::const_iterator c =
+				std::lower_bound(table.sorted.begin(), table.sorted.end(), code,
+					[](const std::pair<uint32_t, uint32_t> &a, uint32_t b) {
+						return a.first < b;
+					});
+
+			if ((c != table.sorted.end()) && (c->first == code))
+				return _symbols[c->second];
+		}
 	}
 
 	throw Exception("Unknown Huffman code");
@@ -28,7 +28,7 @@
 #include <cstddef>
 
 #include <vector>
-#include <list>
+#include <utility>
 
 #include "src/common/types.h"
 
@@ -68,22 +68,33 @@ public:
 	uint32_t getSymbol(BitStream &bits) const;
 
 private:
-	struct Symbol {
-		uint32_t code;
-		uint32_t symbol;
+	/** Maximum number of bits to decode with a single table lookup. */
+	static const size_t kLookupBits = 9;
 
-		Symbol(uint32_t c, uint32_t s);
+	/** A code found by looking up the next few bits in the stream. */
+	struct Lookup {
+		uint32_t index;  ///< The index of the code.
+		uint8_t  length; ///< The length of the code. 0 if no code fits.
 	};
 
-	typedef std::list<Symbol>     CodeList;
-	typedef std::vector<CodeList> CodeLists;
-	typedef std::vector<Symbol *> SymbolList;
+	/** All codes of one length, for quick lookup of the code index. */
+	struct CodeTable {
+		/** Code index for each possible code, -1 if none. Used for short or dense lengths. */
+		std::vector<int32_t> direct;
+		/** Codes and their code index, sorted by code. Used for long, sparse lengths. */
+		std::vector<std::pair<uint32_t, uint32_t>> sorted;
+	};
+
+	/** The code tables, sorted by code length. */
+	std::vector<CodeTable> _codes;
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	/** The symbols, by code index. */
+	std::vector<uint32_t> _symbols;
 
-	/** Sorted list of pointers to the symbols. */
-	SymbolList _symbols;
+	/** Number of bits looked up at once. */
+	size_t _lookupBits;
+	/** Lookup tables for all codes up to _lookupBits long, for LSB-first and MSB-first streams. */
+	std::vector<Lookup> _lookup[2];
 
 	void init(uint8_t maxLength, size_t codeCount, const uint32_t *codes,
 	          const uint8_t *lengths, const uint32_t *symbols);
@@ -0,0 +1,184 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Read-only access to whole files mapped into memory.
+ */
+
+#include "src/common/system.h"
+
+#if defined(WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+	#include <io.h>
+#endif
+
+#if defined(UNIX)
+	#include <sys/mman.h>
+#endif
+
+#include <cstdio>
+
+#include "src/common/mappedfile.h"
+#include "src/common/error.h"
+#include "src/common/ustring.h"
+#include "src/common/strutil.h"
+#include "src/common/memreadstream.h"
+#include "src/common/platform.h"
+#include "src/common/filepath.h"
+
+namespace Common {
+
+/** A stream over a part of a MappedFile, keeping the MappedFile alive. */
+class MappedReadStream : public MemoryReadStream {
+public:
+	MappedReadStream(std::shared_ptr<const MappedFile> file, size_t offset, size_t size) :
+		MemoryReadStream(file->getData() + offset, size), _file(std::move(file)) {
+
+	}
+
+private:
+	std::shared_ptr<const MappedFile> _file;
+};
+
+
+MappedFile::MappedFile(const UString &fileName) : _data(0), _size(0), _mapped(false) {
+	map(fileName);
+}
+
+MappedFile::MappedFile(SeekableReadStream &stream) : _data(0), _size(0), _mapped(false) {
+	stream.seek(0);
+
+	const size_t size = stream.size();
+
+	_memory = std::make_unique<byte[]>(size);
+	if (stream.read(_memory.get(), size) != size)
+		throw Exception(kReadError);
+
+	_data = _memory.get();
+	_size = size;
+}
+
+MappedFile::~MappedFile() {
+	unmap();
+}
+
+const byte *MappedFile::getData() const {
+	return _data;
+}
+
+size_t MappedFile::getSize() const {
+	return _size;
+}
+
+bool MappedFile::isMapped() const {
+	return _mapped;
+}
+
+SeekableReadStream *MappedFile::getStream(size_t offset, size_t size) const {
+	if ((offset > _size) || (size > (_size - offset)))
+		throw Exception("MappedFile::getStream(): Range out of bounds (%s + %s > %s)",
+		                composeString(offset).c_str(), composeString(size).c_str(),
+		                composeString(_size).c_str());
+
+	return new MappedReadStream(shared_from_this(), offset, size);
+}
+
+/** Map the whole open file into memory. Return 0 on failure. */
+static const byte *mapFile(std::FILE *file, size_t size) {
+#if defined(WIN32)
+	HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+
+	// The view keeps the file mapping object, and the file, open by itself
+	HANDLE mapping = CreateFileMappingW(handle, 0, PAGE_READONLY, 0, 0, 0);
+	if (!mapping)
+		return 0;
+
+	const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+	CloseHandle(mapping);
+
+	return static_cast<const byte *>(data);
+#elif defined(UNIX)
+	// The mapping stays valid after the file is closed
+	void *data = mmap(0, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+	if (data == MAP_FAILED)
+		return 0;
+
+	return static_cast<const byte *>(data);
+#else
+	(void) file;
+	(void) size;
+
+	return 0;
+#endif
+}
+
+static void unmapFile(const byte *data, size_t size) {
+#if defined(WIN32)
+	(void) size;
+
+	UnmapViewOfFile(data);
+#elif defined(UNIX)
+	munmap(const_cast<byte *>(data), size);
+#else
+	(void) data;
+	(void) size;
+#endif
+}
+
+void MappedFile::map(const UString &fileName) {
+	const size_t size = FilePath::getFileSize(fileName);
+	if (size == kFileInvalid)
+		throw Exception("Can't get the size of file \"%s\"", fileName.c_str());
+
+	std::FILE *file = Platform::openFile(fileName, Platform::kFileModeRead);
+	if (!file)
+		throw Exception("Can't open file \"%s\"", fileName.c_str());
+
+	_size = size;
+	if (_size > 0)
+		_data = mapFile(file, _size);
+
+	_mapped = _data != 0;
+
+	if (!_mapped && (_size > 0)) {
+		// Mapping failed, so we read the whole file instead
+
+		_memory = std::make_unique<byte[]>(_size);
+		if (std::fread(_memory.get(), 1, _size, file) != _size) {
+			std::fclose(file);
+			throw Exception(kReadError);
+		}
+
+		_data = _memory.get();
+	}
+
+	std::fclose(file);
+}
+
+void MappedFile::unmap() {
+	if (_mapped)
+		unmapFile(_data, _size);
+
+	_data   = 0;
+	_mapped = false;
+}
+
+} // End of namespace Common
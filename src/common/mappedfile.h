@@ -0,0 +1,88 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Read-only access to whole files mapped into memory.
+ */
+
+#ifndef COMMON_MAPPEDFILE_H
+#define COMMON_MAPPEDFILE_H
+
+#include <memory>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+class UString;
+class SeekableReadStream;
+
+/** The whole content of a file, available read-only in memory.
+ *
+ *  Where the operating system supports it, the file is memory-mapped, so that
+ *  only the pages that are actually accessed are ever read from disk. Otherwise,
+ *  or when constructed from a stream, the data is read into memory instead.
+ *
+ *  A MappedFile is meant to be held by a std::shared_ptr, so that the streams
+ *  returned by getStream() can keep it alive after its creator let go of it.
+ */
+class MappedFile : public std::enable_shared_from_this<MappedFile> {
+public:
+	/** Map the file with this name. Throws if the file can't be opened. */
+	MappedFile(const UString &fileName);
+	/** Read the whole stream into memory. */
+	MappedFile(SeekableReadStream &stream);
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	/** Return the file's data. */
+	const byte *getData() const;
+	/** Return the size of the file's data. */
+	size_t getSize() const;
+
+	/** Is the data actually memory-mapped, as opposed to read into memory? */
+	bool isMapped() const;
+
+	/** Return a stream over a part of the file's data.
+	 *
+	 *  The data is not copied. Instead, the stream holds a reference to this
+	 *  MappedFile, so this MappedFile has to be owned by a std::shared_ptr.
+	 *  Each stream has its own position, so several of them can be read at
+	 *  the same time, from different threads.
+	 */
+	SeekableReadStream *getStream(size_t offset, size_t size) const;
+
+private:
+	const byte *_data;
+	size_t _size;
+
+	bool _mapped; ///< Is _data a memory mapping?
+
+	std::unique_ptr<byte[]> _memory; ///< The data, if it was read into memory.
+
+	void map(const UString &fileName);
+	void unmap();
+};
+
+} // End of namespace Common
+
+#endif // COMMON_MAPPEDFILE_H
@@ -91,7 +91,7 @@ void MDCT::calcMDCT(float *output, const float *input) {
 	const int size2 = _size >> 1;
 	const int size4 = _size >> 2;
 	const int size8 = _size >> 3;
-	const int size3 = _size * 3;
+	const int size3 = size4 * 3;
 
 	const uint16_t *revTab = _fft->getRevTab();
 
@@ -40,6 +40,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/mdct.h \
     src/common/threads.h \
     src/common/thread.h \
+    src/common/threadpool.h \
     src/common/ustring.h \
     src/common/hash.h \
     src/common/md5.h \
@@ -62,6 +63,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/stringmap.h \
     src/common/readline.h \
     src/common/readfile.h \
+    src/common/mappedfile.h \
     src/common/writefile.h \
     src/common/filepath.h \
     src/common/filelist.h \
@@ -82,6 +84,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/timestamp.h \
     src/common/geometry.h \
     src/common/aabbnode.h \
+    src/common/aabbtree.h \
     src/common/random.h \
     src/common/mutex.h \
     src/common/semaphore.h \
@@ -101,6 +104,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/mdct.cpp \
     src/common/threads.cpp \
     src/common/thread.cpp \
+    src/common/threadpool.cpp \
     src/common/ustring.cpp \
     src/common/md5.cpp \
     src/common/blowfish.cpp \
@@ -122,6 +126,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/stringmap.cpp \
     src/common/readline.cpp \
     src/common/readfile.cpp \
+    src/common/mappedfile.cpp \
     src/common/writefile.cpp \
     src/common/filepath.cpp \
     src/common/filelist.cpp \
@@ -138,6 +143,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/rational.cpp \
     src/common/timestamp.cpp \
     src/common/aabbnode.cpp \
+    src/common/aabbtree.cpp \
     src/common/random.cpp \
     src/common/semaphore.cpp \
     src/common/serializationstream.cpp \
@@ -0,0 +1,112 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of worker threads.
+ */
+
+#include "src/common/util.h"
+#include "src/common/thread.h"
+#include "src/common/threadpool.h"
+
+namespace Common {
+
+ThreadPool::ThreadPool(const UString &name, size_t threadCount) : _stop(false), _name(name) {
+	if (threadCount == 0)
+		threadCount = getCoreCount();
+
+	_threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+		_threads.emplace_back(&ThreadPool::threadMethod, this);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_stop = true;
+	}
+
+	_wake.notify_all();
+
+	for (std::vector<std::thread>::iterator t = _threads.begin(); t != _threads.end(); ++t)
+		t->join();
+}
+
+size_t ThreadPool::getThreadCount() const {
+	return _threads.size();
+}
+
+std::future<void> ThreadPool::addJob(const std::function<void()> &job) {
+	std::packaged_task<void()> task(job);
+	std::future<void> future = task.get_future();
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_jobs.push_back(std::move(task));
+	}
+
+	_wake.notify_one();
+
+	return future;
+}
+
+void ThreadPool::cancelJobs() {
+	std::deque<std::packaged_task<void()>> jobs;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_jobs.swap(jobs);
+	}
+
+	// Destroy the jobs outside the lock, in case they hold on to resources that need locking themselves
+}
+
+size_t ThreadPool::getCoreCount() {
+	return MAX<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+void ThreadPool::threadMethod() {
+	if (!_name.empty())
+		Thread::setCurrentThreadName(_name);
+
+	while (true) {
+		std::packaged_task<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+
+			_wake.wait(lock, [this] { return _stop || !_jobs.empty(); });
+
+			// Only stop once all the queued jobs have run
+			if (_jobs.empty())
+				return;
+
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		job();
+	}
+}
+
+} // End of namespace Common
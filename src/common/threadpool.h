@@ -0,0 +1,97 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of worker threads.
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#if defined(__MINGW32__ ) && !defined(_GLIBCXX_HAS_GTHREADS)
+	#include "external/mingw-std-threads/mingw.thread.h"
+	#include "external/mingw-std-threads/mingw.future.h"
+#else
+	#include <thread>
+	#include <future>
+#endif
+
+#include <functional>
+#include <deque>
+#include <vector>
+
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+
+namespace Common {
+
+/** A pool of worker threads, running queued jobs in the background.
+ *
+ *  Jobs are run in the order they were added, as soon as a worker
+ *  thread is free. Every job returns a future that becomes ready once
+ *  the job has run. An exception thrown by a job is stored in its
+ *  future and rethrown by std::future::get().
+ *
+ *  Destroying the pool still runs all jobs that are already queued.
+ */
+class ThreadPool {
+public:
+	/** Create a pool of worker threads.
+	 *
+	 *  @param name        The name given to the worker threads.
+	 *  @param threadCount The number of worker threads. 0 means one for each CPU core.
+	 */
+	ThreadPool(const UString &name = "", size_t threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	/** Return the number of worker threads. */
+	size_t getThreadCount() const;
+
+	/** Queue a job to be run by one of the worker threads. */
+	std::future<void> addJob(const std::function<void()> &job);
+	/** Remove all queued jobs that haven't been started yet.
+	 *
+	 *  The futures of those jobs report a broken promise.
+	 */
+	void cancelJobs();
+
+	/** Return the number of CPU cores, or 1 if that's unknown. */
+	static size_t getCoreCount();
+
+private:
+	std::vector<std::thread> _threads;
+	std::deque<std::packaged_task<void()>> _jobs;
+
+	std::mutex _mutex;
+	std::condition_variable _wake;
+
+	bool _stop;
+
+	UString _name;
+
+	void threadMethod();
+};
+
+} // End of namespace Common
+
+#endif // COMMON_THREADPOOL_H
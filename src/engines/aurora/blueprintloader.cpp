@@ -0,0 +1,170 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Parsing object blueprints in the background.
+ */
+
+#include <cassert>
+
+#include "src/common/strutil.h"
+
+#include "src/aurora/gff3file.h"
+#include "src/aurora/2dareg.h"
+
+#include "src/engines/aurora/blueprintloader.h"
+
+namespace Engines {
+
+BlueprintLoader *BlueprintLoader::_active = 0;
+std::mutex BlueprintLoader::_activeMutex;
+
+BlueprintLoader::Blueprint::Blueprint(const Common::UString &r, Aurora::FileType t, uint32_t i, bool repair) :
+	resRef(r), type(t), id(i), repairNWNPremium(repair), claimed(false) {
+
+	parsed = promise.get_future().share();
+}
+
+
+BlueprintLoader::BlueprintLoader() {
+	std::lock_guard<std::mutex> lock(_activeMutex);
+
+	assert(!_active);
+	_active = this;
+}
+
+BlueprintLoader::~BlueprintLoader() {
+	{
+		std::lock_guard<std::mutex> lock(_activeMutex);
+
+		assert(_active == this);
+		_active = 0;
+	}
+
+	if (!_threads)
+		return;
+
+	// Don't bother parsing blueprints nobody will ask for anymore
+	_threads->cancelJobs();
+	_threads.reset();
+}
+
+Common::UString BlueprintLoader::getKey(const Common::UString &resRef, Aurora::FileType type) {
+	return resRef + "#" + Common::composeString((int) type);
+}
+
+void BlueprintLoader::preload(const Aurora::GFF3List &instances, Aurora::FileType type,
+                              uint32_t id, bool repairNWNPremium) {
+
+	if (!_threads)
+		_threads = std::make_unique<Common::ThreadPool>("BlueprintLoader");
+
+	for (Aurora::GFF3List::const_iterator i = instances.begin(); i != instances.end(); ++i) {
+		if (!*i)
+			continue;
+
+		const Common::UString resRef = (*i)->getString("TemplateResRef");
+		if (resRef.empty())
+			continue;
+
+		/* Every object gets its own copy of its blueprint, so we parse
+		 * the same blueprint again for every object using it. */
+		std::shared_ptr<Blueprint> blueprint = std::make_shared<Blueprint>(resRef, type, id, repairNWNPremium);
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			_blueprints[getKey(resRef, type)].push_back(blueprint);
+		}
+
+		_threads->addJob([blueprint]() {
+			parse(*blueprint);
+		});
+	}
+}
+
+void BlueprintLoader::preload2DA(const Common::UString &name) {
+	if (!_threads)
+		_threads = std::make_unique<Common::ThreadPool>("BlueprintLoader");
+
+	_threads->addJob([name]() {
+		try {
+			TwoDAReg.get2DA(name);
+		} catch (...) {
+			// Ignore it here, whoever needs the 2DA will get the error when they ask for it
+		}
+	});
+}
+
+void BlueprintLoader::parse(Blueprint &blueprint) {
+	if (blueprint.claimed.exchange(true))
+		return;
+
+	try {
+		blueprint.gff = std::make_unique<Aurora::GFF3File>(blueprint.resRef, blueprint.type,
+		                                                   blueprint.id, blueprint.repairNWNPremium);
+
+		blueprint.promise.set_value();
+
+	} catch (...) {
+		blueprint.promise.set_exception(std::current_exception());
+	}
+}
+
+Aurora::GFF3File *BlueprintLoader::take(const Common::UString &resRef, Aurora::FileType type,
+                                        uint32_t id, bool repairNWNPremium) {
+
+	std::lock_guard<std::mutex> lock(_activeMutex);
+	if (!_active)
+		return 0;
+
+	return _active->takeBlueprint(resRef, type, id, repairNWNPremium);
+}
+
+Aurora::GFF3File *BlueprintLoader::takeBlueprint(const Common::UString &resRef, Aurora::FileType type,
+                                                 uint32_t id, bool repairNWNPremium) {
+
+	std::shared_ptr<Blueprint> blueprint;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		BlueprintMap::iterator b = _blueprints.find(getKey(resRef, type));
+		if ((b == _blueprints.end()) || b->second.empty())
+			return 0;
+
+		blueprint = b->second.front();
+		b->second.pop_front();
+	}
+
+	// Preloaded with different parameters, so not quite what the caller wants
+	if ((blueprint->id != id) || (blueprint->repairNWNPremium != repairNWNPremium))
+		return 0;
+
+	// If nobody started parsing the blueprint yet, do it ourselves instead of waiting in line
+	parse(*blueprint);
+
+	// Rethrows the error if the blueprint failed to parse
+	blueprint->parsed.get();
+
+	return blueprint->gff.release();
+}
+
+} // End of namespace Engines
@@ -0,0 +1,129 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Parsing object blueprints in the background.
+ */
+
+#ifndef ENGINES_AURORA_BLUEPRINTLOADER_H
+#define ENGINES_AURORA_BLUEPRINTLOADER_H
+
+#include <map>
+#include <list>
+#include <memory>
+#include <atomic>
+#include <future>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+#include "src/common/threadpool.h"
+
+#include "src/aurora/types.h"
+
+namespace Aurora {
+	class GFF3File;
+}
+
+namespace Engines {
+
+/** Parses the blueprints of area objects on worker threads.
+ *
+ *  Creating the objects of an area has to happen in order, on one thread:
+ *  their IDs, their registration with the module and the order of the
+ *  area's object lists all depend on it. Most of the time, however, goes
+ *  into reading and parsing each object's blueprint GFF, and into the 2DAs
+ *  they look up, and those don't depend on anything else.
+ *
+ *  So before creating the objects, an area hands its object lists to a
+ *  BlueprintLoader, which parses all referenced blueprints in the
+ *  background. While the BlueprintLoader exists, loadOptionalGFF3() then
+ *  takes the parsed blueprints as the objects ask for them, only waiting
+ *  for those that aren't ready yet. A blueprint that nobody started to
+ *  parse yet is parsed by the thread asking for it.
+ *
+ *  Only one BlueprintLoader can be active at a time.
+ */
+class BlueprintLoader : boost::noncopyable {
+public:
+	BlueprintLoader();
+	~BlueprintLoader();
+
+	/** Parse the blueprints referenced by the TemplateResRef fields of these object instances. */
+	void preload(const Aurora::GFF3List &instances, Aurora::FileType type,
+	             uint32_t id = 0xFFFFFFFF, bool repairNWNPremium = false);
+
+	/** Load a 2DA into the 2DA registry. */
+	void preload2DA(const Common::UString &name);
+
+	/** Take a preloaded blueprint out of the active BlueprintLoader.
+	 *
+	 *  Rethrows the error if parsing the blueprint failed.
+	 *
+	 *  @return The parsed blueprint, or 0 if it wasn't preloaded.
+	 */
+	static Aurora::GFF3File *take(const Common::UString &resRef, Aurora::FileType type,
+	                              uint32_t id, bool repairNWNPremium);
+
+private:
+	/** A blueprint, possibly still being parsed. */
+	struct Blueprint {
+		Common::UString resRef;
+		Aurora::FileType type;
+		uint32_t id;
+		bool repairNWNPremium;
+
+		std::unique_ptr<Aurora::GFF3File> gff;
+
+		std::atomic<bool> claimed; ///< Has anybody started to parse the blueprint?
+		std::promise<void> promise;
+		std::shared_future<void> parsed; ///< Ready once the blueprint was parsed or failed to parse.
+
+		Blueprint(const Common::UString &r, Aurora::FileType t, uint32_t i, bool repair);
+	};
+
+	typedef std::list<std::shared_ptr<Blueprint>> BlueprintList;
+	/** All preloaded blueprints, in the order they were queued, by resref and type. */
+	typedef std::map<Common::UString, BlueprintList, Common::UString::iless> BlueprintMap;
+
+	BlueprintMap _blueprints;
+	std::mutex _mutex;
+
+	std::unique_ptr<Common::ThreadPool> _threads;
+
+	/** The BlueprintLoader loadOptionalGFF3() takes its blueprints from. */
+	static BlueprintLoader *_active;
+	/** Protects _active. */
+	static std::mutex _activeMutex;
+
+
+	static Common::UString getKey(const Common::UString &resRef, Aurora::FileType type);
+
+	/** Parse a blueprint, unless somebody else already started to. */
+	static void parse(Blueprint &blueprint);
+
+	Aurora::GFF3File *takeBlueprint(const Common::UString &resRef, Aurora::FileType type,
+	                                uint32_t id, bool repairNWNPremium);
+};
+
+} // End of namespace Engines
+
+#endif // ENGINES_AURORA_BLUEPRINTLOADER_H
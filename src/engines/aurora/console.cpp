@@ -28,6 +28,8 @@
 #include <cstddef>
 
 #include <functional>
+#include <atomic>
+#include <memory>
 
 #include "external/glm/gtc/matrix_transform.hpp"
 
@@ -36,12 +38,15 @@
 #include "src/common/filepath.h"
 #include "src/common/readline.h"
 #include "src/common/configman.h"
+#include "src/common/threadpool.h"
 
 #include "src/aurora/resman.h"
 #include "src/aurora/talkman.h"
 
 #include "src/graphics/graphics.h"
 #include "src/graphics/font.h"
+#include "src/graphics/images/decoder.h"
+#include "src/graphics/images/texturecache.h"
 #include "src/graphics/camera.h"
 //#include "src/graphics/windowman.h"
 
@@ -50,6 +55,8 @@
 #include "src/events/events.h"
 
 #include "src/graphics/aurora/textureman.h"
+#include "src/graphics/aurora/texture.h"
+#include "src/graphics/aurora/pltcompositor.h"
 #include "src/graphics/aurora/cursorman.h"
 #include "src/graphics/aurora/fontman.h"
 #include "src/graphics/aurora/text.h"
@@ -59,6 +66,7 @@
 
 #include "src/engines/aurora/console.h"
 #include "src/engines/aurora/util.h"
+#include "src/engines/aurora/model.h"
 
 #include "src/graphics/mesh/meshman.h"
 #include "src/graphics/shader/surfaceman.h"
@@ -796,12 +804,28 @@ Console::Console(Engine &engine, const Common::UString &font, int fontHeight) :
 			"Usage: playsound <sound>\nPlay the specified sound");
 	registerCommand("silence"    , std::bind(&Console::cmdSilence    , this, std::placeholders::_1),
 			"Usage: silence\nStop all playing sounds and music");
+	registerCommand("soundcache" , std::bind(&Console::cmdSoundCache , this, std::placeholders::_1),
+			"Usage: soundcache [clear]\nPrint the statistics of the decoded sound cache, or clear it");
+	registerCommand("soundstats" , std::bind(&Console::cmdSoundStats , this, std::placeholders::_1),
+			"Usage: soundstats\nPrint sound buffer underruns and decoding throughput");
 	registerCommand("getoption"  , std::bind(&Console::cmdGetOption  , this, std::placeholders::_1),
 			"Usage: getoption <option>\nPrint the value of a config options");
 	registerCommand("setoption"  , std::bind(&Console::cmdSetOption  , this, std::placeholders::_1),
 			"Usage: setoption <option> <value>\nSet the value of a config option for this session");
 	registerCommand("showfps"    , std::bind(&Console::cmdShowFPS    , this, std::placeholders::_1),
 			"Usage: showfps <true/false>\nShow/Hide the frames-per-second display");
+	registerCommand("framestats" , std::bind(&Console::cmdFrameStats , this, std::placeholders::_1),
+			"Usage: framestats\nPrint the current frame rate and render queue sorting times");
+	registerCommand("benchmodels", std::bind(&Console::cmdBenchModels, this, std::placeholders::_1),
+			"Usage: benchmodels [<count>]\nParse all (or the first <count>) models in the background\n"
+			"and print the loading throughput. The models stay cached afterwards");
+	registerCommand("benchtextures", std::bind(&Console::cmdBenchTextures, this, std::placeholders::_1),
+			"Usage: benchtextures [<count>]\nDecode all (or the first <count>) images on all cores,\n"
+			"without uploading them, and print the decoding throughput.\n"
+			"With a texture cache, the first run fills it and the second one reads from it");
+	registerCommand("texturestats", std::bind(&Console::cmdTextureStats, this, std::placeholders::_1),
+			"Usage: texturestats [list]\nPrint the memory used by textures and the evictions.\n"
+			"With \"list\", also print where each texture resides");
 	registerCommand("listlangs"  , std::bind(&Console::cmdListLangs  , this, std::placeholders::_1),
 			"Usage: listlangs\nLists all languages supported by this game version");
 	registerCommand("getlang"    , std::bind(&Console::cmdGetLang    , this, std::placeholders::_1),
@@ -1345,6 +1369,37 @@ void Console::cmdSilence(const CommandLine &UNUSED(cl)) {
 	SoundMan.stopAll();
 }
 
+void Console::cmdSoundCache(const CommandLine &cl) {
+	if (cl.args == "clear") {
+		SoundMan.clearPCMCache();
+		return;
+	}
+
+	if (!cl.args.empty()) {
+		printCommandHelp(cl.cmd);
+		return;
+	}
+
+	const Sound::PCMCache::Stats stats = SoundMan.getPCMCacheStats();
+
+	printf("Cached sounds : %u (%u KiB)", (uint) stats.count, (uint) (stats.size / 1024));
+	printf("Hits          : %u", (uint) stats.hits);
+	printf("Misses        : %u", (uint) stats.misses);
+	printf("Uncacheable   : %u", (uint) stats.uncacheable);
+	printf("Evictions     : %u", (uint) stats.evictions);
+}
+
+void Console::cmdSoundStats(const CommandLine &UNUSED(cl)) {
+	const Sound::SoundManager::BufferStats stats = SoundMan.getBufferStats();
+
+	const double seconds = stats.decodeTime / 1000000.0;
+
+	printf("Underruns       : %s", Common::composeString(stats.underruns).c_str());
+	printf("Samples decoded : %s", Common::composeString(stats.samplesDecoded).c_str());
+	printf("Decoding time   : %s ms", Common::composeString(stats.decodeTime / 1000).c_str());
+	printf("Throughput      : %.0f samples/s", (seconds > 0.0) ? (stats.samplesDecoded / seconds) : 0.0);
+}
+
 void Console::cmdGetOption(const CommandLine &cl) {
 	std::vector<Common::UString> args;
 	splitArguments(cl.args, args);
@@ -1382,6 +1437,141 @@ void Console::cmdShowFPS(const CommandLine &cl) {
 	_engine->showFPS();
 }
 
+void Console::cmdFrameStats(const CommandLine &UNUSED(cl)) {
+	printf("Frames per second    : %u", GfxMan.getFPS());
+	printf("Distance calculation : %u us", GfxMan.getDistanceTime());
+	printf("Queue sorting        : %u us", GfxMan.getSortTime());
+}
+
+void Console::cmdBenchModels(const CommandLine &cl) {
+	size_t count = SIZE_MAX;
+	if (!cl.args.empty()) {
+		try {
+			Common::parseString(cl.args, count);
+		} catch (...) {
+			printCommandHelp(cl.cmd);
+			return;
+		}
+	}
+
+	std::list<Aurora::ResourceManager::ResourceID> models;
+	ResMan.getAvailableResources(Aurora::kFileTypeMDL, models);
+
+	while (models.size() > count)
+		models.pop_back();
+
+	const uint32_t start = EventMan.getTimestamp();
+
+	for (std::list<Aurora::ResourceManager::ResourceID>::const_iterator m = models.begin(); m != models.end(); ++m)
+		preloadModelObject(m->name);
+
+	size_t failed = 0;
+	for (std::list<Aurora::ResourceManager::ResourceID>::const_iterator m = models.begin(); m != models.end(); ++m) {
+		Graphics::Aurora::Model *model = loadModelObject(m->name);
+		if (!model)
+			failed++;
+
+		freeModel(model);
+	}
+
+	const uint32_t time = EventMan.getTimestamp() - start;
+
+	printf("Models          : %u (%u failed)", (uint) models.size(), (uint) failed);
+	printf("Worker threads  : %u", (uint) Common::ThreadPool::getCoreCount());
+	printf("Loading time    : %u ms", time);
+	printf("Throughput      : %.1f models/s", (time > 0) ? (models.size() * 1000.0 / time) : 0.0);
+}
+
+void Console::cmdBenchTextures(const CommandLine &cl) {
+	size_t count = SIZE_MAX;
+	if (!cl.args.empty()) {
+		try {
+			Common::parseString(cl.args, count);
+		} catch (...) {
+			printCommandHelp(cl.cmd);
+			return;
+		}
+	}
+
+	std::list<Aurora::ResourceManager::ResourceID> images;
+	ResMan.getAvailableResources(Aurora::kResourceImage, images);
+
+	while (images.size() > count)
+		images.pop_back();
+
+	std::atomic<size_t> failed(0), size(0);
+
+	const uint32_t start = EventMan.getTimestamp();
+
+	{
+		Common::ThreadPool threads("BenchTextures");
+
+		for (std::list<Aurora::ResourceManager::ResourceID>::const_iterator i = images.begin(); i != images.end(); ++i) {
+			const Common::UString name = i->name;
+
+			threads.addJob([name, &failed, &size]() {
+				try {
+					std::unique_ptr<Graphics::ImageDecoder> image(Graphics::Aurora::Texture::loadImage(name));
+
+					for (size_t l = 0; l < image->getLayerCount(); l++)
+						for (size_t m = 0; m < image->getMipMapCount(); m++)
+							size += image->getMipMap(m, l).size;
+
+				} catch (...) {
+					failed++;
+				}
+			});
+		}
+
+		// Leaving the scope waits for all jobs to finish
+	}
+
+	const uint32_t time = EventMan.getTimestamp() - start;
+
+	printf("Images          : %u (%u failed)", (uint) images.size(), (uint) failed.load());
+	printf("Decoded data    : %u KiB", (uint) (size.load() / 1024));
+	printf("Worker threads  : %u", (uint) Common::ThreadPool::getCoreCount());
+	printf("Texture cache   : %s", TextureMan.getDiskCache() ?
+	       TextureMan.getDiskCache()->getDirectory().c_str() : "disabled");
+	printf("Decoding time   : %u ms", time);
+	printf("Throughput      : %.1f images/s", (time > 0) ? (images.size() * 1000.0 / time) : 0.0);
+}
+
+void Console::cmdTextureStats(const CommandLine &cl) {
+	if (!cl.args.empty() && (cl.args != "list")) {
+		printCommandHelp(cl.cmd);
+		return;
+	}
+
+	if (cl.args == "list") {
+		std::list<Graphics::Aurora::TextureManager::Residency> residency;
+		TextureMan.getResidency(residency);
+
+		for (std::list<Graphics::Aurora::TextureManager::Residency>::const_iterator r = residency.begin();
+		     r != residency.end(); ++r) {
+
+			printf("%-32s %6u KiB %-6s %-3s unused for %u frames", r->name.c_str(), (uint) (r->size / 1024),
+			       r->inMemory ? "memory" : "", r->onGPU ? "GPU" : "", r->framesUnused);
+		}
+	}
+
+	const Graphics::Aurora::TextureManager::Stats stats = TextureMan.getStats();
+
+	printf("Textures          : %u", (uint) stats.count);
+	printf("Image data        : %u KiB", (uint) (stats.imageDataSize / 1024));
+	printf("On the GPU        : %u KiB", (uint) (stats.textureSize / 1024));
+	printf("Budget            : %u KiB", (uint) (stats.budget / 1024));
+	printf("Image evictions   : %u", (uint) stats.imageEvictions);
+	printf("Texture evictions : %u", (uint) stats.textureEvictions);
+	printf("Restores          : %u", (uint) stats.restores);
+
+	const Graphics::Aurora::PLTCompositor::Stats pltStats = PLTComp.getStats();
+
+	printf("Cached PLT images : %u (%u KiB of %u KiB)", (uint) pltStats.images,
+	       (uint) (pltStats.size / 1024), (uint) (pltStats.budget / 1024));
+	printf("PLT cache hits    : %u of %u", (uint) pltStats.hits, (uint) (pltStats.hits + pltStats.misses));
+}
+
 void Console::cmdListLangs(const CommandLine &UNUSED(cl)) {
 	std::vector<Aurora::Language> langs;
 	if (_engine->detectLanguages(langs)) {
@@ -307,9 +307,15 @@ private:
 	void cmdListSounds (const CommandLine &cl);
 	void cmdPlaySound  (const CommandLine &cl);
 	void cmdSilence    (const CommandLine &cl);
+	void cmdSoundCache (const CommandLine &cl);
+	void cmdSoundStats (const CommandLine &cl);
 	void cmdGetOption  (const CommandLine &cl);
 	void cmdSetOption  (const CommandLine &cl);
 	void cmdShowFPS    (const CommandLine &cl);
+	void cmdFrameStats (const CommandLine &cl);
+	void cmdBenchModels(const CommandLine &cl);
+	void cmdBenchTextures(const CommandLine &cl);
+	void cmdTextureStats(const CommandLine &cl);
 	void cmdListLangs  (const CommandLine &cl);
 	void cmdGetLang    (const CommandLine &cl);
 	void cmdSetLang    (const CommandLine &cl);
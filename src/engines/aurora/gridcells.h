@@ -0,0 +1,75 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Addressing the cells of a uniform grid over the XY plane.
+ */
+
+#ifndef ENGINES_AURORA_GRIDCELLS_H
+#define ENGINES_AURORA_GRIDCELLS_H
+
+#include <cassert>
+#include <cmath>
+
+#include "src/common/types.h"
+
+namespace Engines {
+
+/** The square cells of a uniform grid over the XY plane.
+ *
+ *  The grid has no bounds. Every cell is identified by a key made out of
+ *  its integer coordinates, to be used for hashing the cells into a map.
+ *  This way, the extents of the area don't need to be known beforehand.
+ */
+class GridCells {
+public:
+	typedef uint64_t Key;
+
+	GridCells(float cellSize) : _cellSize(cellSize) {
+		assert(_cellSize > 0.0f);
+	}
+
+	/** Return the length of a side of a cell. */
+	float getCellSize() const {
+		return _cellSize;
+	}
+
+	/** Return the coordinate of the cell containing this position, along one axis. */
+	int32_t getCoordinate(float position) const {
+		return (int32_t) std::floor(position / _cellSize);
+	}
+
+	/** Return the key of the cell with these coordinates. */
+	static Key getKey(int32_t x, int32_t y) {
+		return (((Key) (uint32_t) x) << 32) | ((Key) (uint32_t) y);
+	}
+
+	/** Return the key of the cell containing this point. */
+	Key getKeyAt(float x, float y) const {
+		return getKey(getCoordinate(x), getCoordinate(y));
+	}
+
+private:
+	float _cellSize;
+};
+
+} // End of namespace Engines
+
+#endif // ENGINES_AURORA_GRIDCELLS_H
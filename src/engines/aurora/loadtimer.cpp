@@ -0,0 +1,72 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Measuring the time spent in the phases of loading something.
+ */
+
+#include "src/common/debug.h"
+#include "src/common/debugman.h"
+
+#include "src/engines/aurora/loadtimer.h"
+
+namespace Engines {
+
+LoadTimer::LoadTimer(const Common::UString &what) : _what(what), _finished(false) {
+	_start = _phaseStart = Clock::now();
+}
+
+void LoadTimer::phase(const Common::UString &name) {
+	endPhase();
+
+	Phase phase;
+	phase.name = name;
+	phase.time = 0.0;
+
+	_phases.push_back(phase);
+}
+
+void LoadTimer::finish() {
+	if (_finished)
+		return;
+
+	endPhase();
+	_finished = true;
+
+	if (!DebugMan.isEnabled(Common::kDebugEngineLogic, 1))
+		return;
+
+	const double total = std::chrono::duration<double, std::milli>(_phaseStart - _start).count();
+
+	debugC(Common::kDebugEngineLogic, 1, "Loading %s took %.1f ms:", _what.c_str(), total);
+	for (std::vector<Phase>::const_iterator p = _phases.begin(); p != _phases.end(); ++p)
+		debugC(Common::kDebugEngineLogic, 1, "  %-20s %8.1f ms", p->name.c_str(), p->time);
+}
+
+void LoadTimer::endPhase() {
+	const Clock::time_point now = Clock::now();
+
+	if (!_phases.empty())
+		_phases.back().time = std::chrono::duration<double, std::milli>(now - _phaseStart).count();
+
+	_phaseStart = now;
+}
+
+} // End of namespace Engines
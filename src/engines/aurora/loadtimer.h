@@ -0,0 +1,77 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Measuring the time spent in the phases of loading something.
+ */
+
+#ifndef ENGINES_AURORA_LOADTIMER_H
+#define ENGINES_AURORA_LOADTIMER_H
+
+#include <vector>
+#include <chrono>
+
+#include "src/common/ustring.h"
+
+namespace Engines {
+
+/** Measures how long each phase of a lengthy loading process takes.
+ *
+ *  When done, the times are printed to the "ELogic" debug channel, at
+ *  debug level 1. For example, to see how long each part of loading an
+ *  area takes, start xoreos with --debug=ELogic:1.
+ */
+class LoadTimer {
+public:
+	/** Start measuring the loading of something. */
+	LoadTimer(const Common::UString &what);
+
+	LoadTimer(const LoadTimer &) = delete;
+	LoadTimer &operator=(const LoadTimer &) = delete;
+
+	/** End the current phase, if any, and start the next one. */
+	void phase(const Common::UString &name);
+
+	/** End the current phase and print the times of all phases. */
+	void finish();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Phase {
+		Common::UString name;
+		double time; ///< In milliseconds.
+	};
+
+	Common::UString _what;
+
+	std::vector<Phase> _phases;
+
+	Clock::time_point _start;      ///< When we started measuring.
+	Clock::time_point _phaseStart; ///< When the current phase started.
+
+	bool _finished;
+
+	void endPhase();
+};
+
+} // End of namespace Engines
+
+#endif // ENGINES_AURORA_LOADTIMER_H
@@ -24,9 +24,12 @@
 
 #include <cassert>
 
+#include "src/common/util.h"
 #include "src/common/ustring.h"
 #include "src/common/error.h"
 
+#include "src/aurora/resman.h"
+
 #include "src/engines/aurora/model.h"
 #include "src/engines/aurora/modelloader.h"
 
@@ -39,6 +42,9 @@ void registerModelLoader(ModelLoader *loader) {
 }
 
 void unregisterModelLoader() {
+	if (kModelLoader)
+		kModelLoader->stopPreloading();
+
 	delete kModelLoader;
 
 	kModelLoader = 0;
@@ -62,6 +68,34 @@ Graphics::Aurora::Model *loadModelObject(const Common::UString &resref,
 	return model;
 }
 
+void preloadModelObject(const Common::UString &resref, const Common::UString &texture) {
+	assert(kModelLoader);
+
+	if (!resref.empty())
+		kModelLoader->preload(resref, Graphics::Aurora::kModelTypeObject, texture);
+}
+
+void clearModelPrototypes() {
+	if (kModelLoader)
+		kModelLoader->clearPrototypes();
+}
+
+size_t getModelObjectSize(const Common::UString &resref) {
+	static const ::Aurora::FileType kModelTypes[] = { ::Aurora::kFileTypeMDL, ::Aurora::kFileTypeMDX };
+
+	if (resref.empty())
+		return 0;
+
+	size_t size = 0;
+	for (size_t i = 0; i < ARRAYSIZE(kModelTypes); i++) {
+		const uint32_t fileSize = ResMan.getResourceSize(resref, kModelTypes[i]);
+		if (fileSize != 0xFFFFFFFF)
+			size += fileSize;
+	}
+
+	return size;
+}
+
 Graphics::Aurora::Model *loadModelGUI(const Common::UString &resref) {
 	assert(kModelLoader);
 
@@ -25,6 +25,8 @@
 #ifndef ENGINES_AURORA_MODEL_H
 #define ENGINES_AURORA_MODEL_H
 
+#include <cstddef>
+
 #include "src/graphics/aurora/types.h"
 
 namespace Common {
@@ -42,6 +44,18 @@ Graphics::Aurora::Model *loadModelObject(const Common::UString &resref,
                                          const Common::UString &texture = "");
 Graphics::Aurora::Model *loadModelGUI   (const Common::UString &resref);
 
+/** Start loading an object model in the background, for a later loadModelObject(). */
+void preloadModelObject(const Common::UString &resref, const Common::UString &texture = "");
+
+/** Forget all loaded models, because the files they're loaded from might have changed. */
+void clearModelPrototypes();
+
+/** Return the size of the files an object model is loaded from, or 0 if it doesn't exist.
+ *
+ *  Meant as a rough estimate of how much memory loading the model will take.
+ */
+size_t getModelObjectSize(const Common::UString &resref);
+
 void freeModel(Graphics::Aurora::Model *&model);
 
 } // End of namespace Engines
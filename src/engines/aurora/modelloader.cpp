@@ -22,13 +22,26 @@
  *  An abstract Aurora model loader.
  */
 
+#include "src/common/ustring.h"
+#include "src/common/strutil.h"
+#include "src/common/error.h"
+
 #include "src/graphics/aurora/model.h"
 
 #include "src/engines/aurora/modelloader.h"
 
 namespace Engines {
 
+ModelLoader::Prototype::Prototype(const Common::UString &r, Graphics::Aurora::ModelType t,
+		const Common::UString &tex, uint32_t gen) : resref(r), type(t), texture(tex),
+		claimed(false), used(false), generation(gen) {
+
+	loaded = promise.get_future().share();
+}
+
+
 ModelLoader::~ModelLoader() {
+	stopPreloading();
 }
 
 void ModelLoader::free(Graphics::Aurora::Model *&model) {
@@ -36,4 +49,138 @@ void ModelLoader::free(Graphics::Aurora::Model *&model) {
 	model = 0;
 }
 
+void ModelLoader::preload(const Common::UString &UNUSED(resref),
+		Graphics::Aurora::ModelType UNUSED(type), const Common::UString &UNUSED(texture)) {
+
+}
+
+void ModelLoader::stopPreloading() {
+	std::unique_ptr<Common::ThreadPool> threads;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		threads = std::move(_threads);
+	}
+
+	if (!threads)
+		return;
+
+	/* Preloads that never ran are still unclaimed, and will
+	 * simply be loaded by loadShared() when requested. */
+	threads->cancelJobs();
+	threads.reset();
+}
+
+void ModelLoader::clearPrototypes() {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	/* Preloads still running hold on to their prototype, and
+	 * instances hold on to the model of their prototype.
+	 *
+	 * Unused preloads are only kept if they were queued since the last
+	 * clear, i.e. for what's about to be loaded. Older ones were guesses
+	 * that didn't pan out, like doors hovered over but never used. */
+	for (PrototypeMap::iterator p = _prototypes.begin(); p != _prototypes.end(); ) {
+		if (p->second->used.load() || (p->second->generation != _generation))
+			p = _prototypes.erase(p);
+		else
+			++p;
+	}
+
+	_generation++;
+}
+
+std::shared_ptr<ModelLoader::Prototype> ModelLoader::getPrototype(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture, bool &added) {
+
+	const Common::UString key = resref + "#" + Common::composeString((int) type) + "#" + texture;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	PrototypeMap::iterator prototype = _prototypes.find(key);
+	if (prototype != _prototypes.end()) {
+		added = false;
+		return prototype->second;
+	}
+
+	added = true;
+	return _prototypes.insert(std::make_pair(key, std::make_shared<Prototype>(resref, type, texture, _generation))).first->second;
+}
+
+void ModelLoader::createPrototype(Prototype &prototype) {
+	if (prototype.claimed.exchange(true))
+		return;
+
+	try {
+		std::unique_ptr<Graphics::Aurora::Model> model(loadPrototype(prototype.resref, prototype.type, prototype.texture));
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			// Skinned models can't share their vertices. Give this one out once, directly
+			if (model->hasSkinNodes())
+				prototype.unshared = std::move(model);
+			else
+				prototype.model = std::move(model);
+		}
+
+		prototype.promise.set_value();
+
+	} catch (...) {
+		prototype.promise.set_exception(std::current_exception());
+	}
+}
+
+void ModelLoader::preloadShared(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	bool added;
+	std::shared_ptr<Prototype> prototype = getPrototype(resref, type, texture, added);
+	if (!added)
+		return;
+
+	// Preloads can be queued from other worker threads, too
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (!_threads)
+		_threads = std::make_unique<Common::ThreadPool>("ModelLoader");
+
+	_threads->addJob([this, prototype]() {
+		createPrototype(*prototype);
+	});
+}
+
+Graphics::Aurora::Model *ModelLoader::loadShared(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	bool added;
+	std::shared_ptr<Prototype> prototype = getPrototype(resref, type, texture, added);
+
+	prototype->used.store(true);
+
+	// If nobody started loading the model yet, do it ourselves instead of waiting in line
+	createPrototype(*prototype);
+
+	// Rethrows the error if the model failed to load
+	prototype->loaded.get();
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		if (prototype->model)
+			return Graphics::Aurora::Model::createInstance(prototype->model);
+
+		if (prototype->unshared)
+			return prototype->unshared.release();
+	}
+
+	return loadPrototype(resref, type, texture);
+}
+
+Graphics::Aurora::Model *ModelLoader::loadPrototype(const Common::UString &resref,
+		Graphics::Aurora::ModelType UNUSED(type), const Common::UString &UNUSED(texture)) {
+
+	throw Common::Exception("Model loader can't load model prototype \"%s\"", resref.c_str());
+}
+
 } // End of namespace Engines
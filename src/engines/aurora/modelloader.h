@@ -25,11 +25,16 @@
 #ifndef ENGINES_AURORA_MODELLOADER_H
 #define ENGINES_AURORA_MODELLOADER_H
 
-#include "src/graphics/aurora/types.h"
+#include <map>
+#include <memory>
+#include <atomic>
+#include <future>
+
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+#include "src/common/threadpool.h"
 
-namespace Common {
-	class UString;
-}
+#include "src/graphics/aurora/types.h"
 
 namespace Engines {
 
@@ -40,6 +45,99 @@ public:
 	virtual Graphics::Aurora::Model *load(const Common::UString &resref,
 			Graphics::Aurora::ModelType type, const Common::UString &texture) = 0;
 	virtual void free(Graphics::Aurora::Model *&model);
+
+	/** Start loading a model in the background, so that a later load() finds it ready.
+	 *
+	 *  Loaders that don't share their models ignore this.
+	 */
+	virtual void preload(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
+
+	/** Drop all queued preloads and wait for the ones already running.
+	 *
+	 *  Needs to be called before the model loader is destroyed, while
+	 *  loadPrototype() can still be called.
+	 */
+	void stopPreloading();
+
+	/** Release the prototypes of all shared models that were loaded so far.
+	 *
+	 *  Needs to be called whenever model files can change, like when HAKs
+	 *  or a module are unloaded. Models still in use keep their prototype
+	 *  alive on their own.
+	 *
+	 *  Prototypes that were preloaded but not yet requested are kept once,
+	 *  since they were queued for what will be loaded next. If they are
+	 *  still unused by the next call, they were a wrong guess and dropped.
+	 */
+	void clearPrototypes();
+
+protected:
+	/** Load a model that shares its data with all other loaded instances of the same model.
+	 *
+	 *  The first time a model is requested, a prototype is loaded with loadPrototype()
+	 *  and kept until clearPrototypes() is called. Every time the model is requested,
+	 *  a new instance of that prototype is returned.
+	 *
+	 *  Models with skin nodes modify their vertices while animating and are not shared.
+	 *  A completely new model is loaded every time one of those is requested.
+	 */
+	Graphics::Aurora::Model *loadShared(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
+
+	/** Queue the prototype of a shared model to be loaded on a worker thread. */
+	void preloadShared(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
+
+	/** Load a new model, to be used as a prototype by loadShared().
+	 *
+	 *  This can be called from worker threads.
+	 */
+	virtual Graphics::Aurora::Model *loadPrototype(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
+
+private:
+	/** A prototype of a shared model, possibly still being loaded. */
+	struct Prototype {
+		Common::UString resref;
+		Graphics::Aurora::ModelType type;
+		Common::UString texture;
+
+		/** The loaded model. Empty for models that can't be shared. */
+		std::shared_ptr<const Graphics::Aurora::Model> model;
+		/** A skinned model that was loaded but not yet given out. */
+		std::unique_ptr<Graphics::Aurora::Model> unshared;
+
+		std::atomic<bool> claimed; ///< Has anybody started to load the model?
+		std::atomic<bool> used;    ///< Has the model been requested by loadShared()?
+		std::promise<void> promise;
+		std::shared_future<void> loaded; ///< Ready once the model was loaded or failed to load.
+
+		uint32_t generation; ///< The number of clearPrototypes() calls before this was added.
+
+		Prototype(const Common::UString &r, Graphics::Aurora::ModelType t,
+		          const Common::UString &tex, uint32_t gen);
+	};
+
+	typedef std::map<Common::UString, std::shared_ptr<Prototype>, Common::UString::iless> PrototypeMap;
+
+	/** All known prototypes. */
+	PrototypeMap _prototypes;
+	/** The number of times the prototypes were cleared. */
+	uint32_t _generation { 0 };
+	/** Protects the prototypes against concurrent preloading. */
+	std::mutex _mutex;
+
+	/** The worker threads loading the preloaded models. Created on first use. */
+	std::unique_ptr<Common::ThreadPool> _threads;
+
+
+	/** Find or add the prototype of a model. */
+	std::shared_ptr<Prototype> getPrototype(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture, bool &added);
+
+	/** Load the model of a prototype, unless somebody else already started to. */
+	void createPrototype(Prototype &prototype);
 };
 
 } // End of namespace Engines
@@ -188,9 +188,7 @@ void Pathfinding::smoothPath(float startX, float startY, float endX, float endY,
 	for (std::vector<glm::vec3>::iterator f = path.begin(); f != path.end(); ++f)
 		pathToDraw.push_back(*f);
 
-	for (std::vector<glm::vec3>::iterator it = pathToDraw.begin(); it != pathToDraw.end(); ++it) {
-		(*it)[2] = getHeight((*it)[0], (*it)[1], true);
-	}
+	getHeights(pathToDraw, true);
 	_pathDrawing->setVertices(pathToDraw);
 }
 
@@ -381,27 +379,22 @@ float Pathfinding::getHeight(float x, float y, bool onlyWalkable) const {
 	return FLT_MIN;
 }
 
+void Pathfinding::getHeights(std::vector<glm::vec3> &points, bool onlyWalkable) const {
+	for (std::vector<glm::vec3>::iterator it = points.begin(); it != points.end(); ++it)
+		(*it)[2] = getHeight((*it)[0], (*it)[1], onlyWalkable);
+}
+
 uint32_t Pathfinding::findFace(float x, float y, bool onlyWalkable) {
-	for (std::vector<Common::AABBNode *>::iterator it = _aabbTrees.begin(); it != _aabbTrees.end(); ++it) {
-		if (*it == 0)
+	for (size_t n = _aabbTree.findAt(x, y); n < _aabbTree.size(); n = _aabbTree.findAt(x, y, n + 1)) {
+		uint32_t face = _aabbTree.getProperty(n);
+		// Check walkability
+		if (onlyWalkable && !faceWalkable(face))
 			continue;
 
-		if (!(*it)->isIn(x, y))
+		if (!inFace(face, glm::vec3(x, y, 0.f)))
 			continue;
 
-		std::vector<Common::AABBNode *> nodes;
-		(*it)->getNodes(x, y, nodes);
-		for (uint n = 0; n < nodes.size(); ++n) {
-			uint32_t face = nodes[n]->getProperty();
-			// Check walkability
-			if (onlyWalkable && !faceWalkable(face))
-				continue;
-
-			if (!inFace(face, glm::vec3(x, y, 0.f)))
-				continue;
-
-			return face;
-		}
+		return face;
 	}
 
 	return UINT32_MAX;
@@ -409,31 +402,27 @@ uint32_t Pathfinding::findFace(float x, float y, bool onlyWalkable) {
 
 bool Pathfinding::findIntersection(float x1, float y1, float z1, float x2, float y2, float z2,
                                    glm::vec3 &intersect, bool onlyWalkable) const {
-	for (size_t it = 0; it < _aabbTrees.size(); ++it) {
-		if (_aabbTrees[it] == 0)
-			continue;
+	for (size_t n = _aabbTree.findOnSegment(x1, y1, z1, x2, y2, z2); n < _aabbTree.size();
+	     n = _aabbTree.findOnSegment(x1, y1, z1, x2, y2, z2, n + 1)) {
 
-		if (!_aabbTrees[it]->isIn(x1, y1, z1, x2, y2, z2))
+		uint32_t face = _aabbTree.getProperty(n);
+		if (!inFace(face, glm::vec3(x1, y1, z1), glm::vec3(x2, y2, z2), intersect))
 			continue;
 
-		std::vector<Common::AABBNode *> nodes;
-		_aabbTrees[it]->getNodes(x1, y1, z1, x2, y2, z2, nodes);
-		for (uint n = 0; n < nodes.size(); ++n) {
-			uint32_t face = nodes[n]->getProperty();
-			if (!inFace(face, glm::vec3(x1, y1, z1), glm::vec3(x2, y2, z2), intersect))
-				continue;
-
-			if (onlyWalkable && !faceWalkable(face))
-				continue;
+		if (onlyWalkable && !faceWalkable(face))
+			continue;
 
-			return true;
-		}
+		return true;
 	}
 
 	// Face not found
 	return false;
 }
 
+void Pathfinding::flattenAABBTrees() {
+	_aabbTree.build(_aabbTrees);
+}
+
 bool Pathfinding::goThrough(uint32_t fromFace, uint32_t toFace, float width) {
 	if (width <= 0.f)
 		return true;
@@ -28,6 +28,7 @@
 #include "external/glm/vec3.hpp"
 
 #include "src/common/ustring.h"
+#include "src/common/aabbtree.h"
 
 #include "src/graphics/renderable.h"
 
@@ -93,6 +94,8 @@ public:
 	virtual bool faceWalkable(uint32_t faceID) const;
 	/** Get the height at a specific point (in the XY plane) in the walkmesh. */
 	float getHeight(float x, float y, bool onlyWalkable = false) const;
+	/** Set the z component of all these points to the height of the walkmesh there. */
+	void getHeights(std::vector<glm::vec3> &points, bool onlyWalkable = false) const;
 
 	/** Show the computed path. */
 	void showPath(bool visible = true);
@@ -124,6 +127,8 @@ protected:
 	virtual void findCenter(std::vector<glm::vec3> &vertices, float &centerX, float &centerY) const;
 	/** Are two points close? Use the _epsilon value to evaluate the proximity.*/
 	bool close(glm::vec3 &pointA, glm::vec3 &pointB) const;
+	/** Build the flattened AABB tree used by the queries. Call once the AABB trees are complete. */
+	void flattenAABBTrees();
 
 	uint32_t _polygonEdges;  ///< The number of edge a walkmesh face has.
 	uint32_t _verticesCount; ///< The total number of vertices in the walkmesh.
@@ -137,6 +142,7 @@ protected:
 	std::vector<uint32_t> _faceProperty; ///< The property of each faces. Usually used to state the walkability.
 
 	std::vector<Common::AABBNode *> _aabbTrees; ///< The set of AABB trees in the walkmesh.
+	Common::AABBTree _aabbTree; ///< All AABB trees, flattened for faster point and segment queries.
 	bool _pathVisible;
 	bool _walkmeshVisible;
 
@@ -0,0 +1,188 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A uniform grid for finding moving objects close to a point.
+ */
+
+#ifndef ENGINES_AURORA_PROXIMITYGRID_H
+#define ENGINES_AURORA_PROXIMITYGRID_H
+
+#include <cassert>
+#include <cstddef>
+
+#include <vector>
+#include <unordered_map>
+
+#include "src/common/types.h"
+
+#include "src/engines/aurora/gridcells.h"
+
+namespace Engines {
+
+/** A uniform grid over the XY plane, sorting objects into square cells
+ *  according to their position.
+ *
+ *  Looking for objects within a certain distance of a point then only
+ *  needs to consider the cells overlapping that circle, instead of all
+ *  objects.
+ *
+ *  Ideally, the size of a cell is about the distance usually searched for.
+ *  The grid only stores pointers, it never dereferences them.
+ */
+template<typename T>
+class ProximityGrid {
+public:
+	ProximityGrid(float cellSize) : _grid(cellSize) {
+	}
+
+	/** Return the number of objects in the grid. */
+	size_t size() const {
+		return _objects.size();
+	}
+
+	/** Is this object in the grid? */
+	bool contains(T *object) const {
+		return _objects.find(object) != _objects.end();
+	}
+
+	/** Append all objects in the grid to the vector, in no particular order. */
+	void getObjects(std::vector<T *> &objects) const {
+		objects.reserve(objects.size() + _objects.size());
+
+		for (const auto &o : _objects)
+			objects.push_back(o.first);
+	}
+
+	/** Remove all objects from the grid. */
+	void clear() {
+		_cells.clear();
+		_objects.clear();
+	}
+
+	/** Add an object to the grid, or update its position if it's already there. */
+	void update(T *object, float x, float y) {
+		const GridCells::Key cell = _grid.getKeyAt(x, y);
+
+		auto o = _objects.find(object);
+		if (o != _objects.end()) {
+			if (o->second.cell == cell) {
+				Entry &entry = _cells[cell][o->second.index];
+
+				entry.x = x;
+				entry.y = y;
+				return;
+			}
+
+			removeFromCell(o->second);
+			o->second = addToCell(cell, object, x, y);
+			return;
+		}
+
+		_objects.insert(std::make_pair(object, addToCell(cell, object, x, y)));
+	}
+
+	/** Remove an object from the grid. */
+	void remove(T *object) {
+		auto o = _objects.find(object);
+		if (o == _objects.end())
+			return;
+
+		removeFromCell(o->second);
+		_objects.erase(o);
+	}
+
+	/** Find all objects within this distance of this point.
+	 *
+	 *  The distance is measured in the XY plane, using the position last
+	 *  given to update(). The objects found are appended to the vector.
+	 */
+	void findNear(float x, float y, float distance, std::vector<T *> &objects) const {
+		const int32_t minX = _grid.getCoordinate(x - distance), maxX = _grid.getCoordinate(x + distance);
+		const int32_t minY = _grid.getCoordinate(y - distance), maxY = _grid.getCoordinate(y + distance);
+
+		const float distanceSquared = distance * distance;
+
+		for (int32_t cellY = minY; cellY <= maxY; cellY++) {
+			for (int32_t cellX = minX; cellX <= maxX; cellX++) {
+				auto c = _cells.find(GridCells::getKey(cellX, cellY));
+				if (c == _cells.end())
+					continue;
+
+				for (const Entry &entry : c->second) {
+					const float dX = entry.x - x;
+					const float dY = entry.y - y;
+
+					if ((dX * dX + dY * dY) <= distanceSquared)
+						objects.push_back(entry.object);
+				}
+			}
+		}
+	}
+
+private:
+	/** An object within a cell. */
+	struct Entry {
+		T *object;
+		float x, y;
+	};
+
+	/** Where an object is stored. */
+	struct Location {
+		GridCells::Key cell;
+		size_t index; ///< Index of the object within the cell.
+	};
+
+	GridCells _grid;
+
+	std::unordered_map<GridCells::Key, std::vector<Entry>> _cells;
+	std::unordered_map<T *, Location> _objects;
+
+
+	Location addToCell(GridCells::Key cell, T *object, float x, float y) {
+		std::vector<Entry> &entries = _cells[cell];
+
+		entries.push_back({ object, x, y });
+
+		return { cell, entries.size() - 1 };
+	}
+
+	void removeFromCell(const Location &location) {
+		auto c = _cells.find(location.cell);
+		assert(c != _cells.end());
+
+		std::vector<Entry> &entries = c->second;
+		assert(location.index < entries.size());
+
+		// Move the last object of the cell into the hole
+		if (location.index != (entries.size() - 1)) {
+			entries[location.index] = entries.back();
+			_objects[entries[location.index].object].index = location.index;
+		}
+
+		entries.pop_back();
+		if (entries.empty())
+			_cells.erase(c);
+	}
+};
+
+} // End of namespace Engines
+
+#endif // ENGINES_AURORA_PROXIMITYGRID_H
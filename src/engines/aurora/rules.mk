@@ -27,17 +27,22 @@ src_engines_aurora_libaurora_la_SOURCES += \
     src/engines/aurora/resources.h \
     src/engines/aurora/tokenman.h \
     src/engines/aurora/modelloader.h \
+    src/engines/aurora/blueprintloader.h \
     src/engines/aurora/model.h \
     src/engines/aurora/widget.h \
     src/engines/aurora/gui.h \
     src/engines/aurora/console.h \
     src/engines/aurora/loadprogress.h \
+    src/engines/aurora/loadtimer.h \
     src/engines/aurora/flycamera.h \
     src/engines/aurora/trigger.h \
     src/engines/aurora/pathfinding.h \
     src/engines/aurora/astar.h \
     src/engines/aurora/localpathfinding.h \
     src/engines/aurora/objectwalkmesh.h \
+    src/engines/aurora/gridcells.h \
+    src/engines/aurora/proximitygrid.h \
+    src/engines/aurora/spatialindex.h \
     $(EMPTY)
 
 src_engines_aurora_libaurora_la_SOURCES += \
@@ -45,11 +50,13 @@ src_engines_aurora_libaurora_la_SOURCES += \
     src/engines/aurora/resources.cpp \
     src/engines/aurora/tokenman.cpp \
     src/engines/aurora/modelloader.cpp \
+    src/engines/aurora/blueprintloader.cpp \
     src/engines/aurora/model.cpp \
     src/engines/aurora/widget.cpp \
     src/engines/aurora/gui.cpp \
     src/engines/aurora/console.cpp \
     src/engines/aurora/loadprogress.cpp \
+    src/engines/aurora/loadtimer.cpp \
     src/engines/aurora/flycamera.cpp \
     src/engines/aurora/trigger.cpp \
     src/engines/aurora/pathfinding.cpp \
@@ -0,0 +1,264 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A spatial index for finding objects at a point or along a line.
+ */
+
+#ifndef ENGINES_AURORA_SPATIALINDEX_H
+#define ENGINES_AURORA_SPATIALINDEX_H
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+#include "src/common/util.h"
+
+#include "src/engines/aurora/gridcells.h"
+
+namespace Engines {
+
+/** An index of objects covering rectangular regions of the XY plane, like
+ *  triggers or the bounding boxes of clickable objects.
+ *
+ *  The plane is divided into a uniform grid of square cells, and each object
+ *  is listed in all the cells its rectangle overlaps. A query then only needs
+ *  to look at the objects in the cells touched by the point or line, instead
+ *  of at all objects.
+ *
+ *  Queries only test the rectangles; the caller still needs to do any exact
+ *  test against the object's real shape. The objects found are always
+ *  returned in the order in which they were added to the index.
+ *
+ *  The index only stores pointers, it never dereferences them.
+ */
+template<typename T>
+class SpatialIndex {
+public:
+	SpatialIndex(float cellSize) : _grid(cellSize), _nextSerial(0) {
+	}
+
+	/** Return the number of objects in the index. */
+	size_t size() const {
+		return _objects.size();
+	}
+
+	/** Is this object in the index? */
+	bool contains(T *object) const {
+		return _objects.find(object) != _objects.end();
+	}
+
+	/** Remove all objects from the index. */
+	void clear() {
+		_cells.clear();
+		_objects.clear();
+
+		_nextSerial = 0;
+	}
+
+	/** Add an object covering this rectangle, or update the rectangle of an object already in the index. */
+	void update(T *object, float minX, float minY, float maxX, float maxY) {
+		assert((minX <= maxX) && (minY <= maxY));
+
+		Entry entry = { object, 0, minX, minY, maxX, maxY };
+
+		auto o = _objects.find(object);
+		if (o != _objects.end()) {
+			entry.serial = o->second.serial;
+
+			removeFromCells(o->second);
+			o->second = entry;
+		} else {
+			entry.serial = _nextSerial++;
+
+			_objects.insert(std::make_pair(object, entry));
+		}
+
+		addToCells(entry);
+	}
+
+	/** Remove an object from the index. */
+	void remove(T *object) {
+		auto o = _objects.find(object);
+		if (o == _objects.end())
+			return;
+
+		removeFromCells(o->second);
+		_objects.erase(o);
+	}
+
+	/** Find all objects whose rectangle contains this point. The objects found are appended to the vector. */
+	void findAt(float x, float y, std::vector<T *> &objects) const {
+		auto c = _cells.find(_grid.getKeyAt(x, y));
+		if (c == _cells.end())
+			return;
+
+		std::vector<const Entry *> found;
+		for (const Entry &entry : c->second)
+			if ((x >= entry.minX) && (x <= entry.maxX) && (y >= entry.minY) && (y <= entry.maxY))
+				found.push_back(&entry);
+
+		appendSorted(found, objects);
+	}
+
+	/** Find all objects whose rectangle is crossed by the line from (x1, y1) to (x2, y2).
+	 *  The objects found are appended to the vector.
+	 */
+	void findAlong(float x1, float y1, float x2, float y2, std::vector<T *> &objects) const {
+		const float dX = x2 - x1;
+		const float dY = y2 - y1;
+
+		int32_t cellX = _grid.getCoordinate(x1), cellY = _grid.getCoordinate(y1);
+
+		const int32_t endCellX = _grid.getCoordinate(x2), endCellY = _grid.getCoordinate(y2);
+
+		const int32_t stepX = (dX > 0.0f) ? 1 : -1;
+		const int32_t stepY = (dY > 0.0f) ? 1 : -1;
+
+		/* Walk along the cells crossed by the line. tMax is how far along the line
+		 * the next cell border is, tDelta how far apart the borders are. */
+
+		const float nextBorderX = (cellX + ((stepX > 0) ? 1 : 0)) * _grid.getCellSize();
+		const float nextBorderY = (cellY + ((stepY > 0) ? 1 : 0)) * _grid.getCellSize();
+
+		float tMaxX = (dX != 0.0f) ? ((nextBorderX - x1) / dX) : INFINITY;
+		float tMaxY = (dY != 0.0f) ? ((nextBorderY - y1) / dY) : INFINITY;
+
+		const float tDeltaX = (dX != 0.0f) ? (_grid.getCellSize() / std::fabs(dX)) : INFINITY;
+		const float tDeltaY = (dY != 0.0f) ? (_grid.getCellSize() / std::fabs(dY)) : INFINITY;
+
+		size_t cellCount = 1 + std::abs(endCellX - cellX) + std::abs(endCellY - cellY);
+
+		std::vector<const Entry *> found;
+		while (cellCount-- > 0) {
+			auto c = _cells.find(GridCells::getKey(cellX, cellY));
+			if (c != _cells.end())
+				for (const Entry &entry : c->second)
+					if (isCrossed(entry, x1, y1, dX, dY))
+						found.push_back(&entry);
+
+			if (tMaxX < tMaxY) {
+				tMaxX += tDeltaX;
+				cellX += stepX;
+			} else {
+				tMaxY += tDeltaY;
+				cellY += stepY;
+			}
+		}
+
+		// Objects spanning several cells might have been found more than once
+		appendSorted(found, objects);
+	}
+
+private:
+	/** An object and the rectangle it covers. */
+	struct Entry {
+		T *object;
+		uint64_t serial; ///< Order in which the object was added.
+
+		float minX, minY;
+		float maxX, maxY;
+	};
+
+	GridCells _grid;
+
+	uint64_t _nextSerial;
+
+	std::unordered_map<GridCells::Key, std::vector<Entry>> _cells;
+	std::unordered_map<T *, Entry> _objects;
+
+
+	void addToCells(const Entry &entry) {
+		const int32_t minX = _grid.getCoordinate(entry.minX), maxX = _grid.getCoordinate(entry.maxX);
+		const int32_t minY = _grid.getCoordinate(entry.minY), maxY = _grid.getCoordinate(entry.maxY);
+
+		for (int32_t y = minY; y <= maxY; y++)
+			for (int32_t x = minX; x <= maxX; x++)
+				_cells[GridCells::getKey(x, y)].push_back(entry);
+	}
+
+	void removeFromCells(const Entry &entry) {
+		const int32_t minX = _grid.getCoordinate(entry.minX), maxX = _grid.getCoordinate(entry.maxX);
+		const int32_t minY = _grid.getCoordinate(entry.minY), maxY = _grid.getCoordinate(entry.maxY);
+
+		for (int32_t y = minY; y <= maxY; y++) {
+			for (int32_t x = minX; x <= maxX; x++) {
+				auto c = _cells.find(GridCells::getKey(x, y));
+				assert(c != _cells.end());
+
+				std::vector<Entry> &entries = c->second;
+				entries.erase(std::find_if(entries.begin(), entries.end(), [&](const Entry &e) {
+					return e.object == entry.object;
+				}));
+
+				if (entries.empty())
+					_cells.erase(c);
+			}
+		}
+	}
+
+	/** Does the line starting at (x, y) going (dX, dY) cross the rectangle of this entry? */
+	static bool isCrossed(const Entry &entry, float x, float y, float dX, float dY) {
+		// Clip the line against the borders of the rectangle
+		float tMin = 0.0f, tMax = 1.0f;
+
+		return clip(-dX, x - entry.minX, tMin, tMax) && clip(dX, entry.maxX - x, tMin, tMax) &&
+		       clip(-dY, y - entry.minY, tMin, tMax) && clip(dY, entry.maxY - y, tMin, tMax);
+	}
+
+	static bool clip(float p, float q, float &tMin, float &tMax) {
+		if (p == 0.0f)
+			return q >= 0.0f;
+
+		const float t = q / p;
+		if (p < 0.0f) {
+			if (t > tMax)
+				return false;
+
+			tMin = MAX(tMin, t);
+		} else {
+			if (t < tMin)
+				return false;
+
+			tMax = MIN(tMax, t);
+		}
+
+		return true;
+	}
+
+	static void appendSorted(std::vector<const Entry *> &found, std::vector<T *> &objects) {
+		std::sort(found.begin(), found.end(), [](const Entry *a, const Entry *b) {
+			return a->serial < b->serial;
+		});
+
+		for (size_t i = 0; i < found.size(); i++)
+			if ((i == 0) || (found[i]->serial != found[i - 1]->serial))
+				objects.push_back(found[i]->object);
+	}
+};
+
+} // End of namespace Engines
+
+#endif // ENGINES_AURORA_SPATIALINDEX_H
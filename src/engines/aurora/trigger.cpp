@@ -86,6 +86,19 @@ bool Trigger::contains(float x, float y) const {
 	return (count % 2) ? true : false;
 }
 
+bool Trigger::getBounds(float &minX, float &minY, float &maxX, float &maxY) const {
+	if (_geometry.size() < 3)
+		return false;
+
+	assert(_prepared);
+
+	float minZ, maxZ;
+	_boundingbox.getMin(minX, minY, minZ);
+	_boundingbox.getMax(maxX, maxY, maxZ);
+
+	return true;
+}
+
 void Trigger::calculateDistance() {
 
 }
@@ -42,6 +42,9 @@ public:
 	void setVisible(bool visible);
 	bool contains(float x, float y) const;
 
+	/** Get the horizontal extent of the trigger. Return false if it doesn't cover any area. */
+	bool getBounds(float &minX, float &minY, float &maxX, float &maxY) const;
+
 	// .--- Renderable
 	void calculateDistance();
 	void render(Graphics::RenderPass pass);
@@ -50,6 +50,7 @@
 #include "src/events/events.h"
 
 #include "src/engines/aurora/util.h"
+#include "src/engines/aurora/blueprintloader.h"
 
 namespace Engines {
 
@@ -89,11 +90,25 @@ Sound::ChannelHandle playSound(const Common::UString &sound, Sound::SoundType so
 	Sound::ChannelHandle channel;
 
 	try {
-		Common::SeekableReadStream *soundStream = ResMan.getResource(resType, sound);
-		if (!soundStream)
-			return channel;
+		if (soundType == Sound::kSoundTypeSFX) {
+			// Sound effects are often short and played again and again. Keep those decoded
+			channel = SoundMan.playCachedSound(sound, soundType, loop);
 
-		channel = SoundMan.playSoundFile(soundStream, soundType, loop);
+			if (!SoundMan.isValidChannel(channel)) {
+				Common::SeekableReadStream *soundStream = ResMan.getResource(resType, sound);
+				if (!soundStream)
+					return channel;
+
+				channel = SoundMan.playSoundFile(soundStream, sound, soundType, loop);
+			}
+
+		} else {
+			Common::SeekableReadStream *soundStream = ResMan.getResource(resType, sound);
+			if (!soundStream)
+				return channel;
+
+			channel = SoundMan.playSoundFile(soundStream, soundType, loop);
+		}
 
 		debugC(Common::kDebugEngineSound, 1, "Playing sound \"%s\" in %s",
 		       sound.c_str(), SoundMan.formatChannel(channel).c_str());
@@ -153,6 +168,11 @@ Aurora::GFF3File *loadOptionalGFF3(const Common::UString &gff3, Aurora::FileType
                                    uint32_t id, bool repairNWNPremium) {
 
 	try {
+		// Maybe it was already parsed in the background
+		Aurora::GFF3File *preloaded = BlueprintLoader::take(gff3, type, id, repairNWNPremium);
+		if (preloaded)
+			return preloaded;
+
 		return new Aurora::GFF3File(gff3, type, id, repairNWNPremium);
 	} catch (...) {
 	}
@@ -36,6 +36,10 @@
 
 #include "src/graphics/camera.h"
 
+#include "src/sound/sound.h"
+
+#include "src/engines/aurora/model.h"
+
 #include "src/engines/dragonage/game.h"
 #include "src/engines/dragonage/campaign.h"
 #include "src/engines/dragonage/area.h"
@@ -320,6 +324,9 @@ void Campaign::loadResources() {
 		_game->loadTalkTables ("/addins/" + _addinBase + "/module", 10500, _tlks);
 		_game->loadTexturePack("/addins/" + _addinBase + "/module", 10500, _resources, kTextureQualityHigh);
 	}
+
+	// The campaign can come with its own sounds, replacing ones we might have already played
+	SoundMan.clearPCMCache();
 }
 
 void Campaign::readCIFDynamic(const Common::UString &path) {
@@ -368,6 +375,10 @@ void Campaign::unload() {
 
 	deindexResources(_resources);
 
+	// The campaign can come with its own models and sounds
+	clearModelPrototypes();
+	SoundMan.clearPCMCache();
+
 	_loaded = false;
 }
 
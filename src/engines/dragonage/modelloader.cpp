@@ -38,6 +38,18 @@ namespace Engines {
 namespace DragonAge {
 
 Graphics::Aurora::Model *DragonAgeModelLoader::load(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	return loadShared(resref, type, texture);
+}
+
+void DragonAgeModelLoader::preload(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	preloadShared(resref, type, texture);
+}
+
+Graphics::Aurora::Model *DragonAgeModelLoader::loadPrototype(const Common::UString &resref,
 		Graphics::Aurora::ModelType type, const Common::UString &UNUSED(texture)) {
 
 	// Check if this model uses LOD. If so, load the highest
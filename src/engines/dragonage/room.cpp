@@ -128,6 +128,11 @@ void Room::loadLayout(const Common::UString &roomFile) {
 	const GFF4List &models = rmlTop.getList(kGFF4EnvRoomModelList);
 	_models.reserve(models.size());
 
+	// Parse all room models in the background, while we're placing them in order
+	for (GFF4List::const_iterator m = models.begin(); m != models.end(); ++m)
+		if (*m && ((*m)->getLabel() == kMDLID))
+			preloadModelObject((*m)->getString(kGFF4EnvModelFile));
+
 	for (GFF4List::const_iterator m = models.begin(); m != models.end(); ++m) {
 		if (!*m || ((*m)->getLabel() != kMDLID))
 			continue;
@@ -39,6 +39,18 @@ KotORModelLoader::KotORModelLoader(bool xbox) : _xbox(xbox) {
 Graphics::Aurora::Model *KotORModelLoader::load(const Common::UString &resref,
 		Graphics::Aurora::ModelType type, const Common::UString &texture) {
 
+	return loadShared(resref, type, texture);
+}
+
+void KotORModelLoader::preload(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	preloadShared(resref, type, texture);
+}
+
+Graphics::Aurora::Model *KotORModelLoader::loadPrototype(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
 	return new Graphics::Aurora::Model_KotOR(resref, false, _xbox, type, texture, &_modelCache);
 }
 
@@ -39,6 +39,18 @@ KotOR2ModelLoader::KotOR2ModelLoader(bool xbox) : _xbox(xbox) {
 Graphics::Aurora::Model *KotOR2ModelLoader::load(const Common::UString &resref,
 		Graphics::Aurora::ModelType type, const Common::UString &texture) {
 
+	return loadShared(resref, type, texture);
+}
+
+void KotOR2ModelLoader::preload(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	preloadShared(resref, type, texture);
+}
+
+Graphics::Aurora::Model *KotOR2ModelLoader::loadPrototype(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
 	return new Graphics::Aurora::Model_KotOR(resref, true, _xbox, type, texture, &_modelCache);
 }
 
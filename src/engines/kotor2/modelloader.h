@@ -39,6 +39,12 @@ public:
 
 	Graphics::Aurora::Model *load(const Common::UString &resref,
 			Graphics::Aurora::ModelType type, const Common::UString &texture);
+	void preload(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
+
+protected:
+	Graphics::Aurora::Model *loadPrototype(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
 
 private:
 	bool _xbox;
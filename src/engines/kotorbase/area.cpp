@@ -43,7 +43,10 @@
 #include "src/sound/sound.h"
 
 #include "src/engines/aurora/util.h"
+#include "src/engines/aurora/model.h"
 #include "src/engines/aurora/localpathfinding.h"
+#include "src/engines/aurora/blueprintloader.h"
+#include "src/engines/aurora/loadtimer.h"
 
 #include "src/engines/kotorbase/room.h"
 #include "src/engines/kotorbase/creature.h"
@@ -65,6 +68,9 @@ namespace Engines {
 
 namespace KotORBase {
 
+/** Size of the cells the triggers are sorted into. */
+static const float kTriggerCellSize = 8.0f;
+
 Area::Area(Module &module, const Common::UString &resRef) :
 		Object(kObjectTypeArea),
 		_module(&module),
@@ -72,6 +78,7 @@ Area::Area(Module &module, const Common::UString &resRef) :
 		_visible(false),
 		_activeObject(0),
 		_highlightAll(false),
+		_triggerIndex(kTriggerCellSize),
 		_triggersVisible(false),
 		_activeTrigger(0),
 		_walkmeshInvisible(true) {
@@ -106,26 +113,41 @@ Area::~Area() {
 }
 
 void Area::load() {
+	LoadTimer timer("area \"" + _resRef + "\"");
+
+	timer.phase("LYT and VIS");
 	loadLYT(); // Room layout
 	loadVIS(); // Room visibilities
 
+	timer.phase("GIT");
+	std::unique_ptr<Aurora::GFF3File> git(loadGFF(Aurora::kFileTypeGIT, MKTAG('G', 'I', 'T', ' ')));
+
+	// Parse the object blueprints in the background, while we're loading the rooms and creating the objects in order
+	BlueprintLoader blueprints;
+	preloadBlueprints(git->getTopLevel(), blueprints);
+
+	timer.phase("Rooms");
 	loadRooms();
 
-	_are = std::make_unique<Aurora::GFF3File>(_resRef, Aurora::kFileTypeARE, MKTAG('A', 'R', 'E', ' '));
+	timer.phase("ARE");
+	_are.reset(loadGFF(Aurora::kFileTypeARE, MKTAG('A', 'R', 'E', ' ')));
 	loadARE(_are->getTopLevel());
 
-	Aurora::GFF3File git(_resRef, Aurora::kFileTypeGIT, MKTAG('G', 'I', 'T', ' '));
-	loadGIT(git.getTopLevel());
+	loadGIT(git->getTopLevel(), timer);
+
+	timer.finish();
 }
 
 void Area::clear() {
 	for (auto &object : _objects)
 		_module->removeObject(*object);
 
+	_creatureGrid.clear();
 	_objects.clear();
 	_creatures.clear();
 	_rooms.clear();
 	_triggers.clear();
+	_triggerIndex.clear();
 	_situatedObjects.clear();
 	_activeTrigger = 0;
 }
@@ -304,9 +326,26 @@ void Area::hide() {
 	_visible = false;
 }
 
+Common::SeekableReadStream *Area::loadFile(Aurora::FileType type) {
+	// We might have loaded it already, while the party was on its way here
+	Common::SeekableReadStream *file = _module->takePreloaded(_resRef, type);
+	if (file)
+		return file;
+
+	return ResMan.getResource(_resRef, type);
+}
+
+Aurora::GFF3File *Area::loadGFF(Aurora::FileType type, uint32_t id) {
+	Common::SeekableReadStream *file = _module->takePreloaded(_resRef, type);
+	if (file)
+		return new Aurora::GFF3File(file, id);
+
+	return new Aurora::GFF3File(_resRef, type, id);
+}
+
 void Area::loadLYT() {
 	try {
-		std::unique_ptr<Common::SeekableReadStream> lyt(ResMan.getResource(_resRef, Aurora::kFileTypeLYT));
+		std::unique_ptr<Common::SeekableReadStream> lyt(loadFile(Aurora::kFileTypeLYT));
 		if (!lyt)
 			throw Common::Exception("No such LYT");
 
@@ -320,7 +359,7 @@ void Area::loadLYT() {
 
 void Area::loadVIS() {
 	try {
-		std::unique_ptr<Common::SeekableReadStream> vis(ResMan.getResource(_resRef, Aurora::kFileTypeVIS));
+		std::unique_ptr<Common::SeekableReadStream> vis(loadFile(Aurora::kFileTypeVIS));
 		if (!vis)
 			throw Common::Exception("No such VIS");
 
@@ -367,29 +406,76 @@ void Area::loadCameraStyle(uint32_t id) {
 	_cameraStyle.viewAngle = row.getFloat("viewangle");
 }
 
-void Area::loadGIT(const Aurora::GFF3Struct &git) {
+void Area::loadGIT(const Aurora::GFF3Struct &git, LoadTimer &timer) {
+	timer.phase("Properties");
 	if (git.hasField("AreaProperties"))
 		loadProperties(git.getStruct("AreaProperties"));
 
+	timer.phase("Waypoints");
 	if (git.hasField("WaypointList"))
 		loadWaypoints(git.getList("WaypointList"));
 
+	timer.phase("Placeables");
 	if (git.hasField("Placeable List"))
 		loadPlaceables(git.getList("Placeable List"));
 
+	timer.phase("Doors");
 	if (git.hasField("Door List"))
 		loadDoors(git.getList("Door List"));
 
+	timer.phase("Creatures");
 	if (git.hasField("Creature List"))
 		loadCreatures(git.getList("Creature List"));
 
+	timer.phase("Sounds");
 	if (git.hasField("SoundList"))
 		loadSounds(git.getList("SoundList"));
 
+	timer.phase("Triggers");
 	if (git.hasField("TriggerList"))
 		loadTriggers(git.getList("TriggerList"));
 }
 
+void Area::preloadBlueprints(const Aurora::GFF3Struct &git, BlueprintLoader &blueprints) {
+	/* Queued in the order the objects are created, each object type
+	 * together with the 2DAs it looks up. */
+
+	if (git.hasField("AreaProperties"))
+		blueprints.preload2DA("ambientsound");
+
+	if (git.hasField("WaypointList"))
+		blueprints.preload(git.getList("WaypointList"), Aurora::kFileTypeUTW, MKTAG('U', 'T', 'W', ' '));
+
+	if (git.hasField("Placeable List")) {
+		blueprints.preload2DA("placeables");
+		blueprints.preload2DA("placeableobjsnds");
+
+		blueprints.preload(git.getList("Placeable List"), Aurora::kFileTypeUTP, MKTAG('U', 'T', 'P', ' '));
+	}
+
+	if (git.hasField("Door List")) {
+		blueprints.preload2DA("genericdoors");
+		blueprints.preload2DA("doortypes");
+
+		blueprints.preload(git.getList("Door List"), Aurora::kFileTypeUTD, MKTAG('U', 'T', 'D', ' '));
+	}
+
+	if (git.hasField("Creature List")) {
+		blueprints.preload2DA("appearance");
+		blueprints.preload2DA("heads");
+		blueprints.preload2DA("creaturespeed");
+		blueprints.preload2DA("portraits");
+
+		blueprints.preload(git.getList("Creature List"), Aurora::kFileTypeUTC, MKTAG('U', 'T', 'C', ' '));
+	}
+
+	if (git.hasField("SoundList"))
+		blueprints.preload(git.getList("SoundList"), Aurora::kFileTypeUTS, MKTAG('U', 'T', 'S', ' '));
+
+	if (git.hasField("TriggerList"))
+		blueprints.preload(git.getList("TriggerList"), Aurora::kFileTypeUTT, MKTAG('U', 'T', 'T', ' '));
+}
+
 void Area::loadProperties(const Aurora::GFF3Struct &props) {
 	// Ambient sound
 
@@ -422,6 +508,11 @@ void Area::loadProperties(const Aurora::GFF3Struct &props) {
 
 void Area::loadRooms() {
 	const Aurora::LYTFile::RoomArray &rooms = _lyt.getRooms();
+
+	// Parse all room models in the background, while we're creating the rooms in order
+	for (Aurora::LYTFile::RoomArray::const_iterator r = rooms.begin(); r != rooms.end(); ++r)
+		preloadModelObject(r->model);
+
 	for (Aurora::LYTFile::RoomArray::const_iterator r = rooms.begin(); r != rooms.end(); ++r) {
 		_rooms.emplace_back(std::make_unique<Room>(r->model, r->x, r->y, r->z));
 		_pathfinding->addRoom(_rooms.back().get());
@@ -479,7 +570,12 @@ void Area::loadTriggers(const Aurora::GFF3List &list) {
 		if (trigger) {
 			loadObject(std::make_unique<Trigger>(*trigger));
 
-			_triggers.push_back(static_cast<Trigger *>(_objects.back().get()));
+			Trigger *t = static_cast<Trigger *>(_objects.back().get());
+			_triggers.push_back(t);
+
+			float minX, minY, maxX, maxY;
+			if (t->getBounds(minX, minY, maxX, maxY))
+				_triggerIndex.update(t, minX, minY, maxX, maxY);
 		}
 	}
 }
@@ -631,8 +727,11 @@ void Area::toggleTriggers() {
 void Area::evaluateTriggers(float x, float y) {
 	Trigger *trigger = 0;
 
-	for (std::vector<Trigger *>::iterator it = _triggers.begin();
-			it != _triggers.end();
+	std::vector<Trigger *> triggers;
+	_triggerIndex.findAt(x, y, triggers);
+
+	for (std::vector<Trigger *>::iterator it = triggers.begin();
+			it != triggers.end();
 			++it) {
 		Trigger *t = *it;
 		if (t->contains(x, y)) {
@@ -673,16 +772,11 @@ void Area::notifyObjectMoved(Object &o) {
 	o.getPosition(x, y, _);
 	o.setRoom(_pathfinding->getRoomAt(x, y));
 
-	if (o.getType() == kObjectTypeCreature)
-		updatePerception((Creature &)o);
-}
-
-void Area::updatePerception(Creature &subject) {
-	for (auto &object : _creatures) {
-		if (object == &subject || object->isDead())
-			continue;
-
-		subject.updatePerception(*object);
+	// Creatures already in the grid keep it updated on their own whenever they move
+	if (o.getType() == kObjectTypeCreature) {
+		Creature &creature = static_cast<Creature &>(o);
+		if (!_creatureGrid.contains(&creature))
+			_creatureGrid.add(creature);
 	}
 }
 
@@ -846,12 +940,16 @@ void Area::removeObject(Object *object) {
 	}
 
 	std::vector<Creature *>::iterator crit = std::find(_creatures.begin(), _creatures.end(), object);
-	if (crit != _creatures.end())
+	if (crit != _creatures.end()) {
+		_creatureGrid.remove(**crit);
 		_creatures.erase(crit);
+	}
 
 	std::vector<Trigger *>::iterator tit = std::find(_triggers.begin(), _triggers.end(), object);
-	if (tit != _triggers.end())
+	if (tit != _triggers.end()) {
+		_triggerIndex.remove(*tit);
 		_triggers.erase(tit);
+	}
 
 	std::list<Situated *>::iterator soit = std::find(_situatedObjects.begin(), _situatedObjects.end(), object);
 	if (soit != _situatedObjects.end())
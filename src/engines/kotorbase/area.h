@@ -43,12 +43,17 @@
 #include "src/events/types.h"
 #include "src/events/notifyable.h"
 
+#include "src/engines/aurora/spatialindex.h"
+
 #include "src/engines/kotorbase/object.h"
 #include "src/engines/kotorbase/trigger.h"
+#include "src/engines/kotorbase/perceptiongrid.h"
 
 namespace Engines {
 
 class LocalPathfinding;
+class LoadTimer;
+class BlueprintLoader;
 
 namespace KotORBase {
 
@@ -228,6 +233,9 @@ private:
 
 	std::vector<Creature *> _creatures;
 
+	/** All creatures in the area, sorted by position for perception updates. */
+	PerceptionGrid _creatureGrid;
+
 	Object *_activeObject; ///< The currently active (highlighted) object.
 
 	bool _highlightAll; ///< Are we currently highlighting all objects?
@@ -239,6 +247,7 @@ private:
 	// Triggers
 
 	std::vector<Trigger *> _triggers;
+	SpatialIndex<Trigger> _triggerIndex; ///< All triggers, sorted by the region they cover.
 	bool _triggersVisible;
 	Trigger *_activeTrigger;
 
@@ -255,11 +264,18 @@ private:
 	void clear();
 	void load();
 
+	/** Load one of the area's files, either preloaded by the module or from the resource manager. */
+	Common::SeekableReadStream *loadFile(Aurora::FileType type);
+	/** Load one of the area's GFF files, either preloaded by the module or from the resource manager. */
+	Aurora::GFF3File *loadGFF(Aurora::FileType type, uint32_t id);
+
 	void loadLYT();
 	void loadVIS();
 
 	void loadARE(const Aurora::GFF3Struct &are);
-	void loadGIT(const Aurora::GFF3Struct &git);
+	void loadGIT(const Aurora::GFF3Struct &git, LoadTimer &timer);
+
+	void preloadBlueprints(const Aurora::GFF3Struct &git, BlueprintLoader &blueprints);
 
 	void loadCameraStyle(uint32_t id);
 
@@ -288,7 +304,6 @@ private:
 
 
 	void updateRoomsVisiblity();
-	void updatePerception(Creature &subject);
 
 
 	friend class Console;
@@ -50,6 +50,7 @@
 #include "src/engines/kotorbase/creature.h"
 #include "src/engines/kotorbase/item.h"
 #include "src/engines/kotorbase/creaturesearch.h"
+#include "src/engines/kotorbase/perceptiongrid.h"
 
 #include "src/engines/kotorbase/gui/chargeninfo.h"
 
@@ -92,6 +93,8 @@ Creature::Creature() :
 }
 
 Creature::~Creature() {
+	if (_perceptionGrid)
+		_perceptionGrid->remove(*this);
 }
 
 void Creature::init() {
@@ -206,6 +209,9 @@ void Creature::setPosition(float x, float y, float z) {
 
 	if (_model)
 		_model->setPosition(x, y, z);
+
+	if (_perceptionGrid)
+		_perceptionGrid->update(*this);
 }
 
 void Creature::setOrientation(float x, float y, float z, float angle) {
@@ -806,8 +812,6 @@ void Creature::getTooltipAnchor(float &x, float &y, float &z) const {
 }
 
 void Creature::updatePerception(Creature &object) {
-	const float kPerceptionRange = 16.0f;
-
 	float distance = glm::distance(
 		glm::make_vec3(_position),
 		glm::make_vec3(object._position));
@@ -828,6 +832,14 @@ void Creature::updatePerception(Creature &object) {
 	}
 }
 
+const std::set<Object *> &Creature::getSeenObjects() const {
+	return _seenObjects;
+}
+
+const std::set<Object *> &Creature::getHeardObjects() const {
+	return _heardObjects;
+}
+
 bool Creature::isInCombat() const {
 	return _inCombat;
 }
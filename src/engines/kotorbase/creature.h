@@ -48,6 +48,7 @@ namespace KotORBase {
 
 class CharacterGenerationInfo;
 class Item;
+class PerceptionGrid;
 struct CreatureSearchCriteria;
 
 class Creature : public Object {
@@ -129,7 +130,7 @@ public:
 	/** Get the camera height for this creature. */
 	float getCameraHeight() const;
 
-	/** Set the creature's position. */
+	/** Set the creature's position, updating what it and the creatures around it perceive. */
 	void setPosition(float x, float y, float z);
 	/** Set the creature's orientation. */
 	void setOrientation(float x, float y, float z, float angle);
@@ -188,8 +189,14 @@ public:
 
 	// Perception
 
+	/** The maximum distance at which creatures can see and hear each other. */
+	static constexpr float kPerceptionRange = 16.0f;
+
 	void updatePerception(Creature &object);
 
+	const std::set<Object *> &getSeenObjects() const;
+	const std::set<Object *> &getHeardObjects() const;
+
 	// Combat
 
 	bool isInCombat() const;
@@ -235,6 +242,9 @@ private:
 	std::set<Object *> _seenObjects;
 	std::set<Object *> _heardObjects;
 
+	/** The grid of the area the creature is in, notified whenever the creature moves. */
+	PerceptionGrid *_perceptionGrid { nullptr };
+
 	// Combat
 
 	bool _inCombat { false };
@@ -303,6 +313,8 @@ private:
 
 	int getWeaponAnimationNumber() const;
 	int computeWeaponDamage(const Item *weapon) const;
+
+	friend class PerceptionGrid;
 };
 
 } // End of namespace KotORBase
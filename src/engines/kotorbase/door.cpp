@@ -124,6 +124,12 @@ const Common::UString &Door::getCursor() const {
 	return cursor;
 }
 
+void Door::enter() {
+	// The party might walk through this door soon
+	if (!_linkedTo.empty())
+		_module->preloadModule(_linkedToModule);
+}
+
 void Door::highlight(bool enabled) {
 	if (_model)
 		_model->drawBound(enabled);
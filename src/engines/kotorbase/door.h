@@ -71,6 +71,9 @@ public:
 
 	const Common::UString &getCursor() const;
 
+	/** The cursor entered the door. */
+	void enter();
+
 	/** (Un)Highlight the door. */
 	void highlight(bool enabled);
 	/** The door was clicked. */
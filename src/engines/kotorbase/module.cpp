@@ -49,6 +49,7 @@
 #include "src/events/events.h"
 
 #include "src/engines/aurora/util.h"
+#include "src/engines/aurora/model.h"
 #include "src/engines/aurora/resources.h"
 #include "src/engines/aurora/console.h"
 #include "src/engines/aurora/flycamera.h"
@@ -153,12 +154,16 @@ void Module::loadModule(const Common::UString &module, const Common::UString &en
 		load();
 
 	} catch (Common::Exception &e) {
+		_preloader.clear();
 		_module.clear();
 
 		e.add("Failed loading module \"%s\"", module.c_str());
 		throw e;
 	}
 
+	// Whatever the area didn't take of the preloaded module isn't needed anymore
+	_preloader.clear();
+
 	initMinimap();
 
 	_newModule.clear();
@@ -355,6 +360,8 @@ void Module::unload(bool completeUnload) {
 	unloadArea();
 
 	if (completeUnload) {
+		_preloader.clear();
+
 		unloadTexturePack();
 
 		_globalNumbers.clear();
@@ -385,6 +392,10 @@ void Module::unloadResources() {
 		deindexResources(*r);
 
 	_resources.clear();
+
+	// The module can come with its own models and sounds
+	clearModelPrototypes();
+	SoundMan.clearPCMCache();
 }
 
 void Module::unloadIFO() {
@@ -798,6 +809,21 @@ void Module::moveParty(const Common::UString &module, const Common::UString &obj
 	load(module, object, type);
 }
 
+void Module::preloadModule(const Common::UString &module) {
+	if (module.empty() || module.equalsIgnoreCase(_module))
+		return;
+
+	const int budget = ConfigMan.getInt("preloadbudget", 64);
+	if (budget <= 0)
+		return;
+
+	_preloader.preload(module, ((size_t) budget) * 1024 * 1024);
+}
+
+Common::SeekableReadStream *Module::takePreloaded(const Common::UString &area, Aurora::FileType type) {
+	return _preloader.take(_module, area, type);
+}
+
 void Module::movedPartyLeader() {
 	float x, y, _;
 	_partyController.getPartyLeader()->getPosition(x, y, _);
@@ -49,6 +49,7 @@
 #include "src/engines/kotorbase/cameracontroller.h"
 #include "src/engines/kotorbase/creatureinfo.h"
 #include "src/engines/kotorbase/round.h"
+#include "src/engines/kotorbase/modulepreloader.h"
 
 #include "src/engines/kotorbase/gui/ingame.h"
 #include "src/engines/kotorbase/gui/dialog.h"
@@ -139,6 +140,11 @@ public:
 	/** Notify the module that the party leader was moved. */
 	void movedPartyLeader();
 
+	/** The party will probably move to this module soon, so start loading its entry area. */
+	void preloadModule(const Common::UString &module);
+	/** Take a file of this area that was loaded in the background, or return nullptr. */
+	Common::SeekableReadStream *takePreloaded(const Common::UString &area, Aurora::FileType type);
+
 	// Party management
 
 	/** Get the party leader. */
@@ -331,6 +337,8 @@ private:
 	Common::UString _module;    ///< The current module's name.
 	Common::UString _newModule; ///< The module we should change to.
 
+	ModulePreloader _preloader; ///< Loads the module we guess we'll change to next.
+
 	Common::UString _entryLocation; ///< The tag of the object in the start location for this module.
 	ObjectType      _entryLocationType; ///< The type(s) of the object in the start location for this module.
 
@@ -0,0 +1,224 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Loading the entry area of a KotOR module in the background.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/readstream.h"
+#include "src/common/debug.h"
+
+#include "src/aurora/resman.h"
+#include "src/aurora/archive.h"
+#include "src/aurora/gff3file.h"
+#include "src/aurora/lytfile.h"
+
+#include "src/engines/aurora/model.h"
+
+#include "src/engines/kotorbase/modulepreloader.h"
+
+namespace Engines {
+
+namespace KotORBase {
+
+typedef std::vector<std::unique_ptr<Aurora::Archive>> ArchiveList;
+
+/** Open all archives of a module, highest priority first.
+ *
+ *  These are the same archives Module::loadResources() indexes.
+ */
+static void openArchives(const Common::UString &module, ArchiveList &archives) {
+	static const char * const kSuffixes[] = { "_adx", "_a", "_dlg", "_s", "" };
+
+	for (size_t i = 0; i < ARRAYSIZE(kSuffixes); i++) {
+		const Common::UString erf = module + kSuffixes[i] + ".erf";
+		const Common::UString rim = module + kSuffixes[i] + ".rim";
+
+		if      (ResMan.hasArchive(erf))
+			archives.emplace_back(ResMan.openArchive(erf));
+		else if (ResMan.hasArchive(rim))
+			archives.emplace_back(ResMan.openArchive(rim));
+	}
+}
+
+/** Find the archive that will provide a file once the module is indexed. */
+static const Aurora::Archive *findArchive(const ArchiveList &archives, const Common::UString &name,
+                                          Aurora::FileType type, uint32_t &index) {
+
+	for (ArchiveList::const_iterator a = archives.begin(); a != archives.end(); ++a) {
+		index = (*a)->findResource(name, type);
+		if (index != 0xFFFFFFFF)
+			return a->get();
+	}
+
+	return 0;
+}
+
+static Common::SeekableReadStream *getFile(const ArchiveList &archives, const Common::UString &name,
+                                           Aurora::FileType type) {
+
+	uint32_t index;
+	const Aurora::Archive *archive = findArchive(archives, name, type, index);
+	if (!archive)
+		return 0;
+
+	return archive->getResource(index);
+}
+
+
+ModulePreloader::Preload::Preload(const Common::UString &m, size_t b) :
+	module(m), budget(b), cancelled(false) {
+
+}
+
+
+ModulePreloader::ModulePreloader() {
+}
+
+ModulePreloader::~ModulePreloader() {
+	clear();
+
+	if (_thread)
+		_thread->cancelJobs();
+}
+
+void ModulePreloader::preload(const Common::UString &module, size_t budget) {
+	if (module.empty() || (budget == 0))
+		return;
+
+	if (_preload && _preload->module.equalsIgnoreCase(module))
+		return;
+
+	clear();
+
+	if (!_thread)
+		_thread = std::make_unique<Common::ThreadPool>("ModulePreloader", 1);
+
+	std::shared_ptr<Preload> preload = std::make_shared<Preload>(module, budget);
+
+	preload->loaded = _thread->addJob([preload]() {
+		load(*preload);
+	});
+
+	_preload = preload;
+}
+
+void ModulePreloader::clear() {
+	if (!_preload)
+		return;
+
+	// The job keeps its own reference, and stops as soon as it notices
+	_preload->cancelled.store(true);
+	_preload.reset();
+}
+
+Common::SeekableReadStream *ModulePreloader::take(const Common::UString &module,
+		const Common::UString &area, Aurora::FileType type) {
+
+	if (!_preload || !_preload->module.equalsIgnoreCase(module))
+		return 0;
+
+	_preload->loaded.wait();
+
+	if (!_preload->area.equalsIgnoreCase(area))
+		return 0;
+
+	auto file = _preload->files.find(type);
+	if (file == _preload->files.end())
+		return 0;
+
+	Common::SeekableReadStream *stream = file->second.release();
+	_preload->files.erase(file);
+
+	return stream;
+}
+
+void ModulePreloader::load(Preload &preload) {
+	static const Aurora::FileType kAreaTypes[] = {
+		Aurora::kFileTypeLYT, Aurora::kFileTypeVIS, Aurora::kFileTypeGIT, Aurora::kFileTypeARE
+	};
+
+	try {
+		ArchiveList archives;
+		openArchives(preload.module, archives);
+
+		std::unique_ptr<Common::SeekableReadStream> ifo(getFile(archives, "module", Aurora::kFileTypeIFO));
+		if (!ifo || preload.cancelled.load())
+			return;
+
+		Aurora::GFF3File ifoGFF(ifo.release(), MKTAG('I', 'F', 'O', ' '));
+		const Common::UString area = ifoGFF.getTopLevel().getString("Mod_Entry_Area");
+
+		for (size_t i = 0; i < ARRAYSIZE(kAreaTypes); i++) {
+			if (preload.cancelled.load())
+				return;
+
+			// Files the module doesn't have itself are read normally when the area is loaded
+			Common::SeekableReadStream *file = getFile(archives, area, kAreaTypes[i]);
+			if (file)
+				preload.files[kAreaTypes[i]].reset(file);
+		}
+
+		preload.area = area;
+
+		auto lytFile = preload.files.find(Aurora::kFileTypeLYT);
+		if (lytFile == preload.files.end())
+			return;
+
+		Aurora::LYTFile lyt;
+		lyt.load(*lytFile->second);
+		lytFile->second->seek(0);
+
+		size_t size = 0;
+
+		const Aurora::LYTFile::RoomArray &rooms = lyt.getRooms();
+		for (Aurora::LYTFile::RoomArray::const_iterator r = rooms.begin(); r != rooms.end(); ++r) {
+			if (preload.cancelled.load() || (size >= preload.budget))
+				break;
+
+			/* Models in the module's own archives can only be loaded once the
+			 * module is indexed. Before that, we'd load the wrong model, or none. */
+			uint32_t index;
+			if (findArchive(archives, r->model, Aurora::kFileTypeMDL, index))
+				continue;
+
+			const size_t modelSize = getModelObjectSize(r->model);
+			if (modelSize == 0)
+				continue;
+
+			preloadModelObject(r->model);
+			size += modelSize;
+		}
+
+		debugC(Common::kDebugEngineLogic, 1, "Preloading area \"%s\" of module \"%s\" (%u KiB of models)",
+		       area.c_str(), preload.module.c_str(), (uint) (size / 1024));
+
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed preloading module \"%s\"", preload.module.c_str());
+	}
+}
+
+} // End of namespace KotORBase
+
+} // End of namespace Engines
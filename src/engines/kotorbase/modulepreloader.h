@@ -0,0 +1,114 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Loading the entry area of a KotOR module in the background.
+ */
+
+#ifndef ENGINES_KOTORBASE_MODULEPRELOADER_H
+#define ENGINES_KOTORBASE_MODULEPRELOADER_H
+
+#include <map>
+#include <memory>
+#include <atomic>
+#include <future>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/ustring.h"
+#include "src/common/threadpool.h"
+
+#include "src/aurora/types.h"
+
+namespace Common {
+	class SeekableReadStream;
+}
+
+namespace Engines {
+
+namespace KotORBase {
+
+/** Loads the entry area of a module the party will probably move to next.
+ *
+ *  When the player hovers over a door leading to another module, the
+ *  module preloader opens that module's archives on its own, without
+ *  indexing them yet, and reads the entry area's LYT, VIS, GIT and ARE.
+ *  It then queues the area's room models with the model loader, until
+ *  their estimated size reaches the budget.
+ *
+ *  If the party does move to that module, the area takes the preloaded
+ *  files instead of reading them again, and finds its room models ready.
+ *  If it doesn't, the files are simply dropped.
+ *
+ *  Only files that will win against everything else once the module is
+ *  indexed are taken from the module's archives. And only room models
+ *  that the module doesn't override are queued, so nothing is loaded
+ *  that the committed module would load differently.
+ */
+class ModulePreloader : boost::noncopyable {
+public:
+	ModulePreloader();
+	~ModulePreloader();
+
+	/** Start loading the entry area of this module, replacing the previous guess. */
+	void preload(const Common::UString &module, size_t budget);
+	/** Forget the current guess. */
+	void clear();
+
+	/** Take a preloaded file of the entry area of this module.
+	 *
+	 *  If the module is still being preloaded, this waits for it to finish.
+	 *  Every file can only be taken once.
+	 *
+	 *  @return The file, or nullptr if it wasn't preloaded.
+	 */
+	Common::SeekableReadStream *take(const Common::UString &module, const Common::UString &area,
+	                                 Aurora::FileType type);
+
+private:
+	/** A module being preloaded. */
+	struct Preload {
+		Common::UString module;
+		size_t budget;
+
+		std::atomic<bool> cancelled; ///< Has this guess been replaced?
+
+		Common::UString area; ///< The entry area of the module.
+		/** The preloaded files of the entry area. */
+		std::map<Aurora::FileType, std::unique_ptr<Common::SeekableReadStream>> files;
+
+		std::future<void> loaded; ///< Ready once the preloading finished.
+
+		Preload(const Common::UString &m, size_t b);
+	};
+
+	/** The thread doing the preloading. Created on first use. */
+	std::unique_ptr<Common::ThreadPool> _thread;
+	/** The current guess. */
+	std::shared_ptr<Preload> _preload;
+
+	static void load(Preload &preload);
+};
+
+} // End of namespace KotORBase
+
+} // End of namespace Engines
+
+#endif // ENGINES_KOTORBASE_MODULEPRELOADER_H
@@ -0,0 +1,113 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Keeping track of which creatures in KotOR games perceive each other.
+ */
+
+#include <cassert>
+
+#include <vector>
+#include <algorithm>
+
+#include "src/engines/kotorbase/perceptiongrid.h"
+#include "src/engines/kotorbase/creature.h"
+
+namespace Engines {
+
+namespace KotORBase {
+
+PerceptionGrid::PerceptionGrid() : _grid(Creature::kPerceptionRange) {
+}
+
+PerceptionGrid::~PerceptionGrid() {
+	clear();
+}
+
+bool PerceptionGrid::contains(Creature *creature) const {
+	return _grid.contains(creature);
+}
+
+void PerceptionGrid::add(Creature &creature) {
+	assert(!creature._perceptionGrid || (creature._perceptionGrid == this));
+
+	creature._perceptionGrid = this;
+	update(creature);
+}
+
+void PerceptionGrid::remove(Creature &creature) {
+	if (creature._perceptionGrid != this)
+		return;
+
+	_grid.remove(&creature);
+	creature._perceptionGrid = nullptr;
+}
+
+void PerceptionGrid::clear() {
+	std::vector<Creature *> creatures;
+	_grid.getObjects(creatures);
+
+	for (auto &creature : creatures)
+		creature->_perceptionGrid = nullptr;
+
+	_grid.clear();
+}
+
+void PerceptionGrid::update(Creature &creature) {
+	float x, y, _;
+	creature.getPosition(x, y, _);
+
+	_grid.update(&creature, x, y);
+	updatePerception(creature);
+}
+
+void PerceptionGrid::updatePerception(Creature &subject) {
+	float x, y, z;
+	subject.getPosition(x, y, z);
+
+	/* Only look at the creatures that are within perception range, and
+	 * the ones perceived until now, which might have just left the range. */
+
+	std::vector<Creature *> creatures;
+	_grid.findNear(x, y, Creature::kPerceptionRange, creatures);
+
+	for (auto &object : subject.getSeenObjects())
+		creatures.push_back(static_cast<Creature *>(object));
+	for (auto &object : subject.getHeardObjects())
+		creatures.push_back(static_cast<Creature *>(object));
+
+	std::sort(creatures.begin(), creatures.end());
+	creatures.erase(std::unique(creatures.begin(), creatures.end()), creatures.end());
+
+	for (auto &creature : creatures) {
+		// Ignore creatures that have since left the area
+		if ((creature == &subject) || !_grid.contains(creature))
+			continue;
+
+		if (creature->isDead())
+			continue;
+
+		subject.updatePerception(*creature);
+	}
+}
+
+} // End of namespace KotORBase
+
+} // End of namespace Engines
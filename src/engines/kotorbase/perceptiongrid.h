@@ -0,0 +1,72 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Keeping track of which creatures in KotOR games perceive each other.
+ */
+
+#ifndef ENGINES_KOTORBASE_PERCEPTIONGRID_H
+#define ENGINES_KOTORBASE_PERCEPTIONGRID_H
+
+#include <boost/noncopyable.hpp>
+
+#include "src/engines/aurora/proximitygrid.h"
+
+namespace Engines {
+
+namespace KotORBase {
+
+class Creature;
+
+/** All creatures of an area, sorted by position for perception updates.
+ *
+ *  A creature in the grid reports every change of its position back to
+ *  the grid, so that what it and the creatures around it perceive stays
+ *  current no matter how the creature was moved.
+ */
+class PerceptionGrid : boost::noncopyable {
+public:
+	PerceptionGrid();
+	~PerceptionGrid();
+
+	/** Is this creature in the grid? */
+	bool contains(Creature *creature) const;
+
+	/** Add a creature to the grid and update what it perceives. */
+	void add(Creature &creature);
+	/** Remove a creature from the grid. */
+	void remove(Creature &creature);
+	/** Remove all creatures from the grid. */
+	void clear();
+
+	/** The creature has moved. Update its cell and what it perceives. */
+	void update(Creature &creature);
+
+private:
+	ProximityGrid<Creature> _grid;
+
+	void updatePerception(Creature &subject);
+};
+
+} // End of namespace KotORBase
+
+} // End of namespace Engines
+
+#endif // ENGINES_KOTORBASE_PERCEPTIONGRID_H
@@ -54,6 +54,8 @@ src_engines_kotorbase_libkotorbase_la_SOURCES += \
     src/engines/kotorbase/console.h \
     src/engines/kotorbase/actionqueue.h \
     src/engines/kotorbase/round.h \
+    src/engines/kotorbase/modulepreloader.h \
+    src/engines/kotorbase/perceptiongrid.h \
     $(EMPTY)
 
 src_engines_kotorbase_libkotorbase_la_SOURCES += \
@@ -86,6 +88,8 @@ src_engines_kotorbase_libkotorbase_la_SOURCES += \
     src/engines/kotorbase/console.cpp \
     src/engines/kotorbase/actionqueue.cpp \
     src/engines/kotorbase/round.cpp \
+    src/engines/kotorbase/modulepreloader.cpp \
+    src/engines/kotorbase/perceptiongrid.cpp \
     $(EMPTY)
 
 include src/engines/kotorbase/script/rules.mk
@@ -23,10 +23,12 @@
  */
 
 #include <cassert>
+#include <set>
 
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/maths.h"
+#include "src/common/debug.h"
 
 #include "src/aurora/gff3file.h"
 #include "src/aurora/2dafile.h"
@@ -42,6 +44,8 @@
 #include "src/engines/aurora/util.h"
 #include "src/engines/aurora/model.h"
 #include "src/engines/aurora/localpathfinding.h"
+#include "src/engines/aurora/blueprintloader.h"
+#include "src/engines/aurora/loadtimer.h"
 
 #include "src/engines/nwn/area.h"
 #include "src/engines/nwn/module.h"
@@ -86,11 +90,17 @@ Area::~Area() {
 }
 
 void Area::load() {
+	LoadTimer timer("area \"" + _resRef + "\"");
+
+	timer.phase("ARE");
 	Aurora::GFF3File are(_resRef, Aurora::kFileTypeARE, MKTAG('A', 'R', 'E', ' '), true);
 	loadARE(are.getTopLevel());
 
+	timer.phase("GIT");
 	Aurora::GFF3File git(_resRef, Aurora::kFileTypeGIT, MKTAG('G', 'I', 'T', ' '), true);
-	loadGIT(git.getTopLevel());
+	loadGIT(git.getTopLevel(), timer);
+
+	timer.finish();
 }
 
 void Area::clear() {
@@ -315,28 +325,71 @@ void Area::loadARE(const Aurora::GFF3Struct &are) {
 	readScripts(are);
 }
 
-void Area::loadGIT(const Aurora::GFF3Struct &git) {
+void Area::loadGIT(const Aurora::GFF3Struct &git, LoadTimer &timer) {
+	// Parse the object blueprints in the background, while we're creating the objects in order
+	BlueprintLoader blueprints;
+	preloadBlueprints(git, blueprints);
+
 	// Generic properties
+	timer.phase("Properties");
 	if (git.hasField("AreaProperties"))
 		loadProperties(git.getStruct("AreaProperties"));
 
 	// Waypoints
+	timer.phase("Waypoints");
 	if (git.hasField("WaypointList"))
 		loadWaypoints(git.getList("WaypointList"));
 
 	// Placeables
+	timer.phase("Placeables");
 	if (git.hasField("Placeable List"))
 		loadPlaceables(git.getList("Placeable List"));
 
 	// Doors
+	timer.phase("Doors");
 	if (git.hasField("Door List"))
 		loadDoors(git.getList("Door List"));
 
 	// Creatures
+	timer.phase("Creatures");
 	if (git.hasField("Creature List"))
 		loadCreatures(git.getList("Creature List"));
 }
 
+void Area::preloadBlueprints(const Aurora::GFF3Struct &git, BlueprintLoader &blueprints) {
+	/* Queued in the order the objects are created, each object type
+	 * together with the 2DAs it looks up. */
+
+	if (git.hasField("AreaProperties"))
+		blueprints.preload2DA("ambientsound");
+
+	if (git.hasField("WaypointList"))
+		blueprints.preload(git.getList("WaypointList"), Aurora::kFileTypeUTW, MKTAG('U', 'T', 'W', ' '), true);
+
+	if (git.hasField("Placeable List")) {
+		blueprints.preload2DA("placeables");
+		blueprints.preload2DA("placeableobjsnds");
+
+		blueprints.preload(git.getList("Placeable List"), Aurora::kFileTypeUTP, MKTAG('U', 'T', 'P', ' '), true);
+	}
+
+	if (git.hasField("Door List")) {
+		blueprints.preload2DA("genericdoors");
+		blueprints.preload2DA("doortypes");
+
+		blueprints.preload(git.getList("Door List"), Aurora::kFileTypeUTD, MKTAG('U', 'T', 'D', ' '), true);
+	}
+
+	if (git.hasField("Creature List")) {
+		blueprints.preload2DA("appearance");
+		blueprints.preload2DA("racialtypes");
+		blueprints.preload2DA("classes");
+		blueprints.preload2DA("portraits");
+
+		blueprints.preload(git.getList("Creature List"), Aurora::kFileTypeUTC, MKTAG('U', 'T', 'C', ' '), true);
+	}
+}
+
 void Area::loadProperties(const Aurora::GFF3Struct &props) {
 	// Ambient sound
 
@@ -407,8 +460,19 @@ void Area::loadTile(const Aurora::GFF3Struct &t, Tile &tile) {
 }
 
 void Area::loadModels() {
-	loadTileModels();
+	LoadTimer timer("models of area \"" + _resRef + "\"");
+
+	timer.phase("Tileset");
+	if (!_tileset)
+		loadTileset();
 
+	timer.phase("Queueing models");
+	preloadModels();
+
+	timer.phase("Tiles");
+	loadTiles();
+
+	timer.phase("Objects");
 	for (auto &object : _objects) {
 		object->loadModel();
 
@@ -419,6 +483,8 @@ void Area::loadModels() {
 				_objectMap.insert(std::make_pair(*id, object.get()));
 		}
 	}
+
+	timer.finish();
 }
 
 void Area::unloadModels() {
@@ -427,17 +493,63 @@ void Area::unloadModels() {
 	for (auto &object : _objects)
 		object->unloadModel();
 
-	unloadTileModels();
+	unloadTiles();
+	unloadTileset();
 }
 
-void Area::loadTileModels() {
-	loadTileset();
-	loadTiles();
+size_t Area::preload(size_t budget) {
+	if (_visible)
+		return 0;
+
+	// We need the tileset to know the tile models. It's kept for show()
+	if (!_tileset) {
+		try {
+			loadTileset();
+		} catch (...) {
+			Common::exceptionDispatcherWarning("Failed preloading area \"%s\"", _resRef.c_str());
+			return 0;
+		}
+	}
+
+	size_t size = 0;
+
+	std::set<Common::UString, Common::UString::iless> tileModels;
+	for (uint32_t i = 0; (i < _tiles.size()) && (size < budget); i++) {
+		const Common::UString &model = _tileset->getTile(_tiles[i].tileID).model;
+		if (!tileModels.insert(model).second)
+			continue;
+
+		preloadModelObject(model);
+		size += getModelObjectSize(model);
+	}
+
+	for (auto &object : _objects) {
+		if (size >= budget)
+			break;
+
+		size += object->preloadModel();
+	}
+
+	debugC(Common::kDebugEngineLogic, 1, "Preloading models of area \"%s\" (%u KiB)",
+	       _resRef.c_str(), (uint) (size / 1024));
+
+	return size;
 }
 
-void Area::unloadTileModels() {
-	unloadTiles();
-	unloadTileset();
+void Area::unpreload() {
+	if (!_visible)
+		unloadTileset();
+}
+
+void Area::preloadModels() {
+	/* Queue all models of this area to be parsed in the background,
+	 * while we're creating the tiles and objects in order. */
+
+	for (uint32_t i = 0; i < _tiles.size(); i++)
+		preloadModelObject(_tileset->getTile(_tiles[i].tileID).model);
+
+	for (auto &object : _objects)
+		object->preloadModel();
 }
 
 void Area::loadTileset() {
@@ -49,6 +49,8 @@
 namespace Engines {
 
 class LocalPathfinding;
+class LoadTimer;
+class BlueprintLoader;
 
 namespace NWN {
 
@@ -85,6 +87,16 @@ public:
 	void show(); ///< Show the area.
 	void hide(); ///< Hide the area.
 
+	/** Start loading the area's models in the background, before the area is shown.
+	 *
+	 *  Models are queued until their estimated size reaches the budget.
+	 *
+	 *  @return The estimated size of the models that were queued.
+	 */
+	size_t preload(size_t budget);
+	/** Free what preload() kept around, when the area isn't shown after all. */
+	void unpreload();
+
 	// Music/Sound
 
 	uint32_t getMusicDayTrack   () const; ///< Return the music track ID playing by day.
@@ -215,7 +227,9 @@ private:
 	void load();
 
 	void loadARE(const Aurora::GFF3Struct &are);
-	void loadGIT(const Aurora::GFF3Struct &git);
+	void loadGIT(const Aurora::GFF3Struct &git, LoadTimer &timer);
+
+	void preloadBlueprints(const Aurora::GFF3Struct &git, BlueprintLoader &blueprints);
 
 	void loadProperties(const Aurora::GFF3Struct &props);
 
@@ -233,8 +247,7 @@ private:
 	void loadModels();
 	void unloadModels();
 
-	void loadTileModels();
-	void unloadTileModels();
+	void preloadModels();
 
 	void loadTileset();
 	void unloadTileset();
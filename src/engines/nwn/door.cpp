@@ -158,6 +158,10 @@ void Door::enter() {
 		CursorMan.set("trans", "up");
 	else
 		CursorMan.set("door", "up");
+
+	// The PC might walk through this door soon
+	if (_link && (_link->getArea() != getArea()))
+		_module->preloadArea(_link->getArea());
 }
 
 void Door::leave() {
@@ -223,6 +223,7 @@ void DialogBox::setPosition(float x, float y, float z) {
 			replyLine.line->setPosition(replyLineX, replyY, portraitZ);
 	}
 
+	calculateDistance();
 	resort();
 
 	GfxMan.unlockFrame();
@@ -223,7 +223,7 @@ void Portrait::setPortrait(const Common::UString &name) {
 	_texture.clear();
 	while (_texture.empty() && (curSize < kSizeMAX)) {
 		try {
-			_texture = TextureMan.get(name + kSuffix[curSize]);
+			_texture = TextureMan.getAsync(name + kSuffix[curSize]);
 		} catch (...) {
 			_texture.clear();
 		}
@@ -233,7 +233,7 @@ void Portrait::setPortrait(const Common::UString &name) {
 
 	if (_texture.empty()) {
 		try {
-			_texture = TextureMan.get(name);
+			_texture = TextureMan.getAsync(name);
 		} catch (...) {
 			_texture.clear();
 		}
@@ -36,6 +36,18 @@ namespace NWN {
 Graphics::Aurora::Model *NWNModelLoader::load(const Common::UString &resref,
 		Graphics::Aurora::ModelType type, const Common::UString &texture) {
 
+	return loadShared(resref, type, texture);
+}
+
+void NWNModelLoader::preload(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	preloadShared(resref, type, texture);
+}
+
+Graphics::Aurora::Model *NWNModelLoader::loadPrototype(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
 	/* TODO: Modules and HAKs can overwrite model files, so we actually need
 	 *       to clean the cache after every module unload. */
 
@@ -37,6 +37,12 @@ class NWNModelLoader : public ModelLoader {
 public:
 	Graphics::Aurora::Model *load(const Common::UString &resref,
 			Graphics::Aurora::ModelType type, const Common::UString &texture);
+	void preload(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
+
+protected:
+	Graphics::Aurora::Model *loadPrototype(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
 
 private:
 	Graphics::Aurora::ModelCache _modelCache;
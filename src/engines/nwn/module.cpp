@@ -42,9 +42,13 @@
 #include "src/graphics/camera.h"
 
 #include "src/graphics/aurora/textureman.h"
+#include "src/graphics/aurora/pltfile.h"
 #include "src/graphics/aurora/model.h"
 
+#include "src/sound/sound.h"
+
 #include "src/engines/aurora/util.h"
+#include "src/engines/aurora/model.h"
 #include "src/engines/aurora/tokenman.h"
 #include "src/engines/aurora/console.h"
 #include "src/engines/aurora/flycamera.h"
@@ -428,6 +432,11 @@ void Module::enterArea() {
 
 	_currentArea = area->second.get();
 
+	// If we guessed wrong, free what we preloaded for the other area
+	if (_preloadArea && (_preloadArea != _currentArea))
+		_preloadArea->unpreload();
+	_preloadArea = nullptr;
+
 	_currentArea->show();
 	_pc->show();
 
@@ -599,10 +608,20 @@ void Module::loadHAKs() {
 
 	for (size_t i = 0; i < haks.size(); i++)
 		indexMandatoryArchive(haks[i] + ".hak", 1002 + i, _resHAKs);
+
+	// HAKs can come with their own sounds, replacing ones we might have already played
+	SoundMan.clearPCMCache();
 }
 
 void Module::unloadHAKs() {
 	deindexResources(_resHAKs);
+
+	// HAKs can come with their own PLT layer palettes
+	Graphics::Aurora::PLTFile::clearCache();
+	// And their own models
+	clearModelPrototypes();
+	// And their own sounds
+	SoundMan.clearPCMCache();
 }
 
 static const char * const texturePacks[4][4] = {
@@ -677,6 +696,7 @@ void Module::unloadAreas() {
 	_newArea.clear();
 
 	_currentArea = nullptr;
+	_preloadArea = nullptr;
 }
 
 void Module::showMenu() {
@@ -756,6 +776,22 @@ void Module::movedPC() {
 	}
 }
 
+void Module::preloadArea(Area *area) {
+	if (!area || (area == _currentArea) || (area == _preloadArea))
+		return;
+
+	const int budget = ConfigMan.getInt("preloadbudget", 64);
+	if (budget <= 0)
+		return;
+
+	// Only keep one guess around
+	if (_preloadArea)
+		_preloadArea->unpreload();
+
+	_preloadArea = area;
+	_preloadArea->preload(((size_t) budget) * 1024 * 1024);
+}
+
 const Aurora::IFOFile &Module::getIFO() const {
 	return _ifo;
 }
@@ -131,6 +131,9 @@ public:
 	void movePC(Area *area, float x, float y, float z);
 	/** Notify the module that the PC was moved. */
 	void movedPC();
+
+	/** The PC will probably move to this area soon, so start loading its models. */
+	void preloadArea(Area *area);
 	// '---
 
 	// .--- Static utility methods
@@ -207,6 +210,7 @@ private:
 	AreaMap _areas;                 ///< The areas in the current module.
 	Common::UString _newArea;       ///< The new area to enter.
 	Area *_currentArea { nullptr }; ///< The current area.
+	Area *_preloadArea { nullptr }; ///< The area we guess the PC will enter next.
 
 	Common::UString _newModule; ///< The module we should change to.
 
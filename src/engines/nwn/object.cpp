@@ -74,6 +74,10 @@ ObjectType Object::getType() const {
 	return _type;
 }
 
+size_t Object::preloadModel() {
+	return 0;
+}
+
 void Object::loadModel() {
 }
 
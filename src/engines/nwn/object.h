@@ -66,8 +66,10 @@ public:
 
 	// Basic visuals
 
-	virtual void loadModel();   ///< Load the object's model(s).
-	virtual void unloadModel(); ///< Unload the object's model(s).
+	/** Start loading the object's model(s) in the background, and return their estimated size. */
+	virtual size_t preloadModel();
+	virtual void loadModel();    ///< Load the object's model(s).
+	virtual void unloadModel();  ///< Unload the object's model(s).
 
 	virtual void show(); ///< Show the object's model(s).
 	virtual void hide(); ///< Hide the object's model(s).
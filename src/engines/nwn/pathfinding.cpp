@@ -173,6 +173,8 @@ void Pathfinding::finalize() {
 		}
 	}
 
+	flattenAABBTrees();
+
 	_loaded = true;
 }
 
@@ -50,6 +50,14 @@ Situated::Situated(ObjectType type) : Object(type), _appearanceID(Aurora::kField
 Situated::~Situated() {
 }
 
+size_t Situated::preloadModel() {
+	if (_model)
+		return 0;
+
+	preloadModelObject(_modelName);
+	return getModelObjectSize(_modelName);
+}
+
 void Situated::loadModel() {
 	if (_model)
 		return;
@@ -43,8 +43,9 @@ public:
 
 	// Basic visuals
 
-	void loadModel();   ///< Load the situated object's model.
-	void unloadModel(); ///< Unload the situated object's model.
+	size_t preloadModel(); ///< Start loading the situated object's model in the background.
+	void loadModel();    ///< Load the situated object's model.
+	void unloadModel();  ///< Unload the situated object's model.
 
 	void show(); ///< Show the situated object's model.
 	void hide(); ///< Hide the situated object's model.
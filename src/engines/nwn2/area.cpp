@@ -479,6 +479,11 @@ void Area::unloadModels() {
 }
 
 void Area::loadTileModels() {
+	// Parse all tile models in the background, while we're creating the tiles in order
+	for (std::vector<Tile>::const_iterator t = _tiles.begin(); t != _tiles.end(); ++t)
+		if (!t->modelName.empty())
+			preloadModelObject(t->modelName);
+
 	for (std::vector<Tile>::iterator t = _tiles.begin(); t != _tiles.end(); ++t) {
 		if (t->modelName.empty())
 			continue;
@@ -34,6 +34,18 @@ namespace Engines {
 namespace NWN2 {
 
 Graphics::Aurora::Model *NWN2ModelLoader::load(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	return loadShared(resref, type, texture);
+}
+
+void NWN2ModelLoader::preload(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	preloadShared(resref, type, texture);
+}
+
+Graphics::Aurora::Model *NWN2ModelLoader::loadPrototype(const Common::UString &resref,
 		Graphics::Aurora::ModelType UNUSED(type), const Common::UString &UNUSED(texture)) {
 
 	return new Graphics::Aurora::Model_NWN2(resref);
@@ -38,9 +38,12 @@
 
 #include "src/graphics/camera.h"
 
+#include "src/sound/sound.h"
+
 #include "src/events/events.h"
 
 #include "src/engines/aurora/util.h"
+#include "src/engines/aurora/model.h"
 #include "src/engines/aurora/resources.h"
 #include "src/engines/aurora/console.h"
 
@@ -410,6 +413,9 @@ void Module::loadHAKs() {
 
 	for (size_t i = 0; i < haks.size(); i++)
 		indexMandatoryArchive(haks[i] + ".hak", 1002 + i, &_resHAKs[i]);
+
+	// HAKs can come with their own sounds, replacing ones we might have already played
+	SoundMan.clearPCMCache();
 }
 
 void Module::unloadHAKs() {
@@ -418,6 +424,10 @@ void Module::unloadHAKs() {
 		deindexResources(*hak);
 
 	_resHAKs.clear();
+
+	// HAKs can come with their own models and sounds
+	clearModelPrototypes();
+	SoundMan.clearPCMCache();
 }
 
 void Module::loadFactions() {
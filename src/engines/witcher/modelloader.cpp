@@ -35,6 +35,18 @@ namespace Engines {
 namespace Witcher {
 
 Graphics::Aurora::Model *WitcherModelLoader::load(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	return loadShared(resref, type, texture);
+}
+
+void WitcherModelLoader::preload(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	preloadShared(resref, type, texture);
+}
+
+Graphics::Aurora::Model *WitcherModelLoader::loadPrototype(const Common::UString &resref,
 		Graphics::Aurora::ModelType UNUSED(type), const Common::UString &UNUSED(texture)) {
 
 	return new Graphics::Aurora::Model_Witcher(resref);
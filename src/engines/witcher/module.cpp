@@ -38,9 +38,12 @@
 
 #include "src/graphics/camera.h"
 
+#include "src/sound/sound.h"
+
 #include "src/events/events.h"
 
 #include "src/engines/aurora/util.h"
+#include "src/engines/aurora/model.h"
 #include "src/engines/aurora/resources.h"
 #include "src/engines/aurora/console.h"
 
@@ -362,6 +365,10 @@ void Module::unloadModule() {
 
 	deindexResources(_resModule);
 
+	// The module can come with its own models and sounds
+	clearModelPrototypes();
+	SoundMan.clearPCMCache();
+
 	_module.clear();
 	_newModule.clear();
 
@@ -45,6 +45,18 @@ AnimationChannel::AnimationChannel(Model *model) :
 		_animationLoopTime(0.0f) {
 }
 
+AnimationChannel::AnimationChannel(Model *model, const AnimationChannel &prototype) :
+		_model(model),
+		_currentAnimation(0),
+		_nextAnimation(0),
+		_animationSpeed(1.0f),
+		_animationLength(1.0f),
+		_animationTime(0.0f),
+		_animationLoopLength(1.0f),
+		_animationLoopTime(0.0f),
+		_defaultAnimations(prototype._defaultAnimations) {
+}
+
 void AnimationChannel::playAnimation(const Common::UString &anim, bool restart, float length, float speed) {
 	Animation *animation = _model->getAnimation(anim);
 	if (!animation || speed <= 0.0f)
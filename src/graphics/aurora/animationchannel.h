@@ -41,6 +41,8 @@ class Animation;
 class AnimationChannel {
 public:
 	AnimationChannel(Model *model);
+	/** Create a channel for an instance of the model that owns the prototype channel. */
+	AnimationChannel(Model *model, const AnimationChannel &prototype);
 
 	/** Play a named animation.
 	 *
@@ -24,6 +24,7 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 
 #include "src/common/fallthrough.h"
 START_IGNORE_IMPLICIT_FALLTHROUGH
@@ -62,6 +63,7 @@ Model::Model(ModelType type) :
 		Renderable((RenderableType) type),
 		_type(type),
 		_superModel(0),
+		_prototype(0),
 		_currentState(0),
 		_hasSkinNodes(false),
 		_positionRelative(false),
@@ -89,6 +91,75 @@ Model::Model(ModelType type) :
 	_boundRenderable.setMesh(MeshMan.getMesh("defaultWireBox"));
 }
 
+Model::Model(const std::shared_ptr<const Model> &prototype) :
+		Renderable((RenderableType) prototype->_type),
+		_type(prototype->_type),
+		_fileName(prototype->_fileName),
+		_name(prototype->_name),
+		_superModelName(prototype->_superModelName),
+		_superModel(prototype->_superModel),
+		_prototype(prototype),
+		_currentState(0),
+		_stateNames(prototype->_stateNames),
+		_animationMap(prototype->_animationMap),
+		_animationScale(prototype->_animationScale),
+		_absolutePosition(prototype->_absolutePosition),
+		_boundBox(prototype->_boundBox),
+		_absoluteBoundBox(prototype->_absoluteBoundBox),
+		_hasSkinNodes(prototype->_hasSkinNodes),
+		_positionRelative(prototype->_positionRelative),
+		_drawBound(false),
+		_drawSkeleton(false),
+		_drawSkeletonInvisible(false) {
+
+	std::memcpy(_scale      , prototype->_scale      , sizeof(_scale));
+	std::memcpy(_orientation, prototype->_orientation, sizeof(_orientation));
+	std::memcpy(_position   , prototype->_position   , sizeof(_position));
+	std::memcpy(_center     , prototype->_center     , sizeof(_center));
+
+	// Copy the node hierarchy of all states
+	ModelNode::InstanceNodeMap nodeMap;
+
+	for (StateList::const_iterator s = prototype->_stateList.begin(); s != prototype->_stateList.end(); ++s) {
+		State *state = new State;
+
+		state->name = (*s)->name;
+
+		for (NodeList::const_iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n) {
+			ModelNode *node = (*n)->createInstance(*this);
+
+			nodeMap.insert(std::make_pair(*n, node));
+
+			state->nodeList.push_back(node);
+			state->nodeMap.insert(std::make_pair(node->getName(), node));
+		}
+
+		for (NodeList::const_iterator n = (*s)->rootNodes.begin(); n != (*s)->rootNodes.end(); ++n)
+			state->rootNodes.push_back(nodeMap[*n]);
+
+		_stateList.push_back(state);
+		_stateMap.insert(std::make_pair(state->name, state));
+
+		if (*s == prototype->_currentState)
+			_currentState = state;
+	}
+
+	for (ModelNode::InstanceNodeMap::iterator n = nodeMap.begin(); n != nodeMap.end(); ++n)
+		n->second->remapNodes(nodeMap);
+
+	// Animations are shared, but the channels playing them are not
+	for (AnimationChannelMap::const_iterator c = prototype->_animationChannels.begin();
+	     c != prototype->_animationChannels.end(); ++c)
+		_animationChannels.insert(std::make_pair(c->first, new AnimationChannel(this, *c->second)));
+
+	_boundRenderable.setSurface(SurfaceMan.getSurface("defaultSurface"));
+	_boundRenderable.setMaterial(MaterialMan.getMaterial("defaultWhite"));
+	_boundRenderable.setMesh(MeshMan.getMesh("defaultWireBox"));
+
+	AnimationChannelMap::iterator c = _animationChannels.begin();
+	c->second->playDefaultAnimation();
+}
+
 Model::~Model() {
 	hide();
 
@@ -97,8 +168,10 @@ Model::~Model() {
 		delete c->second;
 	}
 
-	for (AnimationMap::iterator a = _animationMap.begin(); a != _animationMap.end(); ++a)
-		delete a->second;
+	// Instances don't own their animations
+	if (!_prototype)
+		for (AnimationMap::iterator a = _animationMap.begin(); a != _animationMap.end(); ++a)
+			delete a->second;
 
 	for (StateList::iterator s = _stateList.begin(); s != _stateList.end(); ++s) {
 		for (NodeList::iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n)
@@ -108,6 +181,14 @@ Model::~Model() {
 	}
 }
 
+Model *Model::createInstance(const std::shared_ptr<const Model> &prototype) {
+	return prototype->newInstance(prototype);
+}
+
+Model *Model::newInstance(const std::shared_ptr<const Model> &prototype) const {
+	return new Model(prototype);
+}
+
 void Model::show() {
 	Renderable::show();
 	GfxMan.registerAnimatedModel(this);
@@ -28,6 +28,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <memory>
 
 #include "external/glm/mat4x4.hpp"
 
@@ -65,6 +66,15 @@ public:
 	Model(ModelType type = kModelTypeObject);
 	~Model();
 
+	/** Create a new instance of a prototype model.
+	 *
+	 *  The instance has its own node hierarchy, with its own transformations
+	 *  and animation state. The mesh data, the animations and the supermodel
+	 *  are shared with the prototype, which the instance keeps alive.
+	 *  The instance is of the same class as the prototype.
+	 */
+	static Model *createInstance(const std::shared_ptr<const Model> &prototype);
+
 	// Basic visuals
 
 	void show();
@@ -237,6 +247,8 @@ protected:
 	Common::UString _superModelName; ///< Name of the super model.
 	Model *_superModel; ///< The actual super model.
 
+	std::shared_ptr<const Model> _prototype; ///< The model this instance shares its data with.
+
 	StateList _stateList;   ///< All states within this model.
 	StateMap  _stateMap;    ///< All states within this model, index by name.
 	State   *_currentState; ///< The current state.
@@ -277,6 +289,16 @@ protected:
 	Animation *getAnimation(const Common::UString &anim);
 
 
+	/** Create an instance of a prototype model. */
+	Model(const std::shared_ptr<const Model> &prototype);
+
+	/** Create an instance of this model, which is the prototype.
+	 *
+	 *  Models with an interface of their own override this, so
+	 *  that their instances keep the same class.
+	 */
+	virtual Model *newInstance(const std::shared_ptr<const Model> &prototype) const;
+
 	/** Finalize the loading procedure. */
 	void finalize();
 
@@ -274,9 +274,17 @@ void Model_DragonAge::addState(ParserContext &ctx) {
 ModelNode_DragonAge::ModelNode_DragonAge(Model &model) : ModelNode(model) {
 }
 
+ModelNode_DragonAge::ModelNode_DragonAge(Model &model, const ModelNode_DragonAge &prototype) :
+	ModelNode(model, prototype) {
+}
+
 ModelNode_DragonAge::~ModelNode_DragonAge() {
 }
 
+ModelNode *ModelNode_DragonAge::createInstance(Model &model) const {
+	return new ModelNode_DragonAge(model, *this);
+}
+
 // .--- Vertex value reading helpers
 void ModelNode_DragonAge::read2Float32(Common::SeekableSubReadStreamEndian &stream, MeshDeclType type, float *&f) {
 	switch (type) {
@@ -983,7 +991,7 @@ void ModelNode_DragonAge::readMesh(Model_DragonAge::ParserContext &ctx, const GF
 
 	_mesh = new Mesh();
 	_render =_mesh->render = true;
-	_mesh->data = new MeshData();
+	_mesh->data = std::make_shared<MeshData>();
 	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
 	{
@@ -95,6 +95,8 @@ public:
 	ModelNode_DragonAge(Model &model);
 	~ModelNode_DragonAge();
 
+	ModelNode *createInstance(Model &model) const;
+
 	void load(Model_DragonAge::ParserContext &ctx, const ::Aurora::GFF4Struct &nodeGFF);
 
 private:
@@ -166,6 +168,8 @@ private:
 		std::map<Common::UString, Common::UString> textures;
 	};
 
+	ModelNode_DragonAge(Model &model, const ModelNode_DragonAge &prototype);
+
 	void readTransformation(const ::Aurora::GFF4Struct &nodeGFF);
 	void readChildren(Model_DragonAge::ParserContext &ctx, const ::Aurora::GFF4Struct &nodeGFF);
 
@@ -658,7 +658,7 @@ void ModelNode_Jade::createMesh(Model_Jade::ParserContext &ctx) {
 		return;
 
 	_render = _mesh->render;
-	_mesh->data = new MeshData();
+	_mesh->data = std::make_shared<MeshData>();
 	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
 	loadTextures(ctx.textures);
@@ -330,24 +330,25 @@ bool Model_KotOR::readAnim(ParserContext &ctx, uint32_t offset) {
 }
 
 void Model_KotOR::loadSuperModel(ModelCache *modelCache, bool kotor2, bool xbox) {
-	if (!_superModelName.empty() && _superModelName != "NULL") {
-		bool foundInCache = false;
+	if (_superModelName.empty() || (_superModelName == "NULL"))
+		return;
 
-		if (modelCache) {
-			ModelCache::iterator super = modelCache->find(_superModelName);
-			if (super != modelCache->end()) {
-				_superModel = super->second.get();
+	if (!modelCache) {
+		_superModel = new Model_KotOR(_superModelName, kotor2, xbox, _type, "", modelCache);
+		return;
+	}
 
-				foundInCache = true;
-			}
-		}
+	// Load the supermodel while holding the lock, so that it's only loaded once
+	std::lock_guard<std::recursive_mutex> lock(modelCache->mutex);
 
-		if (!_superModel)
-			_superModel = new Model_KotOR(_superModelName, kotor2, xbox, _type, "", modelCache);
+	ModelCache::ModelMap::iterator super = modelCache->models.find(_superModelName);
+	if (super == modelCache->models.end()) {
+		std::unique_ptr<Model> superModel(new Model_KotOR(_superModelName, kotor2, xbox, _type, "", modelCache));
 
-		if (modelCache && !foundInCache)
-			modelCache->insert(std::make_pair(_superModelName, std::unique_ptr<Model>(_superModel)));
+		super = modelCache->models.insert(std::make_pair(_superModelName, std::move(superModel))).first;
 	}
+
+	_superModel = super->second.get();
 }
 
 void Model_KotOR::readStrings(Common::SeekableReadStream &mdl,
@@ -444,9 +445,17 @@ ModelNode_KotOR::ModelNode_KotOR(Model &model) :
 	ModelNode(model) {
 }
 
+ModelNode_KotOR::ModelNode_KotOR(Model &model, const ModelNode_KotOR &prototype) :
+	ModelNode(model, prototype) {
+}
+
 ModelNode_KotOR::~ModelNode_KotOR() {
 }
 
+ModelNode *ModelNode_KotOR::createInstance(Model &model) const {
+	return new ModelNode_KotOR(model, *this);
+}
+
 void ModelNode_KotOR::load(Model_KotOR::ParserContext &ctx) {
 	ctx.flags = ctx.mdl->readUint16LE();
 	uint16_t superNode = ctx.mdl->readUint16LE();
@@ -588,6 +597,9 @@ void ModelNode_KotOR::load(Model_KotOR::ParserContext &ctx) {
 					delete _mesh->data->rawMesh;
 					_mesh->data->rawMesh = checkMesh;
 				} else {
+					optimizeMesh();
+					quantizeMesh();
+
 					_mesh->data->rawMesh->setName(meshName);
 					_mesh->data->rawMesh->init();
 					MeshMan.addMesh(_mesh->data->rawMesh);
@@ -607,6 +619,9 @@ void ModelNode_KotOR::load(Model_KotOR::ParserContext &ctx) {
 			 * manager is responsible for later deleting it.
 			 */
 			meshName += "#" + Common::generateIDRandomString();
+
+			optimizeMesh();
+
 			_mesh->data->rawMesh->setName(meshName);
 			_mesh->data->rawMesh->init();
 
@@ -842,7 +857,7 @@ void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
 		return;
 
 	_render = _mesh->render;
-	_mesh->data = new MeshData();
+	_mesh->data = std::make_shared<MeshData>();
 	_mesh->data->envMapMode = kModeEnvironmentBlendedOver;
 	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 	_mesh->data->rawMesh->setBindPosePtr(&_absoluteBaseTransform);
@@ -1038,7 +1053,7 @@ void ModelNode_KotOR::readSaber(Model_KotOR::ParserContext &ctx) {
 	// Prepare our data structures
 
 	_render = _mesh->render;
-	_mesh->data = new MeshData();
+	_mesh->data = std::make_shared<MeshData>();
 	_mesh->data->envMapMode = kModeEnvironmentBlendedOver;
 	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
@@ -106,6 +106,8 @@ public:
 	ModelNode_KotOR(Model &model);
 	~ModelNode_KotOR();
 
+	ModelNode *createInstance(Model &model) const;
+
 	void load(Model_KotOR::ParserContext &ctx);
 
 	void buildMaterial();
@@ -114,6 +116,8 @@ public:
 	void setupShaderTexture(MaterialConfiguration &config, int textureIndex, Shader::ShaderDescriptor &cripter);
 
 private:
+	ModelNode_KotOR(Model &model, const ModelNode_KotOR &prototype);
+
 	void readNodeControllers(Model_KotOR::ParserContext &ctx, uint32_t offset,
 	                         uint32_t count, std::vector<float> &dataFloat, std::vector<uint32_t> &dataInt);
 	void readPositionController(uint8_t columnCount, uint16_t rowCount, uint16_t timeIndex,
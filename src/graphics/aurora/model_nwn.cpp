@@ -479,24 +479,25 @@ void Model_NWN::readAnimBinary(ParserContext &ctx, uint32_t offset) {
 }
 
 void Model_NWN::loadSuperModel(ModelCache *modelCache) {
-	if (!_superModelName.empty() && _superModelName != "NULL") {
-		bool foundInCache = false;
+	if (_superModelName.empty() || (_superModelName == "NULL"))
+		return;
 
-		if (modelCache) {
-			ModelCache::iterator super = modelCache->find(_superModelName);
-			if (super != modelCache->end()) {
-				_superModel = super->second.get();
+	if (!modelCache) {
+		_superModel = new Model_NWN(_superModelName, _type, "", modelCache);
+		return;
+	}
 
-				foundInCache = true;
-			}
-		}
+	// Load the supermodel while holding the lock, so that it's only loaded once
+	std::lock_guard<std::recursive_mutex> lock(modelCache->mutex);
 
-		if (!_superModel)
-			_superModel = new Model_NWN(_superModelName, _type, "", modelCache);
+	ModelCache::ModelMap::iterator super = modelCache->models.find(_superModelName);
+	if (super == modelCache->models.end()) {
+		std::unique_ptr<Model> superModel(new Model_NWN(_superModelName, _type, "", modelCache));
 
-		if (modelCache && !foundInCache)
-			modelCache->insert(std::make_pair(_superModelName, std::unique_ptr<Model>(_superModel)));
+		super = modelCache->models.insert(std::make_pair(_superModelName, std::move(superModel))).first;
 	}
+
+	_superModel = super->second.get();
 }
 
 struct DefaultAnim {
@@ -808,7 +809,7 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 		textures[0] = ctx.texture;
 
 	_render = _mesh->render;
-	_mesh->data = new MeshData();
+	_mesh->data = std::make_shared<MeshData>();
 	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
 	textures.resize(textureCount);
@@ -961,6 +962,9 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 		delete _mesh->data->rawMesh;
 		_mesh->data->rawMesh = checkMesh;
 	} else {
+		optimizeMesh();
+		quantizeMesh();
+
 		_mesh->data->rawMesh->setName(meshName);
 		_mesh->data->rawMesh->init();
 		MeshMan.addMesh(_mesh->data->rawMesh);
@@ -1212,6 +1216,9 @@ void ModelNode_NWN_ASCII::load(Model_NWN::ParserContext &ctx,
 		return;
 	}
 
+	optimizeMesh();
+	quantizeMesh();
+
 	_mesh->data->rawMesh->setName(meshName);
 	_mesh->data->rawMesh->init();
 	if (MeshMan.getMesh(meshName)) {
@@ -1379,7 +1386,7 @@ void ModelNode_NWN_ASCII::processMesh(ModelNode_NWN_ASCII::Mesh &mesh) {
 		return;
 
 	_render = _mesh->render;
-	_mesh->data = new MeshData();
+	_mesh->data = std::make_shared<MeshData>();
 	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
 	loadTextures(mesh.textures);
@@ -90,9 +90,16 @@ Model_NWN2::Model_NWN2(const Common::UString &name, ModelType type) : Model(type
 	finalize();
 }
 
+Model_NWN2::Model_NWN2(const std::shared_ptr<const Model> &prototype) : Model(prototype) {
+}
+
 Model_NWN2::~Model_NWN2() {
 }
 
+Model *Model_NWN2::newInstance(const std::shared_ptr<const Model> &prototype) const {
+	return new Model_NWN2(prototype);
+}
+
 void Model_NWN2::setTint(const float tint[3][4]) {
 	for (StateList::iterator s = _stateList.begin(); s != _stateList.end(); ++s)
 		for (NodeList::iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n)
@@ -202,9 +209,19 @@ void Model_NWN2::addState(ParserContext &ctx) {
 ModelNode_NWN2::ModelNode_NWN2(Model &model) : ModelNode(model), _tintedMapIndex(-1) {
 }
 
+ModelNode_NWN2::ModelNode_NWN2(Model &model, const ModelNode_NWN2 &prototype) :
+	ModelNode(model, prototype), _tintMap(prototype._tintMap), _tintedMapIndex(prototype._tintedMapIndex) {
+
+	std::memcpy(_tint, prototype._tint, sizeof(_tint));
+}
+
 ModelNode_NWN2::~ModelNode_NWN2() {
 }
 
+ModelNode *ModelNode_NWN2::createInstance(Model &model) const {
+	return new ModelNode_NWN2(model, *this);
+}
+
 bool ModelNode_NWN2::loadRigid(Model_NWN2::ParserContext &ctx) {
 	uint32_t tag = ctx.mdb->readUint32BE();
 	if (tag != kRigidID)
@@ -243,7 +260,7 @@ bool ModelNode_NWN2::loadRigid(Model_NWN2::ParserContext &ctx) {
 		return false;
 
 	_render = _mesh->render = true;
-	_mesh->data = new MeshData();
+	_mesh->data = std::make_shared<MeshData>();
 	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
 	std::vector<Common::UString> textures;
@@ -368,7 +385,7 @@ bool ModelNode_NWN2::loadSkin(Model_NWN2::ParserContext &ctx) {
 		return false;
 
 	_render = _mesh->render = true;
-	_mesh->data = new MeshData();
+	_mesh->data = std::make_shared<MeshData>();
 	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
 	std::vector<Common::UString> textures;
@@ -464,6 +481,9 @@ void ModelNode_NWN2::setTint(const float tint[3][4]) {
 
 	memcpy(_tint, tint, 3 * 4 * sizeof(float));
 
+	// The tinted texture belongs to this instance only
+	unshareMeshData();
+
 	removeTint();
 	createTint();
 
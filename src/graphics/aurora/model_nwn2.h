@@ -52,6 +52,12 @@ public:
 	/** Tint all wall nodes of the model with these tint colors. */
 	void setTintWalls(const float tint[3][4]);
 
+protected:
+	/** Create an instance of a prototype NWN2 model. */
+	Model_NWN2(const std::shared_ptr<const Model> &prototype);
+
+	Model *newInstance(const std::shared_ptr<const Model> &prototype) const;
+
 private:
 	struct PacketKey {
 		uint32_t signature;
@@ -90,6 +96,8 @@ public:
 	ModelNode_NWN2(Model &model);
 	~ModelNode_NWN2();
 
+	ModelNode *createInstance(Model &model) const;
+
 	bool loadRigid(Model_NWN2::ParserContext &ctx);
 	bool loadSkin (Model_NWN2::ParserContext &ctx);
 
@@ -102,6 +110,8 @@ private:
 
 	float _tint[3][4];
 
+	ModelNode_NWN2(Model &model, const ModelNode_NWN2 &prototype);
+
 	void removeTint();
 	void createTint();
 };
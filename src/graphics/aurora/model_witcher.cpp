@@ -242,9 +242,17 @@ void Model_Witcher::addState(ParserContext &ctx) {
 ModelNode_Witcher::ModelNode_Witcher(Model &model) : ModelNode(model) {
 }
 
+ModelNode_Witcher::ModelNode_Witcher(Model &model, const ModelNode_Witcher &prototype) :
+	ModelNode(model, prototype) {
+}
+
 ModelNode_Witcher::~ModelNode_Witcher() {
 }
 
+ModelNode *ModelNode_Witcher::createInstance(Model &model) const {
+	return new ModelNode_Witcher(model, *this);
+}
+
 void ModelNode_Witcher::load(Model_Witcher::ParserContext &ctx) {
 	ctx.mdb->skip(24); // Function pointers
 
@@ -332,6 +340,12 @@ void ModelNode_Witcher::load(Model_Witcher::ParserContext &ctx) {
 				delete _mesh->data->rawMesh;
 				_mesh->data->rawMesh = checkMesh;
 			} else {
+				// Texture paint meshes are already prepared and queued for the GL while reading them
+				if (type != kNodeTypeTexturePaint) {
+					optimizeMesh();
+					quantizeMesh();
+				}
+
 				_mesh->data->rawMesh->setName(meshName);
 				_mesh->data->rawMesh->init();
 				MeshMan.addMesh(_mesh->data->rawMesh);
@@ -514,7 +528,7 @@ void ModelNode_Witcher::readMesh(Model_Witcher::ParserContext &ctx) {
 	}
 
 	_render = _mesh->render;
-	_mesh->data = new MeshData();
+	_mesh->data = std::make_shared<MeshData>();
 	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
 	std::vector<Common::UString> textures;
@@ -720,7 +734,7 @@ void ModelNode_Witcher::readTexturePaint(Model_Witcher::ParserContext &ctx) {
 	}
 
 	_render = _mesh->render;
-	_mesh->data = new MeshData();
+	_mesh->data = std::make_shared<MeshData>();
 	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
 	std::vector<TexturePaintLayer> layers;
@@ -819,6 +833,10 @@ void ModelNode_Witcher::readTexturePaint(Model_Witcher::ParserContext &ctx) {
 		ctx.mdb->skip(68); // Unknown
 	}
 
+	// Before the mesh is queued for the GL and the material is built, so that they match the vertex layout
+	optimizeMesh();
+	quantizeMesh();
+
 	_mesh->data->rawMesh->init();
 
 	createBound();
@@ -1078,6 +1096,11 @@ void ModelNode_Witcher::buildMaterial() {
 		}
 	}
 
+	if (pmesh->data->rawMesh->isQuantized()) {
+		materialName += "quantized.";
+		cripter.declareUniform(Graphics::Shader::ShaderDescriptor::UNIFORM_V_VERTEX_DECODE);
+	}
+
 	if (penvmap) {
 		if (penvmap->getTexture().getImage().isCubeMap()) {
 			cripter.declareInput(Graphics::Shader::ShaderDescriptor::INPUT_UV_CUBE);
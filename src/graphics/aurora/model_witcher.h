@@ -87,6 +87,8 @@ public:
 	ModelNode_Witcher(Model &model);
 	~ModelNode_Witcher();
 
+	ModelNode *createInstance(Model &model) const;
+
 	void load(Model_Witcher::ParserContext &ctx);
 
 private:
@@ -98,6 +100,8 @@ private:
 		std::vector<float> weights;
 	};
 
+	ModelNode_Witcher(Model &model, const ModelNode_Witcher &prototype);
+
 	void readMesh(Model_Witcher::ParserContext &ctx);
 	void readTexturePaint(Model_Witcher::ParserContext &ctx);
 
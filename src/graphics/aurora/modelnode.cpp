@@ -45,6 +45,8 @@
 #include "src/graphics/shader/materialman.h"
 #include "src/graphics/shader/surfaceman.h"
 
+#include "src/graphics/mesh/meshoptimizer.h"
+
 #include "src/graphics/render/renderman.h"
 
 #include "src/graphics/images/decoder.h"
@@ -120,18 +122,65 @@ ModelNode::ModelNode(Model &model) :
 	_orientationBuffer[3] = 0.0f;
 }
 
+ModelNode::ModelNode(Model &model, const ModelNode &prototype) :
+		_model(&model),
+		_parent(prototype._parent),
+		_children(prototype._children),
+		_attachedModel(0),
+		_level(prototype._level),
+		_name(prototype._name),
+		_renderableArray(prototype._renderableArray),
+		_alpha(prototype._alpha),
+		_positionFrames(prototype._positionFrames),
+		_orientationFrames(prototype._orientationFrames),
+		_absolutePosition(prototype._absolutePosition),
+		_renderTransform(prototype._renderTransform),
+		_render(prototype._render),
+		_dirtyRender(prototype._dirtyRender),
+		_mesh(0),
+		_rootStateNode(prototype._rootStateNode),
+		_boundBox(prototype._boundBox),
+		_absoluteBoundBox(prototype._absoluteBoundBox),
+		_nodeNumber(prototype._nodeNumber),
+		_localBaseTransform(prototype._localBaseTransform),
+		_absoluteBaseTransform(prototype._absoluteBaseTransform),
+		_localTransform(prototype._localTransform),
+		_absoluteTransform(prototype._absoluteTransform),
+		_boneTransform(prototype._boneTransform),
+		_localBaseTransformInv(prototype._localBaseTransformInv),
+		_absoluteBaseTransformInv(prototype._absoluteBaseTransformInv),
+		_localTransformInv(prototype._localTransformInv),
+		_absoluteTransformInv(prototype._absoluteTransformInv),
+		_positionBuffered(false),
+		_orientationBuffered(false),
+		_vertexCoordsBuffered(false),
+		_material(prototype._material),
+		_shaderRenderable(0) {
+
+	std::memcpy(_center     , prototype._center     , sizeof(_center));
+	std::memcpy(_position   , prototype._position   , sizeof(_position));
+	std::memcpy(_rotation   , prototype._rotation   , sizeof(_rotation));
+	std::memcpy(_orientation, prototype._orientation, sizeof(_orientation));
+	std::memcpy(_scale      , prototype._scale      , sizeof(_scale));
+
+	std::memset(_positionBuffer   , 0, sizeof(_positionBuffer));
+	std::memset(_orientationBuffer, 0, sizeof(_orientationBuffer));
+
+	if (prototype._mesh) {
+		// The mesh properties belong to the instance, the mesh data is shared
+		_mesh = new Mesh(*prototype._mesh);
+
+		if (_mesh->dangly)
+			_mesh->dangly = new Dangly(*_mesh->dangly);
+		if (_mesh->skin)
+			_mesh->skin = new Skin(*_mesh->skin);
+	}
+}
+
 ModelNode::~ModelNode() {
 	if (_mesh) {
-		if (_mesh->dangly) {
-			delete _mesh->dangly->data;
-			delete _mesh->dangly;
-		}
-		if (_mesh->skin) {
-			delete _mesh->skin;
-		}
-		if (_mesh->data) {
-			delete _mesh->data;
-		}
+		delete _mesh->dangly;
+		delete _mesh->skin;
 	}
 
 	delete _mesh;
@@ -141,6 +190,40 @@ ModelNode::~ModelNode() {
 	_attachedModel = 0;
 }
 
+ModelNode *ModelNode::createInstance(Model &model) const {
+	return new ModelNode(model, *this);
+}
+
+static ModelNode *findInstanceNode(const std::map<const ModelNode *, ModelNode *> &nodeMap,
+                                   const ModelNode *node) {
+
+	std::map<const ModelNode *, ModelNode *>::const_iterator n = nodeMap.find(node);
+	if (n == nodeMap.end())
+		return 0;
+
+	return n->second;
+}
+
+void ModelNode::remapNodes(const InstanceNodeMap &nodeMap) {
+	_parent        = findInstanceNode(nodeMap, _parent);
+	_rootStateNode = findInstanceNode(nodeMap, _rootStateNode);
+
+	for (std::list<ModelNode *>::iterator c = _children.begin(); c != _children.end(); ++c)
+		*c = findInstanceNode(nodeMap, *c);
+
+	_children.remove(0);
+
+	if (_mesh && _mesh->skin)
+		for (std::vector<ModelNode *>::iterator b = _mesh->skin->boneNodeMap.begin();
+		     b != _mesh->skin->boneNodeMap.end(); ++b)
+			*b = findInstanceNode(nodeMap, *b);
+}
+
+void ModelNode::unshareMeshData() {
+	if (_mesh && _mesh->data && (_mesh->data.use_count() > 1))
+		_mesh->data = std::make_shared<MeshData>(*_mesh->data);
+}
+
 ModelNode *ModelNode::getParent() {
 	return _parent;
 }
@@ -389,6 +472,8 @@ void ModelNode::setEnvironmentMap(const Common::UString &environmentMap) {
 	if (!_mesh || !_mesh->data)
 		return;
 
+	unshareMeshData();
+
 	_mesh->data->envMap.clear();
 
 	if (!environmentMap.empty()) {
@@ -450,6 +535,8 @@ void ModelNode::setAlpha(float alpha, bool isRecursive) {
 void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
 	bool hasTexture = false;
 
+	unshareMeshData();
+
 	_mesh->data->textures.resize(textures.size());
 
 	bool hasAlpha = true;
@@ -539,9 +626,60 @@ void ModelNode::createBound() {
 		}
 	}
 
+	const glm::vec4 *decode = _mesh->data->rawMesh->getVertexDecode();
+	if (decode) {
+		// Quantized positions are 16-bit integers, relative to the mesh's bounds
+		for (VertexDecl::const_iterator vA = vertexDecl.begin(); vA != vertexDecl.end(); ++vA) {
+			if (!vA->pointer || (vA->index != VPOSITION) || (vA->type != GL_SHORT))
+				continue;
+
+			const uint32_t stride = MAX<uint32_t>(vA->size, vA->stride / sizeof(int16_t));
+
+			const int16_t *vertexData = reinterpret_cast<const int16_t *>(vA->pointer);
+
+			for (uint32_t v = 0; v < vertexBuffer->getCount(); v++) {
+				const int16_t *position = vertexData + v * stride;
+
+				_boundBox.add(decode[0].x + decode[1].x * position[0],
+				              decode[0].y + decode[1].y * position[1],
+				              decode[0].z + decode[1].z * position[2]);
+			}
+		}
+	}
+
 	createCenter();
 }
 
+void ModelNode::optimizeMesh() {
+	if (!MeshMan.getOptimize() || !_mesh || !_mesh->data || !_mesh->data->rawMesh)
+		return;
+
+	// Skinned meshes are animated by moving their vertices, so those need to stay where they are
+	if (_mesh->skin)
+		return;
+
+	Graphics::Mesh::Mesh &rawMesh = *_mesh->data->rawMesh;
+	if (rawMesh.getType() != GL_TRIANGLES)
+		return;
+
+	Graphics::Mesh::optimizeMesh(*rawMesh.getVertexBuffer(), *rawMesh.getIndexBuffer());
+}
+
+void ModelNode::quantizeMesh() {
+	if (!MeshMan.getQuantize() || !_mesh || !_mesh->data || !_mesh->data->rawMesh)
+		return;
+
+	// Only the shaders of the experimental renderer decode the compact layout
+	if (!GfxMan.isRendererExperimental() || !GfxMan.isGL3())
+		return;
+
+	// Skinned meshes are animated by moving their vertices, so those need to stay floats
+	if (_mesh->skin)
+		return;
+
+	_mesh->data->rawMesh->quantize();
+}
+
 void ModelNode::createCenter() {
 
 	float minX, minY, minZ, maxX, maxY, maxZ;
@@ -1300,7 +1438,12 @@ void ModelNode::buildMaterial() {
 	_renderableArray.push_back(Shader::ShaderRenderable(surface, config.material, _mesh->data->rawMesh));
 }
 
-void ModelNode::declareShaderInputs(MaterialConfiguration &UNUSED(config), Shader::ShaderDescriptor &cripter) {
+void ModelNode::declareShaderInputs(MaterialConfiguration &config, Shader::ShaderDescriptor &cripter) {
+	if (config.pmesh->data->rawMesh->isQuantized()) {
+		config.materialName += ".quantized";
+		cripter.declareUniform(Shader::ShaderDescriptor::UNIFORM_V_VERTEX_DECODE);
+	}
+
 	cripter.declareInput(Shader::ShaderDescriptor::INPUT_POSITION0);
 	cripter.declareInput(Shader::ShaderDescriptor::INPUT_NORMAL0);
 	cripter.declareInput(Shader::ShaderDescriptor::INPUT_UV0);
@@ -26,6 +26,8 @@
 #define GRAPHICS_AURORA_MODELNODE_H
 
 #include <list>
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "external/glm/ext/quaternion_float.hpp"
@@ -69,6 +71,14 @@ public:
 	ModelNode(Model &model);
 	virtual ~ModelNode();
 
+	/** Create a copy of this node for a new instance of its model.
+	 *
+	 *  The copy shares the mesh data with this node. Its parent,
+	 *  children and bones still point to the nodes of this model and
+	 *  need to be remapped with remapNodes().
+	 */
+	virtual ModelNode *createInstance(Model &model) const;
+
 	// Basic properties
 
 	/** Get the node's name. */
@@ -178,7 +188,7 @@ public:
 		float tightness;
 		float displacement;
 
-		DanglyData *data;
+		std::shared_ptr<DanglyData> data;
 
 		Dangly();
 	};
@@ -233,9 +243,10 @@ public:
 
 		bool isBackgroundGeometry;
 
-		MeshData *data;
-		Dangly   *dangly;
-		Skin     *skin;
+		std::shared_ptr<MeshData> data; ///< Raw mesh data, shared between model instances.
+
+		Dangly *dangly;
+		Skin   *skin;
 		// TODO Anim, AABB Meshes
 
 		Mesh();
@@ -255,6 +266,8 @@ public:
 	};
 
 protected:
+	typedef std::map<const ModelNode *, ModelNode *> InstanceNodeMap;
+
 	Model *_model; ///< The model this node belongs to.
 
 	ModelNode *_parent;               ///< The node's parent.
@@ -320,11 +333,23 @@ protected:
 	Shader::ShaderMaterial *_material;
 	Shader::ShaderRenderable *_shaderRenderable;
 
+	ModelNode(Model &model, const ModelNode &prototype);
+
+	/** Point the node relations to the nodes of the new instance. */
+	void remapNodes(const InstanceNodeMap &nodeMap);
+	/** Make sure the mesh data isn't shared anymore before changing it. */
+	void unshareMeshData();
+
 	// Loading helpers
 	void loadTextures(const std::vector<Common::UString> &textures);
 	void createBound();
 	void createCenter();
 
+	/** Optimize the raw mesh for rendering, if enabled and if nothing refers to its vertices. */
+	void optimizeMesh();
+	/** Store the raw mesh in a compact layout, if enabled and if the shaders can decode it. */
+	void quantizeMesh();
+
 	void createAbsoluteBound();
 	void createAbsoluteBound(Common::BoundingBox parentPosition);
 
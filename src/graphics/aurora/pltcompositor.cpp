@@ -0,0 +1,246 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Flattening the layers of PLT textures into one image.
+ */
+
+#include <cstring>
+
+#include "src/common/util.h"
+
+#include "src/graphics/aurora/pltcompositor.h"
+
+// AVX2 is picked at runtime, where the compiler lets us.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define XOREOS_PLT_AVX2 1
+	#define XOREOS_PLT_AVX2_TARGET __attribute__((target("avx2")))
+
+	#include <immintrin.h>
+#endif
+
+DECLARE_SINGLETON(Graphics::Aurora::PLTCompositor)
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** The default maximum size of all cached composited images. */
+static const size_t kDefaultBudget = 16 * 1024 * 1024;
+
+/** Composite whatever's left over with a simple table lookup. */
+static void composeScalar(byte *dst, const uint16_t *indices, const uint32_t *colors, size_t pixels) {
+	for (size_t i = 0; i < pixels; i++, dst += 4)
+		std::memcpy(dst, colors + indices[i], 4);
+}
+
+#if defined(XOREOS_PLT_AVX2)
+/** Composite 8 pixels at a time, gathering their colors out of the table.
+ *
+ *  @return The number of pixels composited.
+ */
+XOREOS_PLT_AVX2_TARGET
+static size_t composeAVX2(byte *dst, const uint16_t *indices, const uint32_t *colors, size_t pixels) {
+	const int *table = reinterpret_cast<const int *>(colors);
+
+	size_t i = 0;
+	for (; (i + 8) <= pixels; i += 8) {
+		const __m256i index = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i)));
+		const __m256i color = _mm256_i32gather_epi32(table, index, 4);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), color);
+	}
+
+	return i;
+}
+#endif // XOREOS_PLT_AVX2
+
+
+bool PLTCompositor::Key::operator<(const Key &key) const {
+	const int cmp = std::memcmp(colors, key.colors, kLayerCount);
+	if (cmp != 0)
+		return cmp < 0;
+
+	return name.lessIgnoreCase(key.name);
+}
+
+
+PLTCompositor::PLTCompositor() : _implementation(kImplementationScalar), _size(0), _budget(kDefaultBudget),
+	_hits(0), _misses(0) {
+
+	if (hasImplementation(kImplementationAVX2))
+		_implementation = kImplementationAVX2;
+}
+
+PLTCompositor::~PLTCompositor() {
+}
+
+PLTCompositor::Implementation PLTCompositor::getImplementation() const {
+	return _implementation;
+}
+
+bool PLTCompositor::hasImplementation(Implementation implementation) {
+	switch (implementation) {
+		case kImplementationScalar:
+			return true;
+
+#if defined(XOREOS_PLT_AVX2)
+		case kImplementationAVX2:
+			return __builtin_cpu_supports("avx2");
+#endif
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
+bool PLTCompositor::setImplementation(Implementation implementation) {
+	if (!hasImplementation(implementation))
+		return false;
+
+	_implementation = implementation;
+	return true;
+}
+
+void PLTCompositor::makeIndices(uint16_t *indices, const byte *layers, const byte *intensities, size_t pixels) {
+	for (size_t i = 0; i < pixels; i++)
+		indices[i] = MIN<uint16_t>(layers[i], kLayerCount - 1) * 256 + intensities[i];
+}
+
+void PLTCompositor::compose(byte *dst, const uint16_t *indices, const uint32_t *colors, size_t pixels) const {
+	size_t done = 0;
+
+	switch (_implementation) {
+#if defined(XOREOS_PLT_AVX2)
+		case kImplementationAVX2:
+			done = composeAVX2(dst, indices, colors, pixels);
+			break;
+#endif
+
+		default:
+			break;
+	}
+
+	composeScalar(dst + done * 4, indices + done, colors, pixels - done);
+}
+
+void PLTCompositor::setBudget(size_t budget) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_budget = budget;
+	enforceBudget();
+}
+
+PLTCompositor::Image PLTCompositor::getCached(const Common::UString &name, const uint8_t colors[kLayerCount]) {
+	Key key;
+	key.name = name;
+	std::memcpy(key.colors, colors, kLayerCount);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	ImageMap::iterator i = _imageMap.find(key);
+	if (i == _imageMap.end()) {
+		_misses++;
+		return Image();
+	}
+
+	_hits++;
+
+	// Move to the front of the list, as the most recently used image
+	_images.splice(_images.begin(), _images, i->second);
+
+	return i->second->image;
+}
+
+PLTCompositor::Image PLTCompositor::addCached(const Common::UString &name, const uint8_t colors[kLayerCount],
+                                              std::vector<byte> &&image) {
+
+	Image shared = std::make_shared<const std::vector<byte>>(std::move(image));
+
+	Key key;
+	key.name = name;
+	std::memcpy(key.colors, colors, kLayerCount);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (shared->size() > _budget)
+		return shared;
+
+	std::pair<ImageMap::iterator, bool> result = _imageMap.insert(std::make_pair(key, _images.end()));
+	if (!result.second) {
+		// Someone else was faster, so take theirs
+		_images.splice(_images.begin(), _images, result.first->second);
+
+		return result.first->second->image;
+	}
+
+	CachedImage cached;
+	cached.key   = result.first;
+	cached.image = shared;
+
+	_images.push_front(cached);
+	result.first->second = _images.begin();
+
+	_size += shared->size();
+	enforceBudget();
+
+	return shared;
+}
+
+void PLTCompositor::clearCache() {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_imageMap.clear();
+	_images.clear();
+
+	_size = 0;
+}
+
+PLTCompositor::Stats PLTCompositor::getStats() {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	Stats stats;
+
+	stats.images = _images.size();
+	stats.size   = _size;
+	stats.budget = _budget;
+	stats.hits   = _hits;
+	stats.misses = _misses;
+
+	return stats;
+}
+
+void PLTCompositor::enforceBudget() {
+	// Drop the least recently used images until we're within the budget again
+	while ((_size > _budget) && !_images.empty()) {
+		CachedImage &cached = _images.back();
+
+		_size -= cached.image->size();
+
+		_imageMap.erase(cached.key);
+		_images.pop_back();
+	}
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
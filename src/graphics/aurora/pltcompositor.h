@@ -0,0 +1,166 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Flattening the layers of PLT textures into one image.
+ */
+
+#ifndef GRAPHICS_AURORA_PLTCOMPOSITOR_H
+#define GRAPHICS_AURORA_PLTCOMPOSITOR_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "src/common/types.h"
+#include "src/common/singleton.h"
+#include "src/common/ustring.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** Composites PLT layer textures, and caches the results.
+ *
+ *  Each pixel of a PLT is an index into a table of 256 BGRA colors for each
+ *  of its layers, the color rows picked by the layer colors out of the layer
+ *  palettes. Compositing is therefore a plain table lookup per pixel.
+ *
+ *  Since many creatures share the same PLT and the same colors (think of a
+ *  group of guards), the composited images are kept, keyed by the name of
+ *  the PLT and its layer colors, so identical textures are only ever
+ *  composited once.
+ */
+class PLTCompositor : public Common::Singleton<PLTCompositor> {
+public:
+	/** The number of layers in a PLT. */
+	static const size_t kLayerCount = 10;
+	/** The number of entries in the color table for all layers. */
+	static const size_t kColorCount = 256 * kLayerCount;
+
+	/** The code path doing the compositing. */
+	enum Implementation {
+		kImplementationScalar, ///< Generic, one pixel at a time.
+		kImplementationAVX2    ///< Using AVX2 gathers, 8 pixels at a time.
+	};
+
+	/** A composited BGRA image. */
+	typedef std::shared_ptr<const std::vector<byte>> Image;
+
+	/** Statistics about the cache of composited images. */
+	struct Stats {
+		size_t images; ///< Number of cached images.
+		size_t size;   ///< Size of all cached images, in bytes.
+		size_t budget; ///< Maximum size of all cached images, in bytes.
+
+		uint64_t hits;   ///< Number of images found in the cache.
+		uint64_t misses; ///< Number of images not found in the cache.
+	};
+
+	/** Return the compositing code path in use. */
+	Implementation getImplementation() const;
+
+	/** Is this implementation available on this CPU? */
+	static bool hasImplementation(Implementation implementation);
+
+	/** Select the compositing code path.
+	 *
+	 *  By default, the fastest available implementation is used. All of them
+	 *  produce exactly the same output.
+	 *
+	 *  @return false if the implementation isn't available on this CPU.
+	 */
+	bool setImplementation(Implementation implementation);
+
+	/** Build the color table index of every pixel, out of the PLT layer and intensity values. */
+	static void makeIndices(uint16_t *indices, const byte *layers, const byte *intensities, size_t pixels);
+
+	/** Composite an image.
+	 *
+	 *  @param dst     The BGRA image to write, 4 * pixels bytes.
+	 *  @param indices The color table index of every pixel.
+	 *  @param colors  The color table, kColorCount BGRA colors.
+	 *  @param pixels  The number of pixels in the image.
+	 */
+	void compose(byte *dst, const uint16_t *indices, const uint32_t *colors, size_t pixels) const;
+
+	// .--- Cache
+	/** Set the maximum size of all cached images, in bytes. 0 disables the cache. */
+	void setBudget(size_t budget);
+
+	/** Find the composited image of this PLT with these layer colors. */
+	Image getCached(const Common::UString &name, const uint8_t colors[kLayerCount]);
+	/** Add a composited image of this PLT with these layer colors to the cache. */
+	Image addCached(const Common::UString &name, const uint8_t colors[kLayerCount], std::vector<byte> &&image);
+
+	/** Forget all cached images, for example because the layer palettes changed. */
+	void clearCache();
+
+	Stats getStats();
+	// '---
+
+private:
+	struct Key {
+		Common::UString name;
+		uint8_t colors[kLayerCount];
+
+		bool operator<(const Key &key) const;
+	};
+
+	struct CachedImage;
+
+	typedef std::list<CachedImage> ImageList;
+	typedef std::map<Key, ImageList::iterator> ImageMap;
+
+	struct CachedImage {
+		ImageMap::iterator key;
+		Image image;
+	};
+
+	Implementation _implementation;
+
+	std::mutex _mutex;
+
+	ImageList _images; ///< All cached images, the most recently used first.
+	ImageMap  _imageMap;
+
+	size_t _size;
+	size_t _budget;
+
+	uint64_t _hits;
+	uint64_t _misses;
+
+	friend class Common::Singleton<SingletonBaseType>;
+	PLTCompositor();
+	~PLTCompositor();
+
+	void enforceBudget();
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+/** Shortcut for accessing the PLT compositor. */
+#define PLTComp ::Graphics::Aurora::PLTCompositor::instance()
+
+#endif // GRAPHICS_AURORA_PLTCOMPOSITOR_H
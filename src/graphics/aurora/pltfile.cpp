@@ -46,10 +46,18 @@
  *
  *   p = layerImages[layerIndex].getPixel(intensity, colorIndex)
  * }
+ *
+ * Since the layer index and the intensity of a pixel never change, we
+ * combine them into one index into a table of all layers' color rows
+ * when loading the PLT. The layer palettes are loaded only once, and the
+ * flattened images are cached by the PLTCompositor, so that creatures
+ * wearing the same colors share the work.
  */
 
 #include <cassert>
 #include <cstring>
+#include <mutex>
+#include <vector>
 
 #include "src/common/error.h"
 #include "src/common/readstream.h"
@@ -59,6 +67,7 @@
 #include "src/graphics/images/surface.h"
 
 #include "src/graphics/aurora/pltfile.h"
+#include "src/graphics/aurora/pltcompositor.h"
 
 static const uint32_t kPLTID     = MKTAG('P', 'L', 'T', ' ');
 static const uint32_t kVersion1  = MKTAG('V', '1', ' ', ' ');
@@ -67,6 +76,12 @@ namespace Graphics {
 
 namespace Aurora {
 
+static_assert(PLTFile::kLayerMAX == PLTCompositor::kLayerCount, "PLT layer count mismatch");
+
+/** The layer palette images, loaded once and shared by all PLTs. */
+static std::unique_ptr<ImageDecoder> palettes[PLTFile::kLayerMAX];
+static std::mutex paletteMutex;
+
 PLTFile::PLTFile(const Common::UString &name, Common::SeekableReadStream &plt) :
 	_name(name), _surface(0) {
 
@@ -124,16 +139,19 @@ void PLTFile::load(Common::SeekableReadStream &plt) {
 
 	size_t size = width * height;
 
-	_dataImage  = std::make_unique<uint8_t[]>(size);
-	_dataLayers = std::make_unique<uint8_t[]>(size);
+	std::unique_ptr<uint8_t[]> data = std::make_unique<uint8_t[]>(2 * size);
+	if (plt.read(data.get(), 2 * size) != (2 * size))
+		throw Common::Exception(Common::kReadError);
 
-	uint8_t *image = _dataImage.get();
-	uint8_t *layer = _dataLayers.get();
-	while (size-- > 0) {
-		*image++ = plt.readByte();
-		*layer++ = MIN<uint8_t>(plt.readByte(), kLayerMAX - 1);
+	std::vector<uint8_t> image(size), layer(size);
+	for (size_t i = 0; i < size; i++) {
+		image[i] = data[2 * i + 0];
+		layer[i] = data[2 * i + 1];
 	}
 
+	_dataIndices = std::make_unique<uint16_t[]>(size);
+	PLTCompositor::makeIndices(_dataIndices.get(), layer.data(), image.data(), size);
+
 	// --- Create the actual texture surface ---
 
 	// Initialize it to pink, for high debug visibility
@@ -145,21 +163,36 @@ void PLTFile::load(Common::SeekableReadStream &plt) {
 }
 
 void PLTFile::build() {
-	/* For all layers, copy one whole row of pixels into the row buffer.
-	 * The row picked for each layer corresponds to the color index we want.
-	 * We don't care about the other rows, as they belong to other color indices. */
-	byte rows[4 * 256 * kLayerMAX];
-	getColorRows(rows, _colors);
-
 	const size_t pixels = _width * _height;
-	const uint8_t *image  = _dataImage.get();
-	const uint8_t *layer  = _dataLayers.get();
-	      byte  *dst    = _surface->getData();
-
-	/* Now iterate over all pixels, each time copying the correct BGRA values
-	 * for the pixel's intensity into the final image. */
-	for (size_t i = 0; i < pixels; i++, image++, layer++, dst += 4)
-		memcpy(dst, rows + (*layer * 4 * 256) + (*image * 4), 4);
+
+	PLTCompositor::Image image = PLTComp.getCached(_name, _colors);
+	if (!image) {
+		/* For all layers, copy one whole row of pixels into the color table.
+		 * The row picked for each layer corresponds to the color index we want.
+		 * We don't care about the other rows, as they belong to other color indices. */
+		uint32_t rows[256 * kLayerMAX];
+		getColorRows(rows, _colors);
+
+		/* Now look up the BGRA values of all pixels, by their layer and intensity. */
+		std::vector<byte> data(pixels * 4);
+		PLTComp.compose(data.data(), _dataIndices.get(), rows, pixels);
+
+		image = PLTComp.addCached(_name, _colors, std::move(data));
+	}
+
+	assert(image->size() == (pixels * 4));
+	std::memcpy(_surface->getData(), image->data(), pixels * 4);
+}
+
+void PLTFile::clearCache() {
+	{
+		std::lock_guard<std::mutex> lock(paletteMutex);
+
+		for (size_t i = 0; i < kLayerMAX; i++)
+			palettes[i].reset();
+	}
+
+	PLTComp.clearCache();
 }
 
 /** The palette image resource names for all layers. */
@@ -176,34 +209,42 @@ static const char * const kPalettes[PLTFile::kLayerMAX] = {
 	"pal_tattoo01"
 };
 
-/** Load a specific layer palette image and perform some sanity checks. */
-ImageDecoder *PLTFile::getLayerPalette(uint32_t layer, uint8_t row) {
+/** Get a specific layer palette image, loading it if necessary, and perform some sanity checks.
+ *
+ *  paletteMutex has to be locked.
+ */
+const ImageDecoder *PLTFile::getLayerPalette(uint32_t layer, uint8_t row) {
 	assert(layer < kLayerMAX);
 
-	// TODO: We may want to cache these somehow...
-	std::unique_ptr<ImageDecoder> palette(loadImage(kPalettes[layer]));
+	if (!palettes[layer]) {
+		std::unique_ptr<ImageDecoder> palette(loadImage(kPalettes[layer]));
 
-	if (palette->getFormat() != kPixelFormatBGRA)
-		throw Common::Exception("Invalid format (%d)", palette->getFormat());
+		if (palette->getFormat() != kPixelFormatBGRA)
+			throw Common::Exception("Invalid format (%d)", palette->getFormat());
 
-	if (palette->getMipMapCount() < 1)
-		throw Common::Exception("No mip maps");
+		if (palette->getMipMapCount() < 1)
+			throw Common::Exception("No mip maps");
 
-	const ImageDecoder::MipMap &mipMap = palette->getMipMap(0);
+		if (palette->getMipMap(0).width != 256)
+			throw Common::Exception("Invalid width (%d)", palette->getMipMap(0).width);
 
-	if (mipMap.width != 256)
-		throw Common::Exception("Invalid width (%d)", mipMap.width);
+		palettes[layer] = std::move(palette);
+	}
+
+	const ImageDecoder::MipMap &mipMap = palettes[layer]->getMipMap(0);
 
 	if (row >= mipMap.height)
 		throw Common::Exception("Invalid height (%d >= %d)", row, mipMap.height);
 
-	return palette.release();
+	return palettes[layer].get();
 }
 
-void PLTFile::getColorRows(byte rows[4 * 256 * kLayerMAX], const uint8_t colors[kLayerMAX]) {
-	for (size_t i = 0; i < kLayerMAX; i++, rows += 4 * 256) {
+void PLTFile::getColorRows(uint32_t rows[256 * kLayerMAX], const uint8_t colors[kLayerMAX]) {
+	std::lock_guard<std::mutex> lock(paletteMutex);
+
+	for (size_t i = 0; i < kLayerMAX; i++, rows += 256) {
 		try {
-			std::unique_ptr<ImageDecoder> palette(getLayerPalette(i, colors[i]));
+			const ImageDecoder *palette = getLayerPalette(i, colors[i]);
 
 			// The images have their origin at the bottom left, so we flip the color row
 			const uint8_t row = palette->getMipMap(0).height - 1 - colors[i];
@@ -213,11 +254,12 @@ void PLTFile::getColorRows(byte rows[4 * 256 * kLayerMAX], const uint8_t colors[
 
 		} catch (...) {
 			// On error set to pink (while honoring intensity), for high debug visibility
+			byte *pink = reinterpret_cast<byte *>(rows);
 			for (size_t p = 0; p < 256; p++) {
-				rows[p * 4 + 0] = p;
-				rows[p * 4 + 1] = 0x00;
-				rows[p * 4 + 2] = p;
-				rows[p * 4 + 3] = 0xFF;
+				pink[p * 4 + 0] = p;
+				pink[p * 4 + 1] = 0x00;
+				pink[p * 4 + 2] = p;
+				pink[p * 4 + 3] = 0xFF;
 			}
 
 			Common::exceptionDispatcherWarning("Failed to load palette \"%s\"", kPalettes[i]);
@@ -63,14 +63,17 @@ public:
 	bool isDynamic() const;
 	bool reload();
 
+	/** Forget the cached layer palettes and composited images. */
+	static void clearCache();
+
 
 private:
 	Common::UString _name;
 
 	Surface *_surface;
 
-	std::unique_ptr<uint8_t[]> _dataImage;
-	std::unique_ptr<uint8_t[]> _dataLayers;
+	/** For each pixel, the index into the color table of all layers. */
+	std::unique_ptr<uint16_t[]> _dataIndices;
 
 	uint8_t _colors[kLayerMAX];
 
@@ -80,8 +83,8 @@ private:
 	void load(Common::SeekableReadStream &plt);
 	void build();
 
-	static ImageDecoder *getLayerPalette(uint32_t layer, uint8_t row);
-	static void getColorRows(byte rows[4 * 256 * kLayerMAX], const uint8_t colors[kLayerMAX]);
+	static const ImageDecoder *getLayerPalette(uint32_t layer, uint8_t row);
+	static void getColorRows(uint32_t rows[256 * kLayerMAX], const uint8_t colors[kLayerMAX]);
 
 	friend class Texture;
 };
@@ -25,6 +25,7 @@ src_graphics_libgraphics_la_SOURCES += \
     src/graphics/aurora/texturehandle.h \
     src/graphics/aurora/textureman.h \
     src/graphics/aurora/pltfile.h \
+    src/graphics/aurora/pltcompositor.h \
     src/graphics/aurora/cursor.h \
     src/graphics/aurora/cursorman.h \
     src/graphics/aurora/texturefont.h \
@@ -68,6 +69,7 @@ src_graphics_libgraphics_la_SOURCES += \
     src/graphics/aurora/texturehandle.cpp \
     src/graphics/aurora/textureman.cpp \
     src/graphics/aurora/pltfile.cpp \
+    src/graphics/aurora/pltcompositor.cpp \
     src/graphics/aurora/cursor.cpp \
     src/graphics/aurora/cursorman.cpp \
     src/graphics/aurora/texturefont.cpp \
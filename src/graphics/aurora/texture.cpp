@@ -32,11 +32,13 @@
 
 #include "src/graphics/aurora/texture.h"
 #include "src/graphics/aurora/pltfile.h"
+#include "src/graphics/aurora/textureman.h"
 
 #include "src/graphics/types.h"
 #include "src/graphics/graphics.h"
 #include "src/graphics/images/txi.h"
 #include "src/graphics/images/decoder.h"
+#include "src/graphics/images/surface.h"
 #include "src/graphics/images/cubemapcombiner.h"
 #include "src/graphics/images/tga.h"
 #include "src/graphics/images/dds.h"
@@ -44,6 +46,7 @@
 #include "src/graphics/images/txb.h"
 #include "src/graphics/images/sbm.h"
 #include "src/graphics/images/xoreositex.h"
+#include "src/graphics/images/texturecache.h"
 
 #include "src/events/requests.h"
 
@@ -55,12 +58,15 @@ namespace Graphics {
 
 namespace Aurora {
 
-Texture::Texture() : _type(::Aurora::kFileTypeNone), _width(0), _height(0), _deswizzle(false) {
+Texture::Texture() : _type(::Aurora::kFileTypeNone), _width(0), _height(0),
+	_imageSize(0), _hasImageData(false), _deswizzle(false) {
+
 }
 
 Texture::Texture(const Common::UString &name, ImageDecoder *image,
                  ::Aurora::FileType type, TXI *txi, bool deswizzle) :
-	_name(name), _type(type), _width(0), _height(0), _deswizzle(deswizzle) {
+	_name(name), _type(type), _width(0), _height(0),
+	_imageSize(0), _hasImageData(false), _deswizzle(deswizzle) {
 
 	set(name, image, type, txi, deswizzle);
 	addToQueues();
@@ -137,12 +143,44 @@ bool Texture::reload() {
 }
 
 bool Texture::dumpTGA(const Common::UString &fileName) const {
-	if (!_image)
+	if (!_image || !_hasImageData)
 		return false;
 
 	return _image->dumpTGA(fileName);
 }
 
+size_t Texture::getImageSize() const {
+	return _imageSize;
+}
+
+bool Texture::hasImageData() const {
+	return _hasImageData;
+}
+
+bool Texture::isUploaded() const {
+	return _textureID != 0;
+}
+
+bool Texture::isEvictable() const {
+	// Only textures we can load again from their resource
+	return !_name.empty() && !isDynamic() && (_type != ::Aurora::kFileTypeNone);
+}
+
+void Texture::evictImageData() {
+	if (!isEvictable() || !_hasImageData)
+		return;
+
+	_image->freeData();
+	_hasImageData = false;
+}
+
+void Texture::evictTexture() {
+	if (!isEvictable())
+		return;
+
+	destroy();
+}
+
 void Texture::doDestroy() {
 	if (_textureID == 0)
 		return;
@@ -153,8 +191,8 @@ void Texture::doDestroy() {
 }
 
 void Texture::doRebuild() {
-	if (!_image)
-		// No image
+	if (!_image || !_hasImageData)
+		// No image, or its data was evicted and needs to be restored first
 		return;
 
 	// Generate the texture ID
@@ -383,6 +421,26 @@ Texture *Texture::create(ImageDecoder *image, ::Aurora::FileType type, TXI *txi,
 	return new Texture("", image, type, txi, deswizzle);
 }
 
+Texture *Texture::createPlaceholder(const Common::UString &name, bool deswizzle) {
+	// A fully transparent pixel, until the real image is there
+	Surface *image = new Surface(1, 1);
+	image->fill(0x00, 0x00, 0x00, 0x00);
+
+	return new Texture(name, image, ::Aurora::kFileTypeNone, loadTXI(name), deswizzle);
+}
+
+ImageDecoder *Texture::decodeImage(::Aurora::FileType &type) const {
+	return loadImage(_name, type, _txi.get(), _deswizzle);
+}
+
+void Texture::setImage(ImageDecoder *image, ::Aurora::FileType type) {
+	if (!image)
+		throw Common::Exception("Can't set an empty image");
+
+	set(_name, image, type, _txi.release(), _deswizzle);
+	rebuild();
+}
+
 void Texture::set(const Common::UString &name, ImageDecoder *image, ::Aurora::FileType type,
                   TXI *txi, bool deswizzle) {
 
@@ -395,6 +453,13 @@ void Texture::set(const Common::UString &name, ImageDecoder *image, ::Aurora::Fi
 	_width  = _image->getMipMap(0).width;
 	_height = _image->getMipMap(0).height;
 
+	_imageSize = 0;
+	for (size_t i = 0; i < _image->getLayerCount(); i++)
+		for (size_t j = 0; j < _image->getMipMapCount(); j++)
+			_imageSize += _image->getMipMap(j, i).size;
+
+	_hasImageData = true;
+
 	_deswizzle = deswizzle;
 }
 
@@ -457,14 +522,43 @@ ImageDecoder *Texture::loadImage(const Common::UString &name, ::Aurora::FileType
 	}
 }
 
+/** Does loading an image of this type take enough work to keep the result in the disk cache? */
+static bool isCacheable(::Aurora::FileType type) {
+	// Swizzled, palettized or otherwise involved formats
+	if ((type == ::Aurora::kFileTypeSBM) || (type == ::Aurora::kFileTypeTXB) || (type == ::Aurora::kFileTypeTPC))
+		return true;
+
+	// DDS are just raw DXT data, unless we have to decompress them ourselves
+	if (type == ::Aurora::kFileTypeDDS)
+		return GfxMan.needManualDeS3TC();
+
+	return false;
+}
+
 ImageDecoder *Texture::loadImage(Common::SeekableReadStream *imageStream, ::Aurora::FileType type,
                                  TXI *txi, bool deswizzle) {
 
 	// Check for a cube map, but only those that don't use a file for each side
 	const bool isCubeMap = txi && txi->getFeatures().cube && (txi->getFeatures().fileRange == 0);
 
+	const TextureCache *cache = isCacheable(type) ? TextureMan.getDiskCache() : 0;
+	uint64_t cacheKey = 0;
+
 	ImageDecoder *image = 0;
 	try {
+		if (cache) {
+			const uint32_t options = ((uint32_t) type) | (deswizzle ? 0x10000 : 0) | (isCubeMap ? 0x20000 : 0) |
+			                         (GfxMan.needManualDeS3TC() ? 0x40000 : 0);
+
+			cacheKey = TextureCache::getKey(*imageStream, options);
+
+			image = cache->load(cacheKey);
+			if (image) {
+				delete imageStream;
+				return image;
+			}
+		}
+
 		// Loading the different image formats
 		if      (type == ::Aurora::kFileTypeTGA)
 			image = new TGA(*imageStream, isCubeMap);
@@ -488,6 +582,9 @@ ImageDecoder *Texture::loadImage(Common::SeekableReadStream *imageStream, ::Auro
 		if (GfxMan.needManualDeS3TC())
 			image->decompress();
 
+		if (cache)
+			cache->save(cacheKey, *image);
+
 	} catch (...) {
 		delete image;
 		delete imageStream;
@@ -69,6 +69,20 @@ public:
 	/** Dump the texture into a TGA. */
 	bool dumpTGA(const Common::UString &fileName) const;
 
+	/** Return the size of the image data in bytes, whether it's currently in memory or not. */
+	size_t getImageSize() const;
+	/** Is the image data currently in memory? */
+	bool hasImageData() const;
+	/** Is the texture currently uploaded to the GPU? */
+	bool isUploaded() const;
+
+	/** Can this texture be evicted, and later be restored from its image resource? */
+	bool isEvictable() const;
+	/** Free the image data in memory, keeping only the properties of the image. */
+	void evictImageData();
+	/** Free the texture on the GPU. Restoring it needs decodeImage() and setImage(). */
+	void evictTexture();
+
 
 	/** Load an image in any of the common texture formats. */
 	static ImageDecoder *loadImage(const Common::UString &name, bool deswizzle = false);
@@ -82,6 +96,21 @@ public:
 	static Texture *create(ImageDecoder *image, ::Aurora::FileType type = ::Aurora::kFileTypeNone,
 	                       TXI *txi = 0, bool deswizzle = false);
 
+	/** Create an empty placeholder for this image resource.
+	 *
+	 *  Only the TXI is loaded right away. The image itself can then be
+	 *  decoded with decodeImage() and put into the texture with setImage().
+	 */
+	static Texture *createPlaceholder(const Common::UString &name, bool deswizzle = false);
+
+	/** Decode the image resource of this texture, without changing the texture.
+	 *
+	 *  This can be called from any thread.
+	 */
+	ImageDecoder *decodeImage(::Aurora::FileType &type) const;
+	/** Take over this image, replacing the current one, and upload it. */
+	void setImage(ImageDecoder *image, ::Aurora::FileType type);
+
 
 protected:
 	Common::UString    _name; ///< The name of the texture's image's file.
@@ -93,6 +122,9 @@ protected:
 	uint32_t _width;
 	uint32_t _height;
 
+	size_t _imageSize;  ///< The size of the image data in bytes.
+	bool _hasImageData; ///< Is the image data in memory, or was it evicted?
+
 	bool _deswizzle;
 
 
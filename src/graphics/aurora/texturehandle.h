@@ -41,6 +41,9 @@ struct ManagedTexture {
 	Texture *texture;
 	uint32_t referenceCount;
 
+	uint32_t lastUsed; ///< The frame the texture was last used in.
+	bool restoring;    ///< Is the evicted texture being restored?
+
 	ManagedTexture(Texture *t);
 	~ManagedTexture();
 };
@@ -23,15 +23,22 @@
  */
 
 #include <memory>
+#include <vector>
+#include <algorithm>
 
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/uuid.h"
+#include "src/common/threadpool.h"
+
+#include "src/aurora/resman.h"
 
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/texture.h"
+#include "src/graphics/aurora/pltfile.h"
 
 #include "src/graphics/images/decoder.h"
+#include "src/graphics/images/texturecache.h"
 
 #include "src/graphics/graphics.h"
 
@@ -80,8 +87,13 @@ static GLenum kTextureUnit[] = {
 
 static const size_t kTextureUnitCount = ARRAYSIZE(kTextureUnit);
 
+/** The maximum number of asynchronously decoded textures uploaded each frame. */
+static const size_t kMaxAsyncUploadsPerFrame = 8;
+
+
+TextureManager::TextureManager() : _deswizzleSBM(false), _recordNewTextures(false), _frame(0), _budget(0),
+	_imageEvictions(0), _textureEvictions(0), _restores(0) {
 
-TextureManager::TextureManager() : _deswizzleSBM(false), _recordNewTextures(false) {
 }
 
 TextureManager::~TextureManager() {
@@ -89,6 +101,8 @@ TextureManager::~TextureManager() {
 }
 
 void TextureManager::clear() {
+	stopAsync();
+
 	std::lock_guard<std::recursive_mutex> lock(_mutex);
 
 	_bogusTextures.clear();
@@ -97,6 +111,8 @@ void TextureManager::clear() {
 		delete t->second;
 	_textures.clear();
 
+	PLTFile::clearCache();
+
 	_deswizzleSBM = false;
 
 	_recordNewTextures = false;
@@ -141,6 +157,8 @@ TextureHandle TextureManager::add(Texture *texture, Common::UString name) {
 	if (!result.second)
 		throw Common::Exception("Texture \"%s\" already exists", name.c_str());
 
+	managedTexture->lastUsed = _frame;
+
 	managedTexture.release();
 	TextureMap::iterator textureIterator = result.first;
 
@@ -151,24 +169,39 @@ TextureHandle TextureManager::add(Texture *texture, Common::UString name) {
 }
 
 TextureHandle TextureManager::get(Common::UString name) {
-	std::lock_guard<std::recursive_mutex> lock(_mutex);
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
 
-	if (_bogusTextures.find(name) != _bogusTextures.end())
-		return TextureHandle();
+		if (_bogusTextures.find(name) != _bogusTextures.end())
+			return TextureHandle();
 
-	TextureMap::iterator texture = _textures.find(name);
-	if (texture == _textures.end()) {
-		std::pair<TextureMap::iterator, bool> result;
+		TextureMap::iterator texture = _textures.find(name);
+		if (texture != _textures.end()) {
+			if (_recordNewTextures)
+				_newTextureNames.push_back(name);
+
+			return TextureHandle(texture);
+		}
+	}
 
-		ManagedTexture *managedTexture = new ManagedTexture(Texture::create(name, _deswizzleSBM));
+	/* Load the texture without holding the lock, so that other threads can
+	 * load other textures at the same time. If another thread loads the same
+	 * texture in the meantime, we throw ours away again below. */
+	std::unique_ptr<ManagedTexture> managedTexture =
+		std::make_unique<ManagedTexture>(Texture::create(name, _deswizzleSBM));
 
-		if (managedTexture->texture->isDynamic())
-			name = name + "#" + Common::generateIDRandomString();
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
 
-		result = _textures.insert(std::make_pair(name, managedTexture));
+	if (managedTexture->texture->isDynamic())
+		name = name + "#" + Common::generateIDRandomString();
 
-		texture = result.first;
-	}
+	managedTexture->lastUsed = _frame;
+
+	std::pair<TextureMap::iterator, bool> result = _textures.insert(std::make_pair(name, managedTexture.get()));
+	if (result.second)
+		managedTexture.release();
+
+	TextureMap::iterator texture = result.first;
 
 	if (_recordNewTextures)
 		_newTextureNames.push_back(name);
@@ -189,6 +222,141 @@ TextureHandle TextureManager::getIfExist(const Common::UString &name) {
 	return TextureHandle();
 }
 
+TextureHandle TextureManager::getAsync(Common::UString name) {
+	TextureHandle handle;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+		if (_bogusTextures.find(name) != _bogusTextures.end())
+			return TextureHandle();
+
+		TextureMap::iterator texture = _textures.find(name);
+		if (texture != _textures.end()) {
+			if (_recordNewTextures)
+				_newTextureNames.push_back(name);
+
+			return TextureHandle(texture);
+		}
+
+		/* Cube maps made out of several files and PLTs, which are dynamic textures,
+		 * are loaded directly. That also throws if the image doesn't exist at all. */
+		if (!ResMan.hasResource(name, ::Aurora::kResourceImage) || ResMan.hasResource(name, ::Aurora::kFileTypePLT))
+			return get(name);
+
+		std::unique_ptr<ManagedTexture> managedTexture =
+			std::make_unique<ManagedTexture>(Texture::createPlaceholder(name, _deswizzleSBM));
+
+		managedTexture->lastUsed = _frame;
+
+		texture = _textures.insert(std::make_pair(name, managedTexture.get())).first;
+		managedTexture.release();
+
+		if (_recordNewTextures)
+			_newTextureNames.push_back(name);
+
+		handle = TextureHandle(texture);
+	}
+
+	queueDecode(handle);
+
+	return handle;
+}
+
+void TextureManager::queueDecode(const TextureHandle &texture) {
+	std::lock_guard<std::mutex> lock(_asyncMutex);
+
+	if (!_asyncThreads)
+		_asyncThreads = std::make_unique<Common::ThreadPool>("TextureDecoder");
+
+	_asyncThreads->addJob(std::bind(&TextureManager::decodeAsync, this, texture));
+}
+
+void TextureManager::decodeAsync(TextureHandle texture) {
+	AsyncTexture decoded;
+
+	decoded.handle = texture;
+	decoded.type   = ::Aurora::kFileTypeNone;
+
+	try {
+		decoded.image.reset(texture.getTexture().decodeImage(decoded.type));
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed to decode texture \"%s\"", texture.getName().c_str());
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(_asyncMutex);
+
+	_asyncTextures.push_back(std::move(decoded));
+}
+
+void TextureManager::uploadAsyncTextures() {
+	std::list<AsyncTexture> textures;
+
+	{
+		std::lock_guard<std::mutex> lock(_asyncMutex);
+
+		std::list<AsyncTexture>::iterator end = _asyncTextures.begin();
+		for (size_t i = 0; (i < kMaxAsyncUploadsPerFrame) && (end != _asyncTextures.end()); i++)
+			++end;
+
+		textures.splice(textures.end(), _asyncTextures, _asyncTextures.begin(), end);
+	}
+
+	for (std::list<AsyncTexture>::iterator t = textures.begin(); t != textures.end(); ++t) {
+		try {
+			t->handle.getTexture().setImage(t->image.release(), t->type);
+			t->handle._it->second->restoring = false;
+		} catch (...) {
+			Common::exceptionDispatcherWarning("Failed to upload texture \"%s\"", t->handle.getName().c_str());
+		}
+	}
+}
+
+void TextureManager::stopAsync() {
+	std::unique_ptr<Common::ThreadPool> threads;
+
+	{
+		std::lock_guard<std::mutex> lock(_asyncMutex);
+
+		threads = std::move(_asyncThreads);
+	}
+
+	// Drop all textures still waiting to be decoded, and wait for the ones being decoded right now
+	if (threads) {
+		threads->cancelJobs();
+		threads.reset();
+	}
+
+	std::list<AsyncTexture> textures;
+
+	{
+		std::lock_guard<std::mutex> lock(_asyncMutex);
+
+		textures.swap(_asyncTextures);
+	}
+}
+
+void TextureManager::setDiskCache(const Common::UString &directory) {
+	_diskCache.reset();
+
+	if (directory.empty())
+		return;
+
+	try {
+		_diskCache = std::make_unique<TextureCache>(directory);
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Disabling the texture cache");
+		return;
+	}
+
+	status("Caching decoded textures in \"%s\"", directory.c_str());
+}
+
+const TextureCache *TextureManager::getDiskCache() const {
+	return _diskCache.get();
+}
+
 void TextureManager::startRecordNewTextures() {
 	std::lock_guard<std::recursive_mutex> lock(_mutex);
 
@@ -234,6 +402,9 @@ void TextureManager::reloadAll() {
 
 	GfxMan.lockFrame();
 
+	// The PLT layer palettes might have changed too
+	PLTFile::clearCache();
+
 	for (TextureMap::iterator texture = _textures.begin(); texture != _textures.end(); ++texture) {
 		try {
 			texture->second->texture->reload();
@@ -280,8 +451,8 @@ void TextureManager::set(const TextureHandle &handle, TextureMode mode) {
 		return;
 	}
 
-	TextureID id = handle._it->second->texture->getID();
-	if (id == 0)
+	TextureID id = use(handle);
+	if ((id == 0) && !handle._it->second->restoring)
 		warning("Empty texture ID for texture \"%s\"", handle._it->first.c_str());
 
 	if (handle._it->second->texture->getImage().isCubeMap()) {
@@ -332,6 +503,129 @@ void TextureManager::activeTexture(size_t n) {
 	glActiveTextureARB(kTextureUnit[n]);
 }
 
+TextureID TextureManager::use(const TextureHandle &handle) {
+	if (handle.empty())
+		return 0;
+
+	ManagedTexture &texture = *handle._it->second;
+
+	texture.lastUsed = _frame;
+
+	if (!texture.texture->isUploaded() && !texture.texture->hasImageData() && !texture.restoring) {
+		// The texture was evicted. Decode it again in the background
+		texture.restoring = true;
+		_restores++;
+
+		queueDecode(handle);
+	}
+
+	return texture.texture->getID();
+}
+
+void TextureManager::setBudget(size_t budget) {
+	_budget = budget;
+}
+
+void TextureManager::enforceBudget() {
+	_frame++;
+
+	if (_budget == 0)
+		return;
+
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	size_t size = 0;
+	std::vector<ManagedTexture *> unused;
+
+	for (TextureMap::iterator t = _textures.begin(); t != _textures.end(); ++t) {
+		const Texture &texture = *t->second->texture;
+
+		if (texture.hasImageData())
+			size += texture.getImageSize();
+		if (texture.isUploaded())
+			size += texture.getImageSize();
+
+		if (texture.isEvictable() && ((_frame - t->second->lastUsed) > 1))
+			unused.push_back(t->second);
+	}
+
+	if (size <= _budget)
+		return;
+
+	std::sort(unused.begin(), unused.end(), [](const ManagedTexture *a, const ManagedTexture *b) {
+		return a->lastUsed < b->lastUsed;
+	});
+
+	// Free the image data of textures that are on the GPU anyway
+	for (std::vector<ManagedTexture *>::iterator t = unused.begin(); (t != unused.end()) && (size > _budget); ++t) {
+		Texture &texture = *(*t)->texture;
+
+		if (!texture.hasImageData() || !texture.isUploaded())
+			continue;
+
+		texture.evictImageData();
+		size -= texture.getImageSize();
+
+		_imageEvictions++;
+	}
+
+	// If that's not enough, free the textures on the GPU as well
+	for (std::vector<ManagedTexture *>::iterator t = unused.begin(); (t != unused.end()) && (size > _budget); ++t) {
+		Texture &texture = *(*t)->texture;
+
+		if (texture.hasImageData() || !texture.isUploaded() || (*t)->restoring)
+			continue;
+
+		texture.evictTexture();
+		size -= texture.getImageSize();
+
+		_textureEvictions++;
+	}
+}
+
+TextureManager::Stats TextureManager::getStats() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	Stats stats;
+
+	stats.count            = _textures.size();
+	stats.imageDataSize    = 0;
+	stats.textureSize      = 0;
+	stats.budget           = _budget;
+	stats.imageEvictions   = _imageEvictions;
+	stats.textureEvictions = _textureEvictions;
+	stats.restores         = _restores;
+
+	for (TextureMap::const_iterator t = _textures.begin(); t != _textures.end(); ++t) {
+		const Texture &texture = *t->second->texture;
+
+		if (texture.hasImageData())
+			stats.imageDataSize += texture.getImageSize();
+		if (texture.isUploaded())
+			stats.textureSize   += texture.getImageSize();
+	}
+
+	return stats;
+}
+
+void TextureManager::getResidency(std::list<Residency> &residency) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	for (TextureMap::const_iterator t = _textures.begin(); t != _textures.end(); ++t) {
+		const Texture &texture = *t->second->texture;
+
+		Residency r;
+
+		r.name         = t->first;
+		r.size         = texture.getImageSize();
+		r.inMemory     = texture.hasImageData();
+		r.onGPU        = texture.isUploaded();
+		r.framesUnused = _frame - t->second->lastUsed;
+
+		residency.push_back(r);
+	}
+}
+
 } // End of namespace Aurora
 
 } // End of namespace Graphics
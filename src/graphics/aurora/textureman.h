@@ -27,16 +27,28 @@
 
 #include <set>
 #include <list>
+#include <memory>
+#include <atomic>
 
 #include "src/common/types.h"
 #include "src/common/singleton.h"
 #include "src/common/ustring.h"
 #include "src/common/mutex.h"
 
+#include "src/aurora/types.h"
+
+#include "src/graphics/types.h"
 #include "src/graphics/aurora/texturehandle.h"
 
+namespace Common {
+	class ThreadPool;
+}
+
 namespace Graphics {
 
+class ImageDecoder;
+class TextureCache;
+
 namespace Aurora {
 
 /** The global Aurora texture manager. */
@@ -48,6 +60,26 @@ public:
 		kModeEnvironmentMapReflective ///< A reflective environment map.
 	};
 
+	/** Statistics about the memory used by the textures. */
+	struct Stats {
+		size_t count;            ///< Number of managed textures.
+		size_t imageDataSize;    ///< Bytes of image data in memory.
+		size_t textureSize;      ///< Estimated bytes of texture data on the GPU.
+		size_t budget;           ///< The memory budget in bytes, 0 if there is none.
+		size_t imageEvictions;   ///< Number of times image data was evicted from memory.
+		size_t textureEvictions; ///< Number of times a texture was evicted from the GPU.
+		size_t restores;         ///< Number of times an evicted texture was restored.
+	};
+
+	/** Where a texture currently resides. */
+	struct Residency {
+		Common::UString name;
+		size_t size;          ///< The size of the image data in bytes.
+		bool inMemory;        ///< Is the image data in memory?
+		bool onGPU;           ///< Is the texture uploaded to the GPU?
+		uint32_t framesUnused; ///< Number of frames since the texture was last used.
+	};
+
 	TextureManager();
 	~TextureManager();
 
@@ -81,6 +113,13 @@ public:
 	/** Retrieve this named texture, returning an empty handle if it's not managed. */
 	TextureHandle getIfExist(const Common::UString &name);
 
+	/** Retrieve this named texture, decoding it in the background if it's not yet managed.
+	 *
+	 *  Until its image has been decoded and uploaded, the texture is an empty
+	 *  1x1 placeholder. Only the TXI is available right away.
+	 */
+	TextureHandle getAsync(Common::UString name);
+
 	/** Start recording all names of newly created textures. */
 	void startRecordNewTextures();
 	/** Stop the recording of texture names, and return a list of previously recorded names. */
@@ -90,6 +129,13 @@ public:
 	void reloadAll();
 	// '---
 
+	// .--- Disk cache
+	/** Keep decoded images that took a lot of work in this directory. Empty to disable the cache. */
+	void setDiskCache(const Common::UString &directory);
+	/** Return the disk cache for decoded images, or 0 if there is none. */
+	const TextureCache *getDiskCache() const;
+	// '---
+
 	// .--- Texture rendering
 	/** Bind this texture to the current texture unit. */
 	void set(const TextureHandle &handle, TextureMode mode = kModeDiffuse);
@@ -100,9 +146,50 @@ public:
 
 	/** Set this texture unit as the current one. */
 	void activeTexture(size_t n);
+
+	/** Mark this texture as used in this frame, and return its ID for binding.
+	 *
+	 *  If the texture has been evicted, it is restored in the background
+	 *  and 0 is returned until then.
+	 */
+	TextureID use(const TextureHandle &handle);
+
+	/** Upload a limited number of textures decoded in the background.
+	 *
+	 *  Needs to be called from the main thread, once per frame.
+	 */
+	void uploadAsyncTextures();
+	// '---
+
+	// .--- Memory budget
+	/** Set the memory budget for image data and textures in bytes. 0 means no budget. */
+	void setBudget(size_t budget);
+
+	/** Evict the least recently used textures until the memory budget is met.
+	 *
+	 *  First, the image data of textures already on the GPU is freed. If that's
+	 *  not enough, textures are freed from the GPU as well. Textures used in the
+	 *  last frame are never evicted.
+	 *
+	 *  Needs to be called from the main thread, once per frame.
+	 */
+	void enforceBudget();
+
+	/** Return statistics about the memory used by the textures. */
+	Stats getStats();
+	/** Return where all textures currently reside. */
+	void getResidency(std::list<Residency> &residency);
 	// '---
 
 private:
+	/** A texture requested by getAsync() that has been decoded. */
+	struct AsyncTexture {
+		TextureHandle handle;
+		::Aurora::FileType type;
+		std::unique_ptr<ImageDecoder> image;
+	};
+
+
 	bool _deswizzleSBM;
 	TextureMap _textures;
 
@@ -113,9 +200,31 @@ private:
 	bool _recordNewTextures;
 	std::list<Common::UString> _newTextureNames;
 
+	/** The worker threads decoding the textures requested by getAsync(). */
+	std::unique_ptr<Common::ThreadPool> _asyncThreads;
+	/** Decoded textures waiting to be uploaded. */
+	std::list<AsyncTexture> _asyncTextures;
+	/** Protects the worker threads and the decoded textures. */
+	std::mutex _asyncMutex;
+
+	/** The disk cache for decoded images. */
+	std::unique_ptr<TextureCache> _diskCache;
+
+	std::atomic<uint32_t> _frame; ///< The current frame, for finding the least recently used textures.
+
+	size_t _budget; ///< The memory budget in bytes.
+
+	size_t _imageEvictions;
+	size_t _textureEvictions;
+	size_t _restores;
+
 	void assign(TextureHandle &texture, const TextureHandle &from);
 	void release(TextureHandle &texture);
 
+	void queueDecode(const TextureHandle &texture);
+	void decodeAsync(TextureHandle texture);
+	void stopAsync();
+
 	friend class TextureHandle;
 };
 
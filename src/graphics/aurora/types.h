@@ -29,6 +29,7 @@
 #include <memory>
 
 #include "src/common/ustring.h"
+#include "src/common/mutex.h"
 
 #include "src/graphics/types.h"
 
@@ -58,7 +59,15 @@ class ModelNode;
 class Text;
 class GUIQuad;
 
-typedef std::map<Common::UString, std::unique_ptr<Model>, Common::UString::iless> ModelCache;
+/** A cache of loaded models, indexed by name. */
+struct ModelCache {
+	typedef std::map<Common::UString, std::unique_ptr<Model>, Common::UString::iless> ModelMap;
+
+	ModelMap models;
+
+	/** Protects the cache, so that models can be loaded from several threads. */
+	std::recursive_mutex mutex;
+};
 
 } // End of namespace Aurora
 
@@ -26,6 +26,7 @@
 #include <cstring>
 
 #include <functional>
+#include <chrono>
 
 #include "external/glm/gtc/type_ptr.hpp"
 #include "external/glm/gtc/matrix_transform.hpp"
@@ -67,6 +68,8 @@
 
 #include "src/graphics/render/renderman.h"
 
+#include "src/graphics/aurora/textureman.h"
+
 DECLARE_SINGLETON(Graphics::GraphicsManager)
 
 static glm::mat4 inverse(const glm::mat4 &m);
@@ -105,6 +108,9 @@ GraphicsManager::GraphicsManager() : Events::Notifyable() {
 
 	_fpsCounter = std::make_unique<FPSCounter>(3);
 
+	_distanceTime.store(0);
+	_sortTime.store(0);
+
 	_frameLock.store(0);
 
 	_cursor = 0;
@@ -180,6 +186,18 @@ void GraphicsManager::init() {
 	MaterialMan.init();
 	MeshMan.init();
 
+	// Memory budget for the texture images and the textures on the GPU, in MiB
+	TextureMan.setBudget(((size_t) MAX(ConfigMan.getInt("texturebudget", 0), 0)) * 1024 * 1024);
+
+	// Directory to keep decoded textures in, so that they load faster the next time
+	TextureMan.setDiskCache(ConfigMan.getString("texturecache"));
+
+	// Weld and reorder the vertices of static model meshes
+	MeshMan.setOptimize(ConfigMan.getBool("optimizemeshes", false));
+
+	// Store the vertices of static model meshes in 16-bit integers
+	MeshMan.setQuantize(ConfigMan.getBool("quantizemeshes", false));
+
 	if (!_animationThread.createThread("Animations"))
 		throw Common::Exception("Failed to create the animation thread");
 
@@ -242,6 +260,14 @@ uint32_t GraphicsManager::getFPS() const {
 	return _fpsCounter->getFPS();
 }
 
+uint32_t GraphicsManager::getDistanceTime() const {
+	return _distanceTime.load(std::memory_order_relaxed);
+}
+
+uint32_t GraphicsManager::getSortTime() const {
+	return _sortTime.load(std::memory_order_relaxed);
+}
+
 bool GraphicsManager::setFSAA(int level) {
 	// Force calling it from the main thread
 	if (!Common::isMainThread()) {
@@ -813,35 +839,48 @@ void GraphicsManager::unlockFrame() {
 }
 
 void GraphicsManager::recalculateObjectDistances() {
-	// World objects
+	/* Only world objects have a distance that depends on the camera. GUI
+	 * objects calculate their distance themselves when they move, and
+	 * request a resort then.
+	 *
+	 * We don't sort here. The queue is only marked as unsorted, and it
+	 * is sorted once before it's rendered the next time, no matter how
+	 * often it has been touched in the meantime. */
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
 
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o)
-		static_cast<Renderable *>(*o)->calculateDistance();
+	const std::vector<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	for (size_t i = 0; i < objects.size(); i++)
+		if (objects[i])
+			static_cast<Renderable *>(objects[i])->calculateDistance();
 
-	QueueMan.sortQueue(kQueueVisibleWorldObject);
+	QueueMan.markQueueUnsorted(kQueueVisibleWorldObject);
 	QueueMan.unlockQueue(kQueueVisibleWorldObject);
 
-	// GUI front objects
-	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	_distanceTime.store(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(),
+	                    std::memory_order_relaxed);
+}
 
-	const std::list<Queueable *> &guiFront = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
-	for (std::list<Queueable *>::const_iterator g = guiFront.begin(); g != guiFront.end(); ++g)
-		static_cast<Renderable *>(*g)->calculateDistance();
+void GraphicsManager::sortQueues() {
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-	QueueMan.sortQueue(kQueueVisibleGUIFrontObject);
-	QueueMan.unlockQueue(kQueueVisibleGUIFrontObject);
+	// Get rid of the empty slots objects left when leaving a queue
+	for (int i = 0; i < kQueueMAX; i++)
+		QueueMan.compactQueue((QueueType) i);
 
-	// GUI back objects
-	QueueMan.lockQueue(kQueueVisibleGUIBackObject);
+	QueueMan.sortQueueIfUnsorted(kQueueVisibleGUIBackObject);
+	QueueMan.sortQueueIfUnsorted(kQueueVisibleWorldObject);
+	QueueMan.sortQueueIfUnsorted(kQueueVisibleGUIFrontObject);
+	QueueMan.sortQueueIfUnsorted(kQueueVisibleGUIConsoleObject);
 
-	const std::list<Queueable *> &guiBack = QueueMan.getQueue(kQueueVisibleGUIBackObject);
-	for (std::list<Queueable *>::const_iterator g = guiBack.begin(); g != guiBack.end(); ++g)
-		static_cast<Renderable *>(*g)->calculateDistance();
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
-	QueueMan.sortQueue(kQueueVisibleGUIBackObject);
-	QueueMan.unlockQueue(kQueueVisibleGUIBackObject);
+	_sortTime.store(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(),
+	                std::memory_order_relaxed);
 }
 
 uint32_t GraphicsManager::createRenderableID() {
@@ -907,11 +946,16 @@ Renderable *GraphicsManager::getGUIObjectAt(float x, float y) const {
 	Renderable *object = 0;
 
 	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
+	QueueMan.sortQueueIfUnsorted(kQueueVisibleGUIFrontObject);
+
+	const std::vector<Queueable *> &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
 
 	// Go through the GUI elements, from nearest to furthest
-	for (std::list<Queueable *>::const_iterator g = gui.begin(); g != gui.end(); ++g) {
-		Renderable &r = static_cast<Renderable &>(**g);
+	for (size_t i = 0; i < gui.size(); i++) {
+		if (!gui[i])
+			continue;
+
+		Renderable &r = static_cast<Renderable &>(*gui[i]);
 
 		if (!r.isClickable())
 			// Object isn't clickable, don't check
@@ -939,10 +983,15 @@ Renderable *GraphicsManager::getWorldObjectAt(float x, float y) const {
 	Renderable *object = 0;
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	QueueMan.sortQueueIfUnsorted(kQueueVisibleWorldObject);
 
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o) {
-		Renderable &r = static_cast<Renderable &>(**o);
+	const std::vector<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+
+	for (size_t i = 0; i < objects.size(); i++) {
+		if (!objects[i])
+			continue;
+
+		Renderable &r = static_cast<Renderable &>(*objects[i]);
 
 		if (!r.isClickable())
 			// Object isn't clickable, don't check
@@ -973,26 +1022,28 @@ Renderable *GraphicsManager::getObjectAt(float x, float y) {
 
 void GraphicsManager::buildNewTextures() {
 	QueueMan.lockQueue(kQueueNewShader);
-	const std::list<Queueable *> &shadq = QueueMan.getQueue(kQueueNewShader);
+	const std::vector<Queueable *> &shadq = QueueMan.getQueue(kQueueNewShader);
 	if (shadq.empty()) {
 		QueueMan.unlockQueue(kQueueNewShader);
 	} else {
-		for (std::list<Queueable *>::const_iterator t = shadq.begin(); t != shadq.end(); ++t)
-			static_cast<GLContainer *>(*t)->rebuild();
+		for (size_t i = 0; i < shadq.size(); i++)
+			if (shadq[i])
+				static_cast<GLContainer *>(shadq[i])->rebuild();
 
 		QueueMan.clearQueue(kQueueNewShader);
 		QueueMan.unlockQueue(kQueueNewShader);
 	}
 
 	QueueMan.lockQueue(kQueueNewTexture);
-	const std::list<Queueable *> &text = QueueMan.getQueue(kQueueNewTexture);
+	const std::vector<Queueable *> &text = QueueMan.getQueue(kQueueNewTexture);
 	if (text.empty()) {
 		QueueMan.unlockQueue(kQueueNewTexture);
 		return;
 	}
 
-	for (std::list<Queueable *>::const_iterator t = text.begin(); t != text.end(); ++t)
-		static_cast<GLContainer *>(*t)->rebuild();
+	for (size_t i = 0; i < text.size(); i++)
+		if (text[i])
+			static_cast<GLContainer *>(text[i])->rebuild();
 
 	QueueMan.clearQueue(kQueueNewTexture);
 	QueueMan.unlockQueue(kQueueNewTexture);
@@ -1034,11 +1085,14 @@ bool GraphicsManager::playVideo() {
 	glLoadIdentity();
 
 	QueueMan.lockQueue(kQueueVisibleVideo);
-	const std::list<Queueable *> &videos = QueueMan.getQueue(kQueueVisibleVideo);
+	const std::vector<Queueable *> &videos = QueueMan.getQueue(kQueueVisibleVideo);
+
+	for (size_t i = 0; i < videos.size(); i++) {
+		if (!videos[i])
+			continue;
 
-	for (std::list<Queueable *>::const_iterator v = videos.begin(); v != videos.end(); ++v) {
 		glPushMatrix();
-		static_cast<Renderable *>(*v)->render(kRenderPassAll);
+		static_cast<Renderable *>(videos[i])->render(kRenderPassAll);
 		glPopMatrix();
 	}
 
@@ -1081,27 +1135,29 @@ bool GraphicsManager::renderWorld() {
 	_modelview = glm::translate(_modelview, glm::vec3(-cPos[0], -cPos[1], -cPos[2]));
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	const std::vector<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
 	_animationThread.flush();
 
 	// Draw opaque objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
+	for (size_t i = objects.size(); i-- > 0; ) {
+		if (!objects[i])
+			continue;
 
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassOpaque);
+		static_cast<Renderable *>(objects[i])->render(kRenderPassOpaque);
 		glPopMatrix();
 	}
 
 	// Draw transparent objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
+	for (size_t i = objects.size(); i-- > 0; ) {
+		if (!objects[i])
+			continue;
 
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassTransparent);
+		static_cast<Renderable *>(objects[i])->render(kRenderPassTransparent);
 		glPopMatrix();
 	}
 
@@ -1145,15 +1201,16 @@ bool GraphicsManager::renderGUI(ScalingType scalingType, QueueType guiQueue, boo
 	glLoadIdentity();
 
 	QueueMan.lockQueue(guiQueue);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(guiQueue);
+	const std::vector<Queueable *> &gui = QueueMan.getQueue(guiQueue);
 
 	buildNewTextures();
 
-	for (std::list<Queueable *>::const_reverse_iterator g = gui.rbegin();
-	     g != gui.rend(); ++g) {
+	for (size_t i = gui.size(); i-- > 0; ) {
+		if (!gui[i])
+			continue;
 
 		glPushMatrix();
-		static_cast<Renderable *>(*g)->render(kRenderPassAll);
+		static_cast<Renderable *>(gui[i])->render(kRenderPassAll);
 		glPopMatrix();
 	}
 
@@ -1225,7 +1282,7 @@ bool GraphicsManager::renderWorldShader() {
 	_modelview = glm::translate(_modelview, glm::vec3(-cPos[0], -cPos[1], -cPos[2]));
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	const std::vector<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
@@ -1233,9 +1290,11 @@ bool GraphicsManager::renderWorldShader() {
 
 	glm::mat4 ident;
 	RenderMan.clear();
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
-		static_cast<Renderable *>(*o)->queueRender(ident);
+	for (size_t i = objects.size(); i-- > 0; ) {
+		if (!objects[i])
+			continue;
+
+		static_cast<Renderable *>(objects[i])->queueRender(ident);
 	}
 	RenderMan.sort();
 	RenderMan.render();
@@ -1268,15 +1327,17 @@ bool GraphicsManager::renderGUIShader(ScalingType UNUSED(scalingType), QueueType
 	_projectionInv = _orthoInv;
 
 	QueueMan.lockQueue(guiQueue);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(guiQueue);
+	const std::vector<Queueable *> &gui = QueueMan.getQueue(guiQueue);
 	_modelview = glm::mat4();
 
 	buildNewTextures();
 
 	glm::mat4 ident;
-	for (std::list<Queueable *>::const_reverse_iterator g = gui.rbegin();
-	     g != gui.rend(); ++g) {
-		static_cast<Renderable *>(*g)->renderImmediate(ident);
+	for (size_t i = gui.size(); i-- > 0; ) {
+		if (!gui[i])
+			continue;
+
+		static_cast<Renderable *>(gui[i])->renderImmediate(ident);
 	}
 
 	QueueMan.unlockQueue(guiQueue);
@@ -1335,8 +1396,13 @@ void GraphicsManager::renderScene() {
 		return;
 	}
 
+	TextureMan.uploadAsyncTextures();
+	TextureMan.enforceBudget();
+
 	beginScene();
 
+	sortQueues();
+
 	if (playVideo()) {
 		renderGUIConsole();
 		renderImGui();
@@ -1412,9 +1478,10 @@ bool GraphicsManager::isGL3() const {
 void GraphicsManager::rebuildGLContainers() {
 	QueueMan.lockQueue(kQueueGLContainer);
 
-	const std::list<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
-	for (std::list<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
-		static_cast<GLContainer *>(*c)->rebuild();
+	const std::vector<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
+	for (size_t i = 0; i < cont.size(); i++)
+		if (cont[i])
+			static_cast<GLContainer *>(cont[i])->rebuild();
 
 	QueueMan.unlockQueue(kQueueGLContainer);
 }
@@ -1422,9 +1489,10 @@ void GraphicsManager::rebuildGLContainers() {
 void GraphicsManager::destroyGLContainers() {
 	QueueMan.lockQueue(kQueueGLContainer);
 
-	const std::list<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
-	for (std::list<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
-		static_cast<GLContainer *>(*c)->destroy();
+	const std::vector<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
+	for (size_t i = 0; i < cont.size(); i++)
+		if (cont[i])
+			static_cast<GLContainer *>(cont[i])->destroy();
 
 	QueueMan.unlockQueue(kQueueGLContainer);
 }
@@ -94,6 +94,11 @@ public:
 	/** How many frames per second to we render at the moments? */
 	uint32_t getFPS() const;
 
+	/** How long, in microseconds, did the last object distance recalculation take? */
+	uint32_t getDistanceTime() const;
+	/** How long, in microseconds, did sorting the render queues take in the last frame? */
+	uint32_t getSortTime() const;
+
 	/** Enable/Disable face culling. */
 	void setCullFace(bool enabled, GLenum mode = GL_BACK);
 
@@ -124,7 +129,7 @@ public:
 	/** Get the object at this screen position. */
 	Renderable *getObjectAt(float x, float y);
 
-	/** Recalculate all object distances to the camera and resort the objects. */
+	/** Recalculate all world object distances to the camera and mark them for resorting. */
 	void recalculateObjectDistances();
 
 	/** Increase the frame lock counter, disabling all frame rendering.
@@ -220,6 +225,9 @@ private:
 
 	uint32_t _lastSampled; ///< Timestamp used to advance animations.
 
+	std::atomic<uint32_t> _distanceTime; ///< Time the last distance recalculation took, in microseconds.
+	std::atomic<uint32_t> _sortTime;     ///< Time sorting the queues took in the last frame, in microseconds.
+
 	glm::mat4 _perspective;    ///< 3D perspective projection matrix.
 	glm::mat4 _perspectiveInv; ///< The inverse of our perspective matrix.
 	glm::mat4 _ortho;          ///< Orthographical projection matrix.
@@ -273,6 +281,9 @@ private:
 
 	void buildNewTextures();
 
+	/** Compact all queues and sort the visible ones that have been marked as unsorted. */
+	void sortQueues();
+
 	void beginScene();
 	bool playVideo();
 	bool renderWorld();
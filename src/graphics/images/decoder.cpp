@@ -45,6 +45,9 @@ ImageDecoder::MipMap::MipMap(const ImageDecoder *i) : image(i) {
 ImageDecoder::MipMap::MipMap(const MipMap &mipMap, const ImageDecoder *i) :
 	width(mipMap.width), height(mipMap.height), size(mipMap.size), image(i) {
 
+	if (!mipMap.data)
+		return;
+
 	data = std::make_unique<byte[]>(size);
 
 	std::memcpy(data.get(), mipMap.data.get(), size);
@@ -255,6 +258,11 @@ void ImageDecoder::decompress() {
 	_compressed = false;
 }
 
+void ImageDecoder::freeData() {
+	for (MipMaps::iterator m = _mipMaps.begin(); m != _mipMaps.end(); ++m)
+		(*m)->data.reset();
+}
+
 bool ImageDecoder::dumpTGA(const Common::UString &fileName) const {
 	if (_mipMaps.size() < 1)
 		return false;
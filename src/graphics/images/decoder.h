@@ -105,6 +105,9 @@ public:
 	/** Manually decompress the texture image data. */
 	void decompress();
 
+	/** Free the data of all mip maps, keeping only their dimensions and the image properties. */
+	void freeData();
+
 	/** Return the texture information TXI, which may be embedded in the image. */
 	const TXI &getTXI() const;
 
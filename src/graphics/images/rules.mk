@@ -43,6 +43,7 @@ src_graphics_images_libimages_la_SOURCES += \
     src/graphics/images/nclr.h \
     src/graphics/images/ncgr.h \
     src/graphics/images/cbgt.h \
+    src/graphics/images/texturecache.h \
     $(EMPTY)
 
 src_graphics_images_libimages_la_SOURCES += \
@@ -65,4 +66,5 @@ src_graphics_images_libimages_la_SOURCES += \
     src/graphics/images/nclr.cpp \
     src/graphics/images/ncgr.cpp \
     src/graphics/images/cbgt.cpp \
+    src/graphics/images/texturecache.cpp \
     $(EMPTY)
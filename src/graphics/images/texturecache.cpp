@@ -0,0 +1,245 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A disk cache for decoded images.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/string.h"
+#include "src/common/hash.h"
+#include "src/common/uuid.h"
+#include "src/common/filepath.h"
+#include "src/common/mappedfile.h"
+#include "src/common/memreadstream.h"
+#include "src/common/writefile.h"
+
+#include "src/graphics/images/texturecache.h"
+#include "src/graphics/images/decoder.h"
+
+static const uint32_t kCacheID      = MKTAG('X', 'T', 'X', 'C');
+static const uint32_t kCacheVersion = 0;
+
+static const size_t kHeaderSize   = 9 * 4;
+static const size_t kMipMapSize   = 4 * 4;
+static const size_t kDataAlignment = 16;
+
+enum CacheFlags {
+	kFlagCompressed = 1 << 0,
+	kFlagHasAlpha   = 1 << 1,
+	kFlagCubeMap    = 1 << 2
+};
+
+namespace Graphics {
+
+/** An image loaded from the texture cache. */
+class CachedImage : public ImageDecoder {
+public:
+	CachedImage(const byte *data, size_t size) {
+		load(data, size);
+	}
+
+private:
+	void load(const byte *data, size_t size) {
+		Common::MemoryReadStream header(data, size);
+
+		if ((header.readUint32BE() != kCacheID) || (header.readUint32LE() != kCacheVersion))
+			throw Common::Exception("Not a texture cache file");
+
+		_format    = (PixelFormat)    header.readUint32LE();
+		_formatRaw = (PixelFormatRaw) header.readUint32LE();
+		_dataType  = (PixelDataType)  header.readUint32LE();
+
+		const uint32_t flags = header.readUint32LE();
+
+		_compressed = (flags & kFlagCompressed) != 0;
+		_hasAlpha   = (flags & kFlagHasAlpha  ) != 0;
+		_isCubeMap  = (flags & kFlagCubeMap   ) != 0;
+
+		_layerCount = header.readUint32LE();
+
+		const uint32_t mipMapCount = header.readUint32LE();
+		const uint32_t txiSize     = header.readUint32LE();
+
+		if ((_layerCount == 0) || (mipMapCount == 0) || ((mipMapCount % _layerCount) != 0) ||
+		    (_isCubeMap && (_layerCount != 6)))
+			throw Common::Exception("Invalid texture cache layout (%u, %u)", (uint) _layerCount, mipMapCount);
+
+		_mipMaps.resize(mipMapCount);
+		for (size_t i = 0; i < _mipMaps.size(); i++) {
+			_mipMaps[i] = std::make_unique<MipMap>(this);
+
+			_mipMaps[i]->width  = header.readUint32LE();
+			_mipMaps[i]->height = header.readUint32LE();
+			_mipMaps[i]->size   = header.readUint32LE();
+
+			const uint32_t offset = header.readUint32LE();
+			if ((offset > size) || (_mipMaps[i]->size > (size - offset)))
+				throw Common::Exception("Texture cache mip map %u out of bounds", (uint) i);
+
+			_mipMaps[i]->data = std::make_unique<byte[]>(_mipMaps[i]->size);
+			std::memcpy(_mipMaps[i]->data.get(), data + offset, _mipMaps[i]->size);
+		}
+
+		if (txiSize > 0) {
+			if (txiSize > (size - header.pos()))
+				throw Common::Exception(Common::kReadError);
+
+			Common::MemoryReadStream txi(data + header.pos(), txiSize);
+			_txi.load(txi);
+		}
+	}
+};
+
+
+TextureCache::TextureCache(const Common::UString &directory) : _directory(directory) {
+	if (!Common::FilePath::isDirectory(_directory) && !Common::FilePath::createDirectories(_directory))
+		throw Common::Exception("Can't create texture cache directory \"%s\"", _directory.c_str());
+}
+
+TextureCache::~TextureCache() {
+}
+
+const Common::UString &TextureCache::getDirectory() const {
+	return _directory;
+}
+
+uint64_t TextureCache::getKey(Common::SeekableReadStream &source, uint32_t options) {
+	uint64_t hash = 0xCBF29CE484222325LL;
+
+	byte buffer[4096];
+
+	source.seek(0);
+
+	size_t n;
+	while ((n = source.read(buffer, sizeof(buffer))) > 0)
+		for (size_t i = 0; i < n; i++)
+			hash = Common::hashFNV64(hash, buffer[i]);
+
+	source.seek(0);
+
+	hash = Common::hashFNV64(hash, options);
+	hash = Common::hashFNV64(hash, kCacheVersion);
+
+	return hash;
+}
+
+Common::UString TextureCache::getFileName(uint64_t key) const {
+	return _directory + "/" + Common::String::format("%08X%08X.xtc",
+			(uint) ((key >> 32) & 0xFFFFFFFF), (uint) (key & 0xFFFFFFFF));
+}
+
+ImageDecoder *TextureCache::load(uint64_t key) const {
+	const Common::UString fileName = getFileName(key);
+	if (!Common::FilePath::isRegularFile(fileName))
+		return 0;
+
+	try {
+		Common::MappedFile file(fileName);
+
+		return new CachedImage(file.getData(), file.getSize());
+
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed to load cached texture \"%s\"", fileName.c_str());
+	}
+
+	return 0;
+}
+
+void TextureCache::save(uint64_t key, const ImageDecoder &image) const {
+	const Common::UString fileName = getFileName(key);
+	const Common::UString tempName = fileName + "." + Common::generateIDRandomString();
+
+	try {
+		const size_t layerCount  = image.getLayerCount();
+		const size_t mipMapCount = image.getMipMapCount();
+
+		const Common::UString &txi = image.getTXI().getText();
+
+		Common::WriteFile file(tempName);
+
+		uint32_t flags = 0;
+		if (image.isCompressed())
+			flags |= kFlagCompressed;
+		if (image.hasAlpha())
+			flags |= kFlagHasAlpha;
+		if (image.isCubeMap())
+			flags |= kFlagCubeMap;
+
+		file.writeUint32BE(kCacheID);
+		file.writeUint32LE(kCacheVersion);
+		file.writeUint32LE((uint32_t) image.getFormat());
+		file.writeUint32LE((uint32_t) image.getFormatRaw());
+		file.writeUint32LE((uint32_t) image.getDataType());
+		file.writeUint32LE(flags);
+		file.writeUint32LE(layerCount);
+		file.writeUint32LE(layerCount * mipMapCount);
+		file.writeUint32LE(txi.size());
+
+		// The mip maps' data comes after the header, the mip map table and the TXI
+		size_t offset = kHeaderSize + layerCount * mipMapCount * kMipMapSize + txi.size();
+
+		for (size_t i = 0; i < layerCount; i++) {
+			for (size_t j = 0; j < mipMapCount; j++) {
+				const ImageDecoder::MipMap &mipMap = image.getMipMap(j, i);
+
+				offset = (offset + kDataAlignment - 1) & ~(kDataAlignment - 1);
+
+				file.writeUint32LE(mipMap.width);
+				file.writeUint32LE(mipMap.height);
+				file.writeUint32LE(mipMap.size);
+				file.writeUint32LE(offset);
+
+				offset += mipMap.size;
+			}
+		}
+
+		file.write(txi.c_str(), txi.size());
+
+		for (size_t i = 0; i < layerCount; i++) {
+			for (size_t j = 0; j < mipMapCount; j++) {
+				const ImageDecoder::MipMap &mipMap = image.getMipMap(j, i);
+
+				file.writeZeros(((file.pos() + kDataAlignment - 1) & ~(kDataAlignment - 1)) - file.pos());
+
+				if (file.write(mipMap.data.get(), mipMap.size) != mipMap.size)
+					throw Common::Exception(Common::kWriteError);
+			}
+		}
+
+		file.flush();
+		file.close();
+
+		// Another thread might have written the same image in the meantime. That's fine, it's identical
+		if (std::rename(tempName.c_str(), fileName.c_str()) != 0)
+			std::remove(tempName.c_str());
+
+	} catch (...) {
+		std::remove(tempName.c_str());
+
+		Common::exceptionDispatcherWarning("Failed to save cached texture \"%s\"", fileName.c_str());
+	}
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,80 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A disk cache for decoded images.
+ */
+
+#ifndef GRAPHICS_IMAGES_TEXTURECACHE_H
+#define GRAPHICS_IMAGES_TEXTURECACHE_H
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+
+namespace Common {
+	class SeekableReadStream;
+}
+
+namespace Graphics {
+
+class ImageDecoder;
+
+/** A disk cache for decoded images.
+ *
+ *  Some image formats need a lot of work after reading: deswizzling,
+ *  palette expansion, manual DXT decompression. The TextureCache stores
+ *  the finished image data, so that it only needs to be copied out of a
+ *  memory-mapped file the next time.
+ *
+ *  Images are keyed by a hash over the source data and the decoding
+ *  options, so changed files or different options never hit stale data.
+ *  Each image is stored in its own file, with all mip maps aligned to
+ *  16 bytes. Writing happens into a temporary file that's then renamed,
+ *  so several threads and processes can use the same cache directory.
+ */
+class TextureCache {
+public:
+	/** Use this directory for the cache, creating it if necessary. Throws on failure. */
+	TextureCache(const Common::UString &directory);
+	~TextureCache();
+
+	/** Return the directory the cache lives in. */
+	const Common::UString &getDirectory() const;
+
+	/** Calculate the key of an image from its source data and decoding options.
+	 *
+	 *  The stream is read in full and seeked back to the start afterwards.
+	 */
+	static uint64_t getKey(Common::SeekableReadStream &source, uint32_t options);
+
+	/** Load the image with this key, or return 0 if it's not in the cache. */
+	ImageDecoder *load(uint64_t key) const;
+	/** Save this image under this key. Failures are only warned about. */
+	void save(uint64_t key, const ImageDecoder &image) const;
+
+private:
+	Common::UString _directory;
+
+	Common::UString getFileName(uint64_t key) const;
+};
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_IMAGES_TEXTURECACHE_H
@@ -45,6 +45,10 @@ bool TXI::empty() const {
 	return _empty;
 }
 
+const Common::UString &TXI::getText() const {
+	return _text;
+}
+
 void TXI::load(Common::SeekableReadStream &stream) {
 	_empty = false;
 
@@ -54,6 +58,9 @@ void TXI::load(Common::SeekableReadStream &stream) {
 		if (line.empty())
 			continue;
 
+		_text += line;
+		_text += "\n";
+
 		if (_mode == kModeUpperLeftCoords) {
 			std::sscanf(line.c_str(), "%f %f %f",
 					&_features.upperLeftCoords[_curCoords].x,
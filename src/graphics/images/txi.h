@@ -134,6 +134,9 @@ public:
 
 	bool empty() const;
 
+	/** Return the text the TXI was loaded from. */
+	const Common::UString &getText() const;
+
 	const Features &getFeatures() const;
 	Features &getFeatures();
 
@@ -150,6 +153,8 @@ private:
 
 	Features _features;
 
+	Common::UString _text;
+
 	uint32_t _curCoords { 0 };
 
 	Blending parseBlending(const char *str);
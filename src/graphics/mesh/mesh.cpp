@@ -22,13 +22,15 @@
  *  Generic mesh handling class.
  */
 
+#include "external/glm/geometric.hpp"
+
 #include "src/graphics/mesh/mesh.h"
 
 namespace Graphics {
 
 namespace Mesh {
 
-Mesh::Mesh(GLuint type, GLuint hint) : GLContainer(), _type(type), _hint(hint), _usageCount(0), _vao(0), _radius(0.0f), _bindPosePtr(0) {
+Mesh::Mesh(GLuint type, GLuint hint) : GLContainer(), _type(type), _hint(hint), _usageCount(0), _vao(0), _radius(0.0f), _bindPosePtr(0), _quantized(false) {
 }
 
 Mesh::~Mesh() {
@@ -68,6 +70,23 @@ GLuint Mesh::getHint() const {
 	return _hint;
 }
 
+bool Mesh::quantize() {
+	if (_quantized)
+		return true;
+
+	_quantized = quantizeMesh(_vertexBuffer, _vertexDecode);
+
+	return _quantized;
+}
+
+bool Mesh::isQuantized() const {
+	return _quantized;
+}
+
+const glm::vec4 *Mesh::getVertexDecode() const {
+	return _quantized ? _vertexDecode : 0;
+}
+
 void Mesh::init() {
 	float minx = 0.0f, miny = 0.0f, minz = 0.0f, maxx = 0.0f, maxy = 0.0f, maxz = 0.0f;
 	float *vertices = static_cast<float *>(_vertexBuffer.getData());
@@ -101,6 +120,15 @@ void Mesh::init() {
 			_centre *= 0.5f;
 			_radius = (_max - _centre).length();
 			//_centre = 0.5f * (_min + _max);
+		} else if (_quantized) {
+			// The positions fill the box the decoding parameters describe
+			const glm::vec3 offset(_vertexDecode[0]);
+			const glm::vec3 extent(_vertexDecode[1] * kPositionRange);
+
+			_min = offset - extent;
+			_max = offset + extent;
+			_centre = offset;
+			_radius = glm::length(extent);
 		}
 	}
 	// Borrowing kQueueNewTexture for now as a more generic GLContainer initialiser.
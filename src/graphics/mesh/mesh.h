@@ -34,6 +34,8 @@
 #include "src/graphics/indexbuffer.h"
 #include "src/graphics/vertexbuffer.h"
 
+#include "src/graphics/mesh/meshquantizer.h"
+
 namespace Graphics {
 
 namespace Mesh {
@@ -55,6 +57,19 @@ public:
 	void setHint(GLuint hint);
 	GLuint getHint() const;
 
+	/** Store the vertex data in a compact layout, see quantizeMesh().
+	 *
+	 *  Must be called before init(). Only shaders that decode the vertex
+	 *  data can render the mesh afterwards.
+	 */
+	bool quantize();
+
+	/** Is the vertex data stored in a compact layout? */
+	bool isQuantized() const;
+
+	/** Return the kVertexDecodeSize parameters decoding the compact layout, or 0 if it isn't. */
+	const glm::vec4 *getVertexDecode() const;
+
 	/** General mesh initialisation, queuing the mesh for GL resource creation. */
 	void init();
 
@@ -110,6 +125,9 @@ private:
 
 	const glm::mat4 *_bindPosePtr;
 	std::vector<float> _boneTransforms;
+
+	bool _quantized; ///< Is the vertex data stored in a compact layout?
+	glm::vec4 _vertexDecode[kVertexDecodeSize]; ///< Parameters decoding the compact layout.
 };
 
 } // End of namespace Mesh
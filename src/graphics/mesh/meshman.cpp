@@ -37,7 +37,7 @@ namespace Graphics {
 
 namespace Mesh {
 
-MeshManager::MeshManager() {
+MeshManager::MeshManager() : _optimize(false), _quantize(false) {
 }
 
 MeshManager::~MeshManager() {
@@ -64,6 +64,8 @@ void MeshManager::init() {
 }
 
 void MeshManager::deinit() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	for (std::map<Common::UString, Mesh *>::iterator iter = _resourceMap.begin(); iter != _resourceMap.end(); ++iter) {
 		delete iter->second;
 	}
@@ -71,6 +73,8 @@ void MeshManager::deinit() {
 }
 
 void MeshManager::cleanup() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	std::map<Common::UString, Mesh *>::iterator iter = _resourceMap.begin();
 	while (iter != _resourceMap.end()) {
 		Mesh *mesh = iter->second;
@@ -83,6 +87,8 @@ void MeshManager::cleanup() {
 }
 
 void MeshManager::addMesh(Mesh *mesh, bool forceAddMesh) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	if (!mesh) {
 		return;
 	}
@@ -98,6 +104,8 @@ void MeshManager::addMesh(Mesh *mesh, bool forceAddMesh) {
 }
 
 void MeshManager::delMesh(Mesh *mesh) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	if (!mesh) {
 		return;
 	}
@@ -109,6 +117,8 @@ void MeshManager::delMesh(Mesh *mesh) {
 }
 
 Mesh *MeshManager::getMesh(const Common::UString &name) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	std::map<Common::UString, Mesh *>::iterator iter = _resourceMap.find(name);
 	if (iter != _resourceMap.end()) {
 		return iter->second;
@@ -117,6 +127,22 @@ Mesh *MeshManager::getMesh(const Common::UString &name) {
 	}
 }
 
+void MeshManager::setOptimize(bool optimize) {
+	_optimize.store(optimize);
+}
+
+bool MeshManager::getOptimize() const {
+	return _optimize.load();
+}
+
+void MeshManager::setQuantize(bool quantize) {
+	_quantize.store(quantize);
+}
+
+bool MeshManager::getQuantize() const {
+	return _quantize.load();
+}
+
 std::map<Common::UString, Mesh *>::iterator MeshManager::delResource(std::map<Common::UString, Mesh *>::iterator iter) {
 	std::map<Common::UString, Mesh *>::iterator inext = iter;
 	inext++;
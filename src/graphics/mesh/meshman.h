@@ -26,9 +26,11 @@
 #define GRAPHICS_MESH_MESHMAN_H
 
 #include <map>
+#include <atomic>
 
 #include "src/common/ustring.h"
 #include "src/common/singleton.h"
+#include "src/common/mutex.h"
 
 #include "src/graphics/mesh/mesh.h"
 
@@ -59,9 +61,22 @@ public:
 	/** Returns a mesh with the given name, or zero if it does not exist. */
 	Mesh *getMesh(const Common::UString &name);
 
+	/** Should model loaders optimize static meshes for rendering? See optimizeMesh(). */
+	void setOptimize(bool optimize);
+	bool getOptimize() const;
+
+	/** Should model loaders store static meshes in a compact layout? See quantizeMesh(). */
+	void setQuantize(bool quantize);
+	bool getQuantize() const;
+
 private:
 	std::map<Common::UString, Mesh *> _resourceMap;
 
+	std::recursive_mutex _mutex; ///< Protects the resources, which can be used from several threads.
+
+	std::atomic<bool> _optimize; ///< Optimize static meshes when loading them?
+	std::atomic<bool> _quantize; ///< Quantize static meshes when loading them?
+
 	std::map<Common::UString, Mesh *>::iterator delResource(std::map<Common::UString, Mesh *>::iterator iter);
 };
 
@@ -0,0 +1,455 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Optimizing indexed triangle meshes for rendering.
+ */
+
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "src/common/util.h"
+
+#include "src/graphics/vertexbuffer.h"
+#include "src/graphics/indexbuffer.h"
+
+#include "src/graphics/mesh/meshoptimizer.h"
+
+namespace Graphics {
+
+namespace Mesh {
+
+double computeACMR(const uint32_t *indices, size_t indexCount, size_t cacheSize) {
+	if ((indexCount < 3) || (cacheSize == 0))
+		return 0.0;
+
+	uint32_t vertexCount = 0;
+	for (size_t i = 0; i < indexCount; i++)
+		vertexCount = MAX(vertexCount, indices[i] + 1);
+
+	/* A vertex is in the FIFO if fewer than cacheSize other vertices
+	 * were put in after it. So we only need to count the misses. */
+	std::vector<size_t> insertedAt(vertexCount, 0);
+
+	size_t misses = 0;
+	for (size_t i = 0; i < indexCount; i++) {
+		const uint32_t v = indices[i];
+
+		if ((insertedAt[v] == 0) || ((misses + 1 - insertedAt[v]) > cacheSize))
+			insertedAt[v] = ++misses;
+	}
+
+	return ((double) misses) / (indexCount / 3);
+}
+
+
+static uint32_t hashVertex(const byte *vertex, size_t size) {
+	// FNV-1a
+	uint32_t hash = 2166136261U;
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ vertex[i]) * 16777619U;
+
+	return hash;
+}
+
+size_t weldVertices(uint32_t *remap, const byte *vertices, size_t vertexCount, size_t vertexSize) {
+	size_t tableSize = 16;
+	while (tableSize < (vertexCount * 2))
+		tableSize *= 2;
+
+	// Open addressing, holding the index of the first vertex with this data
+	std::vector<uint32_t> table(tableSize, kUnusedVertex);
+
+	size_t uniqueCount = 0;
+	for (size_t i = 0; i < vertexCount; i++) {
+		const byte *vertex = vertices + i * vertexSize;
+
+		size_t slot = hashVertex(vertex, vertexSize) & (tableSize - 1);
+		while ((table[slot] != kUnusedVertex) &&
+		       (std::memcmp(vertices + table[slot] * vertexSize, vertex, vertexSize) != 0))
+			slot = (slot + 1) & (tableSize - 1);
+
+		if (table[slot] == kUnusedVertex) {
+			table[slot] = i;
+			remap[i] = uniqueCount++;
+		} else
+			remap[i] = remap[table[slot]];
+	}
+
+	return uniqueCount;
+}
+
+
+/* The vertex scoring of Forsyth's algorithm. Vertices in the cache score
+ * higher, the more recently they were used. The three vertices of the last
+ * triangle score a bit less, so that we don't create strips. Vertices
+ * with only few triangles left to render score higher, so that we don't
+ * leave lone triangles behind that would need them again later. */
+
+static const size_t kScoreCacheSize    = 32;
+static const size_t kScoreMaxValence   = 32;
+static const float  kCacheDecayPower   = 1.5f;
+static const float  kLastTriangleScore = 0.75f;
+static const float  kValenceBoostScale = 2.0f;
+static const float  kValenceBoostPower = 0.5f;
+
+namespace {
+
+struct VertexScores {
+	float cache[kScoreCacheSize];
+	float valence[kScoreMaxValence + 1];
+
+	VertexScores() {
+		for (size_t i = 0; i < kScoreCacheSize; i++) {
+			if (i < 3)
+				cache[i] = kLastTriangleScore;
+			else
+				cache[i] = std::pow(1.0f - (i - 3) / (float) (kScoreCacheSize - 3), kCacheDecayPower);
+		}
+
+		valence[0] = 0.0f;
+		for (size_t i = 1; i <= kScoreMaxValence; i++)
+			valence[i] = kValenceBoostScale * std::pow((float) i, -kValenceBoostPower);
+	}
+
+	float get(int32_t cachePosition, uint32_t remaining) const {
+		if (remaining == 0)
+			return -1.0f;
+
+		float score = (cachePosition >= 0) ? cache[cachePosition] : 0.0f;
+
+		if (remaining <= kScoreMaxValence)
+			score += valence[remaining];
+		else
+			score += kValenceBoostScale * std::pow((float) remaining, -kValenceBoostPower);
+
+		return score;
+	}
+};
+
+} // End of anonymous namespace
+
+void optimizeVertexCache(uint32_t *dst, const uint32_t *indices, size_t indexCount, size_t vertexCount) {
+	static const VertexScores kScores;
+
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	// The triangles using each vertex, the not yet rendered ones first
+
+	std::vector<uint32_t> remaining(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+		remaining[indices[i]]++;
+
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for (size_t i = 0; i < vertexCount; i++)
+		offsets[i + 1] = offsets[i] + remaining[i];
+
+	std::vector<uint32_t> triangles(triangleCount * 3);
+	{
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < triangleCount * 3; i++)
+			triangles[fill[indices[i]]++] = i / 3;
+	}
+
+	std::vector<int32_t> cachePosition(vertexCount, -1);
+
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t i = 0; i < vertexCount; i++)
+		vertexScore[i] = kScores.get(-1, remaining[i]);
+
+	std::vector<float> triangleScore(triangleCount);
+	for (size_t i = 0; i < triangleCount; i++)
+		triangleScore[i] = vertexScore[indices[i * 3 + 0]] +
+		                   vertexScore[indices[i * 3 + 1]] +
+		                   vertexScore[indices[i * 3 + 2]];
+
+	std::vector<bool> rendered(triangleCount, false);
+
+	uint32_t cache[kScoreCacheSize + 3], newCache[kScoreCacheSize + 3];
+	size_t cacheCount = 0;
+
+	size_t bestTriangle = 0;
+	for (size_t i = 1; i < triangleCount; i++)
+		if (triangleScore[i] > triangleScore[bestTriangle])
+			bestTriangle = i;
+
+	// Triangles before this one have all been rendered. For when nothing in the cache is left
+	size_t nextTriangle = 0;
+
+	for (size_t output = 0; output < triangleCount; output++) {
+		if (bestTriangle == SIZE_MAX) {
+			while (rendered[nextTriangle])
+				nextTriangle++;
+
+			bestTriangle = nextTriangle;
+		}
+
+		const uint32_t *triangle = indices + bestTriangle * 3;
+
+		rendered[bestTriangle] = true;
+		*dst++ = triangle[0];
+		*dst++ = triangle[1];
+		*dst++ = triangle[2];
+
+		// Remove the triangle from its vertices' lists of triangles still to render
+		for (size_t i = 0; i < 3; i++) {
+			const uint32_t v = triangle[i];
+
+			uint32_t *list = &triangles[offsets[v]];
+			for (uint32_t j = 0; j < remaining[v]; j++) {
+				if (list[j] == bestTriangle) {
+					std::swap(list[j], list[remaining[v] - 1]);
+					break;
+				}
+			}
+
+			remaining[v]--;
+		}
+
+		// Put the triangle's vertices in front of the cache
+		size_t newCacheCount = 0;
+		for (size_t i = 0; i < 3; i++)
+			if ((i == 0) || ((triangle[i] != triangle[0]) && ((i == 1) || (triangle[i] != triangle[1]))))
+				newCache[newCacheCount++] = triangle[i];
+
+		for (size_t i = 0; i < cacheCount; i++)
+			if ((cache[i] != triangle[0]) && (cache[i] != triangle[1]) && (cache[i] != triangle[2]))
+				newCache[newCacheCount++] = cache[i];
+
+		// Update the scores of all vertices that changed, and of their triangles
+		for (size_t i = 0; i < newCacheCount; i++) {
+			const uint32_t v = newCache[i];
+
+			cachePosition[v] = (i < kScoreCacheSize) ? ((int32_t) i) : -1;
+
+			const float score = kScores.get(cachePosition[v], remaining[v]);
+			const float delta = score - vertexScore[v];
+
+			vertexScore[v] = score;
+
+			const uint32_t *list = &triangles[offsets[v]];
+			for (uint32_t j = 0; j < remaining[v]; j++)
+				triangleScore[list[j]] += delta;
+		}
+
+		// The next triangle is the best one using a vertex in the cache
+		bestTriangle = SIZE_MAX;
+		float bestScore = -1.0f;
+
+		cacheCount = MIN(newCacheCount, kScoreCacheSize);
+		for (size_t i = 0; i < cacheCount; i++) {
+			const uint32_t v = newCache[i];
+			cache[i] = v;
+
+			const uint32_t *list = &triangles[offsets[v]];
+			for (uint32_t j = 0; j < remaining[v]; j++) {
+				if (triangleScore[list[j]] > bestScore) {
+					bestScore = triangleScore[list[j]];
+					bestTriangle = list[j];
+				}
+			}
+		}
+	}
+}
+
+
+size_t optimizeVertexFetch(uint32_t *remap, uint32_t *indices, size_t indexCount, size_t vertexCount) {
+	for (size_t i = 0; i < vertexCount; i++)
+		remap[i] = kUnusedVertex;
+
+	size_t usedCount = 0;
+	for (size_t i = 0; i < indexCount; i++) {
+		uint32_t &v = remap[indices[i]];
+		if (v == kUnusedVertex)
+			v = usedCount++;
+
+		indices[i] = v;
+	}
+
+	return usedCount;
+}
+
+
+static bool readIndices(std::vector<uint32_t> &indices, const IndexBuffer &indexBuffer) {
+	indices.resize(indexBuffer.getCount());
+
+	if (indexBuffer.getType() == GL_UNSIGNED_SHORT) {
+		const uint16_t *data = reinterpret_cast<const uint16_t *>(indexBuffer.getData());
+		std::copy(data, data + indices.size(), indices.begin());
+
+		return true;
+	}
+
+	if (indexBuffer.getType() == GL_UNSIGNED_INT) {
+		const uint32_t *data = reinterpret_cast<const uint32_t *>(indexBuffer.getData());
+		std::copy(data, data + indices.size(), indices.begin());
+
+		return true;
+	}
+
+	return false;
+}
+
+MeshStats getMeshStats(const VertexBuffer &vertexBuffer, const IndexBuffer &indexBuffer) {
+	MeshStats stats;
+
+	stats.vertexCount  = vertexBuffer.getCount();
+	stats.indexCount   = indexBuffer.getCount();
+	stats.vertexMemory = vertexBuffer.getCount() * vertexBuffer.getSize();
+	stats.indexMemory  = indexBuffer.getCount() * VertexBuffer::getTypeSize(indexBuffer.getType());
+	stats.acmr         = 0.0;
+
+	std::vector<uint32_t> indices;
+	if (readIndices(indices, indexBuffer))
+		stats.acmr = computeACMR(indices.data(), indices.size());
+
+	return stats;
+}
+
+/** Where one vertex attribute is found in a vertex buffer. */
+struct AttributeLayout {
+	const byte *data; ///< Start of the attribute's data.
+	size_t stride;    ///< Distance in bytes between two vertices.
+	size_t size;      ///< Size of the attribute in bytes.
+};
+
+bool optimizeMesh(VertexBuffer &vertexBuffer, IndexBuffer &indexBuffer) {
+	const size_t vertexCount = vertexBuffer.getCount();
+	const size_t vertexSize  = vertexBuffer.getSize();
+	if ((vertexCount == 0) || (vertexSize == 0) || (indexBuffer.getCount() < 3) || ((indexBuffer.getCount() % 3) != 0))
+		return false;
+
+	std::vector<uint32_t> indices;
+	if (!readIndices(indices, indexBuffer))
+		return false;
+
+	for (size_t i = 0; i < indices.size(); i++)
+		if (indices[i] >= vertexCount)
+			return false;
+
+	// Find out where the data of all attributes is
+
+	const byte *bufferStart = reinterpret_cast<const byte *>(vertexBuffer.getData());
+	const byte *bufferEnd   = bufferStart + vertexCount * vertexSize;
+
+	const VertexDecl &decl = vertexBuffer.getVertexDecl();
+
+	std::vector<AttributeLayout> layout;
+	size_t layoutSize = 0;
+	for (VertexDecl::const_iterator a = decl.begin(); a != decl.end(); ++a) {
+		AttributeLayout attribute;
+
+		attribute.data   = reinterpret_cast<const byte *>(a->pointer);
+		attribute.size   = a->size * VertexBuffer::getTypeSize(a->type);
+		attribute.stride = (a->stride != 0) ? a->stride : attribute.size;
+
+		if ((attribute.size == 0) || (attribute.data < bufferStart) ||
+		    ((attribute.data + (vertexCount - 1) * attribute.stride + attribute.size) > bufferEnd))
+			return false;
+
+		layout.push_back(attribute);
+		layoutSize += attribute.size;
+	}
+
+	if (layoutSize != vertexSize)
+		return false;
+
+	// Interleave the vertex data, in the order of the declaration
+
+	std::vector<byte> vertices(vertexCount * vertexSize);
+	for (size_t i = 0; i < vertexCount; i++) {
+		byte *vertex = &vertices[i * vertexSize];
+
+		for (std::vector<AttributeLayout>::const_iterator a = layout.begin(); a != layout.end(); ++a) {
+			std::memcpy(vertex, a->data + i * a->stride, a->size);
+			vertex += a->size;
+		}
+	}
+
+	// Weld identical vertices, and drop the triangles that collapsed
+
+	std::vector<uint32_t> remap(vertexCount);
+	const size_t weldedCount = weldVertices(remap.data(), vertices.data(), vertexCount, vertexSize);
+
+	size_t indexCount = 0;
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		const uint32_t a = remap[indices[i + 0]];
+		const uint32_t b = remap[indices[i + 1]];
+		const uint32_t c = remap[indices[i + 2]];
+
+		if ((a == b) || (b == c) || (c == a))
+			continue;
+
+		indices[indexCount++] = a;
+		indices[indexCount++] = b;
+		indices[indexCount++] = c;
+	}
+
+	if (indexCount == 0)
+		return false;
+
+	indices.resize(indexCount);
+
+	std::vector<byte> welded(weldedCount * vertexSize);
+	for (size_t i = 0; i < vertexCount; i++)
+		std::memcpy(&welded[remap[i] * vertexSize], &vertices[i * vertexSize], vertexSize);
+
+	// Reorder the triangles, then the vertices
+
+	std::vector<uint32_t> optimized(indexCount);
+	optimizeVertexCache(optimized.data(), indices.data(), indexCount, weldedCount);
+
+	remap.resize(weldedCount);
+	const size_t newVertexCount = optimizeVertexFetch(remap.data(), optimized.data(), indexCount, weldedCount);
+
+	// Write the new vertex and index data
+
+	VertexDecl newDecl = decl;
+	vertexBuffer.setVertexDeclInterleave(newVertexCount, newDecl);
+
+	byte *newVertices = reinterpret_cast<byte *>(vertexBuffer.getData());
+	for (size_t i = 0; i < weldedCount; i++)
+		if (remap[i] != kUnusedVertex)
+			std::memcpy(newVertices + remap[i] * vertexSize, &welded[i * vertexSize], vertexSize);
+
+	if (newVertexCount <= 65536) {
+		indexBuffer.setSize(indexCount, sizeof(uint16_t), GL_UNSIGNED_SHORT);
+
+		uint16_t *data = reinterpret_cast<uint16_t *>(indexBuffer.getData());
+		for (size_t i = 0; i < indexCount; i++)
+			data[i] = optimized[i];
+
+	} else {
+		indexBuffer.setSize(indexCount, sizeof(uint32_t), GL_UNSIGNED_INT);
+
+		std::memcpy(indexBuffer.getData(), optimized.data(), indexCount * sizeof(uint32_t));
+	}
+
+	return true;
+}
+
+} // End of namespace Mesh
+
+} // End of namespace Graphics
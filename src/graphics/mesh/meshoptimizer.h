@@ -0,0 +1,129 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Optimizing indexed triangle meshes for rendering.
+ */
+
+#ifndef GRAPHICS_MESH_MESHOPTIMIZER_H
+#define GRAPHICS_MESH_MESHOPTIMIZER_H
+
+#include <cstddef>
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+class VertexBuffer;
+class IndexBuffer;
+
+namespace Mesh {
+
+/** Vertex cache size used when measuring a mesh with computeACMR(). */
+static const size_t kFIFOCacheSize = 16;
+
+/** Marks a vertex in a remapping table that's not used by any triangle. */
+static const uint32_t kUnusedVertex = 0xFFFFFFFF;
+
+/** Size and vertex cache efficiency of an indexed triangle mesh. */
+struct MeshStats {
+	size_t vertexCount;  ///< Number of vertices.
+	size_t indexCount;   ///< Number of indices.
+	size_t vertexMemory; ///< Size of the vertex data in bytes.
+	size_t indexMemory;  ///< Size of the index data in bytes.
+
+	/** Average cache miss ratio, the number of vertices transformed per triangle.
+	 *
+	 *  Between 3.0 (every vertex transformed again every time) and about 0.5
+	 *  (every vertex transformed only once, for a regular grid).
+	 */
+	double acmr;
+};
+
+/** Simulate rendering a triangle list through a FIFO vertex cache.
+ *
+ *  @return The average number of cache misses per triangle.
+ */
+double computeACMR(const uint32_t *indices, size_t indexCount, size_t cacheSize = kFIFOCacheSize);
+
+/** Find vertices with exactly the same data.
+ *
+ *  Every vertex is mapped onto the first vertex with the same data. The
+ *  unique vertices keep their order.
+ *
+ *  @param  remap       Filled with the new index of every vertex.
+ *  @param  vertices    The vertex data, vertexCount elements of vertexSize bytes.
+ *  @param  vertexCount The number of vertices.
+ *  @param  vertexSize  The size of one vertex in bytes.
+ *  @return The number of unique vertices.
+ */
+size_t weldVertices(uint32_t *remap, const byte *vertices, size_t vertexCount, size_t vertexSize);
+
+/** Reorder the triangles of a triangle list, so that they reuse the vertices in the vertex cache.
+ *
+ *  This is Tom Forsyth's "Linear-Speed Vertex Cache Optimisation", which
+ *  doesn't depend on the exact size of the cache.
+ *
+ *  @param dst         Receives the indexCount reordered indices. Must not be indices.
+ *  @param indices     The triangle list.
+ *  @param indexCount  The number of indices, a multiple of 3.
+ *  @param vertexCount The number of vertices the indices refer to.
+ */
+void optimizeVertexCache(uint32_t *dst, const uint32_t *indices, size_t indexCount, size_t vertexCount);
+
+/** Number the vertices in the order the triangles use them.
+ *
+ *  Consecutive triangles then read vertices that are close together in
+ *  memory. The indices are rewritten to the new numbers.
+ *
+ *  @param  remap       Filled with the new index of every vertex, or kUnusedVertex.
+ *  @param  indices     The triangle list.
+ *  @param  indexCount  The number of indices.
+ *  @param  vertexCount The number of vertices the indices refer to.
+ *  @return The number of vertices still in use.
+ */
+size_t optimizeVertexFetch(uint32_t *remap, uint32_t *indices, size_t indexCount, size_t vertexCount);
+
+/** Return the size and vertex cache efficiency of a triangle list mesh. */
+MeshStats getMeshStats(const VertexBuffer &vertexBuffer, const IndexBuffer &indexBuffer);
+
+/** Optimize a triangle list mesh for rendering.
+ *
+ *  - Vertices with the same data are merged, and unused vertices dropped
+ *  - Triangles that merged into a line or point are dropped
+ *  - The triangles are reordered for the vertex cache
+ *  - The vertices are reordered in the order the triangles use them
+ *  - 16-bit indices are used if there are few enough vertices
+ *
+ *  The vertex data is interleaved afterwards, whatever its layout was before.
+ *  What the mesh renders doesn't change, only the order of the triangles.
+ *
+ *  Only meshes whose vertices don't need to stay where they are can be
+ *  optimized: nothing else may refer to vertices by their index.
+ *
+ *  @return false if the mesh couldn't be optimized, and is unchanged.
+ */
+bool optimizeMesh(VertexBuffer &vertexBuffer, IndexBuffer &indexBuffer);
+
+} // End of namespace Mesh
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_MESH_MESHOPTIMIZER_H
@@ -0,0 +1,250 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Storing the vertices of static meshes in compact, quantized layouts.
+ */
+
+#include <cstring>
+#include <cmath>
+
+#include "src/common/util.h"
+
+#include "src/graphics/vertexbuffer.h"
+
+#include "src/graphics/mesh/meshquantizer.h"
+
+namespace Graphics {
+
+namespace Mesh {
+
+static int16_t quantizeSigned(float value) {
+	return static_cast<int16_t>(std::lround(CLIP(value, -1.0f, 1.0f) * kPositionRange));
+}
+
+static uint16_t quantizeUnsigned(float value) {
+	return static_cast<uint16_t>(std::lround(CLIP(value, 0.0f, 1.0f) * kTexCoordRange));
+}
+
+static float signNotZero(float value) {
+	return (value < 0.0f) ? -1.0f : 1.0f;
+}
+
+void encodeOctahedral(int16_t *dst, float x, float y, float z) {
+	const float length = std::fabs(x) + std::fabs(y) + std::fabs(z);
+	if (length == 0.0f) {
+		dst[0] = dst[1] = 0;
+		return;
+	}
+
+	float u = x / length;
+	float v = y / length;
+
+	if (z < 0.0f) {
+		const float foldedU = (1.0f - std::fabs(v)) * signNotZero(u);
+		const float foldedV = (1.0f - std::fabs(u)) * signNotZero(v);
+
+		u = foldedU;
+		v = foldedV;
+	}
+
+	dst[0] = quantizeSigned(u);
+	dst[1] = quantizeSigned(v);
+}
+
+void decodeOctahedral(float *dst, const int16_t *src) {
+	float x = src[0] / kPositionRange;
+	float y = src[1] / kPositionRange;
+	float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+	if (z < 0.0f) {
+		const float unfoldedX = (1.0f - std::fabs(y)) * signNotZero(x);
+		const float unfoldedY = (1.0f - std::fabs(x)) * signNotZero(y);
+
+		x = unfoldedX;
+		y = unfoldedY;
+	}
+
+	const float length = std::sqrt(x * x + y * y + z * z);
+
+	dst[0] = x / length;
+	dst[1] = y / length;
+	dst[2] = z / length;
+}
+
+/** Return the data of one vertex attribute of one vertex. */
+static const byte *getAttribute(const VertexAttrib &attrib, size_t vertex) {
+	const size_t size   = attrib.size * VertexBuffer::getTypeSize(attrib.type);
+	const size_t stride = (attrib.stride != 0) ? attrib.stride : size;
+
+	return reinterpret_cast<const byte *>(attrib.pointer) + vertex * stride;
+}
+
+static bool isFloatAttribute(const VertexAttrib &attrib, GLint size) {
+	return (attrib.type == GL_FLOAT) && (attrib.size == size);
+}
+
+/** Find the range of the values of a float attribute. */
+static void getRange(const VertexAttrib &attrib, size_t vertexCount, float *min, float *max) {
+	for (GLint i = 0; i < attrib.size; i++) {
+		min[i] =  INFINITY;
+		max[i] = -INFINITY;
+	}
+
+	for (size_t v = 0; v < vertexCount; v++) {
+		float values[4];
+		std::memcpy(values, getAttribute(attrib, v), attrib.size * sizeof(float));
+
+		for (GLint i = 0; i < attrib.size; i++) {
+			min[i] = MIN(min[i], values[i]);
+			max[i] = MAX(max[i], values[i]);
+		}
+	}
+}
+
+bool quantizeMesh(VertexBuffer &vertexBuffer, glm::vec4 *decode) {
+	const size_t vertexCount = vertexBuffer.getCount();
+	if (vertexCount == 0)
+		return false;
+
+	const VertexDecl &decl = vertexBuffer.getVertexDecl();
+
+	// Check that we know how to quantize everything the shaders decode
+
+	bool hasPosition = false;
+	for (VertexDecl::const_iterator a = decl.begin(); a != decl.end(); ++a) {
+		if (!a->pointer || (VertexBuffer::getTypeSize(a->type) == 0))
+			return false;
+
+		if        (a->index == VPOSITION) {
+			if (!isFloatAttribute(*a, 3))
+				return false;
+
+			hasPosition = true;
+		} else if (a->index == VNORMAL) {
+			if (!isFloatAttribute(*a, 3))
+				return false;
+		} else if ((a->index == VTCOORD) || (a->index == (VTCOORD + 1))) {
+			if (!isFloatAttribute(*a, 2))
+				return false;
+		}
+	}
+
+	if (!hasPosition)
+		return false;
+
+	// Measure the positions and texture coordinates, and build the compact layout
+
+	decode[0] = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+	decode[1] = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+	decode[2] = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	decode[3] = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+	VertexDecl newDecl;
+	for (VertexDecl::const_iterator a = decl.begin(); a != decl.end(); ++a) {
+		float min[4], max[4];
+
+		if        (a->index == VPOSITION) {
+			getRange(*a, vertexCount, min, max);
+
+			for (int i = 0; i < 3; i++) {
+				decode[0][i] = (min[i] + max[i]) * 0.5f;
+				decode[1][i] = (max[i] - min[i]) * 0.5f / kPositionRange;
+			}
+
+			// The fourth component only pads the position to 8 bytes
+			newDecl.push_back(VertexAttrib(VPOSITION, 4, GL_SHORT));
+
+		} else if (a->index == VNORMAL) {
+			newDecl.push_back(VertexAttrib(VNORMAL, 2, GL_SHORT));
+
+		} else if ((a->index == VTCOORD) || (a->index == (VTCOORD + 1))) {
+			getRange(*a, vertexCount, min, max);
+
+			glm::vec4 &texDecode = decode[2 + a->index - VTCOORD];
+			for (int i = 0; i < 2; i++) {
+				texDecode[i    ] = min[i];
+				texDecode[i + 2] = (max[i] - min[i]) / kTexCoordRange;
+			}
+
+			newDecl.push_back(VertexAttrib(a->index, 2, GL_UNSIGNED_SHORT));
+
+		} else {
+			newDecl.push_back(VertexAttrib(a->index, a->size, a->type));
+		}
+	}
+
+	// Write the quantized vertex data
+
+	const VertexBuffer source(vertexBuffer);
+	const VertexDecl &sourceDecl = source.getVertexDecl();
+
+	vertexBuffer.setVertexDeclInterleave(vertexCount, newDecl);
+
+	for (size_t i = 0; i < newDecl.size(); i++) {
+		const VertexAttrib &from = sourceDecl[i];
+		const VertexAttrib &to   = newDecl[i];
+
+		const size_t size = to.size * VertexBuffer::getTypeSize(to.type);
+
+		for (size_t v = 0; v < vertexCount; v++) {
+			const byte *src = getAttribute(from, v);
+			byte       *dst = reinterpret_cast<byte *>(const_cast<GLvoid *>(to.pointer)) + v * to.stride;
+
+			float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			if (from.type == GL_FLOAT)
+				std::memcpy(values, src, MIN<size_t>(from.size, 4) * sizeof(float));
+
+			if        (to.index == VPOSITION) {
+				int16_t position[4] = { 0, 0, 0, 0 };
+				for (int j = 0; j < 3; j++)
+					if (decode[1][j] > 0.0f)
+						position[j] = quantizeSigned((values[j] - decode[0][j]) / (decode[1][j] * kPositionRange));
+
+				std::memcpy(dst, position, sizeof(position));
+
+			} else if (to.index == VNORMAL) {
+				int16_t normal[2];
+				encodeOctahedral(normal, values[0], values[1], values[2]);
+
+				std::memcpy(dst, normal, sizeof(normal));
+
+			} else if ((to.index == VTCOORD) || (to.index == (VTCOORD + 1))) {
+				const glm::vec4 &texDecode = decode[2 + to.index - VTCOORD];
+
+				uint16_t texCoord[2] = { 0, 0 };
+				for (int j = 0; j < 2; j++)
+					if (texDecode[j + 2] > 0.0f)
+						texCoord[j] = quantizeUnsigned((values[j] - texDecode[j]) / (texDecode[j + 2] * kTexCoordRange));
+
+				std::memcpy(dst, texCoord, sizeof(texCoord));
+
+			} else {
+				std::memcpy(dst, src, size);
+			}
+		}
+	}
+
+	return true;
+}
+
+} // End of namespace Mesh
+
+} // End of namespace Graphics
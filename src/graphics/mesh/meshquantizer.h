@@ -0,0 +1,90 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Storing the vertices of static meshes in compact, quantized layouts.
+ */
+
+#ifndef GRAPHICS_MESH_MESHQUANTIZER_H
+#define GRAPHICS_MESH_MESHQUANTIZER_H
+
+#include <cstddef>
+
+#include "external/glm/vec4.hpp"
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+class VertexBuffer;
+
+namespace Mesh {
+
+/** Number of vec4 in the parameters that decode a quantized vertex layout.
+ *
+ *  - [0]: Position offset (xyz)
+ *  - [1]: Position scale (xyz)
+ *  - [2]: Offset (xy) and scale (zw) of the first texture coordinates
+ *  - [3]: Offset (xy) and scale (zw) of the second texture coordinates
+ *
+ *  A decoded value is offset + scale * stored value.
+ */
+static const size_t kVertexDecodeSize = 4;
+
+/** Largest value of a quantized position component (a signed 16-bit integer). */
+static const float kPositionRange = 32767.0f;
+
+/** Largest value of a quantized texture coordinate (an unsigned 16-bit integer). */
+static const float kTexCoordRange = 65535.0f;
+
+/** Encode a unit vector into two signed 16-bit integers, with an octahedral projection.
+ *
+ *  The vector is projected onto an octahedron, whose lower half is then
+ *  folded over the upper half, onto the square [-1, 1]^2.
+ */
+void encodeOctahedral(int16_t *dst, float x, float y, float z);
+
+/** Decode a unit vector stored by encodeOctahedral(). */
+void decodeOctahedral(float *dst, const int16_t *src);
+
+/** Store the vertex data of a mesh in a compact layout.
+ *
+ *  - Positions become 4 signed 16-bit integers, relative to the bounding box
+ *  - Normals become 2 signed 16-bit integers, with an octahedral projection
+ *  - The first two sets of texture coordinates become 2 unsigned 16-bit
+ *    integers each, relative to their range
+ *
+ *  Other attributes are kept as they are. The vertex data is interleaved
+ *  afterwards, and shaders have to decode the values (see kVertexDecodeSize).
+ *
+ *  The mesh needs 3 float positions. Normals need to be 3 floats and texture
+ *  coordinates 2 floats, if they exist.
+ *
+ *  @param  vertexBuffer The vertex data to quantize.
+ *  @param  decode       Receives the kVertexDecodeSize decoding parameters.
+ *  @return false if the mesh couldn't be quantized, and is unchanged.
+ */
+bool quantizeMesh(VertexBuffer &vertexBuffer, glm::vec4 *decode);
+
+} // End of namespace Mesh
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_MESH_MESHQUANTIZER_H
@@ -28,6 +28,8 @@ src_graphics_mesh_libmesh_la_SOURCES += \
     src/graphics/mesh/meshwirebox.h \
     src/graphics/mesh/meshfont.h \
     src/graphics/mesh/meshquad.h \
+    src/graphics/mesh/meshoptimizer.h \
+    src/graphics/mesh/meshquantizer.h \
     $(EMPTY)
 
 src_graphics_mesh_libmesh_la_SOURCES += \
@@ -36,4 +38,6 @@ src_graphics_mesh_libmesh_la_SOURCES += \
     src/graphics/mesh/meshwirebox.cpp \
     src/graphics/mesh/meshfont.cpp \
     src/graphics/mesh/meshquad.cpp \
+    src/graphics/mesh/meshoptimizer.cpp \
+    src/graphics/mesh/meshquantizer.cpp \
     $(EMPTY)
@@ -31,7 +31,7 @@ namespace Graphics {
 
 Queueable::Queueable() {
 	for (int i = 0; i < kQueueMAX; i++)
-		_isInQueue[i] = false;
+		_queueIndex[i] = kNotInQueue;
 }
 
 Queueable::~Queueable() {
@@ -45,10 +45,8 @@ bool Queueable::operator<(const Queueable &UNUSED(q)) const {
 void Queueable::addToQueue(QueueType queue) {
 	QueueMan.lockQueue(queue);
 
-	if (!_isInQueue[queue]) {
-		_queueRef[queue] = QueueMan.addToQueue(queue, *this);
-		_isInQueue[queue] = true;
-	}
+	if (!isInQueue(queue))
+		QueueMan.addToQueue(queue, *this);
 
 	QueueMan.unlockQueue(queue);
 }
@@ -56,9 +54,9 @@ void Queueable::addToQueue(QueueType queue) {
 void Queueable::removeFromQueue(QueueType queue) {
 	QueueMan.lockQueue(queue);
 
-	if (_isInQueue[queue]) {
-		QueueMan.removeFromQueue(queue, _queueRef[queue]);
-		_isInQueue[queue] = false;
+	if (isInQueue(queue)) {
+		QueueMan.removeFromQueue(queue, *this);
+		_queueIndex[queue] = kNotInQueue;
 	}
 
 	QueueMan.unlockQueue(queue);
@@ -73,9 +71,7 @@ void Queueable::unlockQueue(QueueType queue) {
 }
 
 void Queueable::sortQueue(QueueType queue) {
-	QueueMan.lockQueue(queue);
-	QueueMan.sortQueue(queue);
-	QueueMan.unlockQueue(queue);
+	QueueMan.markQueueUnsorted(queue);
 }
 
 void Queueable::removeFromAll() {
@@ -86,7 +82,7 @@ void Queueable::removeFromAll() {
 void Queueable::kickedOut(QueueType queue) {
 	QueueMan.lockQueue(queue);
 
-	_isInQueue[queue] = false;
+	_queueIndex[queue] = kNotInQueue;
 
 	QueueMan.unlockQueue(queue);
 }
@@ -25,7 +25,7 @@
 #ifndef GRAPHICS_QUEUEABLE_H
 #define GRAPHICS_QUEUEABLE_H
 
-#include <list>
+#include <cstddef>
 
 #include "src/graphics/types.h"
 
@@ -40,7 +40,7 @@ public:
 
 protected:
 	bool isInQueue(QueueType queue) const {
-		return _isInQueue[queue];
+		return _queueIndex[queue] != kNotInQueue;
 	}
 
 	void addToQueue(QueueType queue);
@@ -48,11 +48,14 @@ protected:
 
 	void lockQueue(QueueType queue);
 	void unlockQueue(QueueType queue);
+	/** Request a resort of the queue, to be done before it is next used. */
 	void sortQueue(QueueType queue);
 
 private:
-	bool _isInQueue[kQueueMAX];
-	std::list<Queueable *>::iterator _queueRef[kQueueMAX];
+	static const size_t kNotInQueue = SIZE_MAX;
+
+	/** Our index within each queue, or kNotInQueue. Maintained by the QueueManager. */
+	size_t _queueIndex[kQueueMAX];
 
 	void removeFromAll();
 	void kickedOut(QueueType queue);
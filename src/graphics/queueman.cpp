@@ -22,6 +22,10 @@
  *  The graphics queue manager.
  */
 
+#include <cassert>
+
+#include <algorithm>
+
 #include "src/graphics/queueman.h"
 #include "src/graphics/queueable.h"
 
@@ -33,6 +37,39 @@ static bool queueComp(Queueable *a, Queueable *b) {
 	return *a < *b;
 }
 
+/** Stable insertion sort of a queue.
+ *
+ *  Between two frames, the camera and the objects only move a little, so
+ *  the queue order barely changes. In that case, this is a linear pass
+ *  over the queue, instead of a full merge sort.
+ *
+ *  If the order changed too much (for example, after the camera jumped),
+ *  we give up and return false, so that the caller can do a full sort.
+ */
+static bool insertionSort(std::vector<Queueable *> &queue) {
+	// How many element moves we are willing to do in total
+	size_t budget = 8 * queue.size();
+
+	for (size_t i = 1; i < queue.size(); i++) {
+		Queueable *q = queue[i];
+
+		size_t j = i;
+		while ((j > 0) && queueComp(q, queue[j - 1])) {
+			if (budget-- == 0) {
+				queue[j] = q;
+				return false;
+			}
+
+			queue[j] = queue[j - 1];
+			j--;
+		}
+
+		queue[j] = q;
+	}
+
+	return true;
+}
+
 
 QueueManager::QueueManager() {
 }
@@ -49,55 +86,108 @@ void QueueManager::unlockQueue(QueueType queue) {
 	_queueMutex[queue].unlock();
 }
 
-bool QueueManager::isQueueEmpty(QueueType queue) {
-	std::lock_guard<std::recursive_mutex> lock(_queueMutex[queue]);
+bool QueueManager::isQueueEmpty(QueueType queue) const {
+	return _queue[queue].size.load(std::memory_order_acquire) == 0;
+}
 
-	return _queue[queue].empty();
+size_t QueueManager::getQueueSize(QueueType queue) const {
+	return _queue[queue].size.load(std::memory_order_acquire);
 }
 
-const std::list<Queueable *> &QueueManager::getQueue(QueueType queue) const {
-	return _queue[queue];
+const std::vector<Queueable *> &QueueManager::getQueue(QueueType queue) const {
+	return _queue[queue].objects;
 }
 
 void QueueManager::sortQueue(QueueType queue) {
-	lockQueue(queue);
+	std::lock_guard<std::recursive_mutex> lock(_queueMutex[queue]);
+
+	compactQueue(queue);
 
-	_queue[queue].sort(queueComp);
+	std::vector<Queueable *> &objects = _queue[queue].objects;
+	if (!insertionSort(objects))
+		std::stable_sort(objects.begin(), objects.end(), queueComp);
 
-	unlockQueue(queue);
+	reindexQueue(queue);
+
+	_queue[queue].unsorted = false;
 }
 
-std::list<Queueable *>::iterator QueueManager::addToQueue(QueueType queue, Queueable &q) {
-	lockQueue(queue);
+void QueueManager::markQueueUnsorted(QueueType queue) {
+	std::lock_guard<std::recursive_mutex> lock(_queueMutex[queue]);
 
-	_queue[queue].push_back(&q);
-	std::list<Queueable *>::iterator ref = --_queue[queue].end();
+	_queue[queue].unsorted = true;
+}
+
+bool QueueManager::sortQueueIfUnsorted(QueueType queue) {
+	std::lock_guard<std::recursive_mutex> lock(_queueMutex[queue]);
 
-	unlockQueue(queue);
+	if (!_queue[queue].unsorted)
+		return false;
 
-	return ref;
+	sortQueue(queue);
+	return true;
 }
 
-void QueueManager::removeFromQueue(QueueType queue,
-		const std::list<Queueable *>::iterator &ref) {
+void QueueManager::addToQueue(QueueType queue, Queueable &q) {
+	std::lock_guard<std::recursive_mutex> lock(_queueMutex[queue]);
+
+	Queue &qu = _queue[queue];
+
+	q._queueIndex[queue] = qu.objects.size();
+	qu.objects.push_back(&q);
+
+	qu.size.fetch_add(1, std::memory_order_release);
+}
+
+void QueueManager::removeFromQueue(QueueType queue, Queueable &q) {
+	std::lock_guard<std::recursive_mutex> lock(_queueMutex[queue]);
+
+	Queue &qu = _queue[queue];
+
+	const size_t index = q._queueIndex[queue];
+	assert((index < qu.objects.size()) && (qu.objects[index] == &q));
+
+	qu.objects[index] = 0;
+	qu.holes++;
 
-	lockQueue(queue);
+	qu.size.fetch_sub(1, std::memory_order_release);
+}
+
+void QueueManager::compactQueue(QueueType queue) {
+	std::lock_guard<std::recursive_mutex> lock(_queueMutex[queue]);
+
+	Queue &qu = _queue[queue];
+	if (qu.holes == 0)
+		return;
+
+	qu.objects.erase(std::remove(qu.objects.begin(), qu.objects.end(), static_cast<Queueable *>(0)),
+	                 qu.objects.end());
 
-	_queue[queue].erase(ref);
+	qu.holes = 0;
 
-	unlockQueue(queue);
+	reindexQueue(queue);
+}
+
+void QueueManager::reindexQueue(QueueType queue) {
+	std::vector<Queueable *> &objects = _queue[queue].objects;
+
+	for (size_t i = 0; i < objects.size(); i++)
+		objects[i]->_queueIndex[queue] = i;
 }
 
 void QueueManager::clearQueue(QueueType queue) {
-	lockQueue(queue);
+	std::lock_guard<std::recursive_mutex> lock(_queueMutex[queue]);
+
+	Queue &qu = _queue[queue];
 
-	for (std::list<Queueable *>::iterator q = _queue[queue].begin();
-	     q != _queue[queue].end(); ++q)
-		(*q)->kickedOut(queue);
+	for (size_t i = 0; i < qu.objects.size(); i++)
+		if (qu.objects[i])
+			qu.objects[i]->kickedOut(queue);
 
-	_queue[queue].clear();
+	qu.objects.clear();
+	qu.holes = 0;
 
-	unlockQueue(queue);
+	qu.size.store(0, std::memory_order_release);
 }
 
 void QueueManager::clearAllQueues() {
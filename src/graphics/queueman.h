@@ -25,7 +25,8 @@
 #ifndef GRAPHICS_QUEUEMAN_H
 #define GRAPHICS_QUEUEMAN_H
 
-#include <list>
+#include <vector>
+#include <atomic>
 
 #include "src/common/types.h"
 #include "src/common/singleton.h"
@@ -37,30 +38,77 @@ namespace Graphics {
 
 class Queueable;
 
-/** The graphics queue manager. */
+/** The graphics queue manager.
+ *
+ *  Each queue is a contiguous array of objects. Every object remembers its
+ *  index within each queue it is in, so it can remove itself in constant time.
+ *
+ *  Removal is deferred: it only clears the object's slot. The empty slots are
+ *  compacted away when the queue is sorted or explicitly compacted, which the
+ *  graphics manager does once per frame, before rendering. This means that
+ *  objects can leave a queue while it is being iterated over, without
+ *  disturbing the iteration.
+ *
+ *  When iterating over a queue, the caller needs to hold the lock of the
+ *  queue, iterate by index (the queue might grow during the iteration) and
+ *  skip empty slots (0).
+ */
 class QueueManager : public Common::Singleton<QueueManager> {
 public:
 	QueueManager();
 	~QueueManager();
 
-	bool isQueueEmpty(QueueType queue);
+	/** Is the queue empty? This does not need to lock the queue. */
+	bool isQueueEmpty(QueueType queue) const;
+	/** Return the number of objects in the queue. This does not need to lock the queue. */
+	size_t getQueueSize(QueueType queue) const;
 
 	void lockQueue(QueueType queue);
 	void unlockQueue(QueueType queue);
 
-	const std::list<Queueable *> &getQueue(QueueType queue) const;
+	/** Return the contents of the queue, which may contain empty slots. */
+	const std::vector<Queueable *> &getQueue(QueueType queue) const;
 
+	/** Sort the queue by distance, exploiting an already mostly sorted order. */
 	void sortQueue(QueueType queue);
 	void clearQueue(QueueType queue);
 
+	/** Mark the queue as needing to be sorted before its next use. */
+	void markQueueUnsorted(QueueType queue);
+	/** Sort the queue, but only if it was marked as unsorted.
+	 *
+	 *  @return true if the queue was actually sorted.
+	 */
+	bool sortQueueIfUnsorted(QueueType queue);
+
+	/** Remove all empty slots from the queue, keeping the order of the objects.
+	 *
+	 *  This must not be called while the queue is being iterated over.
+	 */
+	void compactQueue(QueueType queue);
+
 	void clearAllQueues();
 
 private:
+	struct Queue {
+		std::vector<Queueable *> objects; ///< The objects, including empty slots.
+
+		size_t holes;    ///< Number of empty slots in the objects array.
+		bool   unsorted; ///< Does the queue need to be sorted?
+
+		std::atomic<size_t> size; ///< Number of actual objects in the queue.
+
+		Queue() : holes(0), unsorted(false), size(0) { }
+	};
+
 	std::recursive_mutex _queueMutex[kQueueMAX];
-	std::list<Queueable *> _queue[kQueueMAX];
+	Queue _queue[kQueueMAX];
+
+	void addToQueue(QueueType queue, Queueable &q);
+	void removeFromQueue(QueueType queue, Queueable &q);
 
-	std::list<Queueable *>::iterator addToQueue(QueueType queue, Queueable &q);
-	void removeFromQueue(QueueType queue, const std::list<Queueable *>::iterator &ref);
+	/** Tell all objects in the queue their current index. */
+	void reindexQueue(QueueType queue);
 
 	friend class Queueable;
 };
@@ -160,6 +160,7 @@ void RenderQueue::render() {
 		assert(currentMaterial);
 
 		currentSurface->bindProgram(currentProgram, _nodeArray[i].transform);
+		currentSurface->bindVertexDecode(currentProgram, currentMesh->getVertexDecode());
 		//currentSurface->bindObjectModelview(currentProgram, _nodeArray[i].transform);
 		bindBoneUniforms(currentProgram, currentSurface, currentMesh);
 		currentMaterial->bindFade(currentProgram, _nodeArray[i].alpha);
@@ -95,6 +95,8 @@ void MaterialManager::init() {
 }
 
 void MaterialManager::deinit() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	for (std::map<Common::UString, ShaderMaterial *>::iterator iter = _resourceMap.begin(); iter != _resourceMap.end(); ++iter) {
 		delete iter->second;
 	}
@@ -102,6 +104,8 @@ void MaterialManager::deinit() {
 }
 
 void MaterialManager::cleanup() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	std::map<Common::UString, ShaderMaterial *>::iterator iter = _resourceMap.begin();
 	while (iter != _resourceMap.end()) {
 		ShaderMaterial *material = iter->second;
@@ -114,6 +118,8 @@ void MaterialManager::cleanup() {
 }
 
 void MaterialManager::addMaterial(ShaderMaterial *material) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	if (!material) {
 		return;
 	}
@@ -125,6 +131,8 @@ void MaterialManager::addMaterial(ShaderMaterial *material) {
 }
 
 void MaterialManager::delMaterial(ShaderMaterial *material) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	if (!material) {
 		return;
 	}
@@ -136,6 +144,8 @@ void MaterialManager::delMaterial(ShaderMaterial *material) {
 }
 
 ShaderMaterial *MaterialManager::getMaterial(const Common::UString &name) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	std::map<Common::UString, ShaderMaterial *>::iterator iter = _resourceMap.find(name);
 	if (iter != _resourceMap.end()) {
 		return iter->second;
@@ -121,6 +121,7 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 	}
 
 	int boneCount = 0;
+	bool vertexDecode = false;
 
 	/**
 	 * Extra uniform declarations. These will go into either vertex or fragment
@@ -138,6 +139,18 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 			v_header += "uniform mat4 _boneTransforms[" + Common::composeString(_uniformDescriptors[i].count) + "];\n";
 			boneCount = _uniformDescriptors[i].count;
 			break;
+		case UNIFORM_V_VERTEX_DECODE:
+			// Position offset and scale, then offset and scale of both texture coordinates
+			v_header += "uniform vec4 _vertexDecode[4];\n"
+			            "vec3 decodeOctahedral(vec2 e) {\n"
+			            "	vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));\n"
+			            "	if (n.z < 0.0) {\n"
+			            "		n.xy = (1.0 - abs(n.yx)) * vec2((n.x < 0.0) ? -1.0 : 1.0, (n.y < 0.0) ? -1.0 : 1.0);\n"
+			            "	}\n"
+			            "	return normalize(n);\n"
+			            "}\n";
+			vertexDecode = true;
+			break;
 		case UNIFORM_F_ALPHA: break;
 		case UNIFORM_F_COLOUR:
 			f_header += "uniform vec4 _colour;\n";
@@ -146,6 +159,22 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 		}
 	}
 
+	/**
+	 * Vertex inputs that might be stored in a compact layout. Positions and texture
+	 * coordinates are then 16-bit integers that need an offset and a scale, normals
+	 * two 16-bit integers with an octahedral projection.
+	 */
+	Common::UString position0String = "inputPosition0.xyz";
+	Common::UString normal0String = "inputNormal0.xyz";
+	Common::UString uv0String = "inputUV0.xy";
+	Common::UString uv1String = "inputUV1.xy";
+	if (vertexDecode) {
+		position0String = "(_vertexDecode[0].xyz + _vertexDecode[1].xyz * inputPosition0.xyz)";
+		normal0String = "decodeOctahedral(inputNormal0.xy / 32767.0)";
+		uv0String = "(_vertexDecode[2].xy + _vertexDecode[2].zw * inputUV0.xy)";
+		uv1String = "(_vertexDecode[3].xy + _vertexDecode[3].zw * inputUV1.xy)";
+	}
+
 	/**
 	 * Vertex shader input declarations.
 	 *
@@ -185,7 +214,7 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 				f_desc_string = "varying vec3 position0;\n";
 			}
 			if (boneCount > 0) {
-				body_desc_string = "vec4 iv = vec4(inputPosition0.xyz, 1.0f);\n"
+				body_desc_string = "vec4 iv = vec4(" + position0String + ", 1.0f);\n"
 				                   "vec4 _vertex = vec4(0.0f, 0.0f, 0.0f, 1.0f);\n"
 				                   "mat4 invBindPose = inverse(_bindPose);\n"
 				                   "for (int i = 0; i < 4; ++i) {\n"
@@ -207,7 +236,7 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 				                   "position0 = vec3(_vertex);\n";
 			} else {
 				///< @note This is always going to be transform matrix modified.
-				body_desc_string = "vec4 _vertex = mo * vec4(inputPosition0.xyz, 1.0f);\n"
+				body_desc_string = "vec4 _vertex = mo * vec4(" + position0String + ", 1.0f);\n"
 				                   "gl_Position = _projectionMatrix * _vertex;\n"
 				                   "position0 = vec3(_vertex);\n";
 			}
@@ -259,7 +288,7 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 				f_desc_string = "varying vec3 normal0;\n";
 			}
 			///< @todo This is always modified by something special.
-			body_desc_string = "normal0 = inputNormal0.xyz;\n";
+			body_desc_string = "normal0 = " + normal0String + ";\n";
 			break;
 		case INPUT_NORMAL1:
 			if (isGL3) {
@@ -304,7 +333,7 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 				output_desc_string = "varying vec2 uv0;\n";
 				f_desc_string = "varying vec2 uv0;\n";
 			}
-			body_desc_string = "uv0 = inputUV0.xy;\n";
+			body_desc_string = "uv0 = " + uv0String + ";\n";
 			break;
 		case INPUT_UV1:
 			if (isGL3) {
@@ -316,7 +345,7 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 				output_desc_string = "varying vec2 uv1;\n";
 				f_desc_string = "varying vec2 uv1;\n";
 			}
-			body_desc_string = "uv1 = inputUV1.xy;\n";
+			body_desc_string = "uv1 = " + uv1String + ";\n";
 			break;
 		case INPUT_UV0_MATRIX:
 			if (isGL3) {
@@ -330,7 +359,7 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 				output_desc_string = "varying vec2 uv0;\n";
 				f_desc_string = "varying vec2 uv0;\n";
 			}
-			body_desc_string = "uv0 = (_uv0Matrix * vec4(inputUV0.xy, 0.0, 1.0)).xy;\n";
+			body_desc_string = "uv0 = (_uv0Matrix * vec4(" + uv0String + ", 0.0, 1.0)).xy;\n";
 			break;
 		case INPUT_UV1_MATRIX:
 			if (isGL3) {
@@ -344,7 +373,7 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 				output_desc_string = "varying vec2 uv1;\n";
 				f_desc_string = "varying vec2 uv1;\n";
 			}
-			body_desc_string = "uv1 = (_uv1Matrix * vec4(inputUV1.xy, 0.0, 1.0)).xy;\n";
+			body_desc_string = "uv1 = (_uv1Matrix * vec4(" + uv1String + ", 0.0, 1.0)).xy;\n";
 			break;
 		case INPUT_UV_CUBE:
 			if (isGL3) {
@@ -668,6 +697,7 @@ void ShaderDescriptor::genName(Common::UString &n_string) {
 		switch (_uniformDescriptors[i].uniform) {
 		case UNIFORM_V_BIND_POSE: n_string += "uniform_bindpose"; break;
 		case UNIFORM_V_BONE_TRANSFORMS: n_string += "uniform_bonetransforms" + Common::composeString(_uniformDescriptors[i].count); break;
+		case UNIFORM_V_VERTEX_DECODE: n_string += "uniform_vertexdecode"; break;
 		default: break;
 		}
 	}
@@ -94,6 +94,7 @@ public:
 		UNIFOM_V_MODELVIEW_MATRIX,
 		UNIFORM_V_BIND_POSE,
 		UNIFORM_V_BONE_TRANSFORMS,
+		UNIFORM_V_VERTEX_DECODE,  ///< Decode vertices stored in a compact layout, see Mesh::quantizeMesh().
 		UNIFORM_F_ALPHA,
 		UNIFORM_F_COLOUR
 	};
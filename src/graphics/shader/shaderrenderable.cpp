@@ -155,6 +155,7 @@ void ShaderRenderable::renderImmediate(const glm::mat4 &tform, float alpha) {
 	_material->bindProgram(_program, alpha);
 	_material->bindGLState();
 	_surface->bindProgram(_program, &tform);
+	_surface->bindVertexDecode(_program, _mesh->getVertexDecode());
 	_surface->bindGLState();
 
 	_mesh->renderImmediate();
@@ -44,7 +44,8 @@ ShaderSurface::ShaderSurface(Shader::ShaderObject *vertShader, const Common::USt
 		_objectModelviewIndex(std::numeric_limits<uint32_t>::max()),
 		_textureViewIndex(std::numeric_limits<uint32_t>::max()),
 		_bindPoseIndex(std::numeric_limits<uint32_t>::max()),
-		_boneTransformsIndex(std::numeric_limits<uint32_t>::max()) {
+		_boneTransformsIndex(std::numeric_limits<uint32_t>::max()),
+		_vertexDecodeIndex(std::numeric_limits<uint32_t>::max()) {
 
 	vertShader->usageCount++;
 
@@ -66,6 +67,8 @@ ShaderSurface::ShaderSurface(Shader::ShaderObject *vertShader, const Common::USt
 			_bindPoseIndex = i;
 		} else if (vertShader->variablesCombined[i].name == "_boneTransforms") {
 			_boneTransformsIndex = i;
+		} else if (vertShader->variablesCombined[i].name == "_vertexDecode") {
+			_vertexDecodeIndex = i;
 		}
 	}
 }
@@ -215,6 +218,12 @@ void ShaderSurface::bindBoneTransforms(Shader::ShaderProgram *program, const flo
 	}
 }
 
+void ShaderSurface::bindVertexDecode(Shader::ShaderProgram *program, const glm::vec4 *decode) {
+	if ((_vertexDecodeIndex != std::numeric_limits<uint32_t>::max()) && decode) {
+		ShaderMan.bindShaderVariable(program->vertexObject->variablesCombined[_vertexDecodeIndex], program->vertexVariableLocations[_vertexDecodeIndex], glm::value_ptr(decode[0]));
+	}
+}
+
 void ShaderSurface::bindGLState() {
 	if (_flags & SHADER_SURFACE_NOCULL) {
 		glDisable(GL_CULL_FACE);
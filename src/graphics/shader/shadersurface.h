@@ -80,6 +80,7 @@ public:
 	void bindTextureView(Shader::ShaderProgram *program, const glm::mat4 *t);
 	void bindBindPose(Shader::ShaderProgram *program, const glm::mat4 *t);
 	void bindBoneTransforms(Shader::ShaderProgram *program, const float *t);
+	void bindVertexDecode(Shader::ShaderProgram *program, const glm::vec4 *decode);
 
 	void bindGLState();
 	void unbindGLState();
@@ -107,6 +108,7 @@ private:
 	uint32_t _textureViewIndex;
 	uint32_t _bindPoseIndex;
 	uint32_t _boneTransformsIndex;
+	uint32_t _vertexDecodeIndex;
 
 	void *genSurfaceVar(uint32_t index);
 	void delSurfaceVar(uint32_t index);
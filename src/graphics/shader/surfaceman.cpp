@@ -52,6 +52,8 @@ void SurfaceManager::init() {
 }
 
 void SurfaceManager::deinit() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	for (std::map<Common::UString, ShaderSurface *>::iterator iter = _resourceMap.begin(); iter != _resourceMap.end(); ++iter) {
 		delete iter->second;
 	}
@@ -59,6 +61,8 @@ void SurfaceManager::deinit() {
 }
 
 void SurfaceManager::cleanup() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	std::map<Common::UString, ShaderSurface *>::iterator iter = _resourceMap.begin();
 	while (iter != _resourceMap.end()) {
 		ShaderSurface *surface = iter->second;
@@ -72,6 +76,8 @@ void SurfaceManager::cleanup() {
 }
 
 void SurfaceManager::addSurface(ShaderSurface *surface) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	if (!surface) {
 		return;
 	}
@@ -83,6 +89,8 @@ void SurfaceManager::addSurface(ShaderSurface *surface) {
 }
 
 void SurfaceManager::delSurface(ShaderSurface *surface) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	if (!surface) {
 		return;
 	}
@@ -94,6 +102,8 @@ void SurfaceManager::delSurface(ShaderSurface *surface) {
 }
 
 ShaderSurface *SurfaceManager::getSurface(const Common::UString &name) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
 	std::map<Common::UString, ShaderSurface *>::iterator iter = _resourceMap.find(name);
 	if (iter != _resourceMap.end()) {
 		return iter->second;
@@ -29,6 +29,7 @@
 
 #include "src/common/ustring.h"
 #include "src/common/singleton.h"
+#include "src/common/mutex.h"
 
 #include "src/graphics/shader/shadersurface.h"
 
@@ -62,6 +63,8 @@ public:
 private:
 	std::map<Common::UString, ShaderSurface *> _resourceMap;
 
+	std::recursive_mutex _mutex; ///< Protects the resources, which can be used from several threads.
+
 	std::map<Common::UString, ShaderSurface *>::iterator delResource(std::map<Common::UString, ShaderSurface *>::iterator iter);
 };
 
@@ -136,6 +136,9 @@ public:
 	/** Draw this IndexBuffer/VertexBuffer combination. */
 	void draw(GLenum mode, const IndexBuffer &indexBuffer) const;
 
+	/** Return the size in bytes of one component of this type, or 0 if it's not supported. */
+	static uint32_t getTypeSize(GLenum type);
+
 private:
 	VertexDecl _decl;  ///< Vertex declaration.
 	uint32_t   _count; ///< Number of elements in buffer.
@@ -144,8 +147,6 @@ private:
 
 	GLuint _vbo;       ///< Vertex Buffer Object.
 	GLuint _hint;      ///< GL hint for static or dynamic data.
-
-	static uint32_t getTypeSize(GLenum type);
 };
 
 } // End of namespace Graphics
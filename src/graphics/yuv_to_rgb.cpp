@@ -92,6 +92,20 @@
 
 #include "src/graphics/yuv_to_rgb.h"
 
+// SSE2 is always there on x86-64. AVX2 is picked at runtime, where the compiler lets us.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define XOREOS_YUV_SSE2 1
+
+	#include <emmintrin.h>
+
+	#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		#define XOREOS_YUV_AVX2 1
+		#define XOREOS_YUV_AVX2_TARGET __attribute__((target("avx2")))
+
+		#include <immintrin.h>
+	#endif
+#endif
+
 DECLARE_SINGLETON(Graphics::YUVToRGBManager)
 
 namespace Graphics {
@@ -158,7 +172,12 @@ YUVToRGBLookup::YUVToRGBLookup(YUVToRGBManager::LuminanceScale scale) {
 	}
 }
 
-YUVToRGBManager::YUVToRGBManager() {
+YUVToRGBManager::YUVToRGBManager() : _implementation(kImplementationTable) {
+	if      (hasImplementation(kImplementationAVX2))
+		_implementation = kImplementationAVX2;
+	else if (hasImplementation(kImplementationSSE2))
+		_implementation = kImplementationSSE2;
+
 	int16_t *Cr_r_tab = &_colorTab[0 * 256];
 	int16_t *Cr_g_tab = &_colorTab[1 * 256];
 	int16_t *Cb_g_tab = &_colorTab[2 * 256];
@@ -196,79 +215,330 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(LuminanceScale scale) {
 	*((d) + 2) = L[cr_r]; \
 	*((d) + 3) = (a)
 
-void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(scale);
-	const byte *rgbToPix = lookup->getRGBToPix();
+/** Convert the pixel pairs in [start, yWidth) of two rows using the lookup tables.
+ *
+ *  The first row of ySrc goes to dst + dstPitch, the second row to dst.
+ *  For an odd yWidth, the last column has no partner and is left alone.
+ */
+template<bool kAlpha>
+static void convertRowsTable(const int16_t *colorTab, const byte *rgbToPix, byte *dst, int dstPitch,
+                             const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                             int start, int yWidth, int yPitch) {
+
+	for (int x = start; (x + 1) < yWidth; x += 2) {
+		const byte *L;
+
+		int16_t cr_r  = colorTab[vSrc[x >> 1] + 0 * 256];
+		int16_t crb_g = colorTab[vSrc[x >> 1] + 1 * 256] + colorTab[uSrc[x >> 1] + 2 * 256];
+		int16_t cb_b  = colorTab[uSrc[x >> 1] + 3 * 256];
+
+		PUT_PIXEL(ySrc[x             ], kAlpha ? aSrc[x             ] : 0xFF, dst + dstPitch + x * 4);
+		PUT_PIXEL(ySrc[x + yPitch    ], kAlpha ? aSrc[x + yPitch    ] : 0xFF, dst            + x * 4);
+		PUT_PIXEL(ySrc[x + 1         ], kAlpha ? aSrc[x + 1         ] : 0xFF, dst + dstPitch + x * 4 + 4);
+		PUT_PIXEL(ySrc[x + 1 + yPitch], kAlpha ? aSrc[x + 1 + yPitch] : 0xFF, dst            + x * 4 + 4);
+	}
+}
 
-	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
+#undef PUT_PIXEL
 
-	dst += dstPitch * (yHeight - 2);
+/* The SIMD implementations calculate the same values as the lookup tables.
+ *
+ * The chroma tables hold trunc(c * (x - 128)) for four factors c. We get
+ * the same values with (integer(c) * n + ((n * kFrac) >> 16)), with n being
+ * |x - 128| and the sign applied afterwards. The fractional multipliers
+ * have been checked to give exact results for all n in [0, 128].
+ *
+ * With the ITU luminance scale, the rgbToPix table maps the sum s to
+ * (clamp(s, 16, 235) - 16) * 255 / 219, which we get exactly as
+ * t + ((t * kITUFrac) >> 16) for t = clamp(s, 16, 235) - 16.
+ */
 
-	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			const byte *L;
-
-			int16_t cr_r  = _colorTab[*vSrc + 0 * 256];
-			int16_t crb_g = _colorTab[*vSrc + 1 * 256] + _colorTab[*uSrc + 2 * 256];
-			int16_t cb_b  = _colorTab[*uSrc + 3 * 256];
-			uSrc++;
-			vSrc++;
-
-			PUT_PIXEL(*ySrc, *aSrc, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), *(aSrc + yPitch), dst);
-			ySrc++;
-			aSrc++;
-			dst += 4;
-			PUT_PIXEL(*ySrc, *aSrc, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), *(aSrc + yPitch), dst);
-			ySrc++;
-			aSrc++;
-			dst += 4;
-		}
+static const uint16_t kCrRFrac = 26266; ///< 0.419 / 0.299 = 1 + kCrRFrac / 65536
+static const uint16_t kCrGFrac = 46773; ///< 0.299 / 0.419 =     kCrGFrac / 65536
+static const uint16_t kCbGFrac = 22568; ///< 0.114 / 0.331 =     kCbGFrac / 65536
+static const uint16_t kCbBFrac = 50685; ///< 0.587 / 0.331 = 1 + kCbBFrac / 65536
+
+static const uint16_t kITUFrac = 10776; ///< 255 / 219 = 1 + kITUFrac / 65536
+
+#if defined(XOREOS_YUV_SSE2)
+
+/** trunc(c * x), for c = integer + frac / 65536 and x in [-128, 127]. */
+static inline __m128i chromaSSE2(__m128i x, bool integer, uint16_t frac) {
+	const __m128i sign = _mm_srai_epi16(x, 15);
+	const __m128i n    = _mm_sub_epi16(_mm_xor_si128(x, sign), sign);
 
-		dst -= yWidth * 4 + dstPitch * 2;
-		ySrc += (yPitch << 1) - yWidth;
-		aSrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+	__m128i c = _mm_mulhi_epu16(n, _mm_set1_epi16(frac));
+	if (integer)
+		c = _mm_add_epi16(c, n);
+
+	return _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+}
+
+/** Map luminance sums to pixel values, like the rgbToPix table. */
+static inline __m128i packSSE2(YUVToRGBManager::LuminanceScale scale, __m128i lo, __m128i hi) {
+	if (scale == YUVToRGBManager::kScaleITU) {
+		const __m128i min  = _mm_set1_epi16(16);
+		const __m128i max  = _mm_set1_epi16(235);
+		const __m128i frac = _mm_set1_epi16(kITUFrac);
+
+		lo = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(lo, min), max), min);
+		hi = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(hi, min), max), min);
+
+		lo = _mm_add_epi16(lo, _mm_mulhi_epu16(lo, frac));
+		hi = _mm_add_epi16(hi, _mm_mulhi_epu16(hi, frac));
 	}
+
+	return _mm_packus_epi16(lo, hi);
 }
 
-void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(scale);
+/** Convert one row of 16 pixels and store them as BGRA. */
+static inline void convertRowSSE2(YUVToRGBManager::LuminanceScale scale, byte *dst, const byte *ySrc,
+                                  const byte *aSrc, __m128i rLo, __m128i rHi, __m128i gLo, __m128i gHi,
+                                  __m128i bLo, __m128i bHi) {
+
+	const __m128i zero = _mm_setzero_si128();
+
+	const __m128i y   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ySrc));
+	const __m128i yLo = _mm_unpacklo_epi8(y, zero);
+	const __m128i yHi = _mm_unpackhi_epi8(y, zero);
+
+	const __m128i r = packSSE2(scale, _mm_add_epi16(yLo, rLo), _mm_add_epi16(yHi, rHi));
+	const __m128i g = packSSE2(scale, _mm_add_epi16(yLo, gLo), _mm_add_epi16(yHi, gHi));
+	const __m128i b = packSSE2(scale, _mm_add_epi16(yLo, bLo), _mm_add_epi16(yHi, bHi));
+	const __m128i a = aSrc ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(aSrc)) : _mm_set1_epi8(-1);
+
+	const __m128i bgLo = _mm_unpacklo_epi8(b, g);
+	const __m128i bgHi = _mm_unpackhi_epi8(b, g);
+	const __m128i raLo = _mm_unpacklo_epi8(r, a);
+	const __m128i raHi = _mm_unpackhi_epi8(r, a);
+
+	__m128i *out = reinterpret_cast<__m128i *>(dst);
+	_mm_storeu_si128(out + 0, _mm_unpacklo_epi16(bgLo, raLo));
+	_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(bgLo, raLo));
+	_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(bgHi, raHi));
+	_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(bgHi, raHi));
+}
+
+/** Convert two rows, 16 pixels at a time. Returns the number of pixels converted. */
+static int convertRowsSSE2(YUVToRGBManager::LuminanceScale scale, byte *dst, int dstPitch,
+                           const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                           int yWidth, int yPitch) {
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi16(128);
+
+	int x = 0;
+	for (; x + 16 <= yWidth; x += 16) {
+		const __m128i u = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(uSrc + (x >> 1))), zero), bias);
+		const __m128i v = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(vSrc + (x >> 1))), zero), bias);
+
+		const __m128i r = chromaSSE2(v, true, kCrRFrac);
+		const __m128i g = _mm_sub_epi16(zero, _mm_add_epi16(chromaSSE2(v, false, kCrGFrac), chromaSSE2(u, false, kCbGFrac)));
+		const __m128i b = chromaSSE2(u, true, kCbBFrac);
+
+		// Each chroma sample covers two pixels in a row
+		const __m128i rLo = _mm_unpacklo_epi16(r, r), rHi = _mm_unpackhi_epi16(r, r);
+		const __m128i gLo = _mm_unpacklo_epi16(g, g), gHi = _mm_unpackhi_epi16(g, g);
+		const __m128i bLo = _mm_unpacklo_epi16(b, b), bHi = _mm_unpackhi_epi16(b, b);
+
+		convertRowSSE2(scale, dst + dstPitch + x * 4, ySrc + x, aSrc ? aSrc + x : 0,
+		               rLo, rHi, gLo, gHi, bLo, bHi);
+		convertRowSSE2(scale, dst + x * 4, ySrc + yPitch + x, aSrc ? aSrc + yPitch + x : 0,
+		               rLo, rHi, gLo, gHi, bLo, bHi);
+	}
+
+	return x;
+}
+
+#endif // XOREOS_YUV_SSE2
+
+#if defined(XOREOS_YUV_AVX2)
+
+/* The AVX2 code works like the SSE2 code, on 32 pixels at once. The unpack
+ * and pack instructions work within the two 128-bit lanes, which keeps
+ * luma and chroma lined up; only the final stores need to cross lanes. */
+
+XOREOS_YUV_AVX2_TARGET
+static inline __m256i chromaAVX2(__m256i x, bool integer, uint16_t frac) {
+	const __m256i sign = _mm256_srai_epi16(x, 15);
+	const __m256i n    = _mm256_abs_epi16(x);
+
+	__m256i c = _mm256_mulhi_epu16(n, _mm256_set1_epi16(frac));
+	if (integer)
+		c = _mm256_add_epi16(c, n);
+
+	return _mm256_sub_epi16(_mm256_xor_si256(c, sign), sign);
+}
+
+XOREOS_YUV_AVX2_TARGET
+static inline __m256i packAVX2(YUVToRGBManager::LuminanceScale scale, __m256i lo, __m256i hi) {
+	if (scale == YUVToRGBManager::kScaleITU) {
+		const __m256i min  = _mm256_set1_epi16(16);
+		const __m256i max  = _mm256_set1_epi16(235);
+		const __m256i frac = _mm256_set1_epi16(kITUFrac);
+
+		lo = _mm256_sub_epi16(_mm256_min_epi16(_mm256_max_epi16(lo, min), max), min);
+		hi = _mm256_sub_epi16(_mm256_min_epi16(_mm256_max_epi16(hi, min), max), min);
+
+		lo = _mm256_add_epi16(lo, _mm256_mulhi_epu16(lo, frac));
+		hi = _mm256_add_epi16(hi, _mm256_mulhi_epu16(hi, frac));
+	}
+
+	return _mm256_packus_epi16(lo, hi);
+}
+
+XOREOS_YUV_AVX2_TARGET
+static inline void convertRowAVX2(YUVToRGBManager::LuminanceScale scale, byte *dst, const byte *ySrc,
+                                  const byte *aSrc, __m256i rLo, __m256i rHi, __m256i gLo, __m256i gHi,
+                                  __m256i bLo, __m256i bHi) {
+
+	const __m256i zero = _mm256_setzero_si256();
+
+	const __m256i y   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ySrc));
+	const __m256i yLo = _mm256_unpacklo_epi8(y, zero);
+	const __m256i yHi = _mm256_unpackhi_epi8(y, zero);
+
+	const __m256i r = packAVX2(scale, _mm256_add_epi16(yLo, rLo), _mm256_add_epi16(yHi, rHi));
+	const __m256i g = packAVX2(scale, _mm256_add_epi16(yLo, gLo), _mm256_add_epi16(yHi, gHi));
+	const __m256i b = packAVX2(scale, _mm256_add_epi16(yLo, bLo), _mm256_add_epi16(yHi, bHi));
+	const __m256i a = aSrc ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(aSrc)) : _mm256_set1_epi8(-1);
+
+	const __m256i bgLo = _mm256_unpacklo_epi8(b, g);
+	const __m256i bgHi = _mm256_unpackhi_epi8(b, g);
+	const __m256i raLo = _mm256_unpacklo_epi8(r, a);
+	const __m256i raHi = _mm256_unpackhi_epi8(r, a);
+
+	// Pixels 0-3 and 16-19, 4-7 and 20-23, 8-11 and 24-27, 12-15 and 28-31
+	const __m256i p0 = _mm256_unpacklo_epi16(bgLo, raLo);
+	const __m256i p1 = _mm256_unpackhi_epi16(bgLo, raLo);
+	const __m256i p2 = _mm256_unpacklo_epi16(bgHi, raHi);
+	const __m256i p3 = _mm256_unpackhi_epi16(bgHi, raHi);
+
+	__m256i *out = reinterpret_cast<__m256i *>(dst);
+	_mm256_storeu_si256(out + 0, _mm256_permute2x128_si256(p0, p1, 0x20));
+	_mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(p2, p3, 0x20));
+	_mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(p0, p1, 0x31));
+	_mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(p2, p3, 0x31));
+}
+
+/** Convert two rows, 32 pixels at a time. Returns the number of pixels converted. */
+XOREOS_YUV_AVX2_TARGET
+static int convertRowsAVX2(YUVToRGBManager::LuminanceScale scale, byte *dst, int dstPitch,
+                           const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                           int yWidth, int yPitch) {
+
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i bias = _mm256_set1_epi16(128);
+
+	int x = 0;
+	for (; x + 32 <= yWidth; x += 32) {
+		const __m256i u = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(uSrc + (x >> 1)))), bias);
+		const __m256i v = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vSrc + (x >> 1)))), bias);
+
+		const __m256i r = chromaAVX2(v, true, kCrRFrac);
+		const __m256i g = _mm256_sub_epi16(zero, _mm256_add_epi16(chromaAVX2(v, false, kCrGFrac), chromaAVX2(u, false, kCbGFrac)));
+		const __m256i b = chromaAVX2(u, true, kCbBFrac);
+
+		// Each chroma sample covers two pixels in a row
+		const __m256i rLo = _mm256_unpacklo_epi16(r, r), rHi = _mm256_unpackhi_epi16(r, r);
+		const __m256i gLo = _mm256_unpacklo_epi16(g, g), gHi = _mm256_unpackhi_epi16(g, g);
+		const __m256i bLo = _mm256_unpacklo_epi16(b, b), bHi = _mm256_unpackhi_epi16(b, b);
+
+		convertRowAVX2(scale, dst + dstPitch + x * 4, ySrc + x, aSrc ? aSrc + x : 0,
+		               rLo, rHi, gLo, gHi, bLo, bHi);
+		convertRowAVX2(scale, dst + x * 4, ySrc + yPitch + x, aSrc ? aSrc + yPitch + x : 0,
+		               rLo, rHi, gLo, gHi, bLo, bHi);
+	}
+
+	return x;
+}
+
+#endif // XOREOS_YUV_AVX2
+
+YUVToRGBManager::Implementation YUVToRGBManager::getImplementation() const {
+	return _implementation;
+}
+
+bool YUVToRGBManager::hasImplementation(Implementation implementation) {
+	switch (implementation) {
+		case kImplementationTable:
+			return true;
+
+#if defined(XOREOS_YUV_SSE2)
+		case kImplementationSSE2:
+			return true;
+#endif
+
+#if defined(XOREOS_YUV_AVX2)
+		case kImplementationAVX2:
+			return __builtin_cpu_supports("avx2");
+#endif
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
+bool YUVToRGBManager::setImplementation(Implementation implementation) {
+	if (!hasImplementation(implementation))
+		return false;
+
+	_implementation = implementation;
+	return true;
+}
+
+void YUVToRGBManager::convert(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const YUVToRGBLookup *lookup = getLookup(scale);
 	const byte *rgbToPix = lookup->getRGBToPix();
 
 	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
 
 	dst += dstPitch * (yHeight - 2);
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			const byte *L;
-
-			int16_t cr_r  = _colorTab[*vSrc + 0 * 256];
-			int16_t crb_g = _colorTab[*vSrc + 1 * 256] + _colorTab[*uSrc + 2 * 256];
-			int16_t cb_b  = _colorTab[*uSrc + 3 * 256];
-			uSrc++;
-			vSrc++;
-
-			PUT_PIXEL(*ySrc, 0xFF, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), 0xFF, dst);
-			ySrc++;
-			dst += 4;
-			PUT_PIXEL(*ySrc, 0xFF, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), 0xFF, dst);
-			ySrc++;
-			dst += 4;
+		int x = 0;
+
+		switch (_implementation) {
+#if defined(XOREOS_YUV_AVX2)
+			case kImplementationAVX2:
+				x = convertRowsAVX2(scale, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, yWidth, yPitch);
+				break;
+#endif
+
+#if defined(XOREOS_YUV_SSE2)
+			case kImplementationSSE2:
+				x = convertRowsSSE2(scale, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, yWidth, yPitch);
+				break;
+#endif
+
+			default:
+				break;
 		}
 
-		dst -= yWidth * 4 + dstPitch * 2;
-		ySrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+		// Whatever the SIMD code left over
+		if (aSrc)
+			convertRowsTable<true >(_colorTab, rgbToPix, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, x, yWidth, yPitch);
+		else
+			convertRowsTable<false>(_colorTab, rgbToPix, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, x, yWidth, yPitch);
+
+		dst  -= dstPitch * 2;
+		ySrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+
+		if (aSrc)
+			aSrc += yPitch << 1;
 	}
 }
 
+void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	convert(scale, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	convert(scale, dst, dstPitch, ySrc, uSrc, vSrc, 0, yWidth, yHeight, yPitch, uvPitch);
+}
+
 } // End of namespace Graphics
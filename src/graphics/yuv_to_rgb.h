@@ -43,6 +43,29 @@ public:
 		kScaleITU   /** Luminance values range from [16, 235], the range from ITU-R BT.601 */
 	};
 
+	/** The code path doing the conversion. */
+	enum Implementation {
+		kImplementationTable, ///< Generic, using lookup tables.
+		kImplementationSSE2,  ///< Using SSE2 instructions, 16 pixels at a time.
+		kImplementationAVX2   ///< Using AVX2 instructions, 32 pixels at a time.
+	};
+
+	/** Return the conversion code path in use. */
+	Implementation getImplementation() const;
+
+	/** Is this implementation available on this CPU? */
+	static bool hasImplementation(Implementation implementation);
+
+	/**
+	 * Select the conversion code path.
+	 *
+	 * By default, the fastest available implementation is used. All of them
+	 * produce exactly the same output.
+	 *
+	 * @return false if the implementation isn't available on this CPU.
+	 */
+	bool setImplementation(Implementation implementation);
+
 	/**
 	 * Convert a YUV420 image to an RGBA surface
 	 *
@@ -83,6 +106,10 @@ private:
 
 	const YUVToRGBLookup *getLookup(LuminanceScale scale);
 
+	void convert(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+
+	Implementation _implementation;
+
 	std::unique_ptr<YUVToRGBLookup> _lookup;
 	int16_t _colorTab[4 * 256]; // 2048 bytes
 };
@@ -0,0 +1,114 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An audio stream decoded ahead of time into a ring buffer.
+ */
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+
+#include "src/sound/bufferedaudiostream.h"
+
+namespace Sound {
+
+BufferedAudioStream::BufferedAudioStream(AudioStream *stream, bool disposeAfterUse, size_t size) :
+	_stream(stream, disposeAfterUse), _channels(stream ? stream->getChannels() : 0),
+	_rate(stream ? stream->getRate() : 0), _buffer(size, MAX(_channels, 1)), _finished(false) {
+
+	if (!stream)
+		throw Common::Exception("BufferedAudioStream: No stream");
+}
+
+BufferedAudioStream::~BufferedAudioStream() {
+}
+
+size_t BufferedAudioStream::readBuffer(int16_t *buffer, const size_t numSamples) {
+	return _buffer.read(buffer, numSamples);
+}
+
+int BufferedAudioStream::getChannels() const {
+	return _channels;
+}
+
+int BufferedAudioStream::getRate() const {
+	return _rate;
+}
+
+bool BufferedAudioStream::endOfData() const {
+	return _buffer.getAvailable() == 0;
+}
+
+bool BufferedAudioStream::endOfStream() const {
+	return _finished.load(std::memory_order_acquire) && (_buffer.getAvailable() == 0);
+}
+
+size_t BufferedAudioStream::decode(size_t maxSamples) {
+	std::lock_guard<std::mutex> lock(_streamMutex);
+
+	if (_finished.load(std::memory_order_relaxed))
+		return 0;
+
+	const size_t channels = MAX(_channels, 1);
+
+	size_t decoded = 0;
+	while (decoded < maxSamples) {
+		if (_stream->endOfData()) {
+			if (_stream->endOfStream())
+				_finished.store(true, std::memory_order_release);
+
+			break;
+		}
+
+		// Decode straight into the ring buffer, in whole sample frames
+		size_t regionSize;
+		int16_t *region = _buffer.getWriteRegion(regionSize);
+
+		regionSize = MIN(regionSize, maxSamples - decoded);
+		regionSize -= regionSize % channels;
+		if (regionSize == 0)
+			break;
+
+		const size_t n = _stream->readBuffer(region, regionSize);
+		if (n == AudioStream::kSizeInvalid) {
+			warning("BufferedAudioStream::decode(): Failed reading from stream");
+
+			_finished.store(true, std::memory_order_release);
+			break;
+		}
+
+		if (n == 0)
+			break;
+
+		_buffer.commitWrite(n);
+		decoded += n;
+	}
+
+	return decoded;
+}
+
+void BufferedAudioStream::stop() {
+	std::lock_guard<std::mutex> lock(_streamMutex);
+
+	_finished.store(true, std::memory_order_release);
+	_stream.reset();
+}
+
+} // End of namespace Sound
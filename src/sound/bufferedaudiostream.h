@@ -0,0 +1,101 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An audio stream decoded ahead of time into a ring buffer.
+ */
+
+#ifndef SOUND_BUFFEREDAUDIOSTREAM_H
+#define SOUND_BUFFEREDAUDIOSTREAM_H
+
+#include <atomic>
+
+#include "src/common/types.h"
+#include "src/common/disposableptr.h"
+#include "src/common/mutex.h"
+
+#include "src/sound/audiostream.h"
+#include "src/sound/ringbuffer.h"
+
+namespace Sound {
+
+/** An audio stream decoded ahead of time into a ring buffer.
+ *
+ *  The decoding side calls decode() to read from the wrapped stream into
+ *  the ring buffer. The playing side uses the normal AudioStream interface,
+ *  which only copies already decoded samples out of the ring buffer.
+ *
+ *  Without data in the ring buffer, endOfData() is true. endOfStream() is
+ *  true once the wrapped stream has ended and all its data has been read.
+ */
+class BufferedAudioStream : public AudioStream {
+public:
+	/** The default size of the ring buffer, in samples. */
+	static const size_t kDefaultSize = 32768;
+
+	/** Create a buffered audio stream.
+	 *
+	 *  @param stream The stream to decode.
+	 *  @param disposeAfterUse Should the stream be taken over and discarded once it finished?
+	 *  @param size The size of the ring buffer, in samples.
+	 */
+	BufferedAudioStream(AudioStream *stream, bool disposeAfterUse, size_t size = kDefaultSize);
+	~BufferedAudioStream();
+
+	size_t readBuffer(int16_t *buffer, const size_t numSamples);
+
+	int getChannels() const;
+	int getRate() const;
+
+	bool endOfData() const;
+	bool endOfStream() const;
+
+	/** Decode up to maxSamples samples of the wrapped stream into the ring buffer.
+	 *
+	 *  @return The number of samples decoded.
+	 */
+	size_t decode(size_t maxSamples = SIZE_MAX);
+
+	/** Stop decoding and discard the wrapped stream.
+	 *
+	 *  Waits for a decode() call currently running on another thread.
+	 *  Afterwards, decode() does nothing, and the wrapped stream is not
+	 *  touched anymore. Samples already in the ring buffer can still be read.
+	 */
+	void stop();
+
+private:
+	Common::DisposablePtr<AudioStream> _stream;
+
+	int _channels;
+	int _rate;
+
+	RingBuffer _buffer;
+
+	/** The wrapped stream has ended, or decoding was stopped. */
+	std::atomic<bool> _finished;
+
+	/** Held while using the wrapped stream. */
+	std::mutex _streamMutex;
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_BUFFEREDAUDIOSTREAM_H
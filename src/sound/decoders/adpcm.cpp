@@ -371,8 +371,9 @@ public:
 			error("MS_ADPCMStream(): blockAlign isn't specified for MS ADPCM");
 		std::memset(&_status, 0, sizeof(_status));
 
-		// 2 samples per input byte, but 7 byte header per block per channel
-		_length = ((_size / _blockAlign) * (_blockAlign - (7 * channels)) * 2) / channels;
+		// 2 samples per input byte, but 7 byte header per block per channel,
+		// which in turn contains 2 samples per channel
+		_length = (_size / _blockAlign) * ((((_blockAlign - (7 * channels)) * 2) / channels) + 2);
 	}
 
 	virtual size_t readBuffer(int16_t *buffer, const size_t numSamples);
@@ -542,6 +543,9 @@ public:
 
 	virtual size_t readBuffer(int16_t *buffer, const size_t numSamples);
 
+	/** We might still have decoded samples left after the whole stream has been read. */
+	virtual bool endOfData() const { return (_blockPos[1] == 8) && ADPCMStream::endOfData(); }
+
 protected:
 	void reset() {
 		ADPCMStream::reset();
@@ -599,7 +603,7 @@ size_t Xbox_ADPCMStream::readBuffer(int16_t *buffer, const size_t numSamples) {
 
 	size_t samples = 0;
 
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
+	while (samples < numSamples && !endOfData()) {
 		if ((_blockPos[0] == _blockAlign) && (_blockPos[1] == 8)) {
 			for (int c = 0; c < _channels; c++) {
 				_status.ch[c].predictor = _stream->readSint16LE();
@@ -25,9 +25,18 @@
 #ifndef SOUND_DECODERS_UTIL_H
 #define SOUND_DECODERS_UTIL_H
 
+#include <cmath>
+
 #include "src/common/types.h"
 #include "src/common/util.h"
 
+// SSE2 is always there on x86-64
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define XOREOS_SOUND_SSE2 1
+
+	#include <emmintrin.h>
+#endif
+
 namespace Sound {
 
 // Convert one float sample into a int16_t sample
@@ -35,18 +44,73 @@ static inline int16_t floatToInt16(float src) {
 	return (int16_t) CLIP<int>((int) floor(src + 0.5), -32768, 32767);
 }
 
+#if defined(XOREOS_SOUND_SSE2)
+/* Convert 4 float samples into int32_t samples, clipped to the int16_t range.
+ * Bit-exact to floatToInt16(): rounding happens in double precision, and
+ * floor() is done by truncating and correcting where that rounded up. */
+static inline __m128i floatToInt16SSE2(__m128 src) {
+	const __m128d half = _mm_set1_pd(0.5);
+	const __m128d minV = _mm_set1_pd(-32768.0);
+	const __m128d maxV = _mm_set1_pd( 32767.0);
+
+	__m128d lo = _mm_cvtps_pd(src);
+	__m128d hi = _mm_cvtps_pd(_mm_movehl_ps(src, src));
+
+	lo = _mm_min_pd(_mm_max_pd(_mm_add_pd(lo, half), minV), maxV);
+	hi = _mm_min_pd(_mm_max_pd(_mm_add_pd(hi, half), minV), maxV);
+
+	__m128i iLo = _mm_cvttpd_epi32(lo);
+	__m128i iHi = _mm_cvttpd_epi32(hi);
+
+	// The masks are all ones (-1) where truncating rounded up
+	const __m128i fixLo = _mm_shuffle_epi32(_mm_castpd_si128(_mm_cmpgt_pd(_mm_cvtepi32_pd(iLo), lo)), _MM_SHUFFLE(3, 3, 2, 0));
+	const __m128i fixHi = _mm_shuffle_epi32(_mm_castpd_si128(_mm_cmpgt_pd(_mm_cvtepi32_pd(iHi), hi)), _MM_SHUFFLE(3, 3, 2, 0));
+
+	iLo = _mm_add_epi32(iLo, fixLo);
+	iHi = _mm_add_epi32(iHi, fixHi);
+
+	return _mm_unpacklo_epi64(iLo, iHi);
+}
+#endif
+
 // Convert planar float samples into interleaved int16_t samples
 static inline void floatToInt16Interleave(int16_t *dst, const float **src,
                                           uint32_t length, uint8_t channels) {
+	uint32_t i = 0;
+
 	if (channels == 2) {
-		for (uint32_t i = 0; i < length; i++) {
+#if defined(XOREOS_SOUND_SSE2)
+		for (; (i + 4) <= length; i += 4) {
+			const __m128 left  = _mm_loadu_ps(src[0] + i);
+			const __m128 right = _mm_loadu_ps(src[1] + i);
+
+			const __m128i a = floatToInt16SSE2(_mm_unpacklo_ps(left, right));
+			const __m128i b = floatToInt16SSE2(_mm_unpackhi_ps(left, right));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i), _mm_packs_epi32(a, b));
+		}
+#endif
+
+		for (; i < length; i++) {
 			dst[2 * i    ] = floatToInt16(src[0][i]);
 			dst[2 * i + 1] = floatToInt16(src[1][i]);
 		}
+	} else if (channels == 1) {
+#if defined(XOREOS_SOUND_SSE2)
+		for (; (i + 8) <= length; i += 8) {
+			const __m128i a = floatToInt16SSE2(_mm_loadu_ps(src[0] + i));
+			const __m128i b = floatToInt16SSE2(_mm_loadu_ps(src[0] + i + 4));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi32(a, b));
+		}
+#endif
+
+		for (; i < length; i++)
+			dst[i] = floatToInt16(src[0][i]);
 	} else {
 		for (uint8_t c = 0; c < channels; c++)
-			for (uint32_t i = 0, j = c; i < length; i++, j += channels)
-				dst[j] = floatToInt16(src[c][i]);
+			for (uint32_t j = 0, k = c; j < length; j++, k += channels)
+				dst[k] = floatToInt16(src[c][j]);
 	}
 }
 
@@ -75,7 +75,24 @@
 
 namespace Sound {
 
+// SSE is always there on x86-64
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+	#define XOREOS_WMA_SSE 1
+
+	#include <xmmintrin.h>
+#endif
+
 static inline void butterflyFloats(float *v1, float *v2, int len) {
+#if defined(XOREOS_WMA_SSE)
+	for (; len >= 4; len -= 4, v1 += 4, v2 += 4) {
+		const __m128 a = _mm_loadu_ps(v1);
+		const __m128 b = _mm_loadu_ps(v2);
+
+		_mm_storeu_ps(v1, _mm_add_ps(a, b));
+		_mm_storeu_ps(v2, _mm_sub_ps(a, b));
+	}
+#endif
+
 	while (len-- > 0) {
 		float t = *v1 - *v2;
 
@@ -86,6 +103,11 @@ static inline void butterflyFloats(float *v1, float *v2, int len) {
 
 static inline void vectorFMulAdd(float *dst, const float *src0,
                           const float *src1, const float *src2, int len) {
+#if defined(XOREOS_WMA_SSE)
+	for (; len >= 4; len -= 4, dst += 4, src0 += 4, src1 += 4, src2 += 4)
+		_mm_storeu_ps(dst, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src0), _mm_loadu_ps(src1)), _mm_loadu_ps(src2)));
+#endif
+
 	while (len-- > 0)
 		*dst++ = *src0++ * *src1++ + *src2++;
 }
@@ -94,6 +116,14 @@ static inline void vectorFMulReverse(float *dst, const float *src0,
                                      const float *src1, int len) {
 	src1 += len - 1;
 
+#if defined(XOREOS_WMA_SSE)
+	for (; len >= 4; len -= 4, dst += 4, src0 += 4, src1 -= 4) {
+		const __m128 w = _mm_loadu_ps(src1 - 3);
+
+		_mm_storeu_ps(dst, _mm_mul_ps(_mm_loadu_ps(src0), _mm_shuffle_ps(w, w, _MM_SHUFFLE(0, 1, 2, 3))));
+	}
+#endif
+
 	while (len-- > 0)
 		*dst++ = *src0++ * *src1--;
 }
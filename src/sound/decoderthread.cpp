@@ -0,0 +1,135 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A thread decoding audio streams ahead of time.
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#include "src/common/error.h"
+
+#include "src/sound/decoderthread.h"
+#include "src/sound/bufferedaudiostream.h"
+
+namespace Sound {
+
+DecoderThread::Stats::Stats() : samples(0), time(0) {
+}
+
+
+DecoderThread::DecoderThread() : _woken(false), _samples(0), _time(0) {
+}
+
+DecoderThread::~DecoderThread() {
+	stop();
+}
+
+void DecoderThread::start() {
+	if (!createThread("SoundDecoder"))
+		throw Common::Exception("Failed to create sound decoder thread");
+}
+
+void DecoderThread::stop() {
+	destroyThread();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_streams.clear();
+}
+
+void DecoderThread::add(const std::shared_ptr<BufferedAudioStream> &stream) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_streams.push_back(stream);
+		_woken = true;
+	}
+
+	_wake.notify_one();
+}
+
+void DecoderThread::remove(const std::shared_ptr<BufferedAudioStream> &stream) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_streams.erase(std::remove(_streams.begin(), _streams.end(), stream), _streams.end());
+}
+
+void DecoderThread::wake() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_woken = true;
+	}
+
+	_wake.notify_one();
+}
+
+DecoderThread::Stats DecoderThread::getStats() const {
+	Stats stats;
+
+	stats.samples = _samples.load(std::memory_order_relaxed);
+	stats.time    = _time.load(std::memory_order_relaxed);
+
+	return stats;
+}
+
+void DecoderThread::threadMethod() {
+	typedef std::chrono::steady_clock Clock;
+
+	while (!_killThread.load(std::memory_order_relaxed)) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			_work  = _streams;
+			_woken = false;
+		}
+
+		const Clock::time_point start = Clock::now();
+
+		size_t decoded = 0;
+		for (std::vector<std::shared_ptr<BufferedAudioStream>>::iterator s = _work.begin(); s != _work.end(); ++s) {
+			try {
+				decoded += (*s)->decode(kChunkSize);
+			} catch (...) {
+				Common::exceptionDispatcherWarning("Failed decoding sound");
+				(*s)->stop();
+			}
+		}
+
+		_work.clear();
+
+		if (decoded > 0) {
+			_samples.fetch_add(decoded, std::memory_order_relaxed);
+			_time.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count(),
+			                std::memory_order_relaxed);
+
+			// There might be more to decode, go round again
+			continue;
+		}
+
+		/* Nothing to do right now. Sleep until someone made room in a buffer.
+		 * Streams that are fed from elsewhere, like video sound, don't tell
+		 * us when they got new data, so don't sleep for too long either. */
+		std::unique_lock<std::mutex> lock(_mutex);
+		_wake.wait_for(lock, std::chrono::milliseconds(10), [this]() { return _woken; });
+	}
+}
+
+} // End of namespace Sound
@@ -0,0 +1,97 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A thread decoding audio streams ahead of time.
+ */
+
+#ifndef SOUND_DECODERTHREAD_H
+#define SOUND_DECODERTHREAD_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "src/common/types.h"
+#include "src/common/thread.h"
+#include "src/common/mutex.h"
+
+namespace Sound {
+
+class BufferedAudioStream;
+
+/** A thread decoding audio streams ahead of time.
+ *
+ *  The thread goes round-robin over all added streams, topping up their
+ *  ring buffers a chunk at a time. When all buffers are full, or no stream
+ *  has new data, it sleeps until woken up with wake(), or until a short
+ *  timeout has passed.
+ */
+class DecoderThread : public Common::Thread {
+public:
+	/** Statistics about the decoding work done. */
+	struct Stats {
+		uint64_t samples; ///< Number of samples decoded.
+		uint64_t time;    ///< Time spent decoding, in microseconds.
+
+		Stats();
+	};
+
+	DecoderThread();
+	~DecoderThread();
+
+	/** Start the decoding thread. */
+	void start();
+	/** Stop the decoding thread. */
+	void stop();
+
+	/** Add a stream to decode. */
+	void add(const std::shared_ptr<BufferedAudioStream> &stream);
+	/** Remove a stream. */
+	void remove(const std::shared_ptr<BufferedAudioStream> &stream);
+
+	/** Signal that a stream has room for more data. */
+	void wake();
+
+	/** Return the current statistics. */
+	Stats getStats() const;
+
+private:
+	/** The maximum number of samples decoded from one stream at a time. */
+	static const size_t kChunkSize = 4096;
+
+	std::vector<std::shared_ptr<BufferedAudioStream>> _streams;
+	/** The streams worked on in one round, owned by the thread. */
+	std::vector<std::shared_ptr<BufferedAudioStream>> _work;
+
+	std::mutex _mutex;
+	std::condition_variable _wake;
+
+	bool _woken;
+
+	std::atomic<uint64_t> _samples;
+	std::atomic<uint64_t> _time;
+
+	void threadMethod();
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_DECODERTHREAD_H
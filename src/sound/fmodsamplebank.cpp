@@ -53,6 +53,7 @@
 #include "src/common/util.h"
 #include "src/common/strutil.h"
 #include "src/common/encoding.h"
+#include "src/common/memreadstream.h"
 
 #include "src/aurora/resman.h"
 
@@ -65,25 +66,36 @@
 
 namespace Sound {
 
-FMODSampleBank::FMODSampleBank(Common::SeekableReadStream *fsb) : _fsb(fsb) {
+FMODSampleBank::FMODSampleBank(Common::SeekableReadStream *fsb) {
+	assert(fsb);
+
+	std::unique_ptr<Common::SeekableReadStream> stream(fsb);
+	_fsb = std::make_shared<Common::MappedFile>(*stream);
+
+	load();
+}
+
+FMODSampleBank::FMODSampleBank(std::shared_ptr<const Common::MappedFile> fsb) : _fsb(std::move(fsb)) {
 	assert(_fsb);
 
-	load(*_fsb);
+	load();
 }
 
 FMODSampleBank::FMODSampleBank(const Common::UString &name) {
-	_fsb.reset(ResMan.getResource(name, Aurora::kFileTypeFSB));
+	_fsb = ResMan.mapResource(name, Aurora::kFileTypeFSB);
 	if (!_fsb)
 		throw Common::Exception("No such FSB resource \"%s\"", name.c_str());
 
-	load(*_fsb);
+	load();
 }
 
 size_t FMODSampleBank::getSampleCount() const {
-	return _samples.size();
+	return _sampleCount;
 }
 
 const Common::UString &FMODSampleBank::getSampleName(size_t index) const {
+	indexSamples();
+
 	if (index >= _samples.size())
 		throw Common::Exception("FMODSampleBank::getSampleName(): Index out of range (%s >= %s)",
 		                        Common::composeString(index).c_str(),
@@ -93,6 +105,8 @@ const Common::UString &FMODSampleBank::getSampleName(size_t index) const {
 }
 
 bool FMODSampleBank::hasSample(const Common::UString &name) const {
+	indexSamples();
+
 	return _sampleMap.find(name) != _sampleMap.end();
 }
 
@@ -100,8 +114,7 @@ static constexpr uint32_t kSampleFlagMP3      = 0x00000200;
 static constexpr uint32_t kSampleFlagIMAADPCM = 0x00400000;
 
 RewindableAudioStream *FMODSampleBank::getSample(const Sample &sample) const {
-	_fsb->seek(sample.offset);
-	std::unique_ptr<Common::SeekableReadStream> dataStream(_fsb->readStream(sample.size));
+	std::unique_ptr<Common::SeekableReadStream> dataStream(_fsb->getStream(sample.offset, sample.size));
 
 	if (sample.flags & kSampleFlagMP3) {
 		warning("MP3");
@@ -114,7 +127,7 @@ RewindableAudioStream *FMODSampleBank::getSample(const Sample &sample) const {
 
 	if (sample.flags & kSampleFlagIMAADPCM) {
 		warning("APCM");
-		return makeADPCMStream(dataStream.release(), true, dataStream->size(),
+		return makeADPCMStream(dataStream.release(), true, sample.size,
 		                       kADPCMMSIma, sample.defFreq, sample.channels, 36 * sample.channels);
 	}
 
@@ -122,6 +135,8 @@ RewindableAudioStream *FMODSampleBank::getSample(const Sample &sample) const {
 }
 
 RewindableAudioStream *FMODSampleBank::getSample(size_t index) const {
+	indexSamples();
+
 	if (index >= _samples.size())
 		throw Common::Exception("FMODSampleBank::getSampleName(): Index out of range (%s >= %s)",
 		                        Common::composeString(index).c_str(),
@@ -131,6 +146,8 @@ RewindableAudioStream *FMODSampleBank::getSample(size_t index) const {
 }
 
 RewindableAudioStream *FMODSampleBank::getSample(const Common::UString &name) const {
+	indexSamples();
+
 	std::map<Common::UString, const Sample *>::const_iterator s = _sampleMap.find(name);
 	if (s == _sampleMap.end())
 		throw Common::Exception("FMODSampleBank::getSampleName(): No such sample \"%s\"", name.c_str());
@@ -140,31 +157,42 @@ RewindableAudioStream *FMODSampleBank::getSample(const Common::UString &name) co
 
 static constexpr uint32_t kHeaderFlagSimpleInfo = 0x00000002;
 
-void FMODSampleBank::load(Common::SeekableReadStream &fsb) {
+void FMODSampleBank::load() {
 	static constexpr uint32_t kFSBID = MKTAG('F', 'S', 'B', '4');
 
+	Common::MemoryReadStream fsb(_fsb->getData(), _fsb->getSize());
+
 	const uint32_t id = fsb.readUint32BE();
 	if (id != kFSBID)
 		throw Common::Exception("Not a FSB file (%s)", Common::debugTag(id).c_str());
 
-	const size_t sampleCount = fsb.readUint32LE();
+	_sampleCount = fsb.readUint32LE();
 
-	const size_t sampleInfoSize = fsb.readUint32LE();
+	_sampleInfoSize = fsb.readUint32LE();
 	fsb.skip(4); // sampleDataSize
 
 	fsb.skip(4); // version
-	const uint32_t flags   = fsb.readUint32LE();
+	_flags = fsb.readUint32LE();
 
 	fsb.skip(24); // Unknown
+}
+
+void FMODSampleBank::indexSamples() const {
+	std::call_once(_indexed, [this]() { readSamples(); });
+}
+
+void FMODSampleBank::readSamples() const {
+	static constexpr size_t kOffsetInfo = 48;
+
+	Common::MemoryReadStream fsb(_fsb->getData(), _fsb->getSize());
 
-	const size_t offsetInfo = 48;
-	size_t offsetData = offsetInfo + sampleInfoSize;
+	size_t offsetData = kOffsetInfo + _sampleInfoSize;
 
-	fsb.seek(offsetInfo);
+	fsb.seek(kOffsetInfo);
 
-	_samples.resize(sampleCount);
+	_samples.resize(_sampleCount);
 	for (auto &sample : _samples) {
-		const bool isSimple = (flags & kHeaderFlagSimpleInfo) && (&sample != &_samples.front());
+		const bool isSimple = (_flags & kHeaderFlagSimpleInfo) && (&sample != &_samples.front());
 
 		if (isSimple) {
 			sample = _samples[0];
@@ -178,7 +206,7 @@ void FMODSampleBank::load(Common::SeekableReadStream &fsb) {
 			const size_t infoSize = fsb.readUint16LE();
 
 			if (infoSize < 80)
-				throw Common::Exception("FMODSampleBank::load(): Invalid sample info size %s",
+				throw Common::Exception("FMODSampleBank::readSamples(): Invalid sample info size %s",
 				                        Common::composeString(infoSize).c_str());
 
 			sample.name = Common::readStringFixed(fsb, Common::kEncodingASCII, 30);
@@ -28,9 +28,11 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <mutex>
 
 #include "src/common/ustring.h"
 #include "src/common/readstream.h"
+#include "src/common/mappedfile.h"
 
 namespace Sound {
 
@@ -46,10 +48,19 @@ class RewindableAudioStream;
  *
  *  Only version 4 of the FSB format is supported, because that's the
  *  version used by Dragon Age: Origins.
+ *
+ *  Only the header of the FSB file is read when the samplebank is opened.
+ *  The sample information is indexed when first needed, and the samples'
+ *  audio streams read straight out of the (ideally memory-mapped) samplebank
+ *  data, without copying it.
  */
 class FMODSampleBank {
 public:
+	/** Read the whole FSB stream into memory and take over the samplebank from there. */
 	FMODSampleBank(Common::SeekableReadStream *fsb);
+	/** Take over the samplebank from an FSB file mapped into memory. */
+	FMODSampleBank(std::shared_ptr<const Common::MappedFile> fsb);
+	/** Map the FSB resource with this name. */
 	FMODSampleBank(const Common::UString &name);
 	~FMODSampleBank() = default;
 
@@ -96,14 +107,25 @@ private:
 	};
 
 
-	std::unique_ptr<Common::SeekableReadStream> _fsb;
+	std::shared_ptr<const Common::MappedFile> _fsb;
+
+	size_t _sampleCount;
+	size_t _sampleInfoSize;
+
+	uint32_t _flags;
+
+	mutable std::once_flag _indexed; ///< Have the samples been indexed?
+
+	mutable std::vector<Sample> _samples;
 
-	std::vector<Sample> _samples;
+	mutable std::map<Common::UString, const Sample *> _sampleMap;
 
-	std::map<Common::UString, const Sample *> _sampleMap;
 
+	void load();
 
-	void load(Common::SeekableReadStream &fsb);
+	/** Read the sample information, if that hasn't happened yet. */
+	void indexSamples() const;
+	void readSamples() const;
 
 	RewindableAudioStream *getSample(const Sample &sample) const;
 };
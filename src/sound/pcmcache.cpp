@@ -0,0 +1,254 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A cache of fully decoded short sounds.
+ */
+
+#include <cstring>
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/debug.h"
+
+#include "src/sound/pcmcache.h"
+#include "src/sound/audiostream.h"
+
+namespace Sound {
+
+/** The decoded, immutable data of a cached sound. */
+struct PCMCache::Data {
+	int channels;
+	int rate;
+
+	std::vector<int16_t> samples; ///< All samples, interleaved.
+};
+
+/** A stream playing the data of a cached sound. */
+class PCMCache::Stream : public RewindableAudioStream {
+public:
+	Stream(const std::shared_ptr<const Data> &data) : _data(data), _pos(0) {
+	}
+
+	size_t readBuffer(int16_t *buffer, const size_t numSamples) {
+		const size_t n = MIN<size_t>(numSamples, _data->samples.size() - _pos);
+
+		std::memcpy(buffer, _data->samples.data() + _pos, n * sizeof(int16_t));
+		_pos += n;
+
+		return n;
+	}
+
+	int getChannels() const {
+		return _data->channels;
+	}
+
+	int getRate() const {
+		return _data->rate;
+	}
+
+	bool endOfData() const {
+		return _pos >= _data->samples.size();
+	}
+
+	bool rewind() {
+		_pos = 0;
+		return true;
+	}
+
+	uint64_t getLength() const {
+		return _data->samples.size() / _data->channels;
+	}
+
+private:
+	std::shared_ptr<const Data> _data;
+
+	size_t _pos;
+};
+
+
+PCMCache::Stats::Stats() : hits(0), misses(0), uncacheable(0), evictions(0), count(0), size(0) {
+}
+
+
+PCMCache::PCMCache(size_t maxSize, uint64_t maxDuration) : _maxSize(maxSize), _maxDuration(maxDuration) {
+}
+
+PCMCache::~PCMCache() {
+}
+
+size_t PCMCache::getMaxSize() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _maxSize;
+}
+
+uint64_t PCMCache::getMaxDuration() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _maxDuration;
+}
+
+void PCMCache::setMaxSize(size_t maxSize) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_maxSize = maxSize;
+	evict();
+}
+
+void PCMCache::setMaxDuration(uint64_t maxDuration) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_maxDuration = maxDuration;
+}
+
+RewindableAudioStream *PCMCache::get(const Common::UString &name) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	SoundMap::iterator s = _soundMap.find(name);
+	if (s == _soundMap.end()) {
+		_stats.misses++;
+		return 0;
+	}
+
+	// Move the sound to the front of the list, making it the most recently used
+	_sounds.splice(_sounds.begin(), _sounds, s->second);
+
+	_stats.hits++;
+	return new Stream(s->second->data);
+}
+
+AudioStream *PCMCache::add(const Common::UString &name, AudioStream *stream) {
+	std::unique_ptr<AudioStream> audioStream(stream);
+
+	size_t maxSize;
+	uint64_t maxDuration;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		maxSize     = _maxSize;
+		maxDuration = _maxDuration;
+	}
+
+	RewindableAudioStream *reStream = dynamic_cast<RewindableAudioStream *>(stream);
+
+	const int channels = stream->getChannels();
+	const uint64_t length   = reStream ? reStream->getLength()   : RewindableAudioStream::kInvalidLength;
+	const uint64_t duration = reStream ? reStream->getDuration() : RewindableAudioStream::kInvalidLength;
+
+	if ((length == RewindableAudioStream::kInvalidLength) || (duration > maxDuration) ||
+	    (channels <= 0) || ((length * channels * sizeof(int16_t)) > maxSize)) {
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stats.uncacheable++;
+
+		return audioStream.release();
+	}
+
+	// Decode the whole sound without holding the lock
+
+	std::shared_ptr<Data> data = std::make_shared<Data>();
+
+	data->channels = channels;
+	data->rate     = stream->getRate();
+
+	data->samples.resize(length * channels);
+
+	size_t size = 0;
+	while (!stream->endOfData()) {
+		if (size == data->samples.size())
+			data->samples.resize(size + 4096 * channels);
+
+		const size_t n = stream->readBuffer(data->samples.data() + size, data->samples.size() - size);
+		if ((n == 0) || (n == AudioStream::kSizeInvalid))
+			break;
+
+		size += n;
+	}
+
+	data->samples.resize(size);
+	data->samples.shrink_to_fit();
+
+	audioStream.reset();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	SoundMap::iterator s = _soundMap.find(name);
+	if (s != _soundMap.end()) {
+		// Another thread was faster. Replace its data with ours
+		_stats.size -= getSize(*s->second->data);
+		_sounds.erase(s->second);
+		_soundMap.erase(s);
+
+		_stats.count--;
+	}
+
+	_sounds.push_front(CachedSound());
+	_sounds.front().name = name;
+	_sounds.front().data = data;
+
+	_soundMap.insert(std::make_pair(name, _sounds.begin()));
+
+	_stats.count++;
+	_stats.size += getSize(*data);
+
+	evict();
+
+	debugC(Common::kDebugSound, 2, "Cached sound \"%s\" (%u bytes, %u sounds, %u bytes total)", name.c_str(),
+	       (uint) getSize(*data), (uint) _stats.count, (uint) _stats.size);
+
+	return new Stream(data);
+}
+
+void PCMCache::clear() {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_soundMap.clear();
+	_sounds.clear();
+
+	_stats.count = 0;
+	_stats.size  = 0;
+}
+
+PCMCache::Stats PCMCache::getStats() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _stats;
+}
+
+void PCMCache::evict() {
+	while (!_sounds.empty() && (_stats.size > _maxSize)) {
+		const CachedSound &sound = _sounds.back();
+
+		_stats.size -= getSize(*sound.data);
+		_stats.count--;
+		_stats.evictions++;
+
+		_soundMap.erase(sound.name);
+		_sounds.pop_back();
+	}
+}
+
+size_t PCMCache::getSize(const Data &data) {
+	return data.samples.size() * sizeof(int16_t);
+}
+
+} // End of namespace Sound
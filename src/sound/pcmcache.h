@@ -0,0 +1,158 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A cache of fully decoded short sounds.
+ */
+
+#ifndef SOUND_PCMCACHE_H
+#define SOUND_PCMCACHE_H
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+
+namespace Sound {
+
+class AudioStream;
+class RewindableAudioStream;
+
+/** A least-recently-used cache of fully decoded short sounds.
+ *
+ *  Sound effects like footsteps, clicks and weapon hits are played over
+ *  and over again. Instead of reading and decoding them anew each time,
+ *  the cache keeps their decoded PCM data around, as an immutable buffer
+ *  shared between all streams currently playing it.
+ *
+ *  Only sounds with a known duration not longer than the maximum duration
+ *  are cached. Once the size of all cached data exceeds the maximum size,
+ *  the sounds that were least recently played are dropped from the cache.
+ *  Streams still playing a dropped sound keep its data alive.
+ *
+ *  All methods are thread-safe.
+ */
+class PCMCache {
+public:
+	static const size_t   kDefaultMaxSize     = 16 * 1024 * 1024; ///< 16MiB of sample data.
+	static const uint64_t kDefaultMaxDuration = 5000;             ///< 5 seconds.
+
+	/** Statistics about the cache's usage. */
+	struct Stats {
+		size_t hits;        ///< Number of sounds served from the cache.
+		size_t misses;      ///< Number of sounds not found in the cache.
+		size_t uncacheable; ///< Number of sounds too long or too big to be cached.
+		size_t evictions;   ///< Number of sounds dropped to make room for others.
+
+		size_t count; ///< Number of sounds currently in the cache.
+		size_t size;  ///< Size of the sample data currently in the cache, in bytes.
+
+		Stats();
+	};
+
+	PCMCache(size_t maxSize = kDefaultMaxSize, uint64_t maxDuration = kDefaultMaxDuration);
+	~PCMCache();
+
+	PCMCache(const PCMCache &) = delete;
+	PCMCache &operator=(const PCMCache &) = delete;
+
+	/** Return the maximum size of the sample data in the cache, in bytes. */
+	size_t getMaxSize() const;
+	/** Return the maximum duration of a sound in the cache, in milliseconds. */
+	uint64_t getMaxDuration() const;
+
+	/** Set the maximum size of the sample data in the cache, in bytes.
+	 *
+	 *  A maximum size of 0 disables the cache.
+	 */
+	void setMaxSize(size_t maxSize);
+	/** Set the maximum duration of a sound in the cache, in milliseconds.
+	 *
+	 *  Sounds already in the cache are not affected.
+	 */
+	void setMaxDuration(uint64_t maxDuration);
+
+	/** Return a new stream playing the cached sound with this name.
+	 *
+	 *  @return The stream, which the caller takes over, or 0 if the sound
+	 *          is not in the cache.
+	 */
+	RewindableAudioStream *get(const Common::UString &name);
+
+	/** Add a sound to the cache.
+	 *
+	 *  If the sound is short enough, it is decoded completely and the
+	 *  stream is then discarded. Otherwise, the stream is left alone.
+	 *
+	 *  @param  name The name to cache the sound under.
+	 *  @param  stream The stream to decode. Will be taken over.
+	 *  @return A stream playing the sound, which the caller takes over.
+	 *          Either a new stream playing the cached data, or the
+	 *          original stream if the sound could not be cached.
+	 */
+	AudioStream *add(const Common::UString &name, AudioStream *stream);
+
+	/** Remove all sounds from the cache. */
+	void clear();
+
+	/** Return the current statistics. */
+	Stats getStats() const;
+
+private:
+	struct Data;
+	class Stream;
+
+	/** A cached sound. */
+	struct CachedSound {
+		Common::UString name;
+
+		std::shared_ptr<const Data> data;
+	};
+
+	typedef std::list<CachedSound> SoundList;
+	typedef std::unordered_map<Common::UString, SoundList::iterator,
+	                           Common::hashUStringCaseInsensitive,
+	                           Common::equalsUStringInsensitive> SoundMap;
+
+	size_t   _maxSize;
+	uint64_t _maxDuration;
+
+	/** All cached sounds, the most recently used first. */
+	SoundList _sounds;
+	/** The cached sounds by name. */
+	SoundMap _soundMap;
+
+	Stats _stats;
+
+	mutable std::mutex _mutex;
+
+	/** Drop the least recently used sounds until the cache fits into the maximum size. */
+	void evict();
+
+	/** Return the size of this sound's sample data, in bytes. */
+	static size_t getSize(const Data &data);
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_PCMCACHE_H
@@ -0,0 +1,117 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A lock-free ring buffer of audio samples.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+
+#include "src/sound/ringbuffer.h"
+
+namespace Sound {
+
+RingBuffer::RingBuffer(size_t capacity, size_t granularity) : _capacity(0), _readPos(0), _writePos(0) {
+	if (granularity == 0)
+		throw Common::Exception("RingBuffer: Invalid granularity 0");
+
+	_capacity = MAX<size_t>(capacity - (capacity % granularity), granularity);
+	_data = std::make_unique<int16_t[]>(_capacity);
+}
+
+RingBuffer::~RingBuffer() {
+}
+
+size_t RingBuffer::getCapacity() const {
+	return _capacity;
+}
+
+size_t RingBuffer::getAvailable() const {
+	return _writePos.load(std::memory_order_acquire) - _readPos.load(std::memory_order_acquire);
+}
+
+size_t RingBuffer::getFree() const {
+	return _capacity - getAvailable();
+}
+
+size_t RingBuffer::write(const int16_t *data, size_t count) {
+	size_t written = 0;
+
+	while (written < count) {
+		size_t regionSize;
+		int16_t *region = getWriteRegion(regionSize);
+
+		const size_t n = MIN(regionSize, count - written);
+		if (n == 0)
+			break;
+
+		std::memcpy(region, data + written, n * sizeof(int16_t));
+		commitWrite(n);
+
+		written += n;
+	}
+
+	return written;
+}
+
+int16_t *RingBuffer::getWriteRegion(size_t &count) {
+	const size_t writePos = _writePos.load(std::memory_order_relaxed);
+	const size_t readPos  = _readPos.load(std::memory_order_acquire);
+
+	const size_t offset = writePos % _capacity;
+
+	count = MIN(_capacity - (writePos - readPos), _capacity - offset);
+	return _data.get() + offset;
+}
+
+void RingBuffer::commitWrite(size_t count) {
+	const size_t writePos = _writePos.load(std::memory_order_relaxed);
+	assert(count <= (_capacity - (writePos - _readPos.load(std::memory_order_acquire))));
+
+	_writePos.store(writePos + count, std::memory_order_release);
+}
+
+size_t RingBuffer::read(int16_t *data, size_t count) {
+	const size_t readPos  = _readPos.load(std::memory_order_relaxed);
+	const size_t writePos = _writePos.load(std::memory_order_acquire);
+
+	count = MIN(count, writePos - readPos);
+
+	const size_t offset = readPos % _capacity;
+	const size_t first  = MIN(count, _capacity - offset);
+
+	std::memcpy(data, _data.get() + offset, first * sizeof(int16_t));
+	std::memcpy(data + first, _data.get(), (count - first) * sizeof(int16_t));
+
+	_readPos.store(readPos + count, std::memory_order_release);
+
+	return count;
+}
+
+void RingBuffer::clear() {
+	_readPos.store(0, std::memory_order_relaxed);
+	_writePos.store(0, std::memory_order_relaxed);
+}
+
+} // End of namespace Sound
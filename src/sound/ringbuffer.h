@@ -0,0 +1,104 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A lock-free ring buffer of audio samples.
+ */
+
+#ifndef SOUND_RINGBUFFER_H
+#define SOUND_RINGBUFFER_H
+
+#include <atomic>
+#include <memory>
+
+#include "src/common/types.h"
+
+namespace Sound {
+
+/** A lock-free ring buffer of 16-bit audio samples.
+ *
+ *  The ring buffer hands samples from exactly one producer thread to
+ *  exactly one consumer thread, without locks and without allocating
+ *  memory after construction.
+ *
+ *  The producer either copies samples in with write(), or fills the
+ *  contiguous region returned by getWriteRegion() directly and then
+ *  publishes it with commitWrite(). The consumer copies samples out
+ *  with read().
+ *
+ *  The capacity is a multiple of the granularity the buffer was created
+ *  with. As long as the producer only writes whole multiples of that
+ *  granularity (for example, whole frames of interleaved channels), the
+ *  write region is never split in the middle of one.
+ */
+class RingBuffer {
+public:
+	RingBuffer(size_t capacity, size_t granularity = 1);
+	~RingBuffer();
+
+	RingBuffer(const RingBuffer &) = delete;
+	RingBuffer &operator=(const RingBuffer &) = delete;
+
+	/** Return the number of samples the ring buffer can hold. */
+	size_t getCapacity() const;
+
+	/** Return the number of samples ready to be read. */
+	size_t getAvailable() const;
+	/** Return the number of samples that can be written. */
+	size_t getFree() const;
+
+	/** Copy up to count samples into the ring buffer. Producer only.
+	 *
+	 *  @return The number of samples actually written.
+	 */
+	size_t write(const int16_t *data, size_t count);
+
+	/** Return the contiguous region the producer can write into next.
+	 *
+	 *  @param  count The number of samples that fit into the region.
+	 *  @return The start of the region.
+	 */
+	int16_t *getWriteRegion(size_t &count);
+	/** Publish count samples written into the write region. Producer only. */
+	void commitWrite(size_t count);
+
+	/** Copy up to count samples out of the ring buffer. Consumer only.
+	 *
+	 *  @return The number of samples actually read.
+	 */
+	size_t read(int16_t *data, size_t count);
+
+	/** Drop all samples. Neither the producer nor the consumer may be active. */
+	void clear();
+
+private:
+	std::unique_ptr<int16_t[]> _data;
+	size_t _capacity;
+
+	/* Both positions count up indefinitely. Each is only written by one side,
+	 * which publishes it with release semantics after touching the data. */
+
+	std::atomic<size_t> _readPos;  ///< Total number of samples read.
+	std::atomic<size_t> _writePos; ///< Total number of samples written.
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_RINGBUFFER_H
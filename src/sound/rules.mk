@@ -36,6 +36,10 @@ src_sound_libsound_la_SOURCES += \
     src/sound/fmodsamplebank.h \
     src/sound/wwisesoundbank.h \
     src/sound/fmodeventfile.h \
+    src/sound/pcmcache.h \
+    src/sound/ringbuffer.h \
+    src/sound/bufferedaudiostream.h \
+    src/sound/decoderthread.h \
     $(EMPTY)
 
 src_sound_libsound_la_SOURCES += \
@@ -51,6 +55,10 @@ src_sound_libsound_la_SOURCES += \
     src/sound/fmodsamplebank.cpp \
     src/sound/wwisesoundbank.cpp \
     src/sound/fmodeventfile.cpp \
+    src/sound/pcmcache.cpp \
+    src/sound/ringbuffer.cpp \
+    src/sound/bufferedaudiostream.cpp \
+    src/sound/decoderthread.cpp \
     $(EMPTY)
 
 src_sound_libsound_la_LIBADD = \
@@ -48,6 +48,7 @@
 
 #include "src/sound/sound.h"
 #include "src/sound/audiostream.h"
+#include "src/sound/bufferedaudiostream.h"
 #include "src/sound/decoders/asf.h"
 #ifdef ENABLE_MAD
 #include "src/sound/decoders/mp3.h"
@@ -78,13 +79,20 @@ namespace Sound {
 
 SoundManager::Channel::Channel(uint32_t i, size_t idx, SoundType t,
                                const TypeList::iterator &ti, AudioStream *s, bool d) :
-	id(i), index(idx), state(AL_PAUSED), stream(s, d), source(0),
-	type(t), typeIt(ti), finishedBuffers(0), gain(1.0f) {
+	id(i), index(idx), state(AL_PAUSED), stream(std::make_shared<BufferedAudioStream>(s, d)), source(0),
+	type(t), typeIt(ti), finishedBuffers(0), gain(1.0f), lastUpdate(std::chrono::steady_clock::now()) {
 
 }
 
 
-SoundManager::SoundManager() : _ready(false), _hasSound(false), _hasMultiChannel(false), _format51(0) {
+SoundManager::BufferStats::BufferStats() : underruns(0), samplesDecoded(0), decodeTime(0) {
+}
+
+
+SoundManager::SoundManager() : _ready(false), _hasSound(false), _headless(false),
+	_hasMultiChannel(false), _format51(0), _underruns(0) {
+
+	_buffer = std::make_unique<int16_t[]>(kOpenALBufferSize / 2);
 }
 
 SoundManager::~SoundManager() {
@@ -99,39 +107,59 @@ void SoundManager::init() {
 	_ctx = 0;
 
 	_hasSound = false;
+	_headless = ConfigMan.getBool("soundheadless", false);
 
 	_hasMultiChannel = false;
 	_format51        = 0;
 
+	_underruns = 0;
+
+	// Size of the cache of decoded short sounds in MiB, and the maximum duration of a cached sound in ms
+	const int cacheSize     = ConfigMan.getInt("soundcache", PCMCache::kDefaultMaxSize / (1024 * 1024));
+	const int cacheDuration = ConfigMan.getInt("soundcacheduration", PCMCache::kDefaultMaxDuration);
+
+	_pcmCache.setMaxSize(((size_t) MAX(cacheSize, 0)) * 1024 * 1024);
+	_pcmCache.setMaxDuration(MAX(cacheDuration, 0));
+
 	try {
-		_dev = alcOpenDevice(0);
-		if (!_dev)
-			throw Common::Exception("Could not open OpenAL device");
+		if (!_headless) {
+			_dev = alcOpenDevice(0);
+			if (!_dev)
+				throw Common::Exception("Could not open OpenAL device");
 
-		_ctx = alcCreateContext(_dev, 0);
-		if (!_ctx)
-			throw Common::Exception("Could not create OpenAL context: 0x%X", (uint) alGetError());
+			_ctx = alcCreateContext(_dev, 0);
+			if (!_ctx)
+				throw Common::Exception("Could not create OpenAL context: 0x%X", (uint) alGetError());
 
-		alcMakeContextCurrent(_ctx);
+			alcMakeContextCurrent(_ctx);
 
-		ALenum error = alGetError();
-		if (error != AL_NO_ERROR)
-			throw Common::Exception("Could not use OpenAL context: 0x%X", (uint) alGetError());
+			ALenum error = alGetError();
+			if (error != AL_NO_ERROR)
+				throw Common::Exception("Could not use OpenAL context: 0x%X", (uint) alGetError());
 
-		_hasMultiChannel = alIsExtensionPresent("AL_EXT_MCFORMATS") != 0;
-		_format51        = alGetEnumValue("AL_FORMAT_51CHN16");
+			_hasMultiChannel = alIsExtensionPresent("AL_EXT_MCFORMATS") != 0;
+			_format51        = alGetEnumValue("AL_FORMAT_51CHN16");
+		}
+
+		_decoder.start();
 
 		if (!createThread("SoundManager"))
 			throw Common::Exception("Failed to create sound thread: %s", SDL_GetError());
 
-		_hasSound = true;
+		_hasSound = !_headless;
 
 	} catch (...) {
 		Common::exceptionDispatcherWarning("Failed to initialize OpenAL. Disabling sound output!");
+
+		_decoder.stop();
+		_headless = false;
 	}
 
 	_ready = true;
 
+	if (_headless)
+		status("Running without sound output");
+
 	if (!_hasSound)
 		return;
 
@@ -154,6 +182,17 @@ void SoundManager::deinit() {
 	for (size_t i = 0; i < kChannelCount; i++)
 		freeChannel(i);
 
+	_decoder.stop();
+
+	if (_headless) {
+		const BufferStats stats = getBufferStats();
+
+		status("Sound: %s underruns, %s samples decoded in %s ms", Common::composeString(stats.underruns).c_str(),
+		       Common::composeString(stats.samplesDecoded).c_str(), Common::composeString(stats.decodeTime / 1000).c_str());
+	}
+
+	_pcmCache.clear();
+
 	if (_hasSound) {
 		alcMakeContextCurrent(0);
 		alcDestroyContext(_ctx);
@@ -167,6 +206,10 @@ bool SoundManager::ready() const {
 	return _ready;
 }
 
+bool SoundManager::isHeadless() const {
+	return _headless;
+}
+
 void SoundManager::triggerUpdate() {
 	checkReady();
 
@@ -195,7 +238,7 @@ bool SoundManager::isPlaying(const ChannelHandle &handle) {
 	return isPlaying(handle.channel);
 }
 
-bool SoundManager::isPlaying(size_t channel) const {
+bool SoundManager::isPlaying(size_t channel) {
 	if ((channel >= kChannelCount) || !_channels[channel])
 		return false;
 
@@ -204,7 +247,7 @@ bool SoundManager::isPlaying(size_t channel) const {
 	//       add a way for audio streams to tell us how long they are
 	//       and then check if that time has elapsed.
 	if (!_hasSound)
-		return true;
+		return !_headless || !_channels[channel]->stream || !_channels[channel]->stream->endOfStream();
 
 	ALenum error = AL_NO_ERROR;
 
@@ -235,6 +278,10 @@ bool SoundManager::isPlaying(size_t channel) const {
 		if (_channels[channel]->state != AL_PLAYING)
 			return true;
 
+		// The source ran dry before we could give it more data
+		if (val == AL_STOPPED)
+			_underruns++;
+
 		alSourcePlay(_channels[channel]->source);
 	}
 
@@ -381,6 +428,9 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 			if ((error = alGetError()) != AL_NO_ERROR)
 				throw Common::Exception("OpenAL error while generating buffers: 0x%X", error);
 
+			// Decode the start of the stream right away, before the decoder thread takes over
+			channel.stream->decode(kOpenALBufferSize / 2);
+
 			if (fillBuffer(channel, buffer, channel.stream.get(), channel.bufferSize[buffer])) {
 				// If we could fill the buffer with data, queue it
 
@@ -401,6 +451,13 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 		alSourcei(channel.source, AL_SOURCE_RELATIVE, AL_TRUE);
 	}
 
+	if (_hasSound || _headless) {
+		if (_headless)
+			channel.stream->decode();
+
+		_decoder.add(channel.stream);
+	}
+
 	// Add the channel to the correct type list
 	_types[channel.type].list.push_back(&channel);
 	channel.typeIt = --_types[channel.type].list.end();
@@ -414,11 +471,38 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 ChannelHandle SoundManager::playSoundFile(Common::SeekableReadStream *wavStream, SoundType type, bool loop) {
 	checkReady();
 
+	if (!wavStream)
+		throw Common::Exception("No stream");
+
+	return playSoundStream(makeAudioStream(wavStream), type, loop);
+}
+
+ChannelHandle SoundManager::playSoundFile(Common::SeekableReadStream *wavStream, const Common::UString &cacheName,
+                                          SoundType type, bool loop) {
+	checkReady();
+
 	if (!wavStream)
 		throw Common::Exception("No stream");
 
 	AudioStream *audioStream = makeAudioStream(wavStream);
 
+	if (!audioStream)
+		throw Common::Exception("No audio stream");
+
+	return playSoundStream(_pcmCache.add(cacheName, audioStream), type, loop);
+}
+
+ChannelHandle SoundManager::playCachedSound(const Common::UString &cacheName, SoundType type, bool loop) {
+	checkReady();
+
+	AudioStream *audioStream = _pcmCache.get(cacheName);
+	if (!audioStream)
+		return ChannelHandle();
+
+	return playSoundStream(audioStream, type, loop);
+}
+
+ChannelHandle SoundManager::playSoundStream(AudioStream *audioStream, SoundType type, bool loop) {
 	if (!audioStream)
 		throw Common::Exception("No audio stream");
 
@@ -634,8 +718,9 @@ uint64_t SoundManager::getChannelSamplesPlayed(const ChannelHandle &handle) {
 	bufferData(*channel);
 
 	// The position within the currently playing buffer
-	ALint currentPosition;
-	alGetSourcei(channel->source, AL_BYTE_OFFSET, &currentPosition);
+	ALint currentPosition = 0;
+	if (_hasSound)
+		alGetSourcei(channel->source, AL_BYTE_OFFSET, &currentPosition);
 
 	// Total number of bytes processed
 	uint64_t byteCount = channel->finishedBuffers + currentPosition;
@@ -671,8 +756,30 @@ void SoundManager::setTypeGain(SoundType type, float gain) {
 	}
 }
 
+SoundManager::BufferStats SoundManager::getBufferStats() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	const DecoderThread::Stats decoderStats = _decoder.getStats();
+
+	BufferStats stats;
+
+	stats.underruns      = _underruns;
+	stats.samplesDecoded = decoderStats.samples;
+	stats.decodeTime     = decoderStats.time;
+
+	return stats;
+}
+
+PCMCache::Stats SoundManager::getPCMCacheStats() const {
+	return _pcmCache.getStats();
+}
+
+void SoundManager::clearPCMCache() {
+	_pcmCache.clear();
+}
+
 bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
-                              AudioStream *stream, ALsizei &bufferedSize) const {
+                              AudioStream *stream, ALsizei &bufferedSize) {
 
 	bufferedSize = 0;
 
@@ -710,17 +817,14 @@ bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
 	// Read in the required amount of samples
 	size_t numSamples = kOpenALBufferSize / 2;
 
-	std::unique_ptr<byte[]> buffer = std::make_unique<byte[]>(kOpenALBufferSize);
-	std::memset(buffer.get(), 0, kOpenALBufferSize);
-
-	numSamples = stream->readBuffer(reinterpret_cast<int16_t *>(buffer.get()), numSamples);
+	numSamples = stream->readBuffer(_buffer.get(), numSamples);
 	if (numSamples == AudioStream::kSizeInvalid) {
 		warning("Failed reading from stream while filling buffer in %s", formatChannel(&channel).c_str());
 		return false;
 	}
 
 	bufferedSize = numSamples * 2;
-	alBufferData(alBuffer, format, buffer.get(), bufferedSize, stream->getRate());
+	alBufferData(alBuffer, format, _buffer.get(), bufferedSize, stream->getRate());
 
 	ALenum error = alGetError();
 	if (error != AL_NO_ERROR) {
@@ -742,8 +846,12 @@ void SoundManager::bufferData(Channel &channel) {
 	if (!channel.stream)
 		return;
 
-	if (!_hasSound)
+	if (!_hasSound) {
+		if (_headless)
+			consumeData(channel);
+
 		return;
+	}
 
 	ALenum error = AL_NO_ERROR;
 
@@ -775,6 +883,8 @@ void SoundManager::bufferData(Channel &channel) {
 	}
 
 	// Buffer as long as we still have data and free buffers
+	bool buffered = false;
+
 	std::list<ALuint>::iterator buffer = channel.freeBuffers.begin();
 	while (buffer != channel.freeBuffers.end()) {
 		if (!fillBuffer(channel, *buffer, channel.stream.get(), channel.bufferSize[*buffer]))
@@ -786,7 +896,43 @@ void SoundManager::bufferData(Channel &channel) {
 			                        formatChannel(&channel).c_str(), error);
 
 		buffer = channel.freeBuffers.erase(buffer);
+		buffered = true;
+	}
+
+	// We made room in the stream's ring buffer, let the decoder thread refill it
+	if (buffered)
+		_decoder.wake();
+}
+
+void SoundManager::consumeData(Channel &channel) {
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	const uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - channel.lastUpdate).count();
+
+	channel.lastUpdate = now;
+
+	if (channel.state != AL_PLAYING)
+		return;
+
+	// The number of samples that would have been played since the last update
+	const size_t channels = channel.stream->getChannels();
+	const size_t due = ((elapsed * channel.stream->getRate()) / 1000000) * channels;
+
+	size_t consumed = 0;
+	while (consumed < due) {
+		const size_t n = channel.stream->readBuffer(_buffer.get(), MIN<size_t>(due - consumed, kOpenALBufferSize / 2));
+		if (n == 0)
+			break;
+
+		consumed += n;
 	}
+
+	channel.finishedBuffers += consumed * 2;
+
+	if ((consumed < due) && !channel.stream->endOfStream())
+		_underruns++;
+
+	if (consumed > 0)
+		_decoder.wake();
 }
 
 void SoundManager::checkReady() {
@@ -889,8 +1035,13 @@ void SoundManager::freeChannel(size_t channel) {
 		// Nothing to do
 		return;
 
-	// Discard the stream
-	c->stream.reset();
+	// Stop decoding and discard the stream
+	if (c->stream) {
+		c->stream->stop();
+
+		_decoder.remove(c->stream);
+		c->stream.reset();
+	}
 
 	if (_hasSound) {
 		// Delete the channel's OpenAL source
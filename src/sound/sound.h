@@ -38,15 +38,17 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <chrono>
 
 #include "src/common/types.h"
-#include "src/common/disposableptr.h"
 #include "src/common/singleton.h"
 #include "src/common/thread.h"
 #include "src/common/ustring.h"
 #include "src/common/mutex.h"
 
 #include "src/sound/types.h"
+#include "src/sound/pcmcache.h"
+#include "src/sound/decoderthread.h"
 
 namespace Common {
 	class SeekableReadStream;
@@ -55,6 +57,7 @@ namespace Common {
 namespace Sound {
 
 class AudioStream;
+class BufferedAudioStream;
 
 /** The sound manager. */
 class SoundManager : public Common::Singleton<SoundManager>, public Common::Thread {
@@ -70,6 +73,9 @@ public:
 	/** Was the sound subsystem successfully initialized? */
 	bool ready() const;
 
+	/** Are we running headless, playing sounds without any actual sound output? */
+	bool isHeadless() const;
+
 
 	/** Signal that one of streams currently being played has changed and should be updated immediately. */
 	void triggerUpdate();
@@ -104,6 +110,33 @@ public:
 	ChannelHandle playSoundFile(Common::SeekableReadStream *wavStream,
 	                            SoundType type, bool loop = false);
 
+	/** Play a sound file, keeping it in the PCM cache if it is short enough.
+	 *
+	 *  This only allocate a channel for the sound, to actually start playing it,
+	 *  call startChannel().
+	 *
+	 *  @param  wavStream The stream to play. Will be taken over.
+	 *  @param  cacheName The name to cache the decoded sound under.
+	 *  @param  type The type of the sound.
+	 *  @param  loop Should the sound loop?
+	 *  @return The channel the sound has been assigned to, or -1 on error.
+	 */
+	ChannelHandle playSoundFile(Common::SeekableReadStream *wavStream, const Common::UString &cacheName,
+	                            SoundType type, bool loop = false);
+
+	/** Play a sound from the PCM cache.
+	 *
+	 *  This only allocate a channel for the sound, to actually start playing it,
+	 *  call startChannel().
+	 *
+	 *  @param  cacheName The name the decoded sound was cached under.
+	 *  @param  type The type of the sound.
+	 *  @param  loop Should the sound loop?
+	 *  @return The channel the sound has been assigned to, or an invalid
+	 *          channel if the sound is not in the cache.
+	 */
+	ChannelHandle playCachedSound(const Common::UString &cacheName, SoundType type, bool loop = false);
+
 	/** Play an audio stream.
 	 *
 	 *  This only allocate a channel for the sound, to actually start playing it,
@@ -174,6 +207,32 @@ public:
 	void setTypeGain(SoundType type, float gain);
 	// '---
 
+	// .--- PCM cache
+	/** Return the statistics of the cache of decoded short sounds. */
+	PCMCache::Stats getPCMCacheStats() const;
+
+	/** Remove all sounds from the cache of decoded short sounds.
+	 *
+	 *  The cache only knows the names of the sounds, so this needs to be
+	 *  called whenever the resources they are loaded from change.
+	 */
+	void clearPCMCache();
+	// '---
+
+	// .--- Buffering statistics
+	/** Statistics about the buffering of sound data. */
+	struct BufferStats {
+		uint64_t underruns;      ///< Number of times a playing channel ran out of data.
+		uint64_t samplesDecoded; ///< Number of samples decoded ahead of time.
+		uint64_t decodeTime;     ///< Time spent decoding ahead of time, in microseconds.
+
+		BufferStats();
+	};
+
+	/** Return the statistics about the buffering of sound data. */
+	BufferStats getBufferStats();
+	// '---
+
 	// .--- Utility methods
 	/** Create an audio stream from this data stream.
 	 *
@@ -205,7 +264,8 @@ private:
 
 		ALint state; ///< The sound's state.
 
-		Common::DisposablePtr<AudioStream> stream;  ///< The actual audio stream.
+		/** The actual audio stream, decoded ahead of time. */
+		std::shared_ptr<BufferedAudioStream> stream;
 
 		ALuint source; ///< OpenAL source for this channel.
 
@@ -222,12 +282,16 @@ private:
 
 		float gain; ///< The channel's gain.
 
+		/** When running headless, the last time data was taken from the stream. */
+		std::chrono::steady_clock::time_point lastUpdate;
+
 		Channel(uint32_t i, size_t idx, SoundType t, const TypeList::iterator &ti, AudioStream *s, bool d);
 	};
 
 	bool _ready; ///< Was the sound subsystem successfully initialized?
 
 	bool _hasSound; ///< Do we have working sound output?
+	bool _headless; ///< Are we playing sounds without sound output?
 
 	bool _hasMultiChannel; ///< Do we have the multi-channel extension?
 	ALenum _format51; ///< The value for the 5.1 multi-channel format.
@@ -246,12 +310,24 @@ private:
 	ALCdevice *_dev;
 	ALCcontext *_ctx;
 
+	PCMCache _pcmCache; ///< The cache of decoded short sounds.
+
+	DecoderThread _decoder; ///< The thread decoding the channels' streams ahead of time.
+
+	/** Buffer for moving decoded data from the streams to the output. */
+	std::unique_ptr<int16_t[]> _buffer;
+
+	uint64_t _underruns; ///< Number of times a playing channel ran out of data.
+
 	/** Check that the SoundManager was properly initialized. */
 	void checkReady();
 
 	/** Update the sound information. Called regularly from within the thread method. */
 	void update();
 
+	/** Play an audio stream, looping it if requested. */
+	ChannelHandle playSoundStream(AudioStream *audioStream, SoundType type, bool loop);
+
 	/** Look for a free place in the channel vector. */
 	ChannelHandle newChannel();
 
@@ -260,8 +336,11 @@ private:
 	/** Buffer more sound from the channel to the OpenAL buffers. */
 	void bufferData(size_t channel);
 
+	/** Without sound output, take as much data from the channel as would have been played. */
+	void consumeData(Channel &channel);
+
 	/** Is that channel currently playing a sound? */
-	bool isPlaying(size_t channel) const;
+	bool isPlaying(size_t channel);
 
 	/** Pause/Unpause a channel. */
 	void pauseChannel(Channel *channel, bool pause);
@@ -282,7 +361,7 @@ private:
 
 	/** Fill the buffer with data from the audio stream. */
 	bool fillBuffer(const Channel &channel, ALuint alBuffer,
-	                AudioStream *stream, ALsizei &bufferedSize) const;
+	                AudioStream *stream, ALsizei &bufferedSize);
 
 	/** Return a string representing this channel. */
 	Common::UString formatChannel(const Channel *channel) const;
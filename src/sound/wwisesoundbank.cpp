@@ -33,6 +33,7 @@
 #include "src/common/debug.h"
 #include "src/common/strutil.h"
 #include "src/common/encoding.h"
+#include "src/common/memreadstream.h"
 
 #include "src/aurora/resman.h"
 
@@ -43,39 +44,54 @@
 
 namespace Sound {
 
-WwiseSoundBank::WwiseSoundBank(Common::SeekableReadStream *bnk) : _bnk(bnk), _bankID(0),
-		_dataOffset(SIZE_MAX) {
+WwiseSoundBank::WwiseSoundBank(Common::SeekableReadStream *bnk) : _bankID(0), _dataOffset(SIZE_MAX) {
+	assert(bnk);
+
+	std::unique_ptr<Common::SeekableReadStream> stream(bnk);
+	_bnk = std::make_shared<Common::MappedFile>(*stream);
+
+	load();
+}
+
+WwiseSoundBank::WwiseSoundBank(std::shared_ptr<const Common::MappedFile> bnk) : _bnk(std::move(bnk)),
+		_bankID(0), _dataOffset(SIZE_MAX) {
 
 	assert(_bnk);
 
-	load(*_bnk);
+	load();
 }
 
 WwiseSoundBank::WwiseSoundBank(const Common::UString &name) : _bankID(0), _dataOffset(SIZE_MAX) {
-	_bnk.reset(ResMan.getResource(name, Aurora::kFileTypeBNK));
+	_bnk = ResMan.mapResource(name, Aurora::kFileTypeBNK);
 	if (!_bnk)
 		throw Common::Exception("No such BNK resource \"%s\"", name.c_str());
 
-	load(*_bnk);
+	load();
 }
 
 WwiseSoundBank::WwiseSoundBank(uint64_t hash) : _bankID(0), _dataOffset(SIZE_MAX) {
-	_bnk.reset(ResMan.getResource(hash));
+	_bnk = ResMan.mapResource(hash);
 	if (!_bnk)
 		throw Common::Exception("No such BNK resource \"%s\"", Common::formatHash(hash).c_str());
 
-	load(*_bnk);
+	load();
 }
 
 size_t WwiseSoundBank::getFileCount() const {
+	indexFiles();
+
 	return _files.size();
 }
 
 size_t WwiseSoundBank::getSoundCount() const {
+	indexSounds();
+
 	return _sounds.size();
 }
 
 const WwiseSoundBank::File &WwiseSoundBank::getFileStruct(size_t index) const {
+	indexFiles();
+
 	if (index >= _files.size())
 		throw Common::Exception("WwiseSoundBank::getFileStruct(): Index out of range (%s >= %s)",
 		                        Common::composeString(index).c_str(),
@@ -85,6 +101,8 @@ const WwiseSoundBank::File &WwiseSoundBank::getFileStruct(size_t index) const {
 }
 
 const WwiseSoundBank::Sound &WwiseSoundBank::getSoundStruct(size_t index) const {
+	indexSounds();
+
 	if (index >= _sounds.size())
 		throw Common::Exception("WwiseSoundBank::getSoundStruct(): Index out of range (%s >= %s)",
 		                        Common::composeString(index).c_str(),
@@ -106,6 +124,8 @@ uint32_t WwiseSoundBank::getSoundFileID(size_t index) const {
 }
 
 size_t WwiseSoundBank::findFileByID(uint32_t id) const {
+	indexFiles();
+
 	std::map<uint32_t, size_t>::const_iterator index = _fileIDs.find(id);
 	if (index == _fileIDs.end())
 		return SIZE_MAX;
@@ -114,6 +134,8 @@ size_t WwiseSoundBank::findFileByID(uint32_t id) const {
 }
 
 size_t WwiseSoundBank::findSoundByID(uint32_t id) const {
+	indexSounds();
+
 	std::map<uint32_t, size_t>::const_iterator index = _soundIDs.find(id);
 	if (index == _soundIDs.end())
 		return SIZE_MAX;
@@ -153,9 +175,7 @@ Common::SeekableReadStream *WwiseSoundBank::getFileData(size_t index) const {
 	if (_dataOffset == SIZE_MAX)
 		throw Common::Exception("WwiseSoundBank::getFileData(): No data offset");
 
-	_bnk->seek(_dataOffset + file.offset);
-
-	return _bnk->readStream(file.size);
+	return _bnk->getStream(_dataOffset + file.offset, file.size);
 }
 
 Common::SeekableReadStream *WwiseSoundBank::getSoundData(size_t index) const {
@@ -177,9 +197,7 @@ Common::SeekableReadStream *WwiseSoundBank::getSoundData(size_t index) const {
 	if (sound.fileSource == _bankID) {
 		// Sound file is embedded in this bank
 
-		_bnk->seek(sound.fileOffset);
-
-		return _bnk->readStream(sound.fileSize);
+		return _bnk->getStream(sound.fileOffset, sound.fileSize);
 	}
 
 	// Sound file is embedded in another bank
@@ -190,15 +208,13 @@ Common::SeekableReadStream *WwiseSoundBank::getSoundData(size_t index) const {
 		                        "without a bank name", Common::composeString(index).c_str(),
 		                        sound.id, sound.fileID, sound.fileSource);
 
-	std::unique_ptr<Common::SeekableReadStream> bank(ResMan.getResource(bankName->second, Aurora::kFileTypeBNK));
+	std::shared_ptr<const Common::MappedFile> bank = ResMan.mapResource(bankName->second, Aurora::kFileTypeBNK);
 	if (!bank)
 		throw Common::Exception("WwiseSoundBank::getSoundData(): Bank \"%s\" for externally embedded file "
 		                        "(%s, %u, %u) does not exist", bankName->second.c_str(),
 		                        Common::composeString(index).c_str(), sound.id, sound.fileID);
 
-	bank->seek(sound.fileOffset);
-
-	return bank->readStream(sound.fileSize);
+	return bank->getStream(sound.fileOffset, sound.fileSize);
 }
 
 static constexpr uint32_t kSectionBankHeader  = MKTAG('B', 'K', 'H', 'D');
@@ -229,8 +245,9 @@ enum class ObjectType {
 	AuxiliaryBus           = 20,
 };
 
-void WwiseSoundBank::load(Common::SeekableReadStream &bnk) {
-	bnk.seek(0);
+void WwiseSoundBank::load() {
+	Common::MemoryReadStream bnk(_bnk->getData(), _bnk->getSize());
+
 	const uint32_t id = bnk.readUint32BE();
 	if (id != kSectionBankHeader)
 		throw Common::Exception("Not a BNK file (%s)", Common::debugTag(id).c_str());
@@ -247,6 +264,11 @@ void WwiseSoundBank::load(Common::SeekableReadStream &bnk) {
 		debugC(Common::kDebugSound, 3, "- Section \"%s\" (%s)", Common::debugTag(sectionType).c_str(),
 		                               Common::composeString(sectionSize).c_str());
 
+		// The section contents are only read on demand, but they have to fit
+		if (sectionEnd > bnk.size())
+			throw Common::Exception("WwiseSoundBank::load(): Section \"%s\" out of bounds",
+			                        Common::debugTag(sectionType).c_str());
+
 		switch (sectionType) {
 			case kSectionBankHeader: {
 				const uint32_t version = bnk.readUint32LE();
@@ -260,139 +282,169 @@ void WwiseSoundBank::load(Common::SeekableReadStream &bnk) {
 				break;
 			}
 
-			case kSectionDataIndex: {
+			case kSectionDataIndex:
 				if ((sectionSize % 12) != 0)
 					throw Common::Exception("WwiseSoundBank::load(): Unaligned data index");
 
-				debugC(Common::kDebugSound, 3, "  - %s entries", Common::composeString(sectionSize / 12).c_str());
-
-				_files.resize(sectionSize / 12);
-				for (auto &file : _files) {
-					file.id     = bnk.readUint32LE();
-					file.offset = bnk.readUint32LE();
-					file.size   = bnk.readUint32LE();
-
-					_fileIDs.insert(std::make_pair(file.id, &file - _files.data()));
-
-					debugC(Common::kDebugSound, 3, "    - %u | %s, %s", file.id,
-					                               Common::composeString(file.offset).c_str(),
-					                               Common::composeString(file.size).c_str());
-				}
+				_dataIndex.offset = sectionStart;
+				_dataIndex.size   = sectionSize;
 				break;
-			}
 
 			case kSectionData:
 				_dataOffset = sectionStart;
 				debugC(Common::kDebugSound, 3, "DATAOFFSET %s", Common::composeString(_dataOffset).c_str());
 				break;
 
-			case kSectionObjects: {
-				const size_t count = bnk.readUint32LE();
-				for (size_t i = 0; i < count; i++) {
-					const ObjectType type = static_cast<ObjectType>(bnk.readUint32LE());
+			case kSectionObjects:
+				_objects.offset = sectionStart;
+				_objects.size   = sectionSize;
+				break;
 
-					const size_t size  = bnk.readUint32LE();
-					const size_t start = bnk.pos();
-					const size_t end   = start + size;
+			case kSectionSoundTypeID:
+				_soundTypeIDs.offset = sectionStart;
+				_soundTypeIDs.size   = sectionSize;
+				break;
 
-					const uint32_t objectID = bnk.readUint32LE();
+			default:
+				break;
+		}
 
-					debugC(Common::kDebugSound, 3, "    - %s/%s: %u, %u (%s)", Common::composeString(i).c_str(),
-					                               Common::composeString(count).c_str(),
-					                               static_cast<uint>(type), objectID,
-					                               Common::composeString(size).c_str());
+		bnk.seek(sectionEnd);
+	}
 
-					if (type == ObjectType::Sound) {
-						_sounds.push_back(Sound());
-						Sound &sound = _sounds.back();
+	debugC(Common::kDebugSound, 3, "'---");
+}
 
-						sound.id = objectID;
+void WwiseSoundBank::indexFiles() const {
+	std::call_once(_filesIndexed, [this]() { readFiles(); });
+}
 
-						bnk.skip(4); // Unknown
-						const uint32_t embedded = bnk.readUint32LE();
+void WwiseSoundBank::indexSounds() const {
+	std::call_once(_soundsIndexed, [this]() { readSounds(); });
+}
 
-						sound.isEmbedded  = embedded == 0;
-						sound.zeroLatency = embedded == 2;
+void WwiseSoundBank::readFiles() const {
+	if (_dataIndex.offset == SIZE_MAX)
+		return;
 
-						sound.fileID     = bnk.readUint32LE();
-						sound.fileSource = bnk.readUint32LE();
+	Common::MemoryReadStream bnk(_bnk->getData() + _dataIndex.offset, _dataIndex.size);
 
-						sound.fileOffset = sound.fileSize = SIZE_MAX;
-						if (sound.isEmbedded) {
-							sound.fileOffset = bnk.readUint32LE();
-							sound.fileSize   = bnk.readUint32LE();
-						}
+	debugC(Common::kDebugSound, 3, "  - %s entries", Common::composeString(_dataIndex.size / 12).c_str());
 
-						sound.type = static_cast<SoundType>(bnk.readByte());
+	_files.resize(_dataIndex.size / 12);
+	for (auto &file : _files) {
+		file.id     = bnk.readUint32LE();
+		file.offset = bnk.readUint32LE();
+		file.size   = bnk.readUint32LE();
 
-						_soundIDs.insert(std::make_pair(sound.id, _sounds.size() - 1));
+		_fileIDs.insert(std::make_pair(file.id, &file - _files.data()));
 
-						debugC(Common::kDebugSound, 3, "=> SOUND: %u | %u, %u | %u (%s, %s)",
-						                               embedded, sound.fileID, sound.fileSource,
-						                               static_cast<uint>(sound.type),
-						                               Common::composeString(sound.fileOffset).c_str(),
-						                               Common::composeString(sound.fileSize).c_str());
+		debugC(Common::kDebugSound, 3, "    - %u | %s, %s", file.id,
+		                               Common::composeString(file.offset).c_str(),
+		                               Common::composeString(file.size).c_str());
+	}
+}
 
-					} else if (type == ObjectType::MusicTrack) {
-						_sounds.push_back(Sound());
-						Sound &music = _sounds.back();
+void WwiseSoundBank::readSounds() const {
+	if (_objects.offset != SIZE_MAX) {
+		Common::MemoryReadStream bnk(_bnk->getData() + _objects.offset, _objects.size);
 
-						music.id = objectID;
+		const size_t count = bnk.readUint32LE();
+		for (size_t i = 0; i < count; i++) {
+			const ObjectType type = static_cast<ObjectType>(bnk.readUint32LE());
 
-						bnk.skip(8); // Unknown
+			const size_t size  = bnk.readUint32LE();
+			const size_t start = bnk.pos();
+			const size_t end   = start + size;
 
-						const uint32_t embedded = bnk.readUint32LE();
+			const uint32_t objectID = bnk.readUint32LE();
 
-						music.isEmbedded  = embedded == 0;
-						music.zeroLatency = embedded == 2;
+			debugC(Common::kDebugSound, 3, "    - %s/%s: %u, %u (%s)", Common::composeString(i).c_str(),
+			                               Common::composeString(count).c_str(),
+			                               static_cast<uint>(type), objectID,
+			                               Common::composeString(size).c_str());
 
-						music.fileID     = bnk.readUint32LE();
-						music.fileSource = bnk.readUint32LE();
+			if (type == ObjectType::Sound) {
+				_sounds.push_back(Sound());
+				Sound &sound = _sounds.back();
 
-						music.fileOffset = music.fileSize = SIZE_MAX;
-						if (music.isEmbedded) {
-							music.fileOffset = bnk.readUint32LE();
-							music.fileSize   = bnk.readUint32LE();
-						}
+				sound.id = objectID;
 
-						music.type = SoundType::Music;
+				bnk.skip(4); // Unknown
+				const uint32_t embedded = bnk.readUint32LE();
 
-						_soundIDs.insert(std::make_pair(music.id, _sounds.size() - 1));
+				sound.isEmbedded  = embedded == 0;
+				sound.zeroLatency = embedded == 2;
 
-						debugC(Common::kDebugSound, 3, "=> MUSIC: %u | %u, %u | %u (%s, %s)",
-						                               embedded, music.fileID, music.fileSource,
-						                               static_cast<uint>(music.type),
-						                               Common::composeString(music.fileOffset).c_str(),
-						                               Common::composeString(music.fileSize).c_str());
-					}
+				sound.fileID     = bnk.readUint32LE();
+				sound.fileSource = bnk.readUint32LE();
 
-					bnk.seek(end);
+				sound.fileOffset = sound.fileSize = SIZE_MAX;
+				if (sound.isEmbedded) {
+					sound.fileOffset = bnk.readUint32LE();
+					sound.fileSize   = bnk.readUint32LE();
 				}
-				break;
-			}
 
-			case kSectionSoundTypeID: {
-				bnk.skip(4); // Unknown
-				const size_t count = bnk.readUint32LE();
-				for (size_t i = 0; i < count; i++) {
-					const uint32_t bankID = bnk.readUint32LE();
-					const uint8_t bankNameLength = bnk.readByte();
+				sound.type = static_cast<SoundType>(bnk.readByte());
+
+				_soundIDs.insert(std::make_pair(sound.id, _sounds.size() - 1));
+
+				debugC(Common::kDebugSound, 3, "=> SOUND: %u | %u, %u | %u (%s, %s)",
+				                               embedded, sound.fileID, sound.fileSource,
+				                               static_cast<uint>(sound.type),
+				                               Common::composeString(sound.fileOffset).c_str(),
+				                               Common::composeString(sound.fileSize).c_str());
+
+			} else if (type == ObjectType::MusicTrack) {
+				_sounds.push_back(Sound());
+				Sound &music = _sounds.back();
+
+				music.id = objectID;
+
+				bnk.skip(8); // Unknown
+
+				const uint32_t embedded = bnk.readUint32LE();
+
+				music.isEmbedded  = embedded == 0;
+				music.zeroLatency = embedded == 2;
 
-					_banks[bankID] = Common::readStringFixed(bnk, Common::kEncodingASCII, bankNameLength);
-					debugC(Common::kDebugSound, 3, "~> %u, \"%s\"", bankID, _banks[bankID].c_str());
+				music.fileID     = bnk.readUint32LE();
+				music.fileSource = bnk.readUint32LE();
+
+				music.fileOffset = music.fileSize = SIZE_MAX;
+				if (music.isEmbedded) {
+					music.fileOffset = bnk.readUint32LE();
+					music.fileSize   = bnk.readUint32LE();
 				}
 
-				break;
-			};
+				music.type = SoundType::Music;
 
-			default:
-				break;
-		}
+				_soundIDs.insert(std::make_pair(music.id, _sounds.size() - 1));
 
-		bnk.seek(sectionEnd);
+				debugC(Common::kDebugSound, 3, "=> MUSIC: %u | %u, %u | %u (%s, %s)",
+				                               embedded, music.fileID, music.fileSource,
+				                               static_cast<uint>(music.type),
+				                               Common::composeString(music.fileOffset).c_str(),
+				                               Common::composeString(music.fileSize).c_str());
+			}
+
+			bnk.seek(end);
+		}
 	}
 
-	debugC(Common::kDebugSound, 3, "'---");
+	if (_soundTypeIDs.offset != SIZE_MAX) {
+		Common::MemoryReadStream bnk(_bnk->getData() + _soundTypeIDs.offset, _soundTypeIDs.size);
+
+		bnk.skip(4); // Unknown
+		const size_t count = bnk.readUint32LE();
+		for (size_t i = 0; i < count; i++) {
+			const uint32_t bankID = bnk.readUint32LE();
+			const uint8_t bankNameLength = bnk.readByte();
+
+			_banks[bankID] = Common::readStringFixed(bnk, Common::kEncodingASCII, bankNameLength);
+			debugC(Common::kDebugSound, 3, "~> %u, \"%s\"", bankID, _banks[bankID].c_str());
+		}
+	}
 }
 
 } // End of namespace Sound
@@ -28,9 +28,11 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <mutex>
 
 #include "src/common/ustring.h"
 #include "src/common/readstream.h"
+#include "src/common/mappedfile.h"
 
 namespace Sound {
 
@@ -42,11 +44,22 @@ class RewindableAudioStream;
  *  audio files, together with event, effect, track and similar information.
  *
  *  It is part of the Wwise middleware.
+ *
+ *  Only the bank header and the list of sections are read when the
+ *  soundbank is opened. The embedded files and the referenced sounds
+ *  are each indexed when first needed, and their audio streams read
+ *  straight out of the (ideally memory-mapped) soundbank data, without
+ *  copying it.
  */
 class WwiseSoundBank {
 public:
+	/** Read the whole BNK stream into memory and take over the soundbank from there. */
 	WwiseSoundBank(Common::SeekableReadStream *bnk);
+	/** Take over the soundbank from a BNK file mapped into memory. */
+	WwiseSoundBank(std::shared_ptr<const Common::MappedFile> bnk);
+	/** Map the BNK resource with this name. */
 	WwiseSoundBank(const Common::UString &name);
+	/** Map the BNK resource with this hash. */
 	WwiseSoundBank(uint64_t hash);
 	~WwiseSoundBank() = default;
 
@@ -101,21 +114,44 @@ private:
 		size_t fileSize;
 	};
 
-	std::unique_ptr<Common::SeekableReadStream> _bnk;
+	/** A section within the SoundBank. */
+	struct Section {
+		size_t offset; ///< Offset of the section's content, or SIZE_MAX if the section doesn't exist.
+		size_t size;   ///< Size of the section's content in bytes.
+
+		Section() : offset(SIZE_MAX), size(0) { }
+	};
+
+	std::shared_ptr<const Common::MappedFile> _bnk;
 
 	uint32_t _bankID;
 	size_t _dataOffset;
 
-	std::vector<File> _files;
-	std::vector<Sound> _sounds;
+	Section _dataIndex;    ///< The DIDX section, indexing the embedded files.
+	Section _objects;      ///< The HIRC section, containing the sound objects.
+	Section _soundTypeIDs; ///< The STID section, naming the referenced banks.
+
+	mutable std::once_flag _filesIndexed;  ///< Have the embedded files been indexed?
+	mutable std::once_flag _soundsIndexed; ///< Have the referenced sounds been indexed?
+
+	mutable std::vector<File> _files;
+	mutable std::vector<Sound> _sounds;
+
+	mutable std::map<uint32_t, Common::UString> _banks;
+
+	mutable std::map<uint32_t, size_t> _fileIDs;
+	mutable std::map<uint32_t, size_t> _soundIDs;
 
-	std::map<uint32_t, Common::UString> _banks;
 
-	std::map<uint32_t, size_t> _fileIDs;
-	std::map<uint32_t, size_t> _soundIDs;
+	void load();
 
+	/** Read the embedded files index, if that hasn't happened yet. */
+	void indexFiles() const;
+	/** Read the referenced sounds, if that hasn't happened yet. */
+	void indexSounds() const;
 
-	void load(Common::SeekableReadStream &bnk);
+	void readFiles() const;
+	void readSounds() const;
 
 	const File &getFileStruct(size_t index) const;
 	const Sound &getSoundStruct(size_t index) const;
@@ -23,6 +23,7 @@
  */
 
 #include "src/common/ustring.h"
+#include "src/common/mappedfile.h"
 
 #include "src/aurora/resman.h"
 
@@ -34,13 +35,11 @@ namespace Sound {
 
 XACTWaveBank *XACTWaveBank::load(const Common::UString &name) {
 	try {
-		Common::SeekableReadStream *stream = nullptr;
+		std::shared_ptr<const Common::MappedFile> xwb = ResMan.mapResource(name, Aurora::kFileTypeXWB);
+		if (xwb)
+			return new XACTWaveBank_Binary(std::move(xwb));
 
-		stream = ResMan.getResource(name, Aurora::kFileTypeXWB);
-		if (stream)
-			return new XACTWaveBank_Binary(stream);
-
-		stream = ResMan.getResource(name + "_xwb", Aurora::kFileTypeTXT);
+		Common::SeekableReadStream *stream = ResMan.getResource(name + "_xwb", Aurora::kFileTypeTXT);
 		if (stream)
 			return new XACTWaveBank_ASCII(stream);
 
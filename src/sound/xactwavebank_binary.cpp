@@ -76,10 +76,19 @@ static constexpr uint32_t kWaveFlagsLoopCache      = 0x00000002; ///< Audio file
 static constexpr uint32_t kWaveFlagsRemoveLoopTail = 0x00000004; ///< Ignore the data after the looping section.
 static constexpr uint32_t kWaveFlagsIgnoreLoop     = 0x00000008; ///< Don't loop this sound.
 
-XACTWaveBank_Binary::XACTWaveBank_Binary(Common::SeekableReadStream *xwb) : _xwb(xwb) {
+XACTWaveBank_Binary::XACTWaveBank_Binary(Common::SeekableReadStream *xwb) {
+	assert(xwb);
+
+	std::unique_ptr<Common::SeekableReadStream> stream(xwb);
+	_xwb = std::make_shared<Common::MappedFile>(*stream);
+
+	load();
+}
+
+XACTWaveBank_Binary::XACTWaveBank_Binary(std::shared_ptr<const Common::MappedFile> xwb) : _xwb(std::move(xwb)) {
 	assert(_xwb);
 
-	load(*_xwb);
+	load();
 }
 
 bool XACTWaveBank_Binary::isStreaming() const {
@@ -87,19 +96,18 @@ bool XACTWaveBank_Binary::isStreaming() const {
 }
 
 size_t XACTWaveBank_Binary::getWaveCount() const {
-	return _waves.size();
+	return _waveCount;
 }
 
 RewindableAudioStream *XACTWaveBank_Binary::getWave(size_t index) const {
-	if (index >= _waves.size())
+	if (index >= _waveCount)
 		throw Common::Exception("XACTWaveBank_Binary::getWave(): Index out of range (%s >= %s)",
 		                        Common::composeString(index).c_str(),
-		                        Common::composeString(_waves.size()).c_str());
+		                        Common::composeString(_waveCount).c_str());
 
-	const Wave &wave = _waves[index];
+	const Wave wave = readWave(index);
 
-	_xwb->seek(wave.offset);
-	std::unique_ptr<Common::SeekableReadStream> dataStream(_xwb->readStream(wave.size));
+	std::unique_ptr<Common::SeekableReadStream> dataStream(_xwb->getStream(wave.offset, wave.size));
 
 	switch (wave.codec) {
 		case Codec::PCM:
@@ -108,7 +116,7 @@ RewindableAudioStream *XACTWaveBank_Binary::getWave(size_t index) const {
 			                     wave.channels);
 
 		case Codec::ADPCM:
-			return makeADPCMStream(dataStream.release(), true, dataStream->size(),
+			return makeADPCMStream(dataStream.release(), true, wave.size,
 			                       kADPCMXbox, wave.samplingRate,  wave.channels);
 
 		case Codec::WMA:
@@ -135,9 +143,11 @@ struct Segment {
 	size_t size;
 };
 
-void XACTWaveBank_Binary::load(Common::SeekableReadStream &xwb) {
+void XACTWaveBank_Binary::load() {
 	static constexpr uint32_t kXWBID = MKTAG('W', 'B', 'N', 'D');
 
+	Common::MemoryReadStream xwb(_xwb->getData(), _xwb->getSize());
+
 	const uint32_t id = xwb.readUint32BE();
 	if (id != kXWBID)
 		throw Common::Exception("Not a XWB file (%s)", Common::debugTag(id).c_str());
@@ -159,57 +169,65 @@ void XACTWaveBank_Binary::load(Common::SeekableReadStream &xwb) {
 	if (_flags & kXWBFlagsCompact)
 		throw Common::Exception("XACTWaveBank_Binary::load(): TODO: Compact format");
 
-	const size_t waveCount = xwb.readUint32LE();
+	_waveCount = xwb.readUint32LE();
 
 	_name = Common::readStringFixed(xwb, Common::kEncodingASCII, 16);
 
-	const size_t waveMetaSize = xwb.readUint32LE();
-	if (waveMetaSize < 24)
+	_waveMetaSize = xwb.readUint32LE();
+	if (_waveMetaSize < 24)
 		throw Common::Exception("XACTWaveBank_Binary::load(): Wave meta data size too small (%s)",
-		                        Common::composeString(waveMetaSize).c_str());
+		                        Common::composeString(_waveMetaSize).c_str());
 
 	xwb.skip(4); // Size of a wave name
 	xwb.skip(4); // Alignment
 
-	uint32_t indexOffset = segments[kSegmentEntryMetaData].offset;
+	_indexOffset = segments[kSegmentEntryMetaData].offset;
+
+	// The wave metadata entries are only read on demand, but they have to fit
+	if ((_indexOffset > xwb.size()) || (_waveCount > ((xwb.size() - _indexOffset) / _waveMetaSize)))
+		throw Common::Exception("XACTWaveBank_Binary::load(): Wave meta data out of bounds (%s, %s * %s)",
+		                        Common::composeString(_indexOffset).c_str(),
+		                        Common::composeString(_waveCount).c_str(),
+		                        Common::composeString(_waveMetaSize).c_str());
 
-	uint32_t dataOffset = segments[kSegmentWaveData].offset;
-	if (dataOffset == 0)
-		dataOffset = indexOffset + waveCount * waveMetaSize;
+	_dataOffset = segments[kSegmentWaveData].offset;
+	if (_dataOffset == 0)
+		_dataOffset = _indexOffset + _waveCount * _waveMetaSize;
+}
 
-	_waves.resize(waveCount);
-	for (auto &wave : _waves) {
-		xwb.seek(indexOffset);
+XACTWaveBank_Binary::Wave XACTWaveBank_Binary::readWave(size_t index) const {
+	Common::MemoryReadStream xwb(_xwb->getData() + _indexOffset + index * _waveMetaSize, _waveMetaSize);
 
-		wave.flags = xwb.readUint32LE();
+	Wave wave;
 
-		const uint32_t formatCode = xwb.readUint32LE();
+	wave.flags = xwb.readUint32LE();
 
-		wave.offset = xwb.readUint32LE() + dataOffset;
-		wave.size   = xwb.readUint32LE();
+	const uint32_t formatCode = xwb.readUint32LE();
 
-		wave.loopOffset = xwb.readUint32LE();
-		wave.loopLength = xwb.readUint32LE();
+	wave.offset = xwb.readUint32LE() + _dataOffset;
+	wave.size   = xwb.readUint32LE();
 
-		wave.codec        = static_cast<Codec>(((formatCode      ) & ((1 <<  2) - 1)));
-		wave.channels     =                     (formatCode >>  2) & ((1 <<  3) - 1);
-		wave.samplingRate =                     (formatCode >>  5) & ((1 << 18) - 1);
-		wave.blockAlign   =                     (formatCode >> 23) & ((1 <<  8) - 1);
-		wave.bitRate      =                    ((formatCode >> 31) & ((1 <<  1) - 1)) ? 16 : 8;
+	wave.loopOffset = xwb.readUint32LE();
+	wave.loopLength = xwb.readUint32LE();
 
-		switch (wave.codec) {
-			case Codec::PCM:
-			case Codec::ADPCM:
-			case Codec::WMA:
-				break;
+	wave.codec        = static_cast<Codec>(((formatCode      ) & ((1 <<  2) - 1)));
+	wave.channels     =                     (formatCode >>  2) & ((1 <<  3) - 1);
+	wave.samplingRate =                     (formatCode >>  5) & ((1 << 18) - 1);
+	wave.blockAlign   =                     (formatCode >> 23) & ((1 <<  8) - 1);
+	wave.bitRate      =                    ((formatCode >> 31) & ((1 <<  1) - 1)) ? 16 : 8;
 
-			default:
-				throw Common::Exception("XACTWaveBank_Binary::load(): Unknown encoding %u",
-				                        static_cast<uint>(wave.codec));
-		}
+	switch (wave.codec) {
+		case Codec::PCM:
+		case Codec::ADPCM:
+		case Codec::WMA:
+			break;
 
-		indexOffset += waveMetaSize;
+		default:
+			throw Common::Exception("XACTWaveBank_Binary::readWave(): Unknown encoding %u",
+			                        static_cast<uint>(wave.codec));
 	}
+
+	return wave;
 }
 
 } // End of namespace Sound
@@ -25,11 +25,11 @@
 #ifndef SOUND_XACTWAVEBANK_BINARY_H
 #define SOUND_XACTWAVEBANK_BINARY_H
 
-#include <vector>
 #include <memory>
 
 #include "src/common/ustring.h"
 #include "src/common/readstream.h"
+#include "src/common/mappedfile.h"
 
 #include "src/sound/xactwavebank.h"
 
@@ -53,12 +53,20 @@ namespace Sound {
  *  of the information in XWB (and XSB) files. See xactwavebank_ascii.h
  *  for this variant.
  *
+ *  Only the header of the XWB file is read when the wavebank is opened.
+ *  The metadata of a wave is only read when that wave is requested, and
+ *  the wave's audio stream reads straight out of the (ideally memory-
+ *  mapped) wavebank data, without copying it.
+ *
  *  See also xactwavebank.h for the abstract XACT WaveBank interface,
  *  and xactsoundbank.h for the abstract XACT SoundBank interface.
  */
 class XACTWaveBank_Binary : public XACTWaveBank {
 public:
+	/** Read the whole XWB stream into memory and take over the wavebank from there. */
 	XACTWaveBank_Binary(Common::SeekableReadStream *xwb);
+	/** Take over the wavebank from an XWB file mapped into memory. */
+	XACTWaveBank_Binary(std::shared_ptr<const Common::MappedFile> xwb);
 	virtual ~XACTWaveBank_Binary() = default;
 
 	/** Return the internal name of the WaveBank. */
@@ -98,18 +106,22 @@ private:
 		size_t loopLength; ///< Length of the looping section.
 	};
 
-	using Waves = std::vector<Wave>;
-
-
-	std::unique_ptr<Common::SeekableReadStream> _xwb;
+	std::shared_ptr<const Common::MappedFile> _xwb;
 
 	Common::UString _name; ///< The internal name of this wavebank. */
 	uint32_t _flags;
 
-	Waves _waves;
+	size_t _waveCount;    ///< Number of waves in this wavebank.
+	size_t _waveMetaSize; ///< Size of a wave's metadata entry in bytes.
+
+	size_t _indexOffset; ///< Offset to the first wave's metadata entry.
+	size_t _dataOffset;  ///< Offset to the wave data.
+
 
+	void load();
 
-	void load(Common::SeekableReadStream &xwb);
+	/** Read the metadata entry of a wave. */
+	Wave readWave(size_t index) const;
 };
 
 } // End of namespace Sound
@@ -39,6 +39,7 @@ ActimagineDecoder::ActimagineDecoder(Common::SeekableReadStream *vx) : _vx(vx) {
 }
 
 ActimagineDecoder::~ActimagineDecoder() {
+	stopDecoding();
 }
 
 void ActimagineDecoder::decodeNextTrackFrame(VideoTrack &UNUSED(track)) {
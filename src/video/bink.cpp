@@ -82,6 +82,7 @@
 #include "src/common/huffman.h"
 #include "src/common/rdft.h"
 #include "src/common/dct.h"
+#include "src/common/threadpool.h"
 
 #include "src/graphics/yuv_to_rgb.h"
 
@@ -93,6 +94,7 @@
 
 #include "src/video/bink.h"
 #include "src/video/binkdata.h"
+#include "src/video/binkidct.h"
 
 static const uint32_t kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32_t kBIKgID = MKTAG('B', 'I', 'K', 'g');
@@ -132,6 +134,10 @@ Bink::BinkVideoTrack::Bundle::Bundle() : countLength(0), dataEnd(0), curDec(0),
 }
 
 
+Bink::BinkVideoTrack::PlaneState::PlaneState() : bits(0), colLastVal(0) {
+}
+
+
 Bink::VideoFrame::VideoFrame() : bits(0) {
 }
 
@@ -151,13 +157,18 @@ Bink::AudioInfo::~AudioInfo() {
 }
 
 
-Bink::Bink(Common::SeekableReadStream *bink) : _bink(bink), _audioTrack(0) {
+Bink::Bink(Common::SeekableReadStream *bink) : _bink(bink), _audioTrack(0), _concurrentDecoding(true) {
 	assert(_bink);
 
 	load();
 }
 
 Bink::~Bink() {
+	stopDecoding();
+}
+
+void Bink::setConcurrentDecoding(bool concurrent) {
+	_concurrentDecoding = concurrent;
 }
 
 void Bink::decodeNextTrackFrame(VideoTrack &track) {
@@ -180,15 +191,13 @@ void Bink::decodeNextTrackFrame(VideoTrack &track) {
 		frameSize -= audioPacketLength;
 	}
 
-	size_t videoPacketStart = _bink->pos();
-	size_t videoPacketEnd   = _bink->pos() + frameSize;
+	// Read the whole video packet, so that its planes can be decoded concurrently
+	std::unique_ptr<Common::MemoryReadStream> videoPacket(_bink->readStream(frameSize));
 
-	frame.bits =
-		new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink.get(),
-		    videoPacketStart, videoPacketEnd), true);
+	frame.bits = new Common::BitStream32LELSB(*videoPacket);
 
 	assert(_surface);
-	videoTrack.decodePacket(*_surface, frame);
+	videoTrack.decodePacket(*_surface, frame, _concurrentDecoding ? videoPacket->getData() : 0, videoPacket->size());
 
 	delete frame.bits;
 	frame.bits = 0;
@@ -200,43 +209,173 @@ void Bink::checkAudioBuffer(AudioTrack &track, const Common::Timestamp &endTime)
 	static_cast<BinkAudioTrack &>(track).decodeAudio(*_bink, _frames, _audioTracks, endTime);
 }
 
-void Bink::BinkVideoTrack::decodePacket(Graphics::Surface &surface, VideoFrame &video) {
+void Bink::BinkVideoTrack::decodePacket(Graphics::Surface &surface, VideoFrame &video,
+                                        const byte *packet, size_t packetSize) {
+
 	assert(video.bits);
 
+	if (!decodePlanesConcurrently(packet, packetSize))
+		decodePlanes(video);
+
+	// Convert the YUVA data we have to BGRA
+	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
+	YUVToRGBMan.convert420(Graphics::YUVToRGBManager::kScaleITU,
+			surface.getData(), surface.getWidth() * 4,
+			_curPlanes[0].get(), _curPlanes[1].get(), _curPlanes[2].get(), _curPlanes[3].get(),
+			_width, _height, _width, _width >> 1);
+
+	// And swap the planes with the reference planes
+	for (int i = 0; i < 4; i++)
+		_oldPlanes[i].swap(_curPlanes[i]);
+
+	_curFrame++;
+}
+
+void Bink::BinkVideoTrack::decodePlanes(VideoFrame &video) {
+	PlaneState &plane = _planeStates[kPlaneGroupLuma];
+
+	plane.bits = video.bits;
+
+	/* Version 'i' stores the size of the plane data in front of the alpha
+	 * and the luma plane. Check that they match the data we decode before
+	 * we trust them for finding the planes in decodePlanesConcurrently(). */
+	bool sizesMatch = true;
+
 	if (_hasAlpha) {
-		if (_id == kBIKiID)
-			video.bits->skip(32);
+		const uint32_t alphaSize  = (_id == kBIKiID) ? video.bits->getBits(32) : 0;
+		const size_t   alphaStart = video.bits->pos();
+
+		decodePlane(plane, 3, false);
 
-		decodePlane(video, 3, false);
+		sizesMatch = (video.bits->pos() - alphaStart) == (((size_t) alphaSize) * 8);
 	}
 
-	if (_id == kBIKiID)
-		video.bits->skip(32);
+	const uint32_t lumaSize  = (_id == kBIKiID) ? video.bits->getBits(32) : 0;
+	const size_t   lumaStart = video.bits->pos();
 
 	for (int i = 0; i < 3; i++) {
 		int planeIdx = ((i == 0) || !_swapPlanes) ? i : (i ^ 3);
 
-		decodePlane(video, planeIdx, i != 0);
+		decodePlane(plane, planeIdx, i != 0);
+
+		if (i == 0)
+			sizesMatch = sizesMatch && ((video.bits->pos() - lumaStart) == (((size_t) lumaSize) * 8));
 
 		if (video.bits->pos() >= video.bits->size())
 			break;
 	}
 
-	// Convert the YUVA data we have to BGRA
-	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-	YUVToRGBMan.convert420(Graphics::YUVToRGBManager::kScaleITU,
-			surface.getData(), surface.getWidth() * 4,
-			_curPlanes[0].get(), _curPlanes[1].get(), _curPlanes[2].get(), _curPlanes[3].get(),
-			_width, _height, _width, _width >> 1);
+	plane.bits = 0;
 
-	// And swap the planes with the reference planes
-	for (int i = 0; i < 4; i++)
-		_oldPlanes[i].swap(_curPlanes[i]);
+	if (_hasPlaneSizes && !_planeSizesVerified) {
+		_hasPlaneSizes      = sizesMatch;
+		_planeSizesVerified = sizesMatch;
+	}
+}
 
-	_curFrame++;
+bool Bink::BinkVideoTrack::decodePlanesConcurrently(const byte *packet, size_t packetSize) {
+	if (!packet || !_hasPlaneSizes || !_planeSizesVerified)
+		return false;
+
+	size_t alphaStart = 0, alphaSize = 0;
+	size_t lumaStart  = 0, lumaSize  = 0;
+
+	if (_hasAlpha) {
+		if (packetSize < 4)
+			return false;
+
+		alphaStart = 4;
+		alphaSize  = READ_LE_UINT32(packet);
+
+		if ((alphaSize > (packetSize - alphaStart)) || (alphaSize & 3))
+			return false;
+
+		lumaStart = alphaStart + alphaSize;
+	}
+
+	if ((packetSize - lumaStart) < 4)
+		return false;
+
+	lumaSize   = READ_LE_UINT32(packet + lumaStart);
+	lumaStart += 4;
+
+	if ((lumaSize > (packetSize - lumaStart)) || (lumaSize & 3))
+		return false;
+
+	// The chroma planes have no size field of their own, so they are decoded together
+	const size_t chromaStart = lumaStart + lumaSize;
+	const size_t chromaSize  = packetSize - chromaStart;
+
+	if (!_planeStates[kPlaneGroupChroma].bundles[0].data) {
+		initBundles(_planeStates[kPlaneGroupChroma]);
+		initBundles(_planeStates[kPlaneGroupAlpha]);
+	}
+
+	if (!_threads)
+		_threads = std::make_unique<Common::ThreadPool>("BinkDecoder", kPlaneGroupMAX);
+
+	std::future<void> jobs[kPlaneGroupMAX];
+
+	jobs[kPlaneGroupLuma] = _threads->addJob([this, packet, lumaStart, lumaSize]() {
+		decodePlaneGroup(kPlaneGroupLuma, packet + lumaStart, lumaSize);
+	});
+
+	// If the luma plane fills the whole packet, the chroma planes stay as they are
+	if (chromaSize > 0)
+		jobs[kPlaneGroupChroma] = _threads->addJob([this, packet, chromaStart, chromaSize]() {
+			decodePlaneGroup(kPlaneGroupChroma, packet + chromaStart, chromaSize);
+		});
+
+	if (_hasAlpha)
+		jobs[kPlaneGroupAlpha] = _threads->addJob([this, packet, alphaStart, alphaSize]() {
+			decodePlaneGroup(kPlaneGroupAlpha, packet + alphaStart, alphaSize);
+		});
+
+	// Wait for all jobs before rethrowing an error, since they still use our plane states
+	for (int i = 0; i < kPlaneGroupMAX; i++)
+		if (jobs[i].valid())
+			jobs[i].wait();
+
+	for (int i = 0; i < kPlaneGroupMAX; i++)
+		if (jobs[i].valid())
+			jobs[i].get();
+
+	return true;
 }
 
-void Bink::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
+void Bink::BinkVideoTrack::decodePlaneGroup(PlaneGroup group, const byte *data, size_t size) {
+	Common::MemoryReadStream stream(data, size);
+	Common::BitStream32LELSB bits(stream);
+
+	PlaneState &plane = _planeStates[group];
+	plane.bits = &bits;
+
+	switch (group) {
+		case kPlaneGroupLuma:
+			decodePlane(plane, 0, false);
+			break;
+
+		case kPlaneGroupChroma:
+			for (int i = 1; i < 3; i++) {
+				decodePlane(plane, _swapPlanes ? (i ^ 3) : i, true);
+
+				if (bits.pos() >= bits.size())
+					break;
+			}
+			break;
+
+		case kPlaneGroupAlpha:
+			decodePlane(plane, 3, false);
+			break;
+
+		default:
+			break;
+	}
+
+	plane.bits = 0;
+}
+
+void Bink::BinkVideoTrack::decodePlane(PlaneState &plane, int planeIdx, bool isChroma) {
 	uint32_t blockWidth  = isChroma ? ((_width  + 15) >> 4) : ((_width  + 7) >> 3);
 	uint32_t blockHeight = isChroma ? ((_height + 15) >> 4) : ((_height + 7) >> 3);
 	uint32_t width       = isChroma ?  (_width        >> 1) :   _width;
@@ -244,7 +383,7 @@ void Bink::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isC
 
 	DecodeContext ctx;
 
-	ctx.video     = &video;
+	ctx.plane     = &plane;
 	ctx.planeIdx  = planeIdx;
 	ctx.destStart = _curPlanes[planeIdx].get();
 	ctx.destEnd   = _curPlanes[planeIdx].get() + width * height;
@@ -262,27 +401,27 @@ void Bink::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isC
 	}
 
 	for (int i = 0; i < kSourceMAX; i++) {
-		_bundles[i].countLength = _bundles[i].countLengths[isChroma ? 1 : 0];
+		plane.bundles[i].countLength = plane.bundles[i].countLengths[isChroma ? 1 : 0];
 
-		readBundle(video, (Source) i);
+		readBundle(plane, (Source) i);
 	}
 
 	for (ctx.blockY = 0; ctx.blockY < blockHeight; ctx.blockY++) {
-		readBlockTypes  (video, _bundles[kSourceBlockTypes]);
-		readBlockTypes  (video, _bundles[kSourceSubBlockTypes]);
-		readColors      (video, _bundles[kSourceColors]);
-		readPatterns    (video, _bundles[kSourcePattern]);
-		readMotionValues(video, _bundles[kSourceXOff]);
-		readMotionValues(video, _bundles[kSourceYOff]);
-		readDCS         (video, _bundles[kSourceIntraDC], kDCStartBits, false);
-		readDCS         (video, _bundles[kSourceInterDC], kDCStartBits, true);
-		readRuns        (video, _bundles[kSourceRun]);
+		readBlockTypes  (plane, plane.bundles[kSourceBlockTypes]);
+		readBlockTypes  (plane, plane.bundles[kSourceSubBlockTypes]);
+		readColors      (plane, plane.bundles[kSourceColors]);
+		readPatterns    (plane, plane.bundles[kSourcePattern]);
+		readMotionValues(plane, plane.bundles[kSourceXOff]);
+		readMotionValues(plane, plane.bundles[kSourceYOff]);
+		readDCS         (plane, plane.bundles[kSourceIntraDC], kDCStartBits, false);
+		readDCS         (plane, plane.bundles[kSourceInterDC], kDCStartBits, true);
+		readRuns        (plane, plane.bundles[kSourceRun]);
 
 		ctx.dest = ctx.destStart + 8 * ctx.blockY * ctx.pitch;
 		ctx.prev = ctx.prevStart + 8 * ctx.blockY * ctx.pitch;
 
 		for (ctx.blockX = 0; ctx.blockX < blockWidth; ctx.blockX++, ctx.dest += 8, ctx.prev += 8) {
-			BlockType blockType = (BlockType) getBundleValue(kSourceBlockTypes);
+			BlockType blockType = (BlockType) getBundleValue(plane, kSourceBlockTypes);
 
 			// 16x16 block type on odd line means part of the already decoded block, so skip it
 			if ((ctx.blockY & 1) && (blockType == kBlockScaled)) {
@@ -341,28 +480,28 @@ void Bink::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isC
 
 	}
 
-	if (video.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
-		video.bits->skip(32 - (video.bits->pos() & 0x1F));
+	if (plane.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
+		plane.bits->skip(32 - (plane.bits->pos() & 0x1F));
 
 }
 
-void Bink::BinkVideoTrack::readBundle(VideoFrame &video, Source source) {
+void Bink::BinkVideoTrack::readBundle(PlaneState &plane, Source source) {
 	if (source == kSourceColors) {
 		for (int i = 0; i < 16; i++)
-			readHuffman(video, _colHighHuffman[i]);
+			readHuffman(plane, plane.colHighHuffman[i]);
 
-		_colLastVal = 0;
+		plane.colLastVal = 0;
 	}
 
 	if ((source != kSourceIntraDC) && (source != kSourceInterDC))
-		readHuffman(video, _bundles[source].huffman);
+		readHuffman(plane, plane.bundles[source].huffman);
 
-	_bundles[source].curDec = _bundles[source].data.get();
-	_bundles[source].curPtr = _bundles[source].data.get();
+	plane.bundles[source].curDec = plane.bundles[source].data.get();
+	plane.bundles[source].curPtr = plane.bundles[source].data.get();
 }
 
-void Bink::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffman) {
-	huffman.index = video.bits->getBits(4);
+void Bink::BinkVideoTrack::readHuffman(PlaneState &plane, Huffman &huffman) {
+	huffman.index = plane.bits->getBits(4);
 
 	if (huffman.index == 0) {
 		// The first tree always gives raw nibbles
@@ -375,14 +514,14 @@ void Bink::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffman) {
 
 	byte hasSymbol[16];
 
-	if (video.bits->getBit()) {
+	if (plane.bits->getBit()) {
 		// Symbol selection
 
 		std::memset(hasSymbol, 0, 16);
 
-		uint8_t length = video.bits->getBits(3);
+		uint8_t length = plane.bits->getBits(3);
 		for (int i = 0; i <= length; i++) {
-			huffman.symbols[i] = video.bits->getBits(4);
+			huffman.symbols[i] = plane.bits->getBits(4);
 			hasSymbol[huffman.symbols[i]] = 1;
 		}
 
@@ -398,7 +537,7 @@ void Bink::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffman) {
 	byte tmp1[16], tmp2[16];
 	byte *in = tmp1, *out = tmp2;
 
-	uint8_t depth = video.bits->getBits(2);
+	uint8_t depth = plane.bits->getBits(2);
 
 	for (int i = 0; i < 16; i++)
 		in[i] = i;
@@ -407,7 +546,7 @@ void Bink::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffman) {
 		int size = 1 << i;
 
 		for (int j = 0; j < 16; j += (size << 1))
-			mergeHuffmanSymbols(video, out + j, in + j, size);
+			mergeHuffmanSymbols(plane, out + j, in + j, size);
 
 		std::swap(in, out);
 	}
@@ -415,12 +554,12 @@ void Bink::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffman) {
 	std::memcpy(huffman.symbols, in, 16);
 }
 
-void Bink::BinkVideoTrack::mergeHuffmanSymbols(VideoFrame &video, byte *dst, const byte *src, int size) {
+void Bink::BinkVideoTrack::mergeHuffmanSymbols(PlaneState &plane, byte *dst, const byte *src, int size) {
 	const byte *src2  = src + size;
 	int         size2 = size;
 
 	do {
-		if (!video.bits->getBit()) {
+		if (!plane.bits->getBit()) {
 			*dst++ = *src++;
 			size--;
 		} else {
@@ -580,14 +719,14 @@ void Bink::initAudioTrack(AudioInfo &audio) {
 		audio.dct  = new Common::DCT(frameLenBits, Common::DCT::DCT_III);
 }
 
-void Bink::BinkVideoTrack::initBundles() {
+void Bink::BinkVideoTrack::initBundles(PlaneState &plane) {
 	uint32_t bw     = (_width  + 7) >> 3;
 	uint32_t bh     = (_height + 7) >> 3;
 	uint32_t blocks = bw * bh;
 
 	for (int i = 0; i < kSourceMAX; i++) {
-		_bundles[i].data = std::make_unique<byte[]>(blocks * 64);
-		_bundles[i].dataEnd = _bundles[i].data.get() + blocks * 64;
+		plane.bundles[i].data = std::make_unique<byte[]>(blocks * 64);
+		plane.bundles[i].dataEnd = plane.bundles[i].data.get() + blocks * 64;
 	}
 
 	uint32_t cbw[2] = { (_width + 7) >> 3, (_width  + 15) >> 4 };
@@ -597,15 +736,15 @@ void Bink::BinkVideoTrack::initBundles() {
 	for (int i = 0; i < 2; i++) {
 		int width = MAX<uint32_t>(cw[i], 8);
 
-		_bundles[kSourceBlockTypes   ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceSubBlockTypes].countLengths[i] = Common::intLog2(((width + 7) >> 4) + 511) + 1;
-		_bundles[kSourceColors       ].countLengths[i] = Common::intLog2((cbw[i])     * 64  + 511) + 1;
-		_bundles[kSourceIntraDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceInterDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceXOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceYOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourcePattern      ].countLengths[i] = Common::intLog2((cbw[i]      << 3) + 511) + 1;
-		_bundles[kSourceRun          ].countLengths[i] = Common::intLog2((cbw[i])     * 48  + 511) + 1;
+		plane.bundles[kSourceBlockTypes   ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		plane.bundles[kSourceSubBlockTypes].countLengths[i] = Common::intLog2(((width + 7) >> 4) + 511) + 1;
+		plane.bundles[kSourceColors       ].countLengths[i] = Common::intLog2((cbw[i])     * 64  + 511) + 1;
+		plane.bundles[kSourceIntraDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		plane.bundles[kSourceInterDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		plane.bundles[kSourceXOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		plane.bundles[kSourceYOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		plane.bundles[kSourcePattern      ].countLengths[i] = Common::intLog2((cbw[i]      << 3) + 511) + 1;
+		plane.bundles[kSourceRun          ].countLengths[i] = Common::intLog2((cbw[i])     * 48  + 511) + 1;
 	}
 }
 
@@ -614,29 +753,29 @@ void Bink::BinkVideoTrack::initHuffman() {
 		_huffman[i] = std::make_unique<Common::Huffman>(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]);
 }
 
-byte Bink::BinkVideoTrack::getHuffmanSymbol(VideoFrame &video, Huffman &huffman) {
-	return huffman.symbols[_huffman[huffman.index]->getSymbol(*video.bits)];
+byte Bink::BinkVideoTrack::getHuffmanSymbol(PlaneState &plane, Huffman &huffman) {
+	return huffman.symbols[_huffman[huffman.index]->getSymbol(*plane.bits)];
 }
 
-int32_t Bink::BinkVideoTrack::getBundleValue(Source source) {
+int32_t Bink::BinkVideoTrack::getBundleValue(PlaneState &plane, Source source) {
 	if ((source < kSourceXOff) || (source == kSourceRun))
-		return *_bundles[source].curPtr++;
+		return *plane.bundles[source].curPtr++;
 
 	if ((source == kSourceXOff) || (source == kSourceYOff))
-		return (int8_t) *_bundles[source].curPtr++;
+		return (int8_t) *plane.bundles[source].curPtr++;
 
-	int16_t ret = *reinterpret_cast<int16_t *>(_bundles[source].curPtr);
+	int16_t ret = *reinterpret_cast<int16_t *>(plane.bundles[source].curPtr);
 
-	_bundles[source].curPtr += 2;
+	plane.bundles[source].curPtr += 2;
 
 	return ret;
 }
 
-uint32_t Bink::BinkVideoTrack::readBundleCount(VideoFrame &video, Bundle &bundle) {
+uint32_t Bink::BinkVideoTrack::readBundleCount(PlaneState &plane, Bundle &bundle) {
 	if (!bundle.curDec || (bundle.curDec > bundle.curPtr))
 		return 0;
 
-	uint32_t n = video.bits->getBits(bundle.countLength);
+	uint32_t n = plane.bits->getBits(bundle.countLength);
 	if (n == 0)
 		bundle.curDec = 0;
 
@@ -660,19 +799,19 @@ void Bink::BinkVideoTrack::blockScaledSkip(DecodeContext &ctx) {
 }
 
 void Bink::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
-	const uint8_t *scan = binkPatterns[ctx.video->bits->getBits(4)];
+	const uint8_t *scan = binkPatterns[ctx.plane->bits->getBits(4)];
 
 	int i = 0;
 	do {
-		int run = getBundleValue(kSourceRun) + 1;
+		int run = getBundleValue(*ctx.plane, kSourceRun) + 1;
 
 		i += run;
 		if (i > 64)
 			throw Common::Exception("Run went out of bounds");
 
-		if (ctx.video->bits->getBit()) {
+		if (ctx.plane->bits->getBit()) {
 
-			byte v = getBundleValue(kSourceColors);
+			byte v = getBundleValue(*ctx.plane, kSourceColors);
 			for (int j = 0; j < run; j++, scan++)
 				ctx.dest[ctx.coordScaledMap1[*scan]] =
 				ctx.dest[ctx.coordScaledMap2[*scan]] =
@@ -684,7 +823,7 @@ void Bink::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
 				ctx.dest[ctx.coordScaledMap1[*scan]] =
 				ctx.dest[ctx.coordScaledMap2[*scan]] =
 				ctx.dest[ctx.coordScaledMap3[*scan]] =
-				ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
+				ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(*ctx.plane, kSourceColors);
 
 	} while (i < 63);
 
@@ -692,18 +831,18 @@ void Bink::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
 		ctx.dest[ctx.coordScaledMap1[*scan]] =
 		ctx.dest[ctx.coordScaledMap2[*scan]] =
 		ctx.dest[ctx.coordScaledMap3[*scan]] =
-		ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
+		ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(*ctx.plane, kSourceColors);
 }
 
 void Bink::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 	int16_t block[64];
 	std::memset(block, 0, 64 * sizeof(int16_t));
 
-	block[0] = getBundleValue(kSourceIntraDC);
+	block[0] = getBundleValue(*ctx.plane, kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
+	readDCTCoeffs(*ctx.plane, block, true);
 
-	IDCT(block);
+	binkIDCT(block);
 
 	int16_t *src   = block;
 	byte  *dest1 = ctx.dest;
@@ -717,7 +856,7 @@ void Bink::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 }
 
 void Bink::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
+	byte v = getBundleValue(*ctx.plane, kSourceColors);
 
 	byte *dest = ctx.dest;
 	for (int i = 0; i < 16; i++, dest += ctx.pitch)
@@ -728,12 +867,12 @@ void Bink::BinkVideoTrack::blockScaledPattern(DecodeContext &ctx) {
 	byte col[2];
 
 	for (int i = 0; i < 2; i++)
-		col[i] = getBundleValue(kSourceColors);
+		col[i] = getBundleValue(*ctx.plane, kSourceColors);
 
 	byte *dest1 = ctx.dest;
 	byte *dest2 = ctx.dest + ctx.pitch;
 	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		byte v = getBundleValue(kSourcePattern);
+		byte v = getBundleValue(*ctx.plane, kSourcePattern);
 
 		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2, v >>= 1)
 			dest1[0] = dest1[1] = dest2[0] = dest2[1] = col[v & 1];
@@ -746,17 +885,17 @@ void Bink::BinkVideoTrack::blockScaledRaw(DecodeContext &ctx) {
 	byte *dest1 = ctx.dest;
 	byte *dest2 = ctx.dest + ctx.pitch;
 	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		std::memcpy(row, _bundles[kSourceColors].curPtr, 8);
+		std::memcpy(row, ctx.plane->bundles[kSourceColors].curPtr, 8);
 
 		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
 			dest1[0] = dest1[1] = dest2[0] = dest2[1] = row[i];
 
-		_bundles[kSourceColors].curPtr += 8;
+		ctx.plane->bundles[kSourceColors].curPtr += 8;
 	}
 }
 
 void Bink::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
-	BlockType blockType = (BlockType) getBundleValue(kSourceSubBlockTypes);
+	BlockType blockType = (BlockType) getBundleValue(*ctx.plane, kSourceSubBlockTypes);
 
 	switch (blockType) {
 		case kBlockRun:
@@ -789,8 +928,8 @@ void Bink::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
 }
 
 void Bink::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
-	int8_t xOff = getBundleValue(kSourceXOff);
-	int8_t yOff = getBundleValue(kSourceYOff);
+	int8_t xOff = getBundleValue(*ctx.plane, kSourceXOff);
+	int8_t yOff = getBundleValue(*ctx.plane, kSourceYOff);
 
 	byte *dest = ctx.dest;
 	byte *prev = ctx.prev + yOff * ((int32_t) ctx.pitch) + xOff;
@@ -802,41 +941,41 @@ void Bink::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
 }
 
 void Bink::BinkVideoTrack::blockRun(DecodeContext &ctx) {
-	const uint8_t *scan = binkPatterns[ctx.video->bits->getBits(4)];
+	const uint8_t *scan = binkPatterns[ctx.plane->bits->getBits(4)];
 
 	int i = 0;
 	do {
-		int run = getBundleValue(kSourceRun) + 1;
+		int run = getBundleValue(*ctx.plane, kSourceRun) + 1;
 
 		i += run;
 		if (i > 64)
 			throw Common::Exception("Run went out of bounds");
 
-		if (ctx.video->bits->getBit()) {
+		if (ctx.plane->bits->getBit()) {
 
-			byte v = getBundleValue(kSourceColors);
+			byte v = getBundleValue(*ctx.plane, kSourceColors);
 			for (int j = 0; j < run; j++)
 				ctx.dest[ctx.coordMap[*scan++]] = v;
 
 		} else
 			for (int j = 0; j < run; j++)
-				ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+				ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(*ctx.plane, kSourceColors);
 
 	} while (i < 63);
 
 	if (i == 63)
-		ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+		ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(*ctx.plane, kSourceColors);
 }
 
 void Bink::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 	blockMotion(ctx);
 
-	byte v = ctx.video->bits->getBits(7);
+	byte v = ctx.plane->bits->getBits(7);
 
 	int16_t block[64];
 	std::memset(block, 0, 64 * sizeof(int16_t));
 
-	readResidue(*ctx.video, block, v);
+	readResidue(*ctx.plane, block, v);
 
 	byte  *dst = ctx.dest;
 	int16_t *src = block;
@@ -849,15 +988,15 @@ void Bink::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
 	int16_t block[64];
 	std::memset(block, 0, 64 * sizeof(int16_t));
 
-	block[0] = getBundleValue(kSourceIntraDC);
+	block[0] = getBundleValue(*ctx.plane, kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
+	readDCTCoeffs(*ctx.plane, block, true);
 
-	IDCTPut(ctx, block);
+	binkIDCTPut(ctx.dest, ctx.pitch, block);
 }
 
 void Bink::BinkVideoTrack::blockFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
+	byte v = getBundleValue(*ctx.plane, kSourceColors);
 
 	byte *dest = ctx.dest;
 	for (int i = 0; i < 8; i++, dest += ctx.pitch)
@@ -870,22 +1009,22 @@ void Bink::BinkVideoTrack::blockInter(DecodeContext &ctx) {
 	int16_t block[64];
 	std::memset(block, 0, 64 * sizeof(int16_t));
 
-	block[0] = getBundleValue(kSourceInterDC);
+	block[0] = getBundleValue(*ctx.plane, kSourceInterDC);
 
-	readDCTCoeffs(*ctx.video, block, false);
+	readDCTCoeffs(*ctx.plane, block, false);
 
-	IDCTAdd(ctx, block);
+	binkIDCTAdd(ctx.dest, ctx.pitch, block);
 }
 
 void Bink::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
 	byte col[2];
 
 	for (int i = 0; i < 2; i++)
-		col[i] = getBundleValue(kSourceColors);
+		col[i] = getBundleValue(*ctx.plane, kSourceColors);
 
 	byte *dest = ctx.dest;
 	for (int i = 0; i < 8; i++, dest += ctx.pitch - 8) {
-		byte v = getBundleValue(kSourcePattern);
+		byte v = getBundleValue(*ctx.plane, kSourcePattern);
 
 		for (int j = 0; j < 8; j++, v >>= 1)
 			*dest++ = col[v & 1];
@@ -894,15 +1033,15 @@ void Bink::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
 
 void Bink::BinkVideoTrack::blockRaw(DecodeContext &ctx) {
 	byte *dest = ctx.dest;
-	byte *data = _bundles[kSourceColors].curPtr;
+	byte *data = ctx.plane->bundles[kSourceColors].curPtr;
 	for (int i = 0; i < 8; i++, dest += ctx.pitch, data += 8)
 		std::memcpy(dest, data, 8);
 
-	_bundles[kSourceColors].curPtr += 64;
+	ctx.plane->bundles[kSourceColors].curPtr += 64;
 }
 
-void Bink::BinkVideoTrack::readRuns(VideoFrame &video, Bundle &bundle) {
-	uint32_t n = readBundleCount(video, bundle);
+void Bink::BinkVideoTrack::readRuns(PlaneState &plane, Bundle &bundle) {
+	uint32_t n = readBundleCount(plane, bundle);
 	if (n == 0)
 		return;
 
@@ -910,19 +1049,19 @@ void Bink::BinkVideoTrack::readRuns(VideoFrame &video, Bundle &bundle) {
 	if (decEnd > bundle.dataEnd)
 		throw Common::Exception("Run value went out of bounds");
 
-	if (video.bits->getBit()) {
-		byte v = video.bits->getBits(4);
+	if (plane.bits->getBit()) {
+		byte v = plane.bits->getBits(4);
 
 		std::memset(bundle.curDec, v, n);
 		bundle.curDec += n;
 
 	} else
 		while (bundle.curDec < decEnd)
-			*bundle.curDec++ = getHuffmanSymbol(video, bundle.huffman);
+			*bundle.curDec++ = getHuffmanSymbol(plane, bundle.huffman);
 }
 
-void Bink::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bundle) {
-	uint32_t n = readBundleCount(video, bundle);
+void Bink::BinkVideoTrack::readMotionValues(PlaneState &plane, Bundle &bundle) {
+	uint32_t n = readBundleCount(plane, bundle);
 	if (n == 0)
 		return;
 
@@ -930,11 +1069,11 @@ void Bink::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bundle) {
 	if (decEnd > bundle.dataEnd)
 		throw Common::Exception("Too many motion values");
 
-	if (video.bits->getBit()) {
-		byte v = video.bits->getBits(4);
+	if (plane.bits->getBit()) {
+		byte v = plane.bits->getBits(4);
 
 		if (v) {
-			int sign = -((int)video.bits->getBit());
+			int sign = -((int)plane.bits->getBit());
 			v = (v ^ sign) - sign;
 		}
 
@@ -945,10 +1084,10 @@ void Bink::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bundle) {
 	}
 
 	do {
-		byte v = getHuffmanSymbol(video, bundle.huffman);
+		byte v = getHuffmanSymbol(plane, bundle.huffman);
 
 		if (v) {
-			int sign = -((int)video.bits->getBit());
+			int sign = -((int)plane.bits->getBit());
 			v = (v ^ sign) - sign;
 		}
 
@@ -958,8 +1097,8 @@ void Bink::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bundle) {
 }
 
 const uint8_t rleLens[4] = { 4, 8, 12, 32 };
-void Bink::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bundle) {
-	uint32_t n = readBundleCount(video, bundle);
+void Bink::BinkVideoTrack::readBlockTypes(PlaneState &plane, Bundle &bundle) {
+	uint32_t n = readBundleCount(plane, bundle);
 	if (n == 0)
 		return;
 
@@ -967,8 +1106,8 @@ void Bink::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bundle) {
 	if (decEnd > bundle.dataEnd)
 		throw Common::Exception("Too many block type values");
 
-	if (video.bits->getBit()) {
-		byte v = video.bits->getBits(4);
+	if (plane.bits->getBit()) {
+		byte v = plane.bits->getBits(4);
 
 		std::memset(bundle.curDec, v, n);
 
@@ -979,7 +1118,7 @@ void Bink::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bundle) {
 	byte last = 0;
 	do {
 
-		byte v = getHuffmanSymbol(video, bundle.huffman);
+		byte v = getHuffmanSymbol(plane, bundle.huffman);
 
 		if (v < 12) {
 			last = v;
@@ -995,8 +1134,8 @@ void Bink::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bundle) {
 	} while (bundle.curDec < decEnd);
 }
 
-void Bink::BinkVideoTrack::readPatterns(VideoFrame &video, Bundle &bundle) {
-	uint32_t n = readBundleCount(video, bundle);
+void Bink::BinkVideoTrack::readPatterns(PlaneState &plane, Bundle &bundle) {
+	uint32_t n = readBundleCount(plane, bundle);
 	if (n == 0)
 		return;
 
@@ -1006,15 +1145,15 @@ void Bink::BinkVideoTrack::readPatterns(VideoFrame &video, Bundle &bundle) {
 
 	byte v;
 	while (bundle.curDec < decEnd) {
-		v  = getHuffmanSymbol(video, bundle.huffman);
-		v |= getHuffmanSymbol(video, bundle.huffman) << 4;
+		v  = getHuffmanSymbol(plane, bundle.huffman);
+		v |= getHuffmanSymbol(plane, bundle.huffman) << 4;
 		*bundle.curDec++ = v;
 	}
 }
 
 
-void Bink::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle) {
-	uint32_t n = readBundleCount(video, bundle);
+void Bink::BinkVideoTrack::readColors(PlaneState &plane, Bundle &bundle) {
+	uint32_t n = readBundleCount(plane, bundle);
 	if (n == 0)
 		return;
 
@@ -1022,12 +1161,12 @@ void Bink::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle) {
 	if (decEnd > bundle.dataEnd)
 		throw Common::Exception("Too many color values");
 
-	if (video.bits->getBit()) {
-		_colLastVal = getHuffmanSymbol(video, _colHighHuffman[_colLastVal]);
+	if (plane.bits->getBit()) {
+		plane.colLastVal = getHuffmanSymbol(plane, plane.colHighHuffman[plane.colLastVal]);
 
 		byte v;
-		v = getHuffmanSymbol(video, bundle.huffman);
-		v = (_colLastVal << 4) | v;
+		v = getHuffmanSymbol(plane, bundle.huffman);
+		v = (plane.colLastVal << 4) | v;
 
 		if (_id != kBIKiID) {
 			int sign = ((int8_t) v) >> 7;
@@ -1042,11 +1181,11 @@ void Bink::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle) {
 	}
 
 	while (bundle.curDec < decEnd) {
-		_colLastVal = getHuffmanSymbol(video, _colHighHuffman[_colLastVal]);
+		plane.colLastVal = getHuffmanSymbol(plane, plane.colHighHuffman[plane.colLastVal]);
 
 		byte v;
-		v = getHuffmanSymbol(video, bundle.huffman);
-		v = (_colLastVal << 4) | v;
+		v = getHuffmanSymbol(plane, bundle.huffman);
+		v = (plane.colLastVal << 4) | v;
 
 		if (_id != kBIKiID) {
 			int sign = ((int8_t) v) >> 7;
@@ -1057,16 +1196,16 @@ void Bink::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle) {
 	}
 }
 
-void Bink::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle, int startBits, bool hasSign) {
-	uint32_t length = readBundleCount(video, bundle);
+void Bink::BinkVideoTrack::readDCS(PlaneState &plane, Bundle &bundle, int startBits, bool hasSign) {
+	uint32_t length = readBundleCount(plane, bundle);
 	if (length == 0)
 		return;
 
 	int16_t *dest = reinterpret_cast<int16_t *>(bundle.curDec);
 
-	int32_t v = video.bits->getBits(startBits - (hasSign ? 1 : 0));
+	int32_t v = plane.bits->getBits(startBits - (hasSign ? 1 : 0));
 	if (v && hasSign) {
-		int sign = -((int)video.bits->getBit());
+		int sign = -((int)plane.bits->getBit());
 		v = (v ^ sign) - sign;
 	}
 
@@ -1076,14 +1215,14 @@ void Bink::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle, int startB
 	for (uint32_t i = 0; i < length; i += 8) {
 		uint32_t length2 = MIN<uint32_t>(length - i, 8);
 
-		byte bSize = video.bits->getBits(4);
+		byte bSize = plane.bits->getBits(4);
 
 		if (bSize) {
 
 			for (uint32_t j = 0; j < length2; j++) {
-				int16_t v2 = video.bits->getBits(bSize);
+				int16_t v2 = plane.bits->getBits(bSize);
 				if (v2) {
-					int sign = -((int)video.bits->getBit());
+					int sign = -((int)plane.bits->getBit());
 					v2 = (v2 ^ sign) - sign;
 				}
 
@@ -1123,7 +1262,7 @@ static inline int16_t dequant(int16_t in, uint32_t quant, bool dc) {
 }
 
 /** Reads 8x8 block of DCT coefficients. */
-void Bink::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int16_t *block, bool isIntra) {
+void Bink::BinkVideoTrack::readDCTCoeffs(PlaneState &plane, int16_t *block, bool isIntra) {
 	int coefCount = 0;
 	int coefIdx[64];
 
@@ -1138,13 +1277,13 @@ void Bink::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int16_t *block, bool
 	coefList[listEnd] = 2;  modeList[listEnd++] = 3;
 	coefList[listEnd] = 3;  modeList[listEnd++] = 3;
 
-	int bits = video.bits->getBits(4) - 1;
+	int bits = plane.bits->getBits(4) - 1;
 	for (int mask = 1 << (MAX<int>(bits, 0)); bits >= 0; mask >>= 1, bits--) {
 		int listPos = listStart;
 
 		while (listPos < listEnd) {
 
-			if (!(modeList[listPos] | coefList[listPos]) || !video.bits->getBit()) {
+			if (!(modeList[listPos] | coefList[listPos]) || !plane.bits->getBit()) {
 				listPos++;
 				continue;
 			}
@@ -1163,17 +1302,17 @@ void Bink::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int16_t *block, bool
 					modeList[listPos++] = 0;
 				}
 				for (int i = 0; i < 4; i++, ccoef++) {
-					if (video.bits->getBit()) {
+					if (plane.bits->getBit()) {
 						coefList[--listStart] = ccoef;
 						modeList[  listStart] = 3;
 					} else {
 						int t;
 						if (!bits) {
-							t = 1 - (video.bits->getBit() << 1);
+							t = 1 - (plane.bits->getBit() << 1);
 						} else {
-							t = video.bits->getBits(bits) | mask;
+							t = plane.bits->getBits(bits) | mask;
 
-							int sign = -((int)video.bits->getBit());
+							int sign = -((int)plane.bits->getBit());
 							t = (t ^ sign) - sign;
 						}
 						block[binkScan[ccoef]] = t;
@@ -1194,11 +1333,11 @@ void Bink::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int16_t *block, bool
 			case 3:
 				int t;
 				if (!bits) {
-					t = 1 - (video.bits->getBit() << 1);
+					t = 1 - (plane.bits->getBit() << 1);
 				} else {
-					t = video.bits->getBits(bits) | mask;
+					t = plane.bits->getBits(bits) | mask;
 
-					int sign = -((int)video.bits->getBit());
+					int sign = -((int)plane.bits->getBit());
 					t = (t ^ sign) - sign;
 				}
 				block[binkScan[ccoef]] = t;
@@ -1210,7 +1349,7 @@ void Bink::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int16_t *block, bool
 		}
 	}
 
-	uint8_t quantIdx = video.bits->getBits(4);
+	uint8_t quantIdx = plane.bits->getBits(4);
 	const uint32_t *quant = isIntra ? binkIntraQuant[quantIdx] : binkInterQuant[quantIdx];
 	block[0] = dequant(block[0], quant[0], true);
 
@@ -1222,7 +1361,7 @@ void Bink::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int16_t *block, bool
 }
 
 /** Reads 8x8 block with residue after motion compensation. */
-void Bink::BinkVideoTrack::readResidue(VideoFrame &video, int16_t *block, int masksCount) {
+void Bink::BinkVideoTrack::readResidue(PlaneState &plane, int16_t *block, int masksCount) {
 	int nzCoeff[64];
 	int nzCoeffCount = 0;
 
@@ -1235,10 +1374,10 @@ void Bink::BinkVideoTrack::readResidue(VideoFrame &video, int16_t *block, int ma
 	coefList[listEnd] = 44; modeList[listEnd++] = 0;
 	coefList[listEnd] =  0; modeList[listEnd++] = 2;
 
-	for (int mask = 1 << video.bits->getBits(3); mask; mask >>= 1) {
+	for (int mask = 1 << plane.bits->getBits(3); mask; mask >>= 1) {
 
 		for (int i = 0; i < nzCoeffCount; i++) {
-			if (!video.bits->getBit())
+			if (!plane.bits->getBit())
 				continue;
 			if (block[nzCoeff[i]] < 0)
 				block[nzCoeff[i]] -= mask;
@@ -1252,7 +1391,7 @@ void Bink::BinkVideoTrack::readResidue(VideoFrame &video, int16_t *block, int ma
 		int listPos = listStart;
 		while (listPos < listEnd) {
 
-			if (!(coefList[listPos] | modeList[listPos]) || !video.bits->getBit()) {
+			if (!(coefList[listPos] | modeList[listPos]) || !plane.bits->getBit()) {
 				listPos++;
 				continue;
 			}
@@ -1272,13 +1411,13 @@ void Bink::BinkVideoTrack::readResidue(VideoFrame &video, int16_t *block, int ma
 				}
 
 				for (int i = 0; i < 4; i++, ccoef++) {
-					if (video.bits->getBit()) {
+					if (plane.bits->getBit()) {
 						coefList[--listStart] = ccoef;
 						modeList[  listStart] = 3;
 					} else {
 						nzCoeff[nzCoeffCount++] = binkScan[ccoef];
 
-						int sign = -((int)video.bits->getBit());
+						int sign = -((int)plane.bits->getBit());
 						block[binkScan[ccoef]] = (mask ^ sign) - sign;
 
 						masksCount--;
@@ -1300,7 +1439,7 @@ void Bink::BinkVideoTrack::readResidue(VideoFrame &video, int16_t *block, int ma
 			case 3:
 				nzCoeff[nzCoeffCount++] = binkScan[ccoef];
 
-				int sign = -((int)video.bits->getBit());
+				int sign = -((int)plane.bits->getBit());
 				block[binkScan[ccoef]] = (mask ^ sign) - sign;
 
 				coefList[listPos]   = 0;
@@ -1522,91 +1661,9 @@ void Bink::BinkAudioTrack::readAudioCoeffs(Common::BitStream &bits, float *coeff
 
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
-#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
-    const int a0 = (src)[s0] + (src)[s4]; \
-    const int a1 = (src)[s0] - (src)[s4]; \
-    const int a2 = (src)[s2] + (src)[s6]; \
-    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
-    const int a4 = (src)[s5] + (src)[s3]; \
-    const int a5 = (src)[s5] - (src)[s3]; \
-    const int a6 = (src)[s1] + (src)[s7]; \
-    const int a7 = (src)[s1] - (src)[s7]; \
-    const int b0 = a4 + a6; \
-    const int b1 = (A3*(a5 + a7)) >> 11; \
-    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
-    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
-    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
-    (dest)[d0] = munge(a0+a2   +b0); \
-    (dest)[d1] = munge(a1+a3-a2+b2); \
-    (dest)[d2] = munge(a1-a3+a2+b3); \
-    (dest)[d3] = munge(a0-a2   -b4); \
-    (dest)[d4] = munge(a0-a2   +b4); \
-    (dest)[d5] = munge(a1-a3+a2-b3); \
-    (dest)[d6] = munge(a1+a3-a2-b2); \
-    (dest)[d7] = munge(a0+a2   -b0); \
-}
-/* end IDCT_TRANSFORM macro */
-
-#define MUNGE_NONE(x) (x)
-#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
-
-#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
-#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
-
-static inline void IDCTCol(int16_t *dest, const int16_t *src)
-{
-	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
-		dest[ 0] =
-		dest[ 8] =
-		dest[16] =
-		dest[24] =
-		dest[32] =
-		dest[40] =
-		dest[48] =
-		dest[56] = src[0];
-	} else {
-		IDCT_COL(dest, src);
-	}
-}
-
-void Bink::BinkVideoTrack::IDCT(int16_t *block) {
-	int i;
-	int16_t temp[64];
-
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
-	}
-}
-
-void Bink::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int16_t *block) {
-	int i, j;
-
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
-}
-
-void Bink::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int16_t *block) {
-	int i;
-	int16_t temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
-	}
-}
-
 Bink::BinkVideoTrack::BinkVideoTrack(uint32_t width, uint32_t height, uint32_t frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32_t id) :
-		_width(width), _height(height), _curFrame(-1), _frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
+		_width(width), _height(height), _curFrame(-1), _frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id),
+		_hasPlaneSizes(id == kBIKiID), _planeSizesVerified(false) {
 	// Give the planes a bit extra space
 	width  = _width  + 32;
 	height = _height + 32;
@@ -1630,8 +1687,11 @@ Bink::BinkVideoTrack::BinkVideoTrack(uint32_t width, uint32_t height, uint32_t f
 	std::memset(_oldPlanes[2].get(),   0, (width >> 1) * (height >> 1));
 	std::memset(_oldPlanes[3].get(), 255,  width       *  height      );
 
-	initBundles();
+	initBundles(_planeStates[kPlaneGroupLuma]);
 	initHuffman();
 }
 
+Bink::BinkVideoTrack::~BinkVideoTrack() {
+}
+
 } // End of namespace Video
@@ -83,6 +83,7 @@ namespace Common {
 	class SeekableReadStream;
 	class BitStream;
 	class Huffman;
+	class ThreadPool;
 
 	class RDFT;
 	class DCT;
@@ -100,6 +101,9 @@ public:
 	Bink(Common::SeekableReadStream *bink);
 	~Bink();
 
+	/** Decode the planes of a frame concurrently, if the video allows it. Enabled by default. */
+	void setConcurrentDecoding(bool concurrent);
+
 protected:
 	void decodeNextTrackFrame(VideoTrack &track);
 	void checkAudioBuffer(AudioTrack &track, const Common::Timestamp &endTime);
@@ -171,49 +175,28 @@ private:
 
 	uint32_t _audioTrack; ///< Audio track to use.
 
+	bool _concurrentDecoding; ///< Decode the planes of a frame concurrently?
+
 	/** Load a Bink file. */
 	void load();
 
 	class BinkVideoTrack : public FixedRateVideoTrack {
 	public:
 		BinkVideoTrack(uint32_t width, uint32_t height, uint32_t frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32_t id);
+		~BinkVideoTrack();
 
 		uint32_t getWidth() const { return _width; }
 		uint32_t getHeight() const { return _height; }
 		int getCurFrame() const { return _curFrame; }
 		int getFrameCount() const { return _frameCount; }
 
-		/** Decode a video packet. */
-		void decodePacket(Graphics::Surface &surface, VideoFrame &frame);
+		/** Decode a video packet. If the raw packet data is given, the planes may be decoded concurrently. */
+		void decodePacket(Graphics::Surface &surface, VideoFrame &frame, const byte *packet, size_t packetSize);
 
 	protected:
 		Common::Rational getFrameRate() const { return _frameRate; }
 
 	private:
-		/** A decoder state. */
-		struct DecodeContext {
-			VideoFrame *video;
-
-			uint32_t planeIdx;
-
-			uint32_t blockX;
-			uint32_t blockY;
-
-			byte *dest;
-			byte *prev;
-
-			byte *destStart, *destEnd;
-			byte *prevStart, *prevEnd;
-
-			uint32_t pitch;
-
-			int coordMap[64];
-			int coordScaledMap1[64];
-			int coordScaledMap2[64];
-			int coordScaledMap3[64];
-			int coordScaledMap4[64];
-		};
-
 		/** IDs for different data types used in Bink video codec. */
 		enum Source {
 			kSourceBlockTypes    = 0, ///< 8x8 block types.
@@ -267,6 +250,53 @@ private:
 			Bundle();
 		};
 
+		/** The state needed to decode a plane, separate for each plane decoded concurrently. */
+		struct PlaneState {
+			Common::BitStream *bits; ///< The bit stream of the plane data.
+
+			Bundle bundles[kSourceMAX]; ///< Bundles for decoding all data types.
+
+			/** Huffman codebooks to use for decoding high nibbles in color data types. */
+			Huffman colHighHuffman[16];
+			/** Value of the last decoded high nibble in color data types. */
+			int colLastVal;
+
+			PlaneState();
+		};
+
+		/** Groups of planes that can be decoded concurrently. */
+		enum PlaneGroup {
+			kPlaneGroupLuma   = 0, ///< Y. Also used for all planes when decoding serially.
+			kPlaneGroupChroma    , ///< U and V, which only share one size field.
+			kPlaneGroupAlpha     , ///< A.
+
+			kPlaneGroupMAX
+		};
+
+		/** A decoder state. */
+		struct DecodeContext {
+			PlaneState *plane;
+
+			uint32_t planeIdx;
+
+			uint32_t blockX;
+			uint32_t blockY;
+
+			byte *dest;
+			byte *prev;
+
+			byte *destStart, *destEnd;
+			byte *prevStart, *prevEnd;
+
+			uint32_t pitch;
+
+			int coordMap[64];
+			int coordScaledMap1[64];
+			int coordScaledMap2[64];
+			int coordScaledMap3[64];
+			int coordScaledMap4[64];
+		};
+
 		uint32_t _width;
 		uint32_t _height;
 
@@ -280,20 +310,21 @@ private:
 
 		uint32_t _id; ///< The BIK FourCC.
 
-		Bundle _bundles[kSourceMAX]; ///< Bundles for decoding all data types.
+		PlaneState _planeStates[kPlaneGroupMAX]; ///< The states for decoding the planes.
 
 		std::unique_ptr<Common::Huffman> _huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
 
-		/** Huffman codebooks to use for decoding high nibbles in color data types. */
-		Huffman _colHighHuffman[16];
-		/** Value of the last decoded high nibble in color data types. */
-		int _colLastVal;
+		bool _hasPlaneSizes;      ///< Do video packets store the size of the plane data?
+		bool _planeSizesVerified; ///< Did the plane sizes match the decoded plane data?
+
+		/** Threads for decoding the planes concurrently. */
+		std::unique_ptr<Common::ThreadPool> _threads;
 
 		std::unique_ptr<byte[]> _curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		std::unique_ptr<byte[]> _oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
-		/** Initialize the bundles. */
-		void initBundles();
+		/** Initialize the bundles of a plane state. */
+		void initBundles(PlaneState &plane);
 
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
@@ -301,24 +332,31 @@ private:
 		/** Decode a video packet. */
 		void videoPacket(VideoFrame &video);
 
+		/** Decode all planes of a video packet, one after the other. */
+		void decodePlanes(VideoFrame &video);
+		/** Decode the planes of a video packet concurrently, if the packet allows it. */
+		bool decodePlanesConcurrently(const byte *packet, size_t packetSize);
+		/** Decode a group of planes out of its part of the video packet. */
+		void decodePlaneGroup(PlaneGroup group, const byte *data, size_t size);
+
 		/** Decode a plane. */
-		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
+		void decodePlane(PlaneState &plane, int planeIdx, bool isChroma);
 
 		/** Read/Initialize a bundle for decoding a plane. */
-		void readBundle(VideoFrame &video, Source source);
+		void readBundle(PlaneState &plane, Source source);
 
 		/** Read the symbols for a Huffman code. */
-		void readHuffman(VideoFrame &video, Huffman &huffman);
+		void readHuffman(PlaneState &plane, Huffman &huffman);
 		/** Merge two Huffman symbol lists. */
-		void mergeHuffmanSymbols(VideoFrame &video, byte *dst, const byte *src, int size);
+		void mergeHuffmanSymbols(PlaneState &plane, byte *dst, const byte *src, int size);
 
 		/** Read and translate a symbol out of a Huffman code. */
-		byte getHuffmanSymbol(VideoFrame &video, Huffman &huffman);
+		byte getHuffmanSymbol(PlaneState &plane, Huffman &huffman);
 
 		/** Get a direct value out of a bundle. */
-		int32_t getBundleValue(Source source);
+		int32_t getBundleValue(PlaneState &plane, Source source);
 		/** Read a count value out of a bundle. */
-		uint32_t readBundleCount(VideoFrame &video, Bundle &bundle);
+		uint32_t readBundleCount(PlaneState &plane, Bundle &bundle);
 
 		// Handle the block types
 		void blockSkip         (DecodeContext &ctx);
@@ -339,19 +377,14 @@ private:
 		void blockRaw          (DecodeContext &ctx);
 
 		// Read the bundles
-		void readRuns        (VideoFrame &video, Bundle &bundle);
-		void readMotionValues(VideoFrame &video, Bundle &bundle);
-		void readBlockTypes  (VideoFrame &video, Bundle &bundle);
-		void readPatterns    (VideoFrame &video, Bundle &bundle);
-		void readColors      (VideoFrame &video, Bundle &bundle);
-		void readDCS         (VideoFrame &video, Bundle &bundle, int startBits, bool hasSign);
-		void readDCTCoeffs   (VideoFrame &video, int16_t *block, bool isIntra);
-		void readResidue     (VideoFrame &video, int16_t *block, int masksCount);
-
-		// Bink video IDCT
-		void IDCT(int16_t *block);
-		void IDCTPut(DecodeContext &ctx, int16_t *block);
-		void IDCTAdd(DecodeContext &ctx, int16_t *block);
+		void readRuns        (PlaneState &plane, Bundle &bundle);
+		void readMotionValues(PlaneState &plane, Bundle &bundle);
+		void readBlockTypes  (PlaneState &plane, Bundle &bundle);
+		void readPatterns    (PlaneState &plane, Bundle &bundle);
+		void readColors      (PlaneState &plane, Bundle &bundle);
+		void readDCS         (PlaneState &plane, Bundle &bundle, int startBits, bool hasSign);
+		void readDCTCoeffs   (PlaneState &plane, int16_t *block, bool isIntra);
+		void readResidue     (PlaneState &plane, int16_t *block, int masksCount);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
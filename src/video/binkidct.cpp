@@ -0,0 +1,354 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The inverse DCT used by Bink video.
+ */
+
+/* Based on the Bink implementation in FFmpeg (<https://ffmpeg.org/)>,
+ * which is released under the terms of version 2 or later of the GNU
+ * Lesser General Public License.
+ *
+ * The original copyright note in libavcodec/binkdsp.c reads as follows:
+ *
+ * Bink DSP routines
+ * Copyright (c) 2009 Konstantin Shishkov
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "src/video/binkidct.h"
+
+// The AVX2 version is picked at runtime, where the compiler lets us
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define XOREOS_BINK_AVX2 1
+	#define XOREOS_BINK_AVX2_TARGET __attribute__((target("avx2")))
+
+	#include <immintrin.h>
+#endif
+
+namespace Video {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+    const int a0 = (src)[s0] + (src)[s4]; \
+    const int a1 = (src)[s0] - (src)[s4]; \
+    const int a2 = (src)[s2] + (src)[s6]; \
+    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+    const int a4 = (src)[s5] + (src)[s3]; \
+    const int a5 = (src)[s5] - (src)[s3]; \
+    const int a6 = (src)[s1] + (src)[s7]; \
+    const int a7 = (src)[s1] - (src)[s7]; \
+    const int b0 = a4 + a6; \
+    const int b1 = (A3*(a5 + a7)) >> 11; \
+    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+    (dest)[d0] = munge(a0+a2   +b0); \
+    (dest)[d1] = munge(a1+a3-a2+b2); \
+    (dest)[d2] = munge(a1-a3+a2+b3); \
+    (dest)[d3] = munge(a0-a2   -b4); \
+    (dest)[d4] = munge(a0-a2   +b4); \
+    (dest)[d5] = munge(a1-a3+a2-b3); \
+    (dest)[d6] = munge(a1+a3-a2-b2); \
+    (dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void IDCTCol(int16_t *dest, const int16_t *src)
+{
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+static void IDCTGeneric(int16_t *block) {
+	int i;
+	int16_t temp[64];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	}
+}
+
+static void IDCTAddGeneric(byte *dest, uint32_t pitch, int16_t *block) {
+	int i, j;
+
+	IDCTGeneric(block);
+	for (i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (j = 0; j < 8; j++)
+			 dest[j] += block[j];
+}
+
+static void IDCTPutGeneric(byte *dest, uint32_t pitch, const int16_t *block) {
+	int i;
+	int16_t temp[64];
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+#if defined(XOREOS_BINK_AVX2)
+
+/* The AVX2 version does the same calculations on all 8 columns (and then
+ * all 8 rows) at once, in 32-bit lanes. Where the generic version stores
+ * into 16-bit or 8-bit values, we truncate the same way, so the results
+ * are identical. */
+
+/** The IDCT_TRANSFORM on 8 lanes of 32-bit values. */
+XOREOS_BINK_AVX2_TARGET
+static inline void transformAVX2(__m256i *d, const __m256i *s) {
+	const __m256i kA1 = _mm256_set1_epi32(A1);
+	const __m256i kA2 = _mm256_set1_epi32(A2);
+	const __m256i kA3 = _mm256_set1_epi32(A3);
+	const __m256i kA4 = _mm256_set1_epi32(A4);
+
+	const __m256i a0 = _mm256_add_epi32(s[0], s[4]);
+	const __m256i a1 = _mm256_sub_epi32(s[0], s[4]);
+	const __m256i a2 = _mm256_add_epi32(s[2], s[6]);
+	const __m256i a3 = _mm256_srai_epi32(_mm256_mullo_epi32(kA1, _mm256_sub_epi32(s[2], s[6])), 11);
+	const __m256i a4 = _mm256_add_epi32(s[5], s[3]);
+	const __m256i a5 = _mm256_sub_epi32(s[5], s[3]);
+	const __m256i a6 = _mm256_add_epi32(s[1], s[7]);
+	const __m256i a7 = _mm256_sub_epi32(s[1], s[7]);
+	const __m256i b0 = _mm256_add_epi32(a4, a6);
+	const __m256i b1 = _mm256_srai_epi32(_mm256_mullo_epi32(kA3, _mm256_add_epi32(a5, a7)), 11);
+	const __m256i b2 = _mm256_add_epi32(_mm256_sub_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(kA4, a5), 11), b0), b1);
+	const __m256i b3 = _mm256_sub_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(kA1, _mm256_sub_epi32(a6, a4)), 11), b2);
+	const __m256i b4 = _mm256_sub_epi32(_mm256_add_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(kA2, a7), 11), b3), b1);
+
+	const __m256i c0 = _mm256_add_epi32(a0, a2);
+	const __m256i c1 = _mm256_sub_epi32(_mm256_add_epi32(a1, a3), a2);
+	const __m256i c2 = _mm256_add_epi32(_mm256_sub_epi32(a1, a3), a2);
+	const __m256i c3 = _mm256_sub_epi32(a0, a2);
+
+	d[0] = _mm256_add_epi32(c0, b0);
+	d[1] = _mm256_add_epi32(c1, b2);
+	d[2] = _mm256_add_epi32(c2, b3);
+	d[3] = _mm256_sub_epi32(c3, b4);
+	d[4] = _mm256_add_epi32(c3, b4);
+	d[5] = _mm256_sub_epi32(c2, b3);
+	d[6] = _mm256_sub_epi32(c1, b2);
+	d[7] = _mm256_sub_epi32(c0, b0);
+}
+
+/** Transpose an 8x8 matrix of 32-bit values. */
+XOREOS_BINK_AVX2_TARGET
+static inline void transposeAVX2(__m256i *d, const __m256i *s) {
+	const __m256i t0 = _mm256_unpacklo_epi32(s[0], s[1]);
+	const __m256i t1 = _mm256_unpackhi_epi32(s[0], s[1]);
+	const __m256i t2 = _mm256_unpacklo_epi32(s[2], s[3]);
+	const __m256i t3 = _mm256_unpackhi_epi32(s[2], s[3]);
+	const __m256i t4 = _mm256_unpacklo_epi32(s[4], s[5]);
+	const __m256i t5 = _mm256_unpackhi_epi32(s[4], s[5]);
+	const __m256i t6 = _mm256_unpacklo_epi32(s[6], s[7]);
+	const __m256i t7 = _mm256_unpackhi_epi32(s[6], s[7]);
+
+	const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+	const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+	const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+	const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+	const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+	const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+	const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+	const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+	d[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+	d[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+	d[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+	d[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+	d[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+	d[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+	d[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+	d[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/** Sign-extend the lower 16 bits of each lane, like storing into an int16_t. */
+XOREOS_BINK_AVX2_TARGET
+static inline __m256i truncate16AVX2(__m256i x) {
+	return _mm256_srai_epi32(_mm256_slli_epi32(x, 16), 16);
+}
+
+/** Pack 8 lanes of values within the int16_t range into 8 int16_t. */
+XOREOS_BINK_AVX2_TARGET
+static inline __m128i pack16AVX2(__m256i x) {
+	return _mm_packs_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+}
+
+/** Pack the lower 8 bits of each lane into 8 bytes, like storing into a byte. */
+XOREOS_BINK_AVX2_TARGET
+static inline __m128i pack8AVX2(__m256i x) {
+	const __m128i x16 = pack16AVX2(_mm256_and_si256(x, _mm256_set1_epi32(0xFF)));
+
+	return _mm_packus_epi16(x16, x16);
+}
+
+/** Run the IDCT on a block, returning the rows of the result, before truncation. */
+XOREOS_BINK_AVX2_TARGET
+static inline void IDCTRowsAVX2(__m256i *rows, const int16_t *block) {
+	__m256i s[8], d[8];
+
+	// Columns: each lane is one column, the vectors are the rows of the block
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 8 * i)));
+
+	transformAVX2(d, s);
+
+	for (int i = 0; i < 8; i++)
+		d[i] = truncate16AVX2(d[i]);
+
+	// Rows: each lane is one row, the vectors are the columns of the block
+	transposeAVX2(s, d);
+	transformAVX2(d, s);
+
+	const __m256i round = _mm256_set1_epi32(0x7F);
+	for (int i = 0; i < 8; i++)
+		d[i] = _mm256_srai_epi32(_mm256_add_epi32(d[i], round), 8);
+
+	transposeAVX2(rows, d);
+}
+
+XOREOS_BINK_AVX2_TARGET
+static void IDCTAVX2(int16_t *block) {
+	__m256i rows[8];
+	IDCTRowsAVX2(rows, block);
+
+	for (int i = 0; i < 8; i++)
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(block + 8 * i), pack16AVX2(truncate16AVX2(rows[i])));
+}
+
+XOREOS_BINK_AVX2_TARGET
+static void IDCTAddAVX2(byte *dest, uint32_t pitch, int16_t *block) {
+	__m256i rows[8];
+	IDCTRowsAVX2(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(block + 8 * i), pack16AVX2(truncate16AVX2(rows[i])));
+
+		const __m128i pixels = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(dest));
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(dest), _mm_add_epi8(pixels, pack8AVX2(rows[i])));
+	}
+}
+
+XOREOS_BINK_AVX2_TARGET
+static void IDCTPutAVX2(byte *dest, uint32_t pitch, const int16_t *block) {
+	__m256i rows[8];
+	IDCTRowsAVX2(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(dest), pack8AVX2(rows[i]));
+}
+
+#endif // XOREOS_BINK_AVX2
+
+bool hasBinkIDCTSIMD() {
+#if defined(XOREOS_BINK_AVX2)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+static bool &useSIMD() {
+	static bool simd = hasBinkIDCTSIMD();
+
+	return simd;
+}
+
+bool setBinkIDCTSIMD(bool enable) {
+	if (enable && !hasBinkIDCTSIMD())
+		return false;
+
+	useSIMD() = enable;
+	return true;
+}
+
+void binkIDCT(int16_t *block) {
+#if defined(XOREOS_BINK_AVX2)
+	if (useSIMD()) {
+		IDCTAVX2(block);
+		return;
+	}
+#endif
+
+	IDCTGeneric(block);
+}
+
+void binkIDCTPut(byte *dest, uint32_t pitch, const int16_t *block) {
+#if defined(XOREOS_BINK_AVX2)
+	if (useSIMD()) {
+		IDCTPutAVX2(dest, pitch, block);
+		return;
+	}
+#endif
+
+	IDCTPutGeneric(dest, pitch, block);
+}
+
+void binkIDCTAdd(byte *dest, uint32_t pitch, int16_t *block) {
+#if defined(XOREOS_BINK_AVX2)
+	if (useSIMD()) {
+		IDCTAddAVX2(dest, pitch, block);
+		return;
+	}
+#endif
+
+	IDCTAddGeneric(dest, pitch, block);
+}
+
+} // End of namespace Video
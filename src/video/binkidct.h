@@ -0,0 +1,56 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The inverse DCT used by Bink video.
+ */
+
+#ifndef VIDEO_BINKIDCT_H
+#define VIDEO_BINKIDCT_H
+
+#include "src/common/types.h"
+
+namespace Video {
+
+/** Inverse DCT of an 8x8 block of Bink video coefficients, in place. */
+void binkIDCT(int16_t *block);
+
+/** Inverse DCT of an 8x8 block, writing the result into 8x8 pixels of a plane. */
+void binkIDCTPut(byte *dest, uint32_t pitch, const int16_t *block);
+
+/** Inverse DCT of an 8x8 block in place, adding the result onto 8x8 pixels of a plane. */
+void binkIDCTAdd(byte *dest, uint32_t pitch, int16_t *block);
+
+/** Does this CPU support the SIMD versions of the Bink IDCT? */
+bool hasBinkIDCTSIMD();
+
+/**
+ * Enable or disable the SIMD versions of the Bink IDCT.
+ *
+ * They are enabled by default, if supported, and produce exactly the
+ * same output as the generic versions.
+ *
+ * @return false if enabling failed because the CPU doesn't support them.
+ */
+bool setBinkIDCTSIMD(bool enable);
+
+} // End of namespace Video
+
+#endif // VIDEO_BINKIDCT_H
@@ -23,6 +23,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
@@ -36,6 +37,7 @@
 #include "src/graphics/images/surface.h"
 
 #include "src/video/decoder.h"
+#include "src/video/framequeue.h"
 
 #include "src/sound/sound.h"
 #include "src/sound/audiostream.h"
@@ -52,6 +54,9 @@ VideoDecoder::VideoDecoder() : Renderable(Graphics::kRenderableTypeVideo),
 }
 
 VideoDecoder::~VideoDecoder() {
+	// The subclass is already gone, so it had to stop the decoding thread itself
+	assert(!_decodeThread);
+
 	deinit();
 
 	if (_texture != 0)
@@ -79,8 +84,12 @@ void VideoDecoder::initVideo() {
 	_textureHeight = ((float) height) / ((float) realHeight);
 
 	_surface = std::make_unique<Graphics::Surface>(realWidth, realHeight);
+	_frame   = std::make_unique<Graphics::Surface>(realWidth, realHeight);
 
 	_surface->fill(0, 0, 0, 0);
+	_frame->fill(0, 0, 0, 0);
+
+	_frameQueue = std::make_unique<FrameQueue>(kFrameQueueSize, realWidth, realHeight);
 
 	rebuild();
 }
@@ -239,7 +248,7 @@ bool VideoDecoder::hasAudio() const {
 }
 
 void VideoDecoder::doRebuild() {
-	if (!_surface)
+	if (!_frame)
 		return;
 
 	// Generate the texture ID
@@ -255,8 +264,8 @@ void VideoDecoder::doRebuild() {
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, _surface->getWidth(), _surface->getHeight(),
-	             0, GL_BGRA, GL_UNSIGNED_BYTE, _surface->getData());
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, _frame->getWidth(), _frame->getHeight(),
+	             0, GL_BGRA, GL_UNSIGNED_BYTE, _frame->getData());
 }
 
 void VideoDecoder::doDestroy() {
@@ -269,19 +278,14 @@ void VideoDecoder::doDestroy() {
 }
 
 void VideoDecoder::copyData() {
-	if (!_needCopy)
-		return;
-
-	if (!_surface)
+	if (!_frame)
 		throw Common::Exception("No video data while trying to copy");
 	if (_texture == 0)
 		throw Common::Exception("No texture while trying to copy");
 
 	glBindTexture(GL_TEXTURE_2D, _texture);
-	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _surface->getWidth(), _surface->getHeight(),
-	                GL_BGRA, GL_UNSIGNED_BYTE, _surface->getData());
-
-	_needCopy = false;
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _frame->getWidth(), _frame->getHeight(),
+	                GL_BGRA, GL_UNSIGNED_BYTE, _frame->getData());
 }
 
 void VideoDecoder::setScale(Scale scale) {
@@ -292,24 +296,49 @@ bool VideoDecoder::isPlaying() const {
 	if (_startTime == 0)
 		return false;
 
+	/* The video tracks belong to the decoding thread, so we only ask the
+	 * frame queue whether there are still frames to show. */
+	if (_frameQueue && !_frameQueue->isFinished())
+		return true;
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
-		if (!(*it)->endOfTrack())
+		if ((*it)->getTrackType() == Track::kTrackTypeAudio && !(*it)->endOfTrack())
 			return true;
 
 	return false;
 }
 
 void VideoDecoder::update() {
-	if (!needsUpdate() || !_nextVideoTrack)
+	if (!_frameQueue || !_frameQueue->popFrame(getTime(), _frame))
 		return;
 
 	debugC(Common::kDebugVideo, 9, "New video frame");
 
+	// Copy the data to the screen
+	copyData();
+}
+
+bool VideoDecoder::decodeAhead() {
+	if (!_nextVideoTrack || endOfVideoTracks())
+		return false;
+
+	// Wait for room in the queue
+	Graphics::Surface *frame = _frameQueue->getFreeFrame();
+	if (!frame)
+		return false;
+
+	const uint32_t frameTime = _nextVideoTrack->getNextFrameStartTime().msecs();
+
 	// Actually decode the frame for the track
 	decodeNextTrackFrame(*_nextVideoTrack);
 
-	// Copy the data to the screen
-	copyData();
+	// Queue it up for the render thread
+	if (_needCopy) {
+		std::memcpy(frame->getData(), _surface->getData(), _surface->getPitch() * _surface->getHeight());
+		_frameQueue->pushFrame(frameTime);
+
+		_needCopy = false;
+	}
 
 	// Look for the next video track here for the next decode.
 	findNextVideoTrack();
@@ -325,6 +354,27 @@ void VideoDecoder::update() {
 	for (TrackList::iterator it = _internalTracks.begin(); it != _internalTracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio && std::static_pointer_cast<AudioTrack>(*it)->canBufferData())
 			checkAudioBuffer(static_cast<AudioTrack&>(**it), audioNeeded);
+
+	return true;
+}
+
+void VideoDecoder::startDecoding() {
+	if (!_frameQueue || _decodeThread)
+		return;
+
+	_decodeThread = std::make_unique<DecodeThread>(*this);
+	if (!_decodeThread->createThread("VideoDecoder"))
+		throw Common::Exception("Failed to create the video decoding thread");
+}
+
+void VideoDecoder::stopDecoding() {
+	if (_frameQueue)
+		_frameQueue->abort();
+
+	if (_decodeThread)
+		_decodeThread->destroyThread();
+
+	_decodeThread.reset();
 }
 
 void VideoDecoder::getQuadDimensions(float &width, float &height) const {
@@ -393,6 +443,8 @@ void VideoDecoder::render(Graphics::RenderPass pass) {
 }
 
 void VideoDecoder::start() {
+	startDecoding();
+
 	_startTime = EventMan.getTimestamp();
 
 	startAudio();
@@ -401,6 +453,8 @@ void VideoDecoder::start() {
 }
 
 void VideoDecoder::abort() {
+	stopDecoding();
+
 	hide();
 
 	stopAudio();
@@ -448,6 +502,26 @@ Common::Timestamp VideoDecoder::getDuration() const {
 	return maxDuration;
 }
 
+VideoDecoder::DecodeThread::DecodeThread(VideoDecoder &decoder) : _decoder(decoder) {
+}
+
+VideoDecoder::DecodeThread::~DecodeThread() {
+	destroyThread();
+}
+
+void VideoDecoder::DecodeThread::threadMethod() {
+	try {
+		while (!_killThread.load(std::memory_order_relaxed))
+			if (!_decoder.decodeAhead())
+				break;
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed decoding video frame");
+	}
+
+	// No more frames are coming; let the queue drain
+	_decoder._frameQueue->finish();
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
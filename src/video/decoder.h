@@ -31,6 +31,7 @@
 #include "src/common/types.h"
 #include "src/common/rational.h"
 #include "src/common/timestamp.h"
+#include "src/common/thread.h"
 
 #include "src/graphics/types.h"
 #include "src/graphics/glcontainer.h"
@@ -49,7 +50,18 @@ namespace Sound {
 
 namespace Video {
 
-/** A generic interface for video decoders. */
+class FrameQueue;
+
+/** A generic interface for video decoders.
+ *
+ *  Once started, the video is decoded ahead of time by a separate thread,
+ *  which fills a small queue of frames. The render thread only uploads the
+ *  frame that is due.
+ *
+ *  Since the decoding thread calls into the subclass, the destructor of
+ *  every concrete decoder has to stop it with stopDecoding(), before any
+ *  of the subclass is torn down.
+ */
 class VideoDecoder : public Graphics::GLContainer, public Graphics::Renderable {
 public:
 	enum Scale {
@@ -92,7 +104,7 @@ public:
 	/** Start playing the video. */
 	void start();
 
-	/** Abort the playing of the video. */
+	/** Abort the playing of the video, stopping the decoding thread. */
 	void abort();
 
 	/**
@@ -386,9 +398,9 @@ protected:
 	 */
 	typedef std::vector<ConstTrackPtr> ConstTrackList;
 
-	bool _needCopy; ///< Is new frame content available that needs to by copied?
+	bool _needCopy; ///< Has decodeNextTrackFrame() written a new frame into _surface?
 
-	std::unique_ptr<Graphics::Surface> _surface; ///< The video's surface.
+	std::unique_ptr<Graphics::Surface> _surface; ///< The surface the video is decoded into.
 
 	/**
 	 * Create a surface for video of these dimensions.
@@ -404,6 +416,13 @@ protected:
 
 	void deinit();
 
+	/** Stop the decoding thread.
+	 *
+	 *  Needs to be called first thing in the destructor of every concrete
+	 *  decoder, while the decoding thread can still safely call into it.
+	 */
+	void stopDecoding();
+
 	// GLContainer
 	void doRebuild();
 	void doDestroy();
@@ -464,6 +483,21 @@ protected:
 	ConstTrackList getInternalTracks() const;
 
 private:
+	/** The thread decoding the video ahead of time. */
+	class DecodeThread : public Common::Thread {
+	public:
+		DecodeThread(VideoDecoder &decoder);
+		~DecodeThread();
+
+	private:
+		VideoDecoder &_decoder;
+
+		void threadMethod();
+	};
+
+	/** The number of frames decoded ahead of time. */
+	static const size_t kFrameQueueSize = 4;
+
 	TrackList _tracks; ///< Tracks owned by this VideoDecoder (both internal and external).
 	TrackList _internalTracks; ///< Tracks internal to this VideoDecoder.
 	TrackList _externalTracks; ///< Tracks loaded from externals files.
@@ -474,6 +508,11 @@ private:
 	void startAudio(); ///< Start the designated internal audio track and any external audio tracks.
 	bool hasAudio() const;
 
+	std::unique_ptr<FrameQueue> _frameQueue;   ///< Decoded frames waiting to be shown.
+	std::unique_ptr<Graphics::Surface> _frame; ///< The frame currently shown.
+
+	std::unique_ptr<DecodeThread> _decodeThread;
+
 	Graphics::TextureID _texture;
 
 	float _textureWidth;
@@ -491,10 +530,16 @@ private:
 	/** The time when the track was first paused. */
 	uint32_t _pauseStartTime;
 
+	/** Start the decoding thread. */
+	void startDecoding();
+
+	/** Decode the next frame into the frame queue. Runs in the decoding thread. */
+	bool decodeAhead();
+
 	/** Update the video, if necessary. */
 	void update();
 
-	/** Copy the video image data to the texture. */
+	/** Copy the current frame's image data to the texture. */
 	void copyData();
 
 	/** Get the dimensions of the quad to draw the texture on. */
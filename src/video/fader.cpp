@@ -39,6 +39,10 @@ Fader::Fader(uint32_t width, uint32_t height, int n) {
 	initVideo();
 }
 
+Fader::~Fader() {
+	stopDecoding();
+}
+
 void Fader::decodeNextTrackFrame(VideoTrack &track) {
 	assert(_surface);
 	static_cast<FaderVideoTrack &>(track).drawFrame(*_surface);
@@ -35,6 +35,7 @@ namespace Video {
 class Fader : public VideoDecoder {
 public:
 	Fader(uint32_t width, uint32_t height, int n);
+	~Fader();
 
 protected:
 	void decodeNextTrackFrame(VideoTrack &track);
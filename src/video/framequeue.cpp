@@ -0,0 +1,165 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A bounded queue of decoded video frames.
+ */
+
+#include <cassert>
+
+#include "src/common/error.h"
+
+#include "src/graphics/images/surface.h"
+
+#include "src/video/framequeue.h"
+
+namespace Video {
+
+FrameQueue::FrameQueue(size_t size, int width, int height) : _frames(size),
+	_start(0), _count(0), _dropped(0), _finished(false), _aborted(false) {
+
+	if (size == 0)
+		throw Common::Exception("FrameQueue: Invalid size");
+
+	for (std::vector<Frame>::iterator f = _frames.begin(); f != _frames.end(); ++f) {
+		f->surface = std::make_unique<Graphics::Surface>(width, height);
+		f->surface->fill(0, 0, 0, 0);
+	}
+}
+
+FrameQueue::~FrameQueue() {
+}
+
+size_t FrameQueue::getSize() const {
+	return _frames.size();
+}
+
+size_t FrameQueue::getCount() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _count;
+}
+
+size_t FrameQueue::getDroppedFrames() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _dropped;
+}
+
+bool FrameQueue::isFinished() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return (_finished && (_count == 0)) || _aborted;
+}
+
+Graphics::Surface *FrameQueue::getFreeFrame() {
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	_frameFreed.wait(lock, [this]() { return _aborted || (_count < _frames.size()); });
+	if (_aborted)
+		return 0;
+
+	return _frames[(_start + _count) % _frames.size()].surface.get();
+}
+
+void FrameQueue::pushFrame(uint32_t time) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		assert(_count < _frames.size());
+
+		_frames[(_start + _count) % _frames.size()].time = time;
+		_count++;
+	}
+
+	_frameQueued.notify_one();
+}
+
+void FrameQueue::finish() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_finished = true;
+	}
+
+	_frameQueued.notify_all();
+}
+
+void FrameQueue::abort() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_aborted = true;
+	}
+
+	_frameFreed.notify_all();
+	_frameQueued.notify_all();
+}
+
+void FrameQueue::takeFrame(std::unique_ptr<Graphics::Surface> &surface) {
+	Frame &frame = _frames[_start];
+
+	assert(surface && (surface->getWidth() == frame.surface->getWidth()) &&
+	       (surface->getHeight() == frame.surface->getHeight()));
+
+	frame.surface.swap(surface);
+
+	_start = (_start + 1) % _frames.size();
+	_count--;
+}
+
+bool FrameQueue::popFrame(uint32_t time, std::unique_ptr<Graphics::Surface> &surface) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		if ((_count == 0) || (_frames[_start].time > time))
+			return false;
+
+		// Skip over all frames that are already late, if a newer one is due as well
+		while ((_count > 1) && (_frames[(_start + 1) % _frames.size()].time <= time)) {
+			_start = (_start + 1) % _frames.size();
+			_count--;
+			_dropped++;
+		}
+
+		takeFrame(surface);
+	}
+
+	_frameFreed.notify_one();
+	return true;
+}
+
+bool FrameQueue::waitFrame(std::unique_ptr<Graphics::Surface> &surface, uint32_t &time) {
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		_frameQueued.wait(lock, [this]() { return _aborted || _finished || (_count > 0); });
+		if (_aborted || (_count == 0))
+			return false;
+
+		time = _frames[_start].time;
+		takeFrame(surface);
+	}
+
+	_frameFreed.notify_one();
+	return true;
+}
+
+} // End of namespace Video
@@ -0,0 +1,131 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A bounded queue of decoded video frames.
+ */
+
+#ifndef VIDEO_FRAMEQUEUE_H
+#define VIDEO_FRAMEQUEUE_H
+
+#include <vector>
+#include <memory>
+
+#include "src/common/types.h"
+#include "src/common/mutex.h"
+
+namespace Graphics {
+	class Surface;
+}
+
+namespace Video {
+
+/** A bounded ring of decoded video frames.
+ *
+ *  The queue hands frames from a single producer, the decoding thread, to
+ *  a single consumer, the render thread. All frame surfaces are allocated
+ *  up front; frames change hands by swapping surface ownership, so neither
+ *  side ever allocates or copies while holding the lock.
+ *
+ *  The producer asks for a free frame with getFreeFrame(), fills it outside
+ *  of the lock and then publishes it with pushFrame(). The consumer takes
+ *  the most recent due frame with popFrame() or, when presentation time
+ *  does not matter, waits for the next frame with waitFrame().
+ */
+class FrameQueue {
+public:
+	FrameQueue(size_t size, int width, int height);
+	~FrameQueue();
+
+	FrameQueue(const FrameQueue &) = delete;
+	FrameQueue &operator=(const FrameQueue &) = delete;
+
+	/** Return the number of frames the queue can hold. */
+	size_t getSize() const;
+	/** Return the number of frames currently queued. */
+	size_t getCount() const;
+	/** Return the number of due frames popFrame() skipped over. */
+	size_t getDroppedFrames() const;
+
+	/** Return whether no more frames will be pushed and all queued frames were taken. */
+	bool isFinished() const;
+
+	/** Wait for a free frame and return it.
+	 *
+	 *  The returned surface belongs to the producer until pushFrame() is
+	 *  called. Returns 0 if the queue was aborted while waiting.
+	 */
+	Graphics::Surface *getFreeFrame();
+
+	/** Publish the frame last returned by getFreeFrame(), to be shown at time (in ms). */
+	void pushFrame(uint32_t time);
+
+	/** Mark that the producer won't push any more frames. */
+	void finish();
+
+	/** Wake up and turn away both sides, e.g. when playback is stopped. */
+	void abort();
+
+	/** Take the most recent frame that is due at time (in ms).
+	 *
+	 *  Any older due frames are dropped. On success, the frame's surface is
+	 *  swapped with the one passed in, which has to be of the same size.
+	 *
+	 *  @return true if a frame was due, false otherwise.
+	 */
+	bool popFrame(uint32_t time, std::unique_ptr<Graphics::Surface> &surface);
+
+	/** Wait for the next frame, regardless of its presentation time.
+	 *
+	 *  On success, the frame's surface is swapped with the one passed in and
+	 *  its presentation time is returned in time.
+	 *
+	 *  @return false if the queue finished or was aborted, true otherwise.
+	 */
+	bool waitFrame(std::unique_ptr<Graphics::Surface> &surface, uint32_t &time);
+
+private:
+	struct Frame {
+		std::unique_ptr<Graphics::Surface> surface; ///< The frame's image data.
+		uint32_t time; ///< The frame's presentation time in ms.
+
+		Frame() : time(0) { }
+	};
+
+	std::vector<Frame> _frames; ///< The ring of frames.
+
+	size_t _start; ///< Index of the oldest queued frame.
+	size_t _count; ///< Number of queued frames.
+
+	size_t _dropped; ///< Number of due frames popFrame() skipped over.
+
+	bool _finished; ///< Will no more frames be pushed?
+	bool _aborted;  ///< Has the queue been aborted?
+
+	mutable std::mutex _mutex;
+	std::condition_variable _frameFreed;  ///< Signalled when the consumer frees a frame.
+	std::condition_variable _frameQueued; ///< Signalled when the producer queues a frame.
+
+	void takeFrame(std::unique_ptr<Graphics::Surface> &surface);
+};
+
+} // End of namespace Video
+
+#endif // VIDEO_FRAMEQUEUE_H
@@ -571,6 +571,10 @@ Matroska::Matroska(Common::SeekableReadStream *fd) : _fd(fd) {
 	load();
 }
 
+Matroska::~Matroska() {
+	stopDecoding();
+}
+
 void Matroska::load() {
 	// Read the header in
 	EBMLHeader header;
@@ -46,6 +46,7 @@ class Codec;
 class Matroska : public VideoDecoder {
 public:
 	Matroska(Common::SeekableReadStream *fd);
+	~Matroska();
 
 protected:
 	void decodeNextTrackFrame(VideoTrack &track);
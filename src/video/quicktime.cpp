@@ -105,6 +105,7 @@ QuickTimeDecoder::QuickTimeDecoder(Common::SeekableReadStream *stream) : _fd(str
 }
 
 QuickTimeDecoder::~QuickTimeDecoder() {
+	stopDecoding();
 }
 
 void QuickTimeDecoder::load() {
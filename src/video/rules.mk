@@ -26,7 +26,9 @@ src_video_libvideo_la_SOURCES += \
     src/video/decoder.h \
     src/video/bink.h \
     src/video/binkdata.h \
+    src/video/binkidct.h \
     src/video/fader.h \
+    src/video/framequeue.h \
     src/video/quicktime.h \
     src/video/xmv.h \
     src/video/actimagine.h \
@@ -36,7 +38,9 @@ src_video_libvideo_la_SOURCES += \
 src_video_libvideo_la_SOURCES += \
     src/video/decoder.cpp \
     src/video/bink.cpp \
+    src/video/binkidct.cpp \
     src/video/fader.cpp \
+    src/video/framequeue.cpp \
     src/video/quicktime.cpp \
     src/video/xmv.cpp \
     src/video/actimagine.cpp \
@@ -58,6 +58,7 @@ XboxMediaVideo::XboxMediaVideo(Common::SeekableReadStream *xmv) :
 }
 
 XboxMediaVideo::~XboxMediaVideo() {
+	stopDecoding();
 }
 
 void XboxMediaVideo::queueNewAudio(PacketAudio &audioPacket) {
@@ -0,0 +1,334 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the flattened AABB tree.
+ */
+
+#include <cstdio>
+#include <cfloat>
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/aabbnode.h"
+#include "src/common/aabbtree.h"
+
+/** A leaf box, covering one face of a synthetic walkmesh. */
+struct TestFace {
+	float min[3];
+	float max[3];
+};
+
+/** Create a walkmesh-like grid of slightly overlapping, slightly uneven faces. */
+static std::vector<TestFace> createFaces(size_t width, size_t height, std::mt19937 &random,
+                                         float offsetX = 0.0f, float offsetY = 0.0f) {
+	std::uniform_real_distribution<float> jitter(0.0f, 0.5f);
+
+	std::vector<TestFace> faces;
+	for (size_t y = 0; y < height; y++) {
+		for (size_t x = 0; x < width; x++) {
+			TestFace face;
+
+			face.min[0] = offsetX + x * 2.0f - jitter(random);
+			face.min[1] = offsetY + y * 2.0f - jitter(random);
+			face.min[2] = jitter(random);
+			face.max[0] = offsetX + x * 2.0f + 2.0f + jitter(random);
+			face.max[1] = offsetY + y * 2.0f + 2.0f + jitter(random);
+			face.max[2] = face.min[2] + jitter(random);
+
+			faces.push_back(face);
+		}
+	}
+
+	return faces;
+}
+
+/** Build a pointer-linked AABB tree over these faces, splitting at the median. */
+static Common::AABBNode *buildTree(std::vector<std::pair<TestFace, int32_t>> &faces, size_t start, size_t end) {
+	float min[3] = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
+	float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	for (size_t i = start; i < end; i++) {
+		for (int c = 0; c < 3; c++) {
+			min[c] = MIN(min[c], faces[i].first.min[c]);
+			max[c] = MAX(max[c], faces[i].first.max[c]);
+		}
+	}
+
+	if ((end - start) == 1)
+		return new Common::AABBNode(faces[start].first.min, faces[start].first.max, faces[start].second);
+
+	// Split along the longer axis
+	const int axis = ((max[0] - min[0]) > (max[1] - min[1])) ? 0 : 1;
+
+	const size_t middle = start + (end - start) / 2;
+	std::nth_element(faces.begin() + start, faces.begin() + middle, faces.begin() + end,
+	                 [axis](const std::pair<TestFace, int32_t> &a, const std::pair<TestFace, int32_t> &b) {
+		return a.first.min[axis] < b.first.min[axis];
+	});
+
+	Common::AABBNode *node = new Common::AABBNode(min, max);
+	node->setChildren(buildTree(faces, start, middle), buildTree(faces, middle, end));
+
+	return node;
+}
+
+static Common::AABBNode *buildTree(const std::vector<TestFace> &faces, int32_t firstProperty) {
+	std::vector<std::pair<TestFace, int32_t>> leaves;
+	for (size_t i = 0; i < faces.size(); i++)
+		leaves.push_back(std::make_pair(faces[i], firstProperty + (int32_t) i));
+
+	return buildTree(leaves, 0, leaves.size());
+}
+
+static std::vector<int32_t> findAt(const Common::AABBTree &tree, float x, float y) {
+	std::vector<int32_t> properties;
+	for (size_t n = tree.findAt(x, y); n < tree.size(); n = tree.findAt(x, y, n + 1))
+		properties.push_back(tree.getProperty(n));
+
+	return properties;
+}
+
+static std::vector<int32_t> findOnSegment(const Common::AABBTree &tree,
+                                          float x1, float y1, float z1, float x2, float y2, float z2) {
+	std::vector<int32_t> properties;
+	for (size_t n = tree.findOnSegment(x1, y1, z1, x2, y2, z2); n < tree.size();
+	     n = tree.findOnSegment(x1, y1, z1, x2, y2, z2, n + 1))
+		properties.push_back(tree.getProperty(n));
+
+	return properties;
+}
+
+static std::vector<int32_t> getNodes(const std::vector<Common::AABBNode *> &trees, float x, float y) {
+	std::vector<Common::AABBNode *> nodes;
+	for (auto &t : trees)
+		if (t && t->isIn(x, y))
+			t->getNodes(x, y, nodes);
+
+	std::vector<int32_t> properties;
+	for (auto &n : nodes)
+		properties.push_back(n->getProperty());
+
+	return properties;
+}
+
+static std::vector<int32_t> getNodes(const std::vector<Common::AABBNode *> &trees,
+                                     float x1, float y1, float z1, float x2, float y2, float z2) {
+	std::vector<Common::AABBNode *> nodes;
+	for (auto &t : trees)
+		if (t && t->isIn(x1, y1, z1, x2, y2, z2))
+			t->getNodes(x1, y1, z1, x2, y2, z2, nodes);
+
+	std::vector<int32_t> properties;
+	for (auto &n : nodes)
+		properties.push_back(n->getProperty());
+
+	return properties;
+}
+
+GTEST_TEST(AABBTree, empty) {
+	Common::AABBTree tree;
+	EXPECT_TRUE(tree.empty());
+	EXPECT_EQ(tree.size(), 0);
+	EXPECT_EQ(tree.findAt(0.0f, 0.0f), 0);
+	EXPECT_EQ(tree.findOnSegment(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, -1.0f), 0);
+
+	std::vector<Common::AABBNode *> trees(2, nullptr);
+	tree.build(trees);
+	EXPECT_TRUE(tree.empty());
+}
+
+GTEST_TEST(AABBTree, build) {
+	float min[] = { 0.0f, 0.0f, 0.0f };
+	float max[] = { 2.0f, 1.0f, 1.0f };
+	float minLeft[]  = { 0.0f, 0.0f, 0.0f };
+	float maxLeft[]  = { 1.0f, 1.0f, 1.0f };
+	float minRight[] = { 1.0f, 0.0f, 0.0f };
+	float maxRight[] = { 2.0f, 1.0f, 1.0f };
+
+	Common::AABBNode root(min, max);
+	root.setChildren(new Common::AABBNode(minLeft, maxLeft, 10), new Common::AABBNode(minRight, maxRight, 11));
+
+	Common::AABBTree tree;
+	tree.build({ &root });
+	ASSERT_EQ(tree.size(), 3);
+	EXPECT_EQ(tree.getProperty(0), -1);
+	EXPECT_EQ(tree.getProperty(1), 10);
+	EXPECT_EQ(tree.getProperty(2), 11);
+
+	EXPECT_EQ(findAt(tree, 0.5f, 0.5f), std::vector<int32_t>({ 10 }));
+	EXPECT_EQ(findAt(tree, 1.5f, 0.5f), std::vector<int32_t>({ 11 }));
+	EXPECT_EQ(findAt(tree, 1.0f, 0.5f), std::vector<int32_t>({ 10, 11 }));
+	EXPECT_TRUE(findAt(tree, 3.0f, 0.5f).empty());
+
+	EXPECT_EQ(findOnSegment(tree, 1.5f, 0.5f, 2.0f, 1.5f, 0.5f, -1.0f), std::vector<int32_t>({ 11 }));
+	EXPECT_TRUE(findOnSegment(tree, 3.0f, 0.5f, 2.0f, 3.0f, 0.5f, -1.0f).empty());
+
+	// Building again replaces the nodes
+	tree.build({ &root, &root });
+	EXPECT_EQ(tree.size(), 6);
+	EXPECT_EQ(findAt(tree, 0.5f, 0.5f), std::vector<int32_t>({ 10, 10 }));
+
+	tree.clear();
+	EXPECT_TRUE(tree.empty());
+}
+
+GTEST_TEST(AABBTree, transformed) {
+	float min[] = { 0.0f, 0.0f, 0.0f };
+	float max[] = { 1.0f, 2.0f, 0.0f };
+
+	Common::AABBNode root(min, max, 5);
+	root.rotate(90.0f, 0.0f, 0.0f, 1.0f);
+	root.translate(10.0f, 0.0f, 0.0f);
+
+	Common::AABBTree tree;
+	tree.build({ &root });
+
+	// Same as the transformed node
+	for (float x = -14.0f; x < 14.0f; x += 0.25f)
+		for (float y = -4.0f; y < 4.0f; y += 0.25f)
+			EXPECT_EQ(findAt(tree, x, y).size(), root.isIn(x, y) ? 1 : 0);
+}
+
+GTEST_TEST(AABBTree, sameAsNodes) {
+	std::mt19937 random(1);
+
+	std::vector<Common::AABBNode *> trees;
+	trees.push_back(buildTree(createFaces(16, 16, random), 0));
+	trees.push_back(nullptr);
+	trees.push_back(buildTree(createFaces(8, 20, random), 256));
+
+	Common::AABBTree tree;
+	tree.build(trees);
+
+	std::uniform_real_distribution<float> position(-2.0f, 42.0f);
+	std::uniform_real_distribution<float> height(-1.0f, 2.0f);
+
+	for (int i = 0; i < 500; i++) {
+		const float x = position(random), y = position(random);
+		EXPECT_EQ(findAt(tree, x, y), getNodes(trees, x, y));
+
+		// Vertical, like when looking for the height of the walkmesh
+		EXPECT_EQ(findOnSegment(tree, x, y, 100.0f, x, y, -100.0f), getNodes(trees, x, y, 100.0f, x, y, -100.0f));
+
+		const float x2 = position(random), y2 = position(random), z1 = height(random), z2 = height(random);
+		EXPECT_EQ(findOnSegment(tree, x, y, z1, x2, y2, z2), getNodes(trees, x, y, z1, x2, y2, z2));
+	}
+
+	for (auto &t : trees)
+		delete t;
+}
+
+/* Point and vertical segment queries, as done by Engines::Pathfinding::findFace()
+ * and getHeight(), on a synthetic walkmesh made of several rooms. Compares the
+ * pointer-linked trees with the flattened tree.
+ *
+ * Run with --gtest_also_run_disabled_tests. */
+GTEST_TEST(AABBTree, DISABLED_benchmark) {
+	static const int kQueries = 1000000;
+
+	std::mt19937 random(1);
+
+	// 4x4 rooms, 80x80 units each
+	std::vector<Common::AABBNode *> trees;
+	for (int room = 0; room < 16; room++)
+		trees.push_back(buildTree(createFaces(40, 40, random, (room % 4) * 80.0f, (room / 4) * 80.0f), room * 1600));
+
+	Common::AABBTree tree;
+	tree.build(trees);
+
+	std::uniform_real_distribution<float> position(0.0f, 320.0f);
+
+	std::vector<float> x(kQueries), y(kQueries);
+	for (int i = 0; i < kQueries; i++) {
+		x[i] = position(random);
+		y[i] = position(random);
+	}
+
+	size_t foundNodes = 0, foundTree = 0;
+
+	// Points
+
+	const auto startPointNodes = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < kQueries; i++) {
+		for (auto &t : trees) {
+			if (!t->isIn(x[i], y[i]))
+				continue;
+
+			std::vector<Common::AABBNode *> nodes;
+			t->getNodes(x[i], y[i], nodes);
+			foundNodes += nodes.size();
+		}
+	}
+
+	const auto startPointTree = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < kQueries; i++)
+		for (size_t n = tree.findAt(x[i], y[i]); n < tree.size(); n = tree.findAt(x[i], y[i], n + 1))
+			foundTree++;
+
+	const auto startSegmentNodes = std::chrono::steady_clock::now();
+
+	EXPECT_EQ(foundTree, foundNodes);
+
+	// Vertical segments
+
+	for (int i = 0; i < kQueries; i++) {
+		for (auto &t : trees) {
+			if (!t->isIn(x[i], y[i], 100.0f, x[i], y[i], -100.0f))
+				continue;
+
+			std::vector<Common::AABBNode *> nodes;
+			t->getNodes(x[i], y[i], 100.0f, x[i], y[i], -100.0f, nodes);
+			foundNodes += nodes.size();
+		}
+	}
+
+	const auto startSegmentTree = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < kQueries; i++)
+		for (size_t n = tree.findOnSegment(x[i], y[i], 100.0f, x[i], y[i], -100.0f); n < tree.size();
+		     n = tree.findOnSegment(x[i], y[i], 100.0f, x[i], y[i], -100.0f, n + 1))
+			foundTree++;
+
+	const auto end = std::chrono::steady_clock::now();
+
+	EXPECT_EQ(foundTree, foundNodes);
+
+	typedef std::chrono::duration<double, std::nano> Nanoseconds;
+
+	std::printf("%u nodes\n", (unsigned int) tree.size());
+	std::printf("Point:   nodes %6.1f ns, flattened %6.1f ns per query\n",
+	            Nanoseconds(startPointTree - startPointNodes).count() / kQueries,
+	            Nanoseconds(startSegmentNodes - startPointTree).count() / kQueries);
+	std::printf("Segment: nodes %6.1f ns, flattened %6.1f ns per query\n",
+	            Nanoseconds(startSegmentTree - startSegmentNodes).count() / kQueries,
+	            Nanoseconds(end - startSegmentTree).count() / kQueries);
+
+	for (auto &t : trees)
+		delete t;
+}
@@ -192,3 +192,39 @@ GTEST_TEST(BitStream, BitStream64BELSB) {
 
 	testBitStream(bitStream, compValues);
 }
+
+template<class T>
+static void testGetBitsChunked() {
+	static const byte data[16] = {
+		0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF,
+		0xFE, 0xDC, 0xBA, 0x09, 0x87, 0x65, 0x43, 0x21
+	};
+
+	static const size_t kCounts[] = { 3, 7, 13, 1, 32, 5, 17, 9, 21 };
+
+	Common::MemoryReadStream streamBits(data), streamBit(data);
+	T bitsChunked(streamBits), bitsSingle(streamBit);
+
+	for (size_t i = 0; i < ARRAYSIZE(kCounts); i++) {
+		const size_t n = kCounts[i];
+
+		// Assemble the expected value bit by bit, the way addBit() does it
+		uint32_t expected = 0;
+		for (size_t j = 0; j < n; j++)
+			bitsSingle.addBit(expected, j);
+
+		EXPECT_EQ(bitsChunked.getBits(n), expected) << "At index " << i;
+		EXPECT_EQ(bitsChunked.pos(), bitsSingle.pos()) << "At index " << i;
+	}
+}
+
+GTEST_TEST(BitStream, getBitsChunked) {
+	testGetBitsChunked<Common::BitStream8MSB>();
+	testGetBitsChunked<Common::BitStream8LSB>();
+	testGetBitsChunked<Common::BitStream16LEMSB>();
+	testGetBitsChunked<Common::BitStream16BELSB>();
+	testGetBitsChunked<Common::BitStream32LELSB>();
+	testGetBitsChunked<Common::BitStream32BEMSB>();
+	testGetBitsChunked<Common::BitStream64LEMSB>();
+	testGetBitsChunked<Common::BitStream64BELSB>();
+}
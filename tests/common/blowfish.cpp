@@ -22,7 +22,12 @@
  *  Unit tests for our Blowfish implementation.
  */
 
+#include <cstdio>
+#include <cstring>
+
 #include <vector>
+#include <memory>
+#include <chrono>
 
 #include "gtest/gtest.h"
 
@@ -81,3 +86,182 @@ GTEST_TEST(Blowfish, misalign) {
 
 	EXPECT_THROW(Common::decryptBlowfishEBC(cipherText, key), Common::Exception);
 }
+
+static std::vector<byte> randomData(size_t size) {
+	std::vector<byte> data(size);
+
+	// A simple, deterministic LCG, so that all runs work on the same data
+	uint32_t state = 0x12345678;
+	for (size_t i = 0; i < size; i++) {
+		state = state * 1664525 + 1013904223;
+		data[i] = state >> 24;
+	}
+
+	return data;
+}
+
+/** Encrypt random data big enough to be decrypted by several threads. */
+static std::vector<byte> createCipherText(const std::vector<byte> &key, size_t size) {
+	const std::vector<byte> clearText = randomData(size);
+
+	Common::MemoryReadStream clearStream(clearText.data(), clearText.size());
+	std::unique_ptr<Common::MemoryReadStream> cipherStream(Common::encryptBlowfishEBC(clearStream, key));
+
+	return std::vector<byte>(cipherStream->getData(), cipherStream->getData() + cipherStream->size());
+}
+
+GTEST_TEST(Blowfish, roundTripBig) {
+	std::vector<byte> key;
+	createKey(key);
+
+	const std::vector<byte> clearText  = randomData(1024 * 1024 + 24);
+	const std::vector<byte> cipherText = createCipherText(key, clearText.size());
+
+	Common::MemoryReadStream cipherStream(cipherText.data(), cipherText.size());
+	std::unique_ptr<Common::MemoryReadStream> decrypted(Common::decryptBlowfishEBC(cipherStream, key));
+
+	ASSERT_EQ(decrypted->size(), clearText.size());
+	for (size_t i = 0; i < clearText.size(); i++)
+		ASSERT_EQ(decrypted->getData()[i], clearText[i]) << "At index " << i;
+}
+
+GTEST_TEST(Blowfish, decryptStream) {
+	Common::MemoryReadStream cipherText(kCypherText);
+
+	std::vector<byte> key;
+	createKey(key);
+
+	Common::BlowfishEBCDecryptStream clearText(&cipherText, key);
+	ASSERT_EQ(clearText.size(), ARRAYSIZE(kCypherText));
+
+	for (size_t i = 0; i < ARRAYSIZE(kClearText); i++)
+		EXPECT_EQ(clearText.readByte(), kClearText[i]) << "At index " << i;
+}
+
+GTEST_TEST(Blowfish, decryptStreamMisalign) {
+	// The last, partial block is decrypted as if it was padded with zeros
+	static const size_t kSize = 13;
+
+	byte padded[ARRAYSIZE(kCypherText)] = { 0 };
+	std::memcpy(padded, kCypherText, kSize);
+
+	std::vector<byte> key;
+	createKey(key);
+
+	Common::MemoryReadStream paddedText(padded);
+	std::unique_ptr<Common::MemoryReadStream> expected(Common::decryptBlowfishEBC(paddedText, key));
+
+	Common::MemoryReadStream cipherText(kCypherText, kSize);
+	Common::BlowfishEBCDecryptStream clearText(&cipherText, key);
+	ASSERT_EQ(clearText.size(), kSize);
+
+	for (size_t i = 0; i < 8; i++)
+		EXPECT_EQ(expected->getData()[i], kClearText[i]) << "At index " << i;
+
+	byte data[ARRAYSIZE(kCypherText)];
+	ASSERT_EQ(clearText.read(data, sizeof(data)), kSize);
+	EXPECT_TRUE(clearText.eos());
+
+	for (size_t i = 0; i < kSize; i++)
+		EXPECT_EQ(data[i], expected->getData()[i]) << "At index " << i;
+
+	// And the same one byte at a time, through the cached block
+	clearText.seek(6);
+	for (size_t i = 6; i < kSize; i++)
+		EXPECT_EQ(clearText.readByte(), expected->getData()[i]) << "At index " << i;
+}
+
+GTEST_TEST(Blowfish, decryptStreamRanges) {
+	std::vector<byte> key;
+	createKey(key);
+
+	const std::vector<byte> clearText  = randomData(300 * 1024);
+	const std::vector<byte> cipherText = createCipherText(key, clearText.size());
+
+	Common::BlowfishEBCDecryptStream stream(new Common::MemoryReadStream(cipherText.data(), cipherText.size()),
+	                                        key, true);
+	ASSERT_EQ(stream.size(), clearText.size());
+
+	// Unaligned reads of all sizes, crossing block boundaries, in and out of order
+	static const size_t kRanges[][2] = {
+		{      0,      1 }, {      1,      7 }, {      3,     13 }, {     8,       8 },
+		{     16,    256 }, {   1001,   4093 }, {    500,      3 }, { 7,      200000 },
+		{ 307190,     10 }, { 307199,      1 }, { 123457, 120001 }, { 0,   307200 }
+	};
+
+	std::vector<byte> data;
+	for (size_t i = 0; i < ARRAYSIZE(kRanges); i++) {
+		const size_t offset = kRanges[i][0];
+		const size_t size   = kRanges[i][1];
+
+		data.resize(size);
+
+		stream.seek(offset);
+		ASSERT_EQ(stream.read(data.data(), size), size) << "Range " << i;
+
+		for (size_t j = 0; j < size; j++)
+			ASSERT_EQ(data[j], clearText[offset + j]) << "Range " << i << ", at index " << j;
+	}
+
+	// Reading past the end
+
+	data.resize(16);
+
+	stream.seek(-4, Common::SeekableReadStream::kOriginEnd);
+	EXPECT_EQ(stream.read(data.data(), 16), 4U);
+	EXPECT_TRUE(stream.eos());
+
+	for (size_t j = 0; j < 4; j++)
+		EXPECT_EQ(data[j], clearText[clearText.size() - 4 + j]) << "At index " << j;
+}
+
+/* Throughput of the whole-stream decryption, and of reading through a
+ * decrypting stream in whole and in small pieces. Run with
+ * --gtest_also_run_disabled_tests.
+ */
+GTEST_TEST(Blowfish, DISABLED_benchmarkDecrypt) {
+	typedef std::chrono::steady_clock Clock;
+
+	std::vector<byte> key;
+	createKey(key);
+
+	const std::vector<byte> cipherText = createCipherText(key, 64 * 1024 * 1024);
+	const double megabytes = cipherText.size() / (1024.0 * 1024.0);
+
+	{
+		Common::MemoryReadStream cipherStream(cipherText.data(), cipherText.size());
+
+		const Clock::time_point start = Clock::now();
+		std::unique_ptr<Common::MemoryReadStream> clearText(Common::decryptBlowfishEBC(cipherStream, key));
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		std::printf("decryptBlowfishEBC():          %8.2f MB/s\n", megabytes / seconds);
+	}
+
+	{
+		Common::MemoryReadStream cipherStream(cipherText.data(), cipherText.size());
+		Common::BlowfishEBCDecryptStream clearStream(&cipherStream, key);
+
+		std::vector<byte> clearText(cipherText.size());
+
+		const Clock::time_point start = Clock::now();
+		clearStream.read(clearText.data(), clearText.size());
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		std::printf("BlowfishEBCDecryptStream, all: %8.2f MB/s\n", megabytes / seconds);
+	}
+
+	{
+		Common::MemoryReadStream cipherStream(cipherText.data(), cipherText.size());
+		Common::BlowfishEBCDecryptStream clearStream(&cipherStream, key);
+
+		byte buffer[13];
+
+		const Clock::time_point start = Clock::now();
+		while (clearStream.read(buffer, sizeof(buffer)) == sizeof(buffer))
+			;
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		std::printf("BlowfishEBCDecryptStream, 13B: %8.2f MB/s\n", megabytes / seconds);
+	}
+}
@@ -0,0 +1,215 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our FFT class and the transforms built on top of it.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <chrono>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/maths.h"
+#include "src/common/fft.h"
+#include "src/common/rdft.h"
+#include "src/common/mdct.h"
+#include "src/common/dct.h"
+
+static float randomFloat(uint32_t &seed) {
+	seed = seed * 1664525 + 1013904223;
+	return ((seed >> 8) / 8388608.0f) - 1.0f;
+}
+
+static std::vector<float> randomData(size_t n, uint32_t seed) {
+	std::vector<float> data(n);
+	for (size_t i = 0; i < n; i++)
+		data[i] = randomFloat(seed);
+
+	return data;
+}
+
+/** Compare the results of the SIMD and the generic FFT, relative to the data's magnitude. */
+static void compare(const std::vector<float> &simd, const std::vector<float> &generic, const char *name, int bits) {
+	ASSERT_EQ(simd.size(), generic.size());
+
+	float magnitude = 1.0f;
+	for (size_t i = 0; i < generic.size(); i++)
+		magnitude = MAX(magnitude, std::fabs(generic[i]));
+
+	for (size_t i = 0; i < generic.size(); i++)
+		ASSERT_NEAR(simd[i], generic[i], magnitude * 1e-6f) << name << ", bits " << bits << ", index " << i;
+}
+
+/** Run a transform on the data, with the generic and the SIMD FFT. */
+template<typename F>
+static void compareTransform(const char *name, int bits, const std::vector<float> &input, F transform) {
+	if (!Common::FFT::hasSIMD())
+		return;
+
+	std::vector<float> generic = input, simd = input;
+
+	EXPECT_TRUE(Common::FFT::setSIMD(false));
+	transform(generic);
+	EXPECT_TRUE(Common::FFT::setSIMD(true));
+	transform(simd);
+
+	compare(simd, generic, name, bits);
+}
+
+GTEST_TEST(FFT, dft) {
+	// Check the generic FFT itself against a plain DFT
+	EXPECT_TRUE(Common::FFT::setSIMD(false));
+
+	for (int bits = 2; bits <= 8; bits++) {
+		const int n = 1 << bits;
+
+		const std::vector<float> input = randomData(2 * n, bits);
+
+		std::vector<float> data = input;
+		Common::Complex *z = reinterpret_cast<Common::Complex *>(data.data());
+
+		Common::FFT fft(bits, false);
+		fft.permute(z);
+		fft.calc(z);
+
+		for (int k = 0; k < n; k++) {
+			double re = 0.0, im = 0.0;
+			for (int j = 0; j < n; j++) {
+				const double angle = -2.0 * M_PI * j * k / n;
+
+				re += input[2 * j] * cos(angle) - input[2 * j + 1] * sin(angle);
+				im += input[2 * j] * sin(angle) + input[2 * j + 1] * cos(angle);
+			}
+
+			EXPECT_NEAR(z[k].re, re, 1e-4 * n) << "bits " << bits << ", index " << k;
+			EXPECT_NEAR(z[k].im, im, 1e-4 * n) << "bits " << bits << ", index " << k;
+		}
+	}
+
+	Common::FFT::setSIMD(true);
+}
+
+GTEST_TEST(FFT, simd) {
+	for (int bits = 2; bits <= 16; bits++) {
+		for (int inverse = 0; inverse < 2; inverse++) {
+			Common::FFT fft(bits, inverse != 0);
+
+			compareTransform("FFT", bits, randomData(2 << bits, bits), [&fft](std::vector<float> &data) {
+				Common::Complex *z = reinterpret_cast<Common::Complex *>(data.data());
+
+				fft.permute(z);
+				fft.calc(z);
+			});
+		}
+	}
+}
+
+GTEST_TEST(RDFT, simd) {
+	static const Common::RDFT::TransformType kTypes[] = {
+		Common::RDFT::DFT_R2C, Common::RDFT::IDFT_C2R, Common::RDFT::IDFT_R2C, Common::RDFT::DFT_C2R
+	};
+
+	for (int bits = 4; bits <= 13; bits++) {
+		for (size_t t = 0; t < ARRAYSIZE(kTypes); t++) {
+			Common::RDFT rdft(bits, kTypes[t]);
+
+			compareTransform("RDFT", bits, randomData(1 << bits, bits), [&rdft](std::vector<float> &data) {
+				rdft.calc(data.data());
+			});
+		}
+	}
+}
+
+GTEST_TEST(MDCT, simd) {
+	for (int bits = 6; bits <= 13; bits++) {
+		Common::MDCT imdct(bits, true, 1.0);
+		Common::MDCT mdct(bits, false, 1.0);
+
+		const int n = 1 << bits;
+
+		compareTransform("IMDCT", bits, randomData(n, bits), [&imdct, n](std::vector<float> &data) {
+			std::vector<float> output(n);
+			imdct.calcIMDCT(output.data(), data.data());
+			data.swap(output);
+		});
+
+		compareTransform("MDCT", bits, randomData(n, bits), [&mdct, n](std::vector<float> &data) {
+			std::vector<float> output(n / 2);
+			mdct.calcMDCT(output.data(), data.data());
+			data.swap(output);
+		});
+	}
+}
+
+GTEST_TEST(DCT, simd) {
+	static const Common::DCT::TransformType kTypes[] = {
+		Common::DCT::DCT_II, Common::DCT::DCT_III, Common::DCT::DCT_I, Common::DCT::DST_I
+	};
+
+	for (int bits = 4; bits <= 12; bits++) {
+		for (size_t t = 0; t < ARRAYSIZE(kTypes); t++) {
+			Common::DCT dct(bits, kTypes[t]);
+
+			// DCT-I needs one more input value
+			compareTransform("DCT", bits, randomData((1 << bits) + 1, bits), [&dct](std::vector<float> &data) {
+				dct.calc(data.data());
+			});
+		}
+	}
+}
+
+/* Throughput of the inverse MDCT, as used by WMA, AAC and Vorbis, for the
+ * block sizes the decoders use, with the generic and the SIMD FFT.
+ *
+ * Run with --gtest_also_run_disabled_tests.
+ */
+GTEST_TEST(MDCT, DISABLED_benchmark) {
+	typedef std::chrono::steady_clock Clock;
+
+	for (int bits = 6; bits <= 12; bits++) {
+		const int n = 1 << bits;
+		const int iterations = (1 << 22) / n;
+
+		Common::MDCT imdct(bits, true, 1.0);
+
+		const std::vector<float> input = randomData(n, bits);
+		std::vector<float> output(n);
+
+		double time[2] = { 0.0, 0.0 };
+		for (int simd = 0; simd < 2; simd++) {
+			if (!Common::FFT::setSIMD(simd != 0))
+				continue;
+
+			const Clock::time_point start = Clock::now();
+			for (int i = 0; i < iterations; i++)
+				imdct.calcIMDCT(output.data(), input.data());
+
+			time[simd] = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+		}
+
+		std::printf("IMDCT %5d: generic %8.3f us, SIMD %8.3f us\n", n, time[0], time[1]);
+	}
+
+	Common::FFT::setSIMD(true);
+}
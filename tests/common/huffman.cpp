@@ -22,6 +22,9 @@
  *  Unit tests for our Huffman decoder.
  */
 
+#include <memory>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "src/common/huffman.h"
@@ -120,3 +123,61 @@ GTEST_TEST(Huffman, invalidSymbol) {
 
 	EXPECT_THROW(huffman.getSymbol(bitStream), Common::Exception);
 }
+
+/* Codes up to 12 bits long, longer than what is looked up at once:
+ * 0, 10, 110, ..., 111111111110, 111111111111. */
+static void createLongCodes(uint32_t (&codes)[13], uint8_t (&lengths)[13], bool msbFirst) {
+	for (size_t i = 0; i < 13; i++) {
+		lengths[i] = MIN<size_t>(i + 1, 12);
+
+		// The code is all 1-bits, followed by a single 0-bit (except for the last)
+		const uint32_t ones = (i < 12) ? i : 12;
+		if (msbFirst)
+			codes[i] = ((1 << ones) - 1) << (lengths[i] - ones);
+		else
+			codes[i] = (1 << ones) - 1;
+	}
+}
+
+/** Put the bits of these symbols' codes, in reading order, into bytes. */
+static std::vector<byte> encodeLongCodes(const std::vector<size_t> &symbols, bool msbFirst) {
+	std::vector<bool> bits;
+	for (std::vector<size_t>::const_iterator s = symbols.begin(); s != symbols.end(); ++s) {
+		bits.insert(bits.end(), MIN<size_t>(*s, 12), true);
+		if (*s < 12)
+			bits.push_back(false);
+	}
+
+	std::vector<byte> data((bits.size() + 7) / 8, 0);
+	for (size_t i = 0; i < bits.size(); i++)
+		if (bits[i])
+			data[i / 8] |= msbFirst ? (0x80 >> (i % 8)) : (1 << (i % 8));
+
+	return data;
+}
+
+GTEST_TEST(Huffman, longCodes) {
+	std::vector<size_t> symbols;
+	for (size_t i = 0; i < 64; i++)
+		symbols.push_back((i * 7) % 13);
+
+	for (int msbFirst = 0; msbFirst < 2; msbFirst++) {
+		uint32_t codes[13];
+		uint8_t lengths[13];
+		createLongCodes(codes, lengths, msbFirst != 0);
+
+		Common::Huffman huffman(0, ARRAYSIZE(codes), codes, lengths, 0);
+
+		const std::vector<byte> data = encodeLongCodes(symbols, msbFirst != 0);
+		Common::MemoryReadStream byteStream(data.data(), data.size());
+
+		std::unique_ptr<Common::BitStream> bitStream;
+		if (msbFirst)
+			bitStream = std::make_unique<Common::BitStream8MSB>(byteStream);
+		else
+			bitStream = std::make_unique<Common::BitStream8LSB>(byteStream);
+
+		for (size_t i = 0; i < symbols.size(); i++)
+			EXPECT_EQ(huffman.getSymbol(*bitStream), symbols[i]) << "At index " << i << ", MSB first: " << msbFirst;
+	}
+}
@@ -0,0 +1,114 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our memory-mapped files.
+ */
+
+#include <memory>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/platform.h"
+#include "src/common/memreadstream.h"
+#include "src/common/mappedfile.h"
+
+boost::filesystem::path kFilePath;
+
+static const byte kData[8] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF };
+
+class MappedFile : public ::testing::Test {
+protected:
+	static void SetUpTestCase() {
+		Common::Platform::init();
+
+		boost::filesystem::path tmpPath    = boost::filesystem::temp_directory_path();
+		boost::filesystem::path uniquePath = boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+		kFilePath = tmpPath / uniquePath;
+
+		boost::filesystem::ofstream testFile(kFilePath, std::ofstream::binary);
+
+		testFile.write(reinterpret_cast<const char *>(kData), ARRAYSIZE(kData));
+		testFile.close();
+	}
+
+	static void TearDownTestCase() {
+		if (!kFilePath.empty())
+			boost::filesystem::remove(kFilePath);
+	}
+};
+
+GTEST_TEST_F(MappedFile, file) {
+	ASSERT_FALSE(kFilePath.empty());
+
+	Common::MappedFile file(kFilePath.generic_string());
+	ASSERT_EQ(file.getSize(), ARRAYSIZE(kData));
+
+	for (size_t i = 0; i < ARRAYSIZE(kData); i++)
+		EXPECT_EQ(file.getData()[i], kData[i]) << "At index " << i;
+}
+
+GTEST_TEST_F(MappedFile, fileMissing) {
+	EXPECT_THROW(Common::MappedFile file(kFilePath.generic_string() + ".missing"), Common::Exception);
+}
+
+GTEST_TEST_F(MappedFile, stream) {
+	Common::MemoryReadStream stream(kData);
+
+	Common::MappedFile file(stream);
+	ASSERT_EQ(file.getSize(), ARRAYSIZE(kData));
+	EXPECT_FALSE(file.isMapped());
+
+	for (size_t i = 0; i < ARRAYSIZE(kData); i++)
+		EXPECT_EQ(file.getData()[i], kData[i]) << "At index " << i;
+}
+
+GTEST_TEST_F(MappedFile, getStream) {
+	ASSERT_FALSE(kFilePath.empty());
+
+	std::unique_ptr<Common::SeekableReadStream> stream1, stream2;
+
+	{
+		std::shared_ptr<Common::MappedFile> file = std::make_shared<Common::MappedFile>(kFilePath.generic_string());
+
+		stream1.reset(file->getStream(2, 4));
+		stream2.reset(file->getStream(4, 4));
+
+		EXPECT_THROW(file->getStream(4, 5), Common::Exception);
+		EXPECT_THROW(file->getStream(9, 0), Common::Exception);
+	}
+
+	// The streams keep the file alive, and have independent positions
+
+	ASSERT_EQ(stream1->size(), 4U);
+	ASSERT_EQ(stream2->size(), 4U);
+
+	EXPECT_EQ(stream1->readUint16BE(), 0x5678);
+	EXPECT_EQ(stream2->readUint32BE(), 0x90ABCDEF);
+	EXPECT_EQ(stream1->readUint16BE(), 0x90AB);
+
+	EXPECT_EQ(stream2->pos(), 4U);
+}
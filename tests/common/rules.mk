@@ -70,6 +70,16 @@ tests_common_test_readfile_SOURCES  = tests/common/readfile.cpp
 tests_common_test_readfile_LDADD    = $(common_LIBS)
 tests_common_test_readfile_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                       += tests/common/test_mappedfile
+tests_common_test_mappedfile_SOURCES  = tests/common/mappedfile.cpp
+tests_common_test_mappedfile_LDADD    = $(common_LIBS)
+tests_common_test_mappedfile_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                        += tests/common/test_threadpool
+tests_common_test_threadpool_SOURCES  = tests/common/threadpool.cpp
+tests_common_test_threadpool_LDADD    = $(common_LIBS)
+tests_common_test_threadpool_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                      += tests/common/test_writefile
 tests_common_test_writefile_SOURCES  = tests/common/writefile.cpp
 tests_common_test_writefile_LDADD    = $(common_LIBS)
@@ -90,6 +100,11 @@ tests_common_test_huffman_SOURCES  = tests/common/huffman.cpp
 tests_common_test_huffman_LDADD    = $(common_LIBS)
 tests_common_test_huffman_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                += tests/common/test_fft
+tests_common_test_fft_SOURCES  = tests/common/fft.cpp
+tests_common_test_fft_LDADD    = $(common_LIBS)
+tests_common_test_fft_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                     += tests/common/test_blowfish
 tests_common_test_blowfish_SOURCES  = tests/common/blowfish.cpp
 tests_common_test_blowfish_LDADD    = $(common_LIBS)
@@ -241,6 +256,11 @@ tests_common_test_aabbnode_SOURCES  = tests/common/aabbnode.cpp
 tests_common_test_aabbnode_LDADD    = $(common_LIBS)
 tests_common_test_aabbnode_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                     += tests/common/test_aabbtree
+tests_common_test_aabbtree_SOURCES  = tests/common/aabbtree.cpp
+tests_common_test_aabbtree_LDADD    = $(common_LIBS)
+tests_common_test_aabbtree_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                                += tests/common/test_serializationstream
 tests_common_test_serializationstream_SOURCES  = tests/common/serializationstream.cpp
 tests_common_test_serializationstream_LDADD    = $(common_LIBS)
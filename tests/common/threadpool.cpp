@@ -0,0 +1,122 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our thread pool.
+ */
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/error.h"
+#include "src/common/threadpool.h"
+
+GTEST_TEST(ThreadPool, threadCount) {
+	Common::ThreadPool pool1("", 1);
+	EXPECT_EQ(pool1.getThreadCount(), 1);
+
+	Common::ThreadPool pool3("", 3);
+	EXPECT_EQ(pool3.getThreadCount(), 3);
+
+	Common::ThreadPool poolCores;
+	EXPECT_EQ(poolCores.getThreadCount(), Common::ThreadPool::getCoreCount());
+}
+
+GTEST_TEST(ThreadPool, jobs) {
+	std::atomic<int> sum(0);
+
+	std::vector<std::future<void>> futures;
+
+	{
+		Common::ThreadPool pool("", 4);
+
+		for (int i = 1; i <= 100; i++)
+			futures.push_back(pool.addJob([&sum, i] { sum += i; }));
+
+		for (size_t i = 0; i < futures.size(); i++)
+			futures[i].get();
+
+		EXPECT_EQ(sum, 5050);
+	}
+}
+
+GTEST_TEST(ThreadPool, order) {
+	std::vector<int> order;
+
+	Common::ThreadPool pool("", 1);
+
+	std::future<void> last;
+	for (int i = 0; i < 10; i++)
+		last = pool.addJob([&order, i] { order.push_back(i); });
+
+	last.get();
+
+	ASSERT_EQ(order.size(), 10);
+	for (int i = 0; i < 10; i++)
+		EXPECT_EQ(order[i], i);
+}
+
+GTEST_TEST(ThreadPool, exception) {
+	Common::ThreadPool pool("", 2);
+
+	std::future<void> future = pool.addJob([] { throw Common::Exception("Test"); });
+
+	EXPECT_THROW(future.get(), Common::Exception);
+
+	// The worker thread survives the exception
+	bool ran = false;
+	pool.addJob([&ran] { ran = true; }).get();
+
+	EXPECT_TRUE(ran);
+}
+
+GTEST_TEST(ThreadPool, finishOnDestroy) {
+	std::atomic<int> count(0);
+
+	{
+		Common::ThreadPool pool("", 2);
+
+		for (int i = 0; i < 50; i++)
+			pool.addJob([&count] { count++; });
+	}
+
+	EXPECT_EQ(count, 50);
+}
+
+GTEST_TEST(ThreadPool, cancel) {
+	Common::ThreadPool pool("", 1);
+
+	std::promise<void> start, block;
+	std::shared_future<void> blocked = block.get_future().share();
+
+	// Keep the only worker thread busy, so that the next job stays queued
+	std::future<void> first  = pool.addJob([&start, blocked] { start.set_value(); blocked.wait(); });
+	std::future<void> second = pool.addJob([] { });
+
+	start.get_future().wait();
+
+	pool.cancelJobs();
+	block.set_value();
+
+	first.get();
+	EXPECT_THROW(second.get(), std::future_error);
+}
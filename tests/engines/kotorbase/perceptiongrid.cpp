@@ -0,0 +1,181 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the grid keeping track of what KotOR creatures perceive.
+ */
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+
+#include "src/engines/kotorbase/creature.h"
+#include "src/engines/kotorbase/perceptiongrid.h"
+
+using Engines::KotORBase::PerceptionGrid;
+
+/** A bare creature, without any models. */
+class Creature : public Engines::KotORBase::Creature {
+protected:
+	void getPartModelsPC(PartModels &UNUSED(parts), uint32_t UNUSED(state), uint8_t UNUSED(textureVariation)) {
+	}
+};
+
+static bool perceives(const Creature &subject, Creature &object) {
+	return (subject.getSeenObjects().count(&object) == 1) && (subject.getHeardObjects().count(&object) == 1);
+}
+
+GTEST_TEST(KotORPerceptionGrid, add) {
+	PerceptionGrid grid;
+
+	Creature a, b, c;
+	a.setPosition(0.0f, 0.0f, 0.0f);
+	b.setPosition(5.0f, 0.0f, 0.0f);
+	c.setPosition(100.0f, 0.0f, 0.0f);
+
+	grid.add(a);
+	grid.add(b);
+	grid.add(c);
+
+	EXPECT_TRUE(grid.contains(&a));
+	EXPECT_TRUE(grid.contains(&b));
+	EXPECT_TRUE(grid.contains(&c));
+
+	EXPECT_TRUE(perceives(a, b));
+	EXPECT_TRUE(perceives(b, a));
+
+	EXPECT_FALSE(perceives(a, c));
+	EXPECT_FALSE(perceives(c, a));
+	EXPECT_FALSE(perceives(b, c));
+}
+
+GTEST_TEST(KotORPerceptionGrid, setPositionIntoRange) {
+	PerceptionGrid grid;
+
+	Creature a, b;
+	a.setPosition(0.0f, 0.0f, 0.0f);
+	b.setPosition(100.0f, 100.0f, 0.0f);
+
+	grid.add(a);
+	grid.add(b);
+
+	EXPECT_FALSE(perceives(a, b));
+	EXPECT_FALSE(perceives(b, a));
+
+	// Teleport b next to a, like a script jump does, without telling the area
+	b.setPosition(3.0f, 4.0f, 0.0f);
+
+	EXPECT_TRUE(perceives(a, b));
+	EXPECT_TRUE(perceives(b, a));
+
+	// Moving a keeps finding b where it was teleported to
+	a.setPosition(-2.0f, 0.0f, 0.0f);
+
+	EXPECT_TRUE(perceives(a, b));
+	EXPECT_TRUE(perceives(b, a));
+}
+
+GTEST_TEST(KotORPerceptionGrid, setPositionOutOfRange) {
+	PerceptionGrid grid;
+
+	Creature a, b;
+	a.setPosition(0.0f, 0.0f, 0.0f);
+	b.setPosition(1.0f, 0.0f, 0.0f);
+
+	grid.add(a);
+	grid.add(b);
+
+	EXPECT_TRUE(perceives(a, b));
+
+	b.setPosition(-500.0f, 300.0f, 0.0f);
+
+	EXPECT_FALSE(perceives(a, b));
+	EXPECT_FALSE(perceives(b, a));
+
+	// A new creature at b's old position doesn't find b there anymore
+	Creature c;
+	c.setPosition(1.0f, 0.0f, 0.0f);
+	grid.add(c);
+
+	EXPECT_TRUE(perceives(c, a));
+	EXPECT_FALSE(perceives(c, b));
+}
+
+GTEST_TEST(KotORPerceptionGrid, remove) {
+	PerceptionGrid grid;
+
+	Creature a, b;
+	a.setPosition(0.0f, 0.0f, 0.0f);
+	b.setPosition(100.0f, 0.0f, 0.0f);
+
+	grid.add(a);
+	grid.add(b);
+
+	grid.remove(b);
+	EXPECT_FALSE(grid.contains(&b));
+
+	// Creatures that left the grid don't update it anymore
+	b.setPosition(1.0f, 0.0f, 0.0f);
+
+	EXPECT_FALSE(grid.contains(&b));
+	EXPECT_FALSE(perceives(a, b));
+	EXPECT_FALSE(perceives(b, a));
+}
+
+GTEST_TEST(KotORPerceptionGrid, clear) {
+	PerceptionGrid grid;
+
+	Creature a, b;
+	a.setPosition(0.0f, 0.0f, 0.0f);
+	b.setPosition(100.0f, 0.0f, 0.0f);
+
+	grid.add(a);
+	grid.add(b);
+
+	grid.clear();
+	EXPECT_FALSE(grid.contains(&a));
+	EXPECT_FALSE(grid.contains(&b));
+
+	b.setPosition(1.0f, 0.0f, 0.0f);
+
+	EXPECT_FALSE(grid.contains(&b));
+	EXPECT_FALSE(perceives(a, b));
+}
+
+GTEST_TEST(KotORPerceptionGrid, destroyCreature) {
+	PerceptionGrid grid;
+
+	Creature a;
+	a.setPosition(0.0f, 0.0f, 0.0f);
+	grid.add(a);
+
+	{
+		Creature b;
+		b.setPosition(1.0f, 0.0f, 0.0f);
+		grid.add(b);
+
+		EXPECT_TRUE(perceives(a, b));
+	}
+
+	// The destroyed creature took itself out of the grid, and isn't looked at anymore
+	a.setPosition(2.0f, 0.0f, 0.0f);
+
+	EXPECT_TRUE(grid.contains(&a));
+}
@@ -0,0 +1,174 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for sharing and preloading models in the Engines::ModelLoader class.
+ */
+
+#include <chrono>
+#include <thread>
+#include <map>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+
+#include "src/graphics/shader/shader.h"
+
+#include "src/graphics/aurora/model.h"
+
+#include "src/engines/aurora/modelloader.h"
+
+using Graphics::Aurora::Model;
+
+/** A model without any nodes. */
+class TestModel : public Model {
+public:
+	TestModel(const Common::UString &name) {
+		_name = name;
+
+		State *state = new State;
+
+		_stateList.push_back(state);
+		_stateMap.insert(std::make_pair(state->name, state));
+
+		finalize();
+	}
+};
+
+/** A model loader sharing its models, and counting how often each prototype was loaded. */
+class TestModelLoader : public Engines::ModelLoader {
+public:
+	~TestModelLoader() {
+		stopPreloading();
+	}
+
+	Model *load(const Common::UString &resref, Graphics::Aurora::ModelType type, const Common::UString &texture) {
+		return loadShared(resref, type, texture);
+	}
+
+	void preload(const Common::UString &resref, Graphics::Aurora::ModelType type, const Common::UString &texture) {
+		preloadShared(resref, type, texture);
+	}
+
+	size_t getLoadCount(const Common::UString &resref) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		return _loadCount[resref];
+	}
+
+	/** Wait for a preload to finish. */
+	bool waitForLoad(const Common::UString &resref, size_t count) {
+		for (int i = 0; i < 1000; i++) {
+			if (getLoadCount(resref) >= count)
+				return true;
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+
+		return false;
+	}
+
+protected:
+	Model *loadPrototype(const Common::UString &resref, Graphics::Aurora::ModelType UNUSED(type),
+	                     const Common::UString &UNUSED(texture)) {
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			_loadCount[resref]++;
+		}
+
+		return new TestModel(resref);
+	}
+
+private:
+	std::mutex _mutex;
+	std::map<Common::UString, size_t> _loadCount;
+};
+
+/** Every model has a bounding box renderable, which needs the default shaders.
+ *  Creating them doesn't need a GL context, only compiling them does. */
+class ShaderEnvironment : public ::testing::Environment {
+public:
+	void SetUp() {
+		ShaderMan.init();
+	}
+};
+
+static ::testing::Environment * const kShaderEnvironment = ::testing::AddGlobalTestEnvironment(new ShaderEnvironment);
+
+static void loadModel(TestModelLoader &loader, const Common::UString &resref) {
+	std::unique_ptr<Model> model(loader.load(resref, Graphics::Aurora::kModelTypeObject, ""));
+	ASSERT_NE(model, nullptr);
+}
+
+GTEST_TEST(ModelLoader, share) {
+	TestModelLoader loader;
+
+	loadModel(loader, "model");
+	loadModel(loader, "model");
+	EXPECT_EQ(loader.getLoadCount("model"), 1);
+
+	// The model files might have changed, so the prototype needs to be loaded again
+	loader.clearPrototypes();
+
+	loadModel(loader, "model");
+	EXPECT_EQ(loader.getLoadCount("model"), 2);
+}
+
+GTEST_TEST(ModelLoader, preload) {
+	TestModelLoader loader;
+
+	loader.preload("model", Graphics::Aurora::kModelTypeObject, "");
+	ASSERT_TRUE(loader.waitForLoad("model", 1));
+
+	loadModel(loader, "model");
+	EXPECT_EQ(loader.getLoadCount("model"), 1);
+}
+
+GTEST_TEST(ModelLoader, clearUnusedPreloads) {
+	TestModelLoader loader;
+
+	// Guess at the next module, like hovering over two doors
+	loader.preload("door1", Graphics::Aurora::kModelTypeObject, "");
+	loader.preload("door2", Graphics::Aurora::kModelTypeObject, "");
+	ASSERT_TRUE(loader.waitForLoad("door1", 1));
+	ASSERT_TRUE(loader.waitForLoad("door2", 1));
+
+	// Going through the first door. Both preloads are kept for the new module
+	loader.clearPrototypes();
+
+	loadModel(loader, "door1");
+	EXPECT_EQ(loader.getLoadCount("door1"), 1);
+
+	// Leaving that module again. The second door was a wrong guess and is dropped
+	loader.clearPrototypes();
+
+	loadModel(loader, "door2");
+	EXPECT_EQ(loader.getLoadCount("door2"), 2);
+
+	// The first door was used, so its prototype is gone, too
+	loadModel(loader, "door1");
+	EXPECT_EQ(loader.getLoadCount("door1"), 2);
+}
@@ -0,0 +1,308 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** @file
+ *  Unit tests for the Engines::ProximityGrid class.
+ */
+
+#include <cstdio>
+
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <random>
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+#include "src/engines/aurora/proximitygrid.h"
+
+struct TestObject {
+	float x, y;
+	float dX, dY;
+};
+
+typedef Engines::ProximityGrid<TestObject> TestGrid;
+
+static std::vector<TestObject *> findNear(const TestGrid &grid, float x, float y, float distance) {
+	std::vector<TestObject *> objects;
+	grid.findNear(x, y, distance, objects);
+
+	std::sort(objects.begin(), objects.end());
+	return objects;
+}
+
+static std::vector<TestObject *> findNearBruteForce(std::vector<TestObject> &objects,
+                                                    float x, float y, float distance) {
+
+	std::vector<TestObject *> found;
+	for (auto &o : objects)
+		if (((o.x - x) * (o.x - x) + (o.y - y) * (o.y - y)) <= (distance * distance))
+			found.push_back(&o);
+
+	std::sort(found.begin(), found.end());
+	return found;
+}
+
+static void placeRandomly(std::vector<TestObject> &objects, float size, std::mt19937 &random) {
+	std::uniform_real_distribution<float> position(-size / 2.0f, size / 2.0f);
+	std::uniform_real_distribution<float> speed(-1.0f, 1.0f);
+
+	for (auto &o : objects) {
+		o.x  = position(random);
+		o.y  = position(random);
+		o.dX = speed(random);
+		o.dY = speed(random);
+	}
+}
+
+static void move(TestObject &object, float size) {
+	object.x += object.dX;
+	object.y += object.dY;
+
+	// Bounce off the edges of the area
+	if ((object.x < (-size / 2.0f)) || (object.x > (size / 2.0f)))
+		object.dX = -object.dX;
+	if ((object.y < (-size / 2.0f)) || (object.y > (size / 2.0f)))
+		object.dY = -object.dY;
+}
+
+GTEST_TEST(ProximityGrid, updateRemove) {
+	TestObject objects[3] = { { 1.0f, 1.0f, 0.0f, 0.0f }, { -5.0f, 3.0f, 0.0f, 0.0f }, { 40.0f, 40.0f, 0.0f, 0.0f } };
+
+	TestGrid grid(16.0f);
+	EXPECT_EQ(grid.size(), 0);
+
+	for (auto &o : objects)
+		grid.update(&o, o.x, o.y);
+
+	EXPECT_EQ(grid.size(), 3);
+	EXPECT_TRUE(grid.contains(&objects[0]));
+	EXPECT_TRUE(grid.contains(&objects[1]));
+	EXPECT_TRUE(grid.contains(&objects[2]));
+
+	// Updating doesn't add the object again
+	grid.update(&objects[0], 2.0f, 2.0f);
+	EXPECT_EQ(grid.size(), 3);
+
+	grid.remove(&objects[1]);
+	EXPECT_EQ(grid.size(), 2);
+	EXPECT_FALSE(grid.contains(&objects[1]));
+
+	// Removing an object not in the grid is ignored
+	grid.remove(&objects[1]);
+	EXPECT_EQ(grid.size(), 2);
+
+	std::vector<TestObject *> all;
+	grid.getObjects(all);
+	std::sort(all.begin(), all.end());
+
+	ASSERT_EQ(all.size(), 2);
+	EXPECT_EQ(all[0], &objects[0]);
+	EXPECT_EQ(all[1], &objects[2]);
+
+	grid.clear();
+	EXPECT_EQ(grid.size(), 0);
+	EXPECT_FALSE(grid.contains(&objects[0]));
+}
+
+GTEST_TEST(ProximityGrid, findNear) {
+	TestObject objects[4] = {
+		{   0.0f,   0.0f, 0.0f, 0.0f },
+		{  10.0f,   0.0f, 0.0f, 0.0f },
+		{ -10.0f, -10.0f, 0.0f, 0.0f },
+		{ 100.0f, 100.0f, 0.0f, 0.0f }
+	};
+
+	TestGrid grid(16.0f);
+	for (auto &o : objects)
+		grid.update(&o, o.x, o.y);
+
+	std::vector<TestObject *> found = findNear(grid, 0.0f, 0.0f, 10.0f);
+	ASSERT_EQ(found.size(), 2);
+	EXPECT_EQ(found[0], &objects[0]);
+	EXPECT_EQ(found[1], &objects[1]);
+
+	found = findNear(grid, 0.0f, 0.0f, 15.0f);
+	ASSERT_EQ(found.size(), 3);
+	EXPECT_EQ(found[2], &objects[2]);
+
+	found = findNear(grid, 50.0f, 50.0f, 10.0f);
+	EXPECT_TRUE(found.empty());
+
+	// Search distance larger than a cell
+	found = findNear(grid, 50.0f, 50.0f, 100.0f);
+	ASSERT_EQ(found.size(), 4);
+}
+
+GTEST_TEST(ProximityGrid, moveBetweenCells) {
+	TestObject objects[2] = { { 0.0f, 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f, 0.0f } };
+
+	TestGrid grid(16.0f);
+	for (auto &o : objects)
+		grid.update(&o, o.x, o.y);
+
+	grid.update(&objects[0], -100.0f, 60.0f);
+
+	std::vector<TestObject *> found = findNear(grid, 0.0f, 0.0f, 5.0f);
+	ASSERT_EQ(found.size(), 1);
+	EXPECT_EQ(found[0], &objects[1]);
+
+	found = findNear(grid, -101.0f, 61.0f, 5.0f);
+	ASSERT_EQ(found.size(), 1);
+	EXPECT_EQ(found[0], &objects[0]);
+
+	// The object that was moved out of the cell is still intact
+	grid.remove(&objects[1]);
+	EXPECT_TRUE(findNear(grid, 0.0f, 0.0f, 5.0f).empty());
+	EXPECT_EQ(findNear(grid, -100.0f, 60.0f, 1.0f).size(), 1);
+}
+
+GTEST_TEST(ProximityGrid, randomMovement) {
+	static const float kSize = 200.0f;
+	static const float kDistance = 16.0f;
+
+	std::mt19937 random(1);
+
+	std::vector<TestObject> objects(300);
+	placeRandomly(objects, kSize, random);
+
+	TestGrid grid(kDistance);
+	for (auto &o : objects)
+		grid.update(&o, o.x, o.y);
+
+	for (int step = 0; step < 20; step++) {
+		for (auto &o : objects) {
+			move(o, kSize);
+			grid.update(&o, o.x, o.y);
+		}
+
+		for (size_t i = 0; i < objects.size(); i += 7) {
+			const TestObject &o = objects[i];
+
+			EXPECT_EQ(findNear(grid, o.x, o.y, kDistance), findNearBruteForce(objects, o.x, o.y, kDistance));
+		}
+	}
+}
+
+struct TestCreature {
+	TestObject object;
+
+	std::set<TestCreature *> perceived;
+};
+
+/** Update the mutual perception of two creatures, like KotORBase::Creature does. */
+static void updatePerception(TestCreature &a, TestCreature &b, float range) {
+	const float dX = a.object.x - b.object.x;
+	const float dY = a.object.y - b.object.y;
+
+	if ((dX * dX + dY * dY) <= (range * range)) {
+		a.perceived.insert(&b);
+		b.perceived.insert(&a);
+	} else {
+		a.perceived.erase(&b);
+		b.perceived.erase(&a);
+	}
+}
+
+static std::vector<TestCreature> createCreatures(size_t count, float size) {
+	std::mt19937 random(1);
+
+	std::vector<TestObject> objects(count);
+	placeRandomly(objects, size, random);
+
+	std::vector<TestCreature> creatures(count);
+	for (size_t i = 0; i < count; i++)
+		creatures[i].object = objects[i];
+
+	return creatures;
+}
+
+static size_t countPerceived(const std::vector<TestCreature> &creatures) {
+	size_t count = 0;
+	for (const auto &c : creatures)
+		count += c.perceived.size();
+
+	return count;
+}
+
+/* Hundreds of creatures moving around in an area, updating their perception
+ * after every step. Compares testing every pair of creatures, which is what
+ * KotORBase::Area used to do, with only testing the creatures found by the
+ * grid and those perceived until now.
+ *
+ * Run with --gtest_also_run_disabled_tests. */
+GTEST_TEST(ProximityGrid, DISABLED_benchmark) {
+	static const float kSize  = 300.0f;
+	static const float kRange = 16.0f;
+	static const int   kSteps = 50;
+
+	for (size_t count : { 100, 300, 1000 }) {
+		std::vector<TestCreature> creaturesAllPairs = createCreatures(count, kSize);
+		std::vector<TestCreature> creaturesGrid     = createCreatures(count, kSize);
+
+		const auto startAllPairs = std::chrono::steady_clock::now();
+
+		for (int step = 0; step < kSteps; step++) {
+			for (auto &c : creaturesAllPairs) {
+				move(c.object, kSize);
+
+				for (auto &other : creaturesAllPairs)
+					if (&other != &c)
+						updatePerception(c, other, kRange);
+			}
+		}
+
+		const auto startGrid = std::chrono::steady_clock::now();
+
+		Engines::ProximityGrid<TestCreature> grid(kRange);
+		for (auto &c : creaturesGrid)
+			grid.update(&c, c.object.x, c.object.y);
+
+		std::vector<TestCreature *> candidates;
+		for (int step = 0; step < kSteps; step++) {
+			for (auto &c : creaturesGrid) {
+				move(c.object, kSize);
+				grid.update(&c, c.object.x, c.object.y);
+
+				candidates.clear();
+				grid.findNear(c.object.x, c.object.y, kRange, candidates);
+				candidates.insert(candidates.end(), c.perceived.begin(), c.perceived.end());
+
+				std::sort(candidates.begin(), candidates.end());
+				candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+				for (auto &other : candidates)
+					if (other != &c)
+						updatePerception(c, *other, kRange);
+			}
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+
+		EXPECT_EQ(countPerceived(creaturesGrid), countPerceived(creaturesAllPairs));
+
+		const double timeAllPairs = std::chrono::duration<double, std::milli>(startGrid - startAllPairs).count();
+		const double timeGrid     = std::chrono::duration<double, std::milli>(end - startGrid).count();
+
+		std::printf("%4u creatures: all pairs %8.3f ms, grid %6.3f ms per step\n",
+		            (unsigned int) count, timeAllPairs / kSteps, timeGrid / kSteps);
+	}
+}
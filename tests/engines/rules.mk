@@ -34,3 +34,18 @@ check_PROGRAMS                     += tests/engines/test_trigger
 tests_engines_test_trigger_SOURCES  = tests/engines/trigger.cpp
 tests_engines_test_trigger_LDADD    = $(engines_LIBS)
 tests_engines_test_trigger_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                           += tests/engines/test_proximitygrid
+tests_engines_test_proximitygrid_SOURCES  = tests/engines/proximitygrid.cpp
+tests_engines_test_proximitygrid_LDADD    = $(engines_LIBS)
+tests_engines_test_proximitygrid_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                          += tests/engines/test_spatialindex
+tests_engines_test_spatialindex_SOURCES  = tests/engines/spatialindex.cpp
+tests_engines_test_spatialindex_LDADD    = $(engines_LIBS)
+tests_engines_test_spatialindex_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                         += tests/engines/test_modelloader
+tests_engines_test_modelloader_SOURCES  = tests/engines/modelloader.cpp
+tests_engines_test_modelloader_LDADD    = $(engines_LIBS)
+tests_engines_test_modelloader_CXXFLAGS = $(test_CXXFLAGS)
@@ -0,0 +1,355 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** @file
+ *  Unit tests for the Engines::SpatialIndex class.
+ */
+
+#include <cstdio>
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+#include "src/engines/aurora/spatialindex.h"
+
+struct TestRegion {
+	float minX, minY;
+	float maxX, maxY;
+};
+
+typedef Engines::SpatialIndex<TestRegion> TestIndex;
+
+static void addRegions(TestIndex &index, std::vector<TestRegion> &regions) {
+	for (auto &r : regions)
+		index.update(&r, r.minX, r.minY, r.maxX, r.maxY);
+}
+
+static std::vector<TestRegion *> findAt(const TestIndex &index, float x, float y) {
+	std::vector<TestRegion *> regions;
+	index.findAt(x, y, regions);
+
+	return regions;
+}
+
+static std::vector<TestRegion *> findAlong(const TestIndex &index, float x1, float y1, float x2, float y2) {
+	std::vector<TestRegion *> regions;
+	index.findAlong(x1, y1, x2, y2, regions);
+
+	return regions;
+}
+
+/** Does the line cross the region? Tested by sampling many points along the line. */
+static bool isCrossedSampled(const TestRegion &r, float x1, float y1, float x2, float y2) {
+	static const int kSamples = 1000;
+
+	for (int i = 0; i <= kSamples; i++) {
+		const float x = x1 + (x2 - x1) * i / kSamples;
+		const float y = y1 + (y2 - y1) * i / kSamples;
+
+		if ((x >= r.minX) && (x <= r.maxX) && (y >= r.minY) && (y <= r.maxY))
+			return true;
+	}
+
+	return false;
+}
+
+static std::vector<TestRegion> createRegions(size_t count, float size, float maxRegionSize, std::mt19937 &random) {
+	std::uniform_real_distribution<float> position(-size / 2.0f, size / 2.0f);
+	std::uniform_real_distribution<float> extent(1.0f, maxRegionSize);
+
+	std::vector<TestRegion> regions(count);
+	for (auto &r : regions) {
+		r.minX = position(random);
+		r.minY = position(random);
+		r.maxX = r.minX + extent(random);
+		r.maxY = r.minY + extent(random);
+	}
+
+	return regions;
+}
+
+GTEST_TEST(SpatialIndex, updateRemove) {
+	std::vector<TestRegion> regions = { { 0.0f, 0.0f, 4.0f, 4.0f }, { -20.0f, -20.0f, 20.0f, 20.0f } };
+
+	TestIndex index(8.0f);
+	EXPECT_EQ(index.size(), 0);
+
+	addRegions(index, regions);
+	EXPECT_EQ(index.size(), 2);
+	EXPECT_TRUE(index.contains(&regions[0]));
+	EXPECT_TRUE(index.contains(&regions[1]));
+
+	// Updating doesn't add the region again
+	index.update(&regions[0], 30.0f, 30.0f, 40.0f, 40.0f);
+	EXPECT_EQ(index.size(), 2);
+	EXPECT_EQ(findAt(index, 2.0f, 2.0f).size(), 1);
+	EXPECT_EQ(findAt(index, 35.0f, 35.0f).size(), 1);
+
+	index.remove(&regions[1]);
+	EXPECT_EQ(index.size(), 1);
+	EXPECT_FALSE(index.contains(&regions[1]));
+	EXPECT_TRUE(findAt(index, 2.0f, 2.0f).empty());
+
+	// Removing a region not in the index is ignored
+	index.remove(&regions[1]);
+	EXPECT_EQ(index.size(), 1);
+
+	index.clear();
+	EXPECT_EQ(index.size(), 0);
+	EXPECT_TRUE(findAt(index, 35.0f, 35.0f).empty());
+}
+
+GTEST_TEST(SpatialIndex, findAt) {
+	std::vector<TestRegion> regions = {
+		{  -1.0f,  -1.0f,  1.0f,  1.0f },
+		{ -50.0f, -50.0f, 50.0f, 50.0f },
+		{   0.0f,   0.0f, 16.0f,  8.0f },
+		{ -24.0f,  -3.0f, -9.0f, -1.0f }
+	};
+
+	TestIndex index(8.0f);
+	addRegions(index, regions);
+
+	std::vector<TestRegion *> found = findAt(index, 0.5f, 0.5f);
+	ASSERT_EQ(found.size(), 3);
+	EXPECT_EQ(found[0], &regions[0]);
+	EXPECT_EQ(found[1], &regions[1]);
+	EXPECT_EQ(found[2], &regions[2]);
+
+	// Points on the border are within the region
+	found = findAt(index, 16.0f, 8.0f);
+	ASSERT_EQ(found.size(), 2);
+	EXPECT_EQ(found[0], &regions[1]);
+	EXPECT_EQ(found[1], &regions[2]);
+
+	found = findAt(index, -10.0f, -2.0f);
+	ASSERT_EQ(found.size(), 2);
+	EXPECT_EQ(found[0], &regions[1]);
+	EXPECT_EQ(found[1], &regions[3]);
+
+	EXPECT_TRUE(findAt(index, 100.0f, 0.0f).empty());
+}
+
+GTEST_TEST(SpatialIndex, findAtOrder) {
+	std::vector<TestRegion> regions(5, { 0.0f, 0.0f, 1.0f, 1.0f });
+
+	TestIndex index(8.0f);
+	addRegions(index, regions);
+
+	// Updating or moving a region doesn't change its order
+	index.update(&regions[0], 0.0f, 0.0f, 2.0f, 2.0f);
+	index.update(&regions[2], 20.0f, 20.0f, 21.0f, 21.0f);
+	index.update(&regions[2], 0.0f, 0.0f, 1.0f, 1.0f);
+
+	std::vector<TestRegion *> found = findAt(index, 0.5f, 0.5f);
+	ASSERT_EQ(found.size(), 5);
+
+	for (size_t i = 0; i < found.size(); i++)
+		EXPECT_EQ(found[i], &regions[i]);
+}
+
+GTEST_TEST(SpatialIndex, findAlong) {
+	std::vector<TestRegion> regions = {
+		{   0.0f,  0.0f,  4.0f,  4.0f },
+		{  30.0f,  0.0f, 34.0f,  4.0f },
+		{  30.0f, 30.0f, 34.0f, 34.0f },
+		{ -20.0f, 10.0f, 60.0f, 11.0f }
+	};
+
+	TestIndex index(8.0f);
+	addRegions(index, regions);
+
+	std::vector<TestRegion *> found = findAlong(index, -10.0f, 2.0f, 40.0f, 2.0f);
+	ASSERT_EQ(found.size(), 2);
+	EXPECT_EQ(found[0], &regions[0]);
+	EXPECT_EQ(found[1], &regions[1]);
+
+	// Same line, the other way around
+	found = findAlong(index, 40.0f, 2.0f, -10.0f, 2.0f);
+	ASSERT_EQ(found.size(), 2);
+	EXPECT_EQ(found[0], &regions[0]);
+	EXPECT_EQ(found[1], &regions[1]);
+
+	found = findAlong(index, -1.0f, -1.0f, 40.0f, 40.0f);
+	ASSERT_EQ(found.size(), 3);
+	EXPECT_EQ(found[0], &regions[0]);
+	EXPECT_EQ(found[1], &regions[2]);
+	EXPECT_EQ(found[2], &regions[3]);
+
+	// Vertical line
+	found = findAlong(index, 32.0f, -5.0f, 32.0f, 50.0f);
+	ASSERT_EQ(found.size(), 3);
+	EXPECT_EQ(found[0], &regions[1]);
+	EXPECT_EQ(found[1], &regions[2]);
+	EXPECT_EQ(found[2], &regions[3]);
+
+	// Line ending before the region
+	EXPECT_TRUE(findAlong(index, 10.0f, 2.0f, 20.0f, 2.0f).empty());
+
+	// A line that's only a point
+	found = findAlong(index, 1.0f, 1.0f, 1.0f, 1.0f);
+	ASSERT_EQ(found.size(), 1);
+	EXPECT_EQ(found[0], &regions[0]);
+}
+
+GTEST_TEST(SpatialIndex, randomRegions) {
+	static const float kSize = 200.0f;
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(-kSize / 2.0f, kSize / 2.0f);
+
+	std::vector<TestRegion> regions = createRegions(200, kSize, 30.0f, random);
+
+	TestIndex index(8.0f);
+	addRegions(index, regions);
+
+	for (int i = 0; i < 200; i++) {
+		const float x = position(random), y = position(random);
+
+		std::vector<TestRegion *> expected;
+		for (auto &r : regions)
+			if ((x >= r.minX) && (x <= r.maxX) && (y >= r.minY) && (y <= r.maxY))
+				expected.push_back(&r);
+
+		EXPECT_EQ(findAt(index, x, y), expected);
+	}
+
+	for (int i = 0; i < 50; i++) {
+		const float x1 = position(random), y1 = position(random);
+		const float x2 = position(random), y2 = position(random);
+
+		const std::vector<TestRegion *> found = findAlong(index, x1, y1, x2, y2);
+
+		// Everything crossed must be found. Touching a corner might be missed by the sampling.
+		for (auto &r : regions) {
+			if (isCrossedSampled(r, x1, y1, x2, y2)) {
+				EXPECT_TRUE(std::find(found.begin(), found.end(), &r) != found.end());
+			}
+		}
+
+		EXPECT_TRUE(std::is_sorted(found.begin(), found.end()));
+	}
+}
+
+/** A trigger-like polygon, with a bounding box to test first. */
+struct TestTrigger {
+	TestRegion bounds;
+
+	std::vector<float> x, y;
+};
+
+/** Is the point within the polygon? Ray casting, like Engines::Trigger. */
+static bool contains(const TestTrigger &t, float x, float y) {
+	if ((x < t.bounds.minX) || (x > t.bounds.maxX) || (y < t.bounds.minY) || (y > t.bounds.maxY))
+		return false;
+
+	bool in = false;
+	for (size_t i = 0, j = t.x.size() - 1; i < t.x.size(); j = i++)
+		if (((t.y[i] > y) != (t.y[j] > y)) &&
+		    (x < ((t.x[j] - t.x[i]) * (y - t.y[i]) / (t.y[j] - t.y[i]) + t.x[i])))
+			in = !in;
+
+	return in;
+}
+
+/* An area with hundreds of triggers, and the party leader walking through it,
+ * looking for the trigger it's in after every step. Compares testing all
+ * triggers, which is what KotORBase::Area used to do, with the index.
+ *
+ * Run with --gtest_also_run_disabled_tests. */
+GTEST_TEST(SpatialIndex, DISABLED_benchmark) {
+	static const float kSize  = 400.0f;
+	static const int   kSteps = 100000;
+
+	for (size_t count : { 100, 500, 2000 }) {
+		std::mt19937 random(1);
+
+		const std::vector<TestRegion> bounds = createRegions(count, kSize, 20.0f, random);
+
+		// Octagons within the bounds
+		std::vector<TestTrigger> triggers(count);
+		for (size_t i = 0; i < count; i++) {
+			triggers[i].bounds = bounds[i];
+
+			const float cX = (bounds[i].minX + bounds[i].maxX) / 2.0f, rX = (bounds[i].maxX - bounds[i].minX) / 2.0f;
+			const float cY = (bounds[i].minY + bounds[i].maxY) / 2.0f, rY = (bounds[i].maxY - bounds[i].minY) / 2.0f;
+
+			for (int v = 0; v < 8; v++) {
+				triggers[i].x.push_back(cX + rX * std::cos(v * 0.785398f));
+				triggers[i].y.push_back(cY + rY * std::sin(v * 0.785398f));
+			}
+		}
+
+		Engines::SpatialIndex<TestTrigger> index(8.0f);
+		for (auto &t : triggers)
+			index.update(&t, t.bounds.minX, t.bounds.minY, t.bounds.maxX, t.bounds.maxY);
+
+		// A random walk
+		std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+
+		std::vector<float> walkX(kSteps), walkY(kSteps);
+		for (int i = 0; i < kSteps; i++) {
+			walkX[i] = std::fmod(((i > 0) ? walkX[i - 1] : 0.0f) + step(random), kSize / 2.0f);
+			walkY[i] = std::fmod(((i > 0) ? walkY[i - 1] : 0.0f) + step(random), kSize / 2.0f);
+		}
+
+		size_t foundAll = 0, foundIndex = 0;
+
+		const auto startAll = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < kSteps; i++) {
+			for (auto &t : triggers) {
+				if (contains(t, walkX[i], walkY[i])) {
+					foundAll++;
+					break;
+				}
+			}
+		}
+
+		const auto startIndex = std::chrono::steady_clock::now();
+
+		std::vector<TestTrigger *> candidates;
+		for (int i = 0; i < kSteps; i++) {
+			candidates.clear();
+			index.findAt(walkX[i], walkY[i], candidates);
+
+			for (auto &t : candidates) {
+				if (contains(*t, walkX[i], walkY[i])) {
+					foundIndex++;
+					break;
+				}
+			}
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+
+		EXPECT_EQ(foundIndex, foundAll);
+
+		const double timeAll   = std::chrono::duration<double, std::micro>(startIndex - startAll).count();
+		const double timeIndex = std::chrono::duration<double, std::micro>(end - startIndex).count();
+
+		std::printf("%4u triggers: all triggers %7.3f us, index %5.3f us per step\n",
+		            (unsigned int) count, timeAll / kSteps, timeIndex / kSteps);
+	}
+}
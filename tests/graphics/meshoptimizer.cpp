@@ -0,0 +1,345 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the mesh optimizer.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "src/graphics/vertexbuffer.h"
+#include "src/graphics/indexbuffer.h"
+
+#include "src/graphics/mesh/meshoptimizer.h"
+
+using namespace Graphics;
+
+static uint32_t randomNumber(uint32_t &seed) {
+	seed = seed * 1664525 + 1013904223;
+	return seed >> 8;
+}
+
+/** A vertex like most model loaders create them. */
+struct Vertex {
+	float position[3];
+	float normal[3];
+	float uv[2];
+};
+
+/** Create a flat grid of size x size quads, the way the NWN model loader would:
+ *  every triangle with its own three vertices, in random order. */
+static void createGrid(VertexBuffer &vertexBuffer, IndexBuffer &indexBuffer, uint32_t size) {
+	std::vector<uint32_t> triangles(size * size * 2);
+	for (size_t i = 0; i < triangles.size(); i++)
+		triangles[i] = i;
+
+	uint32_t seed = 0xC0FFEE;
+	for (size_t i = triangles.size() - 1; i > 0; i--)
+		std::swap(triangles[i], triangles[randomNumber(seed) % (i + 1)]);
+
+	VertexDecl decl;
+	decl.push_back(VertexAttrib(VPOSITION, 3, GL_FLOAT));
+	decl.push_back(VertexAttrib(VNORMAL  , 3, GL_FLOAT));
+	decl.push_back(VertexAttrib(VTCOORD  , 2, GL_FLOAT));
+
+	vertexBuffer.setVertexDeclInterleave(triangles.size() * 3, decl);
+	indexBuffer.setSize(triangles.size() * 3, sizeof(uint32_t), GL_UNSIGNED_INT);
+
+	Vertex   *v = reinterpret_cast<Vertex *>(vertexBuffer.getData());
+	uint32_t *f = reinterpret_cast<uint32_t *>(indexBuffer.getData());
+
+	for (size_t i = 0; i < triangles.size(); i++) {
+		const uint32_t x = (triangles[i] / 2) % size;
+		const uint32_t y = (triangles[i] / 2) / size;
+
+		static const uint32_t kCorners[2][3][2] = { { {0, 0}, {1, 0}, {1, 1} }, { {0, 0}, {1, 1}, {0, 1} } };
+
+		for (size_t j = 0; j < 3; j++) {
+			const uint32_t *corner = kCorners[triangles[i] % 2][j];
+
+			const Vertex vertex = {
+				{ (float) (x + corner[0]), (float) (y + corner[1]), 0.0f },
+				{ 0.0f, 0.0f, 1.0f },
+				{ (x + corner[0]) / (float) size, (y + corner[1]) / (float) size }
+			};
+
+			*v++ = vertex;
+			*f++ = i * 3 + j;
+		}
+	}
+}
+
+static uint32_t getIndex(const IndexBuffer &indexBuffer, size_t i) {
+	if (indexBuffer.getType() == GL_UNSIGNED_SHORT)
+		return reinterpret_cast<const uint16_t *>(indexBuffer.getData())[i];
+
+	return reinterpret_cast<const uint32_t *>(indexBuffer.getData())[i];
+}
+
+/** Return all triangles of a mesh as their vertex data, sorted. */
+static std::vector<std::vector<byte>> getTriangles(const VertexBuffer &vertexBuffer, const IndexBuffer &indexBuffer) {
+	std::vector<std::vector<byte>> triangles;
+
+	const size_t vertexSize = vertexBuffer.getSize();
+	const VertexDecl &decl = vertexBuffer.getVertexDecl();
+
+	for (size_t i = 0; i < indexBuffer.getCount(); i += 3) {
+		std::vector<byte> triangle;
+
+		for (size_t j = 0; j < 3; j++) {
+			const uint32_t index = getIndex(indexBuffer, i + j);
+
+			for (VertexDecl::const_iterator a = decl.begin(); a != decl.end(); ++a) {
+				const size_t size   = a->size * VertexBuffer::getTypeSize(a->type);
+				const size_t stride = (a->stride != 0) ? a->stride : size;
+
+				const byte *data = reinterpret_cast<const byte *>(a->pointer) + index * stride;
+				triangle.insert(triangle.end(), data, data + size);
+			}
+		}
+
+		EXPECT_EQ(triangle.size(), vertexSize * 3);
+		triangles.push_back(triangle);
+	}
+
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+GTEST_TEST(MeshOptimizer, computeACMR) {
+	static const uint32_t kSeparate[] = { 0, 1, 2, 3, 4, 5 };
+	EXPECT_DOUBLE_EQ(Mesh::computeACMR(kSeparate, 6), 3.0);
+
+	static const uint32_t kShared[] = { 0, 1, 2, 2, 1, 3 };
+	EXPECT_DOUBLE_EQ(Mesh::computeACMR(kShared, 6), 2.0);
+
+	// With a cache of 3, vertex 0 is gone once vertex 3 came in. Getting it back pushes out 1, and so on
+	static const uint32_t kEvicted[] = { 0, 1, 2, 3, 2, 1, 0, 1, 2 };
+	EXPECT_DOUBLE_EQ(Mesh::computeACMR(kEvicted, 9, 3), 7.0 / 3.0);
+	EXPECT_DOUBLE_EQ(Mesh::computeACMR(kEvicted, 9, 4), 4.0 / 3.0);
+}
+
+GTEST_TEST(MeshOptimizer, weldVertices) {
+	static const float kVertices[] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 3.0f, 4.0f, 0.0f, 0.0f, -0.0f, 0.0f };
+
+	uint32_t remap[6];
+	EXPECT_EQ(Mesh::weldVertices(remap, reinterpret_cast<const byte *>(kVertices), 6, 2 * sizeof(float)), 5U);
+
+	EXPECT_EQ(remap[0], 0U);
+	EXPECT_EQ(remap[1], 1U);
+	EXPECT_EQ(remap[2], 2U);
+	EXPECT_EQ(remap[3], 1U);
+	EXPECT_EQ(remap[4], 3U);
+	// -0.0 and 0.0 are different data
+	EXPECT_EQ(remap[5], 4U);
+}
+
+GTEST_TEST(MeshOptimizer, optimizeVertexCache) {
+	static const uint32_t kSize = 32;
+
+	// A grid, with the triangles in random order
+	std::vector<uint32_t> indices;
+	for (uint32_t y = 0; y < kSize; y++) {
+		for (uint32_t x = 0; x < kSize; x++) {
+			const uint32_t v = y * (kSize + 1) + x;
+
+			const uint32_t quad[6] = { v, v + 1, v + kSize + 2, v, v + kSize + 2, v + kSize + 1 };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+
+	uint32_t seed = 0xC0FFEE;
+	for (size_t i = indices.size() / 3 - 1; i > 0; i--) {
+		const size_t j = randomNumber(seed) % (i + 1);
+
+		std::swap_ranges(indices.begin() + i * 3, indices.begin() + i * 3 + 3, indices.begin() + j * 3);
+	}
+
+	std::vector<uint32_t> optimized(indices.size());
+	Mesh::optimizeVertexCache(optimized.data(), indices.data(), indices.size(), (kSize + 1) * (kSize + 1));
+
+	// All triangles are still there, unchanged
+	std::vector<std::vector<uint32_t>> before, after;
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		before.push_back(std::vector<uint32_t>(indices.begin() + i, indices.begin() + i + 3));
+		after.push_back(std::vector<uint32_t>(optimized.begin() + i, optimized.begin() + i + 3));
+	}
+
+	std::sort(before.begin(), before.end());
+	std::sort(after.begin(), after.end());
+	EXPECT_EQ(before, after);
+
+	const double acmrBefore = Mesh::computeACMR(indices.data(), indices.size());
+	const double acmrAfter  = Mesh::computeACMR(optimized.data(), optimized.size());
+
+	EXPECT_GT(acmrBefore, 2.0);
+	EXPECT_LT(acmrAfter, 0.8);
+}
+
+GTEST_TEST(MeshOptimizer, optimizeVertexFetch) {
+	uint32_t indices[] = { 4, 2, 0, 2, 4, 5 };
+
+	uint32_t remap[6];
+	EXPECT_EQ(Mesh::optimizeVertexFetch(remap, indices, 6, 6), 4U);
+
+	static const uint32_t kIndices[] = { 0, 1, 2, 1, 0, 3 };
+	for (size_t i = 0; i < 6; i++)
+		EXPECT_EQ(indices[i], kIndices[i]) << "At index " << i;
+
+	EXPECT_EQ(remap[0], 2U);
+	EXPECT_EQ(remap[1], Mesh::kUnusedVertex);
+	EXPECT_EQ(remap[2], 1U);
+	EXPECT_EQ(remap[3], Mesh::kUnusedVertex);
+	EXPECT_EQ(remap[4], 0U);
+	EXPECT_EQ(remap[5], 3U);
+}
+
+GTEST_TEST(MeshOptimizer, optimizeMesh) {
+	static const uint32_t kSize = 64;
+
+	VertexBuffer vertexBuffer;
+	IndexBuffer  indexBuffer;
+	createGrid(vertexBuffer, indexBuffer, kSize);
+
+	const std::vector<std::vector<byte>> before = getTriangles(vertexBuffer, indexBuffer);
+	const Mesh::MeshStats statsBefore = Mesh::getMeshStats(vertexBuffer, indexBuffer);
+
+	ASSERT_TRUE(Mesh::optimizeMesh(vertexBuffer, indexBuffer));
+
+	const Mesh::MeshStats statsAfter = Mesh::getMeshStats(vertexBuffer, indexBuffer);
+
+	// The mesh still renders the same triangles
+	EXPECT_EQ(getTriangles(vertexBuffer, indexBuffer), before);
+
+	EXPECT_EQ(statsAfter.vertexCount, (kSize + 1) * (kSize + 1));
+	EXPECT_EQ(statsAfter.indexCount, statsBefore.indexCount);
+	EXPECT_EQ(indexBuffer.getType(), (GLenum) GL_UNSIGNED_SHORT);
+
+	EXPECT_LT(statsAfter.acmr, 0.8);
+	EXPECT_LT(statsAfter.vertexMemory + statsAfter.indexMemory,
+	          (statsBefore.vertexMemory + statsBefore.indexMemory) / 4);
+
+	std::printf("%ux%u grid: %u vertices, %u KiB, ACMR %.3f -> %u vertices, %u KiB, ACMR %.3f\n", kSize, kSize,
+	            (uint) statsBefore.vertexCount, (uint) ((statsBefore.vertexMemory + statsBefore.indexMemory) / 1024),
+	            statsBefore.acmr,
+	            (uint) statsAfter.vertexCount, (uint) ((statsAfter.vertexMemory + statsAfter.indexMemory) / 1024),
+	            statsAfter.acmr);
+}
+
+GTEST_TEST(MeshOptimizer, optimizeMeshLinear) {
+	VertexDecl decl;
+	decl.push_back(VertexAttrib(VPOSITION, 3, GL_FLOAT));
+	decl.push_back(VertexAttrib(VTCOORD  , 2, GL_FLOAT));
+
+	VertexBuffer vertexBuffer;
+	vertexBuffer.setVertexDeclLinear(4, decl);
+
+	static const float kPositions[] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+	static const float kUVs[]       = { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f };
+	std::memcpy(vertexBuffer.getData(0), kPositions, sizeof(kPositions));
+	std::memcpy(vertexBuffer.getData(1), kUVs, sizeof(kUVs));
+
+	// Two triangles, on top of each other
+	IndexBuffer indexBuffer;
+	indexBuffer.setSize(6, sizeof(uint32_t), GL_UNSIGNED_INT);
+
+	static const uint32_t kIndices[] = { 0, 1, 2, 0, 3, 2 };
+	std::memcpy(indexBuffer.getData(), kIndices, sizeof(kIndices));
+
+	const std::vector<std::vector<byte>> before = getTriangles(vertexBuffer, indexBuffer);
+
+	ASSERT_TRUE(Mesh::optimizeMesh(vertexBuffer, indexBuffer));
+
+	EXPECT_EQ(getTriangles(vertexBuffer, indexBuffer), before);
+
+	EXPECT_EQ(vertexBuffer.getCount(), 3U);
+	EXPECT_EQ(indexBuffer.getCount(), 6U);
+
+	// Interleaved now
+	const VertexDecl &newDecl = vertexBuffer.getVertexDecl();
+	ASSERT_EQ(newDecl.size(), 2U);
+	EXPECT_EQ(newDecl[0].stride, 5 * (GLsizei) sizeof(float));
+	EXPECT_EQ(newDecl[1].stride, 5 * (GLsizei) sizeof(float));
+}
+
+GTEST_TEST(MeshOptimizer, optimizeMeshDegenerate) {
+	VertexDecl decl;
+	decl.push_back(VertexAttrib(VPOSITION, 3, GL_FLOAT));
+
+	VertexBuffer vertexBuffer;
+	vertexBuffer.setVertexDeclInterleave(6, decl);
+
+	// The second triangle collapses into a line once its vertices are welded
+	static const float kPositions[] = {
+		0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f
+	};
+	std::memcpy(vertexBuffer.getData(), kPositions, sizeof(kPositions));
+
+	IndexBuffer indexBuffer;
+	indexBuffer.setSize(6, sizeof(uint16_t), GL_UNSIGNED_SHORT);
+
+	static const uint16_t kIndices[] = { 0, 1, 2, 3, 4, 5 };
+	std::memcpy(indexBuffer.getData(), kIndices, sizeof(kIndices));
+
+	ASSERT_TRUE(Mesh::optimizeMesh(vertexBuffer, indexBuffer));
+
+	EXPECT_EQ(vertexBuffer.getCount(), 3U);
+	EXPECT_EQ(indexBuffer.getCount(), 3U);
+}
+
+GTEST_TEST(MeshOptimizer, optimizeMeshInvalid) {
+	VertexDecl decl;
+	decl.push_back(VertexAttrib(VPOSITION, 3, GL_FLOAT));
+
+	VertexBuffer vertexBuffer;
+	vertexBuffer.setVertexDeclInterleave(3, decl);
+	std::memset(vertexBuffer.getData(), 0, 3 * vertexBuffer.getSize());
+
+	// Index out of range
+	IndexBuffer indexBuffer;
+	indexBuffer.setSize(3, sizeof(uint16_t), GL_UNSIGNED_SHORT);
+
+	static const uint16_t kIndices[] = { 0, 1, 3 };
+	std::memcpy(indexBuffer.getData(), kIndices, sizeof(kIndices));
+
+	EXPECT_FALSE(Mesh::optimizeMesh(vertexBuffer, indexBuffer));
+	EXPECT_EQ(vertexBuffer.getCount(), 3U);
+	EXPECT_EQ(indexBuffer.getCount(), 3U);
+}
+
+GTEST_TEST(MeshOptimizer, optimizeMeshLarge) {
+	// Too many vertices for 16-bit indices
+	static const uint32_t kSize = 300;
+
+	VertexBuffer vertexBuffer;
+	IndexBuffer  indexBuffer;
+	createGrid(vertexBuffer, indexBuffer, kSize);
+
+	ASSERT_TRUE(Mesh::optimizeMesh(vertexBuffer, indexBuffer));
+
+	EXPECT_EQ(vertexBuffer.getCount(), (kSize + 1) * (kSize + 1));
+	EXPECT_EQ(indexBuffer.getType(), (GLenum) GL_UNSIGNED_INT);
+}
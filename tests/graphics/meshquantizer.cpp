@@ -0,0 +1,264 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the mesh quantizer.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/graphics/vertexbuffer.h"
+
+#include "src/graphics/mesh/meshquantizer.h"
+
+using namespace Graphics;
+
+static uint32_t randomNumber(uint32_t &seed) {
+	seed = seed * 1664525 + 1013904223;
+	return seed >> 8;
+}
+
+static float randomFloat(uint32_t &seed, float min, float max) {
+	return min + (max - min) * ((randomNumber(seed) & 0xFFFF) / 65535.0f);
+}
+
+/** A vertex like most model loaders create them. */
+struct Vertex {
+	float position[3];
+	float normal[3];
+	float uv[2];
+};
+
+/** A quantized Vertex. */
+struct QuantizedVertex {
+	int16_t position[4];
+	int16_t normal[2];
+	uint16_t uv[2];
+};
+
+static void randomNormal(uint32_t &seed, float *normal) {
+	float length = 0.0f;
+	while (length < 0.01f) {
+		for (size_t i = 0; i < 3; i++)
+			normal[i] = randomFloat(seed, -1.0f, 1.0f);
+
+		length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+	}
+
+	for (size_t i = 0; i < 3; i++)
+		normal[i] /= length;
+}
+
+/** Create a mesh of random vertices, with texture coordinates that repeat a few times. */
+static void createMesh(VertexBuffer &vertexBuffer, std::vector<Vertex> &vertices, size_t count) {
+	VertexDecl decl;
+	decl.push_back(VertexAttrib(VPOSITION, 3, GL_FLOAT));
+	decl.push_back(VertexAttrib(VNORMAL  , 3, GL_FLOAT));
+	decl.push_back(VertexAttrib(VTCOORD  , 2, GL_FLOAT));
+
+	vertexBuffer.setVertexDeclInterleave(count, decl);
+
+	uint32_t seed = 0xC0FFEE;
+
+	vertices.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		vertices[i].position[0] = randomFloat(seed, -20.0f, 140.0f);
+		vertices[i].position[1] = randomFloat(seed,  10.0f,  12.0f);
+		vertices[i].position[2] = randomFloat(seed, -3.0f,    1.0f);
+
+		randomNormal(seed, vertices[i].normal);
+
+		vertices[i].uv[0] = randomFloat(seed, -1.0f, 4.0f);
+		vertices[i].uv[1] = randomFloat(seed,  0.0f, 1.0f);
+	}
+
+	std::memcpy(vertexBuffer.getData(), vertices.data(), count * sizeof(Vertex));
+}
+
+GTEST_TEST(MeshQuantizer, octahedral) {
+	static const float kAxes[6][3] = {
+		{ 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+		{ 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }
+	};
+
+	for (size_t i = 0; i < 6; i++) {
+		int16_t encoded[2];
+		float decoded[3];
+
+		Mesh::encodeOctahedral(encoded, kAxes[i][0], kAxes[i][1], kAxes[i][2]);
+		Mesh::decodeOctahedral(decoded, encoded);
+
+		for (size_t j = 0; j < 3; j++)
+			EXPECT_FLOAT_EQ(decoded[j], kAxes[i][j]) << "At axis " << i << ", component " << j;
+	}
+
+	uint32_t seed = 0xBEEF;
+	for (size_t i = 0; i < 10000; i++) {
+		float normal[3];
+		randomNormal(seed, normal);
+
+		int16_t encoded[2];
+		float decoded[3];
+
+		Mesh::encodeOctahedral(encoded, normal[0], normal[1], normal[2]);
+		Mesh::decodeOctahedral(decoded, encoded);
+
+		for (size_t j = 0; j < 3; j++)
+			EXPECT_NEAR(decoded[j], normal[j], 1e-4f) << "At normal " << i << ", component " << j;
+	}
+}
+
+GTEST_TEST(MeshQuantizer, quantizeMesh) {
+	static const size_t kCount = 4096;
+
+	VertexBuffer vertexBuffer;
+	std::vector<Vertex> vertices;
+	createMesh(vertexBuffer, vertices, kCount);
+
+	const size_t sizeBefore = vertexBuffer.getCount() * vertexBuffer.getSize();
+
+	glm::vec4 decode[Mesh::kVertexDecodeSize];
+	ASSERT_TRUE(Mesh::quantizeMesh(vertexBuffer, decode));
+
+	const size_t sizeAfter = vertexBuffer.getCount() * vertexBuffer.getSize();
+
+	std::printf("%u vertices: %u bytes each, %u KiB -> %u bytes each, %u KiB\n", (uint) kCount,
+	            (uint) sizeof(Vertex), (uint) (sizeBefore / 1024),
+	            (uint) vertexBuffer.getSize(), (uint) (sizeAfter / 1024));
+
+	ASSERT_EQ(vertexBuffer.getCount(), kCount);
+	ASSERT_EQ(vertexBuffer.getSize(), sizeof(QuantizedVertex));
+	EXPECT_EQ(sizeAfter * 2, sizeBefore);
+
+	const VertexDecl &decl = vertexBuffer.getVertexDecl();
+	ASSERT_EQ(decl.size(), 3);
+
+	EXPECT_EQ(decl[0].index, VPOSITION);
+	EXPECT_EQ(decl[0].size, 4);
+	EXPECT_EQ(decl[0].type, GL_SHORT);
+	EXPECT_EQ(decl[1].index, VNORMAL);
+	EXPECT_EQ(decl[1].size, 2);
+	EXPECT_EQ(decl[1].type, GL_SHORT);
+	EXPECT_EQ(decl[2].index, VTCOORD);
+	EXPECT_EQ(decl[2].size, 2);
+	EXPECT_EQ(decl[2].type, GL_UNSIGNED_SHORT);
+
+	// The decoded values are at most half a step away from the originals
+
+	const QuantizedVertex *quantized = reinterpret_cast<const QuantizedVertex *>(vertexBuffer.getData());
+	for (size_t i = 0; i < kCount; i++) {
+		for (size_t j = 0; j < 3; j++) {
+			const float position = decode[0][j] + decode[1][j] * quantized[i].position[j];
+			EXPECT_NEAR(position, vertices[i].position[j], decode[1][j] * 0.5f + 1e-5f) << "At vertex " << i;
+		}
+
+		float normal[3];
+		Mesh::decodeOctahedral(normal, quantized[i].normal);
+		for (size_t j = 0; j < 3; j++)
+			EXPECT_NEAR(normal[j], vertices[i].normal[j], 1e-4f) << "At vertex " << i;
+
+		for (size_t j = 0; j < 2; j++) {
+			const float uv = decode[2][j] + decode[2][j + 2] * quantized[i].uv[j];
+			EXPECT_NEAR(uv, vertices[i].uv[j], decode[2][j + 2] * 0.5f + 1e-6f) << "At vertex " << i;
+		}
+	}
+
+	// There's no second set of texture coordinates to decode
+	EXPECT_EQ(decode[3], glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+}
+
+GTEST_TEST(MeshQuantizer, quantizeMeshLinear) {
+	// Attributes the quantizer doesn't know are kept as they are
+	VertexDecl decl;
+	decl.push_back(VertexAttrib(VPOSITION, 3, GL_FLOAT));
+	decl.push_back(VertexAttrib(VCOLOR   , 4, GL_FLOAT));
+
+	VertexBuffer vertexBuffer;
+	vertexBuffer.setVertexDeclLinear(2, decl);
+
+	static const float kPositions[] = { 1.0f, 2.0f, 3.0f, 5.0f, 2.0f, 7.0f };
+	static const float kColours[]   = { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f };
+
+	std::memcpy(vertexBuffer.getData(0), kPositions, sizeof(kPositions));
+	std::memcpy(vertexBuffer.getData(1), kColours  , sizeof(kColours));
+
+	glm::vec4 decode[Mesh::kVertexDecodeSize];
+	ASSERT_TRUE(Mesh::quantizeMesh(vertexBuffer, decode));
+
+	ASSERT_EQ(vertexBuffer.getSize(), 4 * sizeof(int16_t) + sizeof(kColours) / 2);
+
+	const byte *data = reinterpret_cast<const byte *>(vertexBuffer.getData());
+	for (size_t i = 0; i < 2; i++) {
+		const byte *vertex = data + i * vertexBuffer.getSize();
+
+		int16_t position[4];
+		std::memcpy(position, vertex, sizeof(position));
+
+		// Both positions are at opposite corners of the bounding box, and flat in y
+		const int16_t sign = (i == 0) ? -1 : 1;
+		EXPECT_EQ(position[0], sign * 32767);
+		EXPECT_EQ(position[1], 0);
+		EXPECT_EQ(position[2], sign * 32767);
+		EXPECT_EQ(position[3], 0);
+
+		for (size_t j = 0; j < 3; j++)
+			EXPECT_FLOAT_EQ(decode[0][j] + decode[1][j] * position[j], kPositions[i * 3 + j]);
+
+		EXPECT_EQ(std::memcmp(vertex + sizeof(position), kColours + i * 4, 4 * sizeof(float)), 0);
+	}
+}
+
+GTEST_TEST(MeshQuantizer, quantizeMeshInvalid) {
+	VertexBuffer vertexBuffer;
+	std::vector<Vertex> vertices;
+	createMesh(vertexBuffer, vertices, 16);
+
+	glm::vec4 decode[Mesh::kVertexDecodeSize];
+
+	// Already quantized
+	ASSERT_TRUE(Mesh::quantizeMesh(vertexBuffer, decode));
+	EXPECT_FALSE(Mesh::quantizeMesh(vertexBuffer, decode));
+
+	// No positions
+	VertexDecl decl;
+	decl.push_back(VertexAttrib(VNORMAL, 3, GL_FLOAT));
+
+	vertexBuffer.setVertexDeclInterleave(16, decl);
+	EXPECT_FALSE(Mesh::quantizeMesh(vertexBuffer, decode));
+
+	// Two-dimensional positions
+	decl.clear();
+	decl.push_back(VertexAttrib(VPOSITION, 2, GL_FLOAT));
+
+	vertexBuffer.setVertexDeclInterleave(16, decl);
+	std::memset(vertexBuffer.getData(), 0, 16 * vertexBuffer.getSize());
+
+	EXPECT_FALSE(Mesh::quantizeMesh(vertexBuffer, decode));
+	EXPECT_EQ(vertexBuffer.getVertexDecl()[0].type, GL_FLOAT);
+
+	// Empty
+	VertexBuffer empty;
+	EXPECT_FALSE(Mesh::quantizeMesh(empty, decode));
+}
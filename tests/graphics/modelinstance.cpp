@@ -0,0 +1,447 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for sharing model data between model instances.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/strutil.h"
+#include "src/common/platform.h"
+#include "src/common/writefile.h"
+#include "src/common/changeid.h"
+
+#include "src/aurora/resman.h"
+
+#include "src/graphics/vertexbuffer.h"
+#include "src/graphics/indexbuffer.h"
+
+#include "src/graphics/shader/shader.h"
+
+#include "src/graphics/mesh/mesh.h"
+
+#include "src/graphics/aurora/model.h"
+#include "src/graphics/aurora/modelnode.h"
+#include "src/graphics/aurora/model_nwn2.h"
+
+using namespace Graphics::Aurora;
+
+/** Stands in for MeshMan, which keeps the raw meshes of all models by name. */
+typedef std::map<Common::UString, std::unique_ptr<Graphics::Mesh::Mesh>> MeshCache;
+
+/** The size of the vertex and index data of a raw mesh with 16-bit indices. */
+static size_t getMeshSize(Graphics::Mesh::Mesh &mesh) {
+	return mesh.getVertexBuffer()->getCount() * mesh.getVertexBuffer()->getSize() +
+	       mesh.getIndexBuffer()->getCount() * sizeof(uint16_t);
+}
+
+class TestModelNode : public ModelNode {
+public:
+	TestModelNode(Model &model, const Common::UString &name, TestModelNode *parent) : ModelNode(model) {
+		_name = name;
+
+		setParent(parent);
+	}
+
+	ModelNode *createInstance(Model &model) const {
+		return new TestModelNode(model, *this);
+	}
+
+	void setRawMesh(Graphics::Mesh::Mesh *rawMesh) {
+		_mesh = new Mesh;
+
+		_mesh->data = std::make_shared<MeshData>();
+		_mesh->data->rawMesh = rawMesh;
+	}
+
+	const MeshData *getMeshData() const {
+		return _mesh ? _mesh->data.get() : 0;
+	}
+
+private:
+	TestModelNode(Model &model, const TestModelNode &prototype) : ModelNode(model, prototype) {
+	}
+};
+
+/** A model with a root node and nodeCount mesh nodes. Every odd
+ *  node is a child of the node before it, every even one of the root. */
+class TestModel : public Model {
+public:
+	TestModel(const Common::UString &name, size_t nodeCount, uint32_t vertexCount,
+	          MeshCache &meshes, size_t &allocated) {
+
+		_name = name;
+
+		State *state = new State;
+
+		_stateList.push_back(state);
+		_stateMap.insert(std::make_pair(state->name, state));
+
+		TestModelNode *root = addNode(*state, "root", 0);
+		TestModelNode *last = root;
+
+		for (size_t i = 0; i < nodeCount; i++) {
+			const Common::UString nodeName = Common::String::format("node%u", (uint) i);
+
+			last = addNode(*state, nodeName, (i % 2) ? last : root);
+			last->setRawMesh(createMesh(_name + "." + nodeName, vertexCount, meshes, allocated));
+		}
+
+		finalize();
+	}
+
+private:
+	TestModelNode *addNode(State &state, const Common::UString &name, TestModelNode *parent) {
+		TestModelNode *node = new TestModelNode(*this, name, parent);
+
+		state.nodeList.push_back(node);
+		state.nodeMap.insert(std::make_pair(name, node));
+
+		if (!parent)
+			state.rootNodes.push_back(node);
+
+		return node;
+	}
+
+	/** Build a raw mesh like a model loader would, and drop it again if MeshMan already knows it. */
+	static Graphics::Mesh::Mesh *createMesh(const Common::UString &name, uint32_t vertexCount,
+	                                        MeshCache &meshes, size_t &allocated) {
+
+		std::unique_ptr<Graphics::Mesh::Mesh> mesh = std::make_unique<Graphics::Mesh::Mesh>();
+
+		Graphics::VertexDecl decl;
+		decl.push_back(Graphics::VertexAttrib(Graphics::VPOSITION, 3, GL_FLOAT));
+		decl.push_back(Graphics::VertexAttrib(Graphics::VNORMAL  , 3, GL_FLOAT));
+		decl.push_back(Graphics::VertexAttrib(Graphics::VTCOORD  , 2, GL_FLOAT));
+
+		Graphics::VertexBuffer &vertexBuffer = *mesh->getVertexBuffer();
+		Graphics::IndexBuffer  &indexBuffer  = *mesh->getIndexBuffer();
+
+		vertexBuffer.setVertexDeclInterleave(vertexCount, decl);
+		indexBuffer.setSize(vertexCount, sizeof(uint16_t), GL_UNSIGNED_SHORT);
+
+		float *v = reinterpret_cast<float *>(vertexBuffer.getData());
+		for (uint32_t i = 0; i < (vertexCount * 8); i++)
+			v[i] = i;
+
+		uint16_t *f = reinterpret_cast<uint16_t *>(indexBuffer.getData());
+		for (uint32_t i = 0; i < vertexCount; i++)
+			f[i] = i;
+
+		allocated += getMeshSize(*mesh);
+
+		MeshCache::iterator known = meshes.find(name);
+		if (known != meshes.end())
+			return known->second.get();
+
+		return meshes.insert(std::make_pair(name, std::move(mesh))).first->second.get();
+	}
+};
+
+/** Every model has a bounding box renderable, which needs the default shaders.
+ *  Creating them doesn't need a GL context, only compiling them does. */
+class ShaderEnvironment : public ::testing::Environment {
+public:
+	void SetUp() {
+		ShaderMan.init();
+	}
+};
+
+static ::testing::Environment * const kShaderEnvironment = ::testing::AddGlobalTestEnvironment(new ShaderEnvironment);
+
+static const TestModelNode *getTestNode(const Model &model, const Common::UString &name) {
+	return dynamic_cast<const TestModelNode *>(model.getNode(name));
+}
+
+GTEST_TEST(ModelInstance, nodes) {
+	MeshCache meshes;
+	size_t allocated = 0;
+
+	const std::shared_ptr<const Model> prototype = std::make_shared<TestModel>("test", 4, 3, meshes, allocated);
+
+	std::unique_ptr<Model> instance1(Model::createInstance(prototype));
+	std::unique_ptr<Model> instance2(Model::createInstance(prototype));
+
+	static const char * const kNodes[]   = { "root", "node0", "node1", "node2", "node3" };
+	static const char * const kParents[] = { 0     , "root" , "node0", "root" , "node2" };
+	static const size_t       kChildren[] = { 2     , 1      , 0      , 1      , 0       };
+
+	for (size_t i = 0; i < ARRAYSIZE(kNodes); i++) {
+		const TestModelNode *node  = getTestNode(*prototype, kNodes[i]);
+		const TestModelNode *node1 = getTestNode(*instance1, kNodes[i]);
+		const TestModelNode *node2 = getTestNode(*instance2, kNodes[i]);
+
+		ASSERT_NE(node , nullptr) << "At index " << i;
+		ASSERT_NE(node1, nullptr) << "At index " << i;
+		ASSERT_NE(node2, nullptr) << "At index " << i;
+
+		// Every instance has its own nodes...
+		EXPECT_NE(node1, node ) << "At index " << i;
+		EXPECT_NE(node2, node ) << "At index " << i;
+		EXPECT_NE(node1, node2) << "At index " << i;
+
+		// ...but shares the mesh data
+		EXPECT_EQ(node1->getMeshData(), node->getMeshData()) << "At index " << i;
+		EXPECT_EQ(node2->getMeshData(), node->getMeshData()) << "At index " << i;
+
+		// The parents belong to the same instance
+		if (kParents[i]) {
+			EXPECT_EQ(node ->getParent(), prototype->getNode(kParents[i])) << "At index " << i;
+			EXPECT_EQ(node1->getParent(), instance1->getNode(kParents[i])) << "At index " << i;
+			EXPECT_EQ(node2->getParent(), instance2->getNode(kParents[i])) << "At index " << i;
+		} else {
+			EXPECT_EQ(node1->getParent(), nullptr) << "At index " << i;
+			EXPECT_EQ(node2->getParent(), nullptr) << "At index " << i;
+		}
+	}
+
+	EXPECT_NE(getTestNode(*instance1, "node0")->getMeshData(), nullptr);
+	EXPECT_EQ(getTestNode(*instance1, "root" )->getMeshData(), nullptr);
+
+	// And so do the children
+	for (Model *instance : { instance1.get(), instance2.get() }) {
+		for (size_t i = 0; i < ARRAYSIZE(kNodes); i++) {
+			ModelNode *node = instance->getNode(kNodes[i]);
+
+			const std::list<ModelNode *> &children = node->getChildren();
+			EXPECT_EQ(children.size(), kChildren[i]) << "At index " << i;
+
+			for (std::list<ModelNode *>::const_iterator c = children.begin(); c != children.end(); ++c) {
+				EXPECT_EQ(*c, instance->getNode((*c)->getName())) << "At index " << i;
+				EXPECT_EQ((*c)->getParent(), node) << "At index " << i;
+			}
+		}
+	}
+}
+
+GTEST_TEST(ModelInstance, transformations) {
+	MeshCache meshes;
+	size_t allocated = 0;
+
+	const std::shared_ptr<const Model> prototype = std::make_shared<TestModel>("test", 4, 3, meshes, allocated);
+
+	std::unique_ptr<Model> instance1(Model::createInstance(prototype));
+	std::unique_ptr<Model> instance2(Model::createInstance(prototype));
+
+	instance1->setPosition(1.0f, 2.0f, 3.0f);
+	instance1->getNode("node1")->setPosition(4.0f, 5.0f, 6.0f);
+
+	float x, y, z;
+
+	instance1->getPosition(x, y, z);
+	EXPECT_FLOAT_EQ(x, 1.0f);
+	EXPECT_FLOAT_EQ(y, 2.0f);
+	EXPECT_FLOAT_EQ(z, 3.0f);
+
+	instance2->getPosition(x, y, z);
+	EXPECT_FLOAT_EQ(x, 0.0f);
+	EXPECT_FLOAT_EQ(y, 0.0f);
+	EXPECT_FLOAT_EQ(z, 0.0f);
+
+	instance1->getNode("node1")->getPosition(x, y, z);
+	EXPECT_FLOAT_EQ(x, 4.0f);
+	EXPECT_FLOAT_EQ(y, 5.0f);
+	EXPECT_FLOAT_EQ(z, 6.0f);
+
+	for (const Model *model : { prototype.get(), static_cast<const Model *>(instance2.get()) }) {
+		model->getNode("node1")->getPosition(x, y, z);
+		EXPECT_FLOAT_EQ(x, 0.0f);
+		EXPECT_FLOAT_EQ(y, 0.0f);
+		EXPECT_FLOAT_EQ(z, 0.0f);
+	}
+}
+
+GTEST_TEST(ModelInstance, keepPrototype) {
+	MeshCache meshes;
+	size_t allocated = 0;
+
+	std::shared_ptr<const Model> prototype = std::make_shared<TestModel>("test", 4, 3, meshes, allocated);
+	const std::weak_ptr<const Model> weakPrototype = prototype;
+
+	std::unique_ptr<Model> instance(Model::createInstance(prototype));
+
+	// Releasing the prototype, like ModelLoader::clearPrototypes() does, keeps it alive for the instance
+	prototype.reset();
+	EXPECT_FALSE(weakPrototype.expired());
+
+	instance.reset();
+	EXPECT_TRUE(weakPrototype.expired());
+}
+
+static void writeFixedString(Common::WriteStream &stream, const Common::UString &str) {
+	byte data[32] = { 0 };
+	std::memcpy(data, str.c_str(), MIN<size_t>(str.size(), sizeof(data) - 1));
+
+	stream.write(data, sizeof(data));
+}
+
+static const uint32_t kNWN2RigidPacketSize = 8 + 5 * 32 + 8 * 4 + 3 * 4 + 3 * 15 * 4 + 3 * 2;
+
+/** Write an NWN2 rigid mesh packet with a single triangle, tinted by a tint map that doesn't exist. */
+static void writeNWN2RigidPacket(Common::WriteStream &mdb, const Common::UString &name) {
+	mdb.writeUint32BE(MKTAG('R', 'I', 'G', 'D'));
+	mdb.writeUint32LE(kNWN2RigidPacketSize - 8);
+
+	writeFixedString(mdb, name);
+	writeFixedString(mdb, "");            // Diffuse map
+	writeFixedString(mdb, "");            // Normal map
+	writeFixedString(mdb, "nwn2tintmap"); // Tint map
+	writeFixedString(mdb, "");            // Glow map
+
+	// Diffuse and specular colors, specular power and value
+	for (int i = 0; i < 8; i++)
+		mdb.writeIEEEFloatLE(1.0f);
+
+	mdb.writeUint32LE(0); // Texture flags
+	mdb.writeUint32LE(3); // Vertex count
+	mdb.writeUint32LE(1); // Face count
+
+	// Position, normal, tangent, binormal and texture coordinates
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 15; j++)
+			mdb.writeIEEEFloatLE(((j % 3) == i) ? 1.0f : 0.0f);
+
+	for (int i = 0; i < 3; i++)
+		mdb.writeUint16LE(i);
+}
+
+/** NWN2 tiles and placeables are tinted through the Model_NWN2 interface,
+ *  so instances of NWN2 models have to stay Model_NWN2 objects. */
+GTEST_TEST(ModelInstance, tintNWN2) {
+	Common::Platform::init();
+
+	const boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("xoreos%%%%%%%%%%%%.mdb");
+
+	const Common::UString name = path.stem().generic_string();
+
+	{
+		Common::WriteFile mdb(path.generic_string());
+
+		mdb.writeUint32BE(MKTAG('N', 'W', 'N', '2'));
+		mdb.writeUint16LE(1);
+		mdb.writeUint16LE(12);
+		mdb.writeUint32LE(2);
+
+		// One floor and one wall node of a tile
+		const uint32_t offset = 12 + 2 * 8;
+
+		mdb.writeUint32BE(MKTAG('R', 'I', 'G', 'D'));
+		mdb.writeUint32LE(offset);
+		mdb.writeUint32BE(MKTAG('R', 'I', 'G', 'D'));
+		mdb.writeUint32LE(offset + kNWN2RigidPacketSize);
+
+		writeNWN2RigidPacket(mdb, "TL_AA_TEST_01_F");
+		writeNWN2RigidPacket(mdb, "TL_AA_TEST_01");
+	}
+
+	Common::ChangeID change;
+	ResMan.indexResourceFile(path.generic_string(), 1, &change);
+
+	std::shared_ptr<const Model> prototype;
+	EXPECT_NO_THROW(prototype = std::make_shared<Model_NWN2>(name));
+
+	ResMan.undo(change);
+	boost::filesystem::remove(path);
+
+	ASSERT_TRUE(prototype);
+
+	static const float kTint[3][4] = {
+		{ 1.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f, 1.0f }
+	};
+
+	for (int i = 0; i < 2; i++) {
+		std::unique_ptr<Model> instance(Model::createInstance(prototype));
+
+		Model_NWN2 *nwn2 = dynamic_cast<Model_NWN2 *>(instance.get());
+		ASSERT_NE(nwn2, nullptr);
+
+		EXPECT_NE(nwn2->getNode("TL_AA_TEST_01_F"), nullptr);
+		EXPECT_NE(nwn2->getNode("TL_AA_TEST_01"), nullptr);
+
+		EXPECT_NO_THROW(nwn2->setTintFloor(kTint));
+		EXPECT_NO_THROW(nwn2->setTintWalls(kTint));
+		EXPECT_NO_THROW(nwn2->setTint(kTint));
+	}
+}
+
+/* Creating the models of a 32x32 area out of a few tile models, once
+ * by loading every tile model anew, like before the model loaders kept
+ * prototypes, and once by instancing the prototypes.
+ *
+ * Parsing the model files isn't included, only building the nodes and
+ * meshes. "Allocated" is all the vertex and index data built while
+ * loading, "kept" what remains after duplicate meshes were dropped.
+ *
+ * Run with --gtest_also_run_disabled_tests. */
+GTEST_TEST(ModelInstance, DISABLED_benchmark) {
+	static const size_t   kTileCount   = 32 * 32;
+	static const size_t   kTileModels  = 24;
+	static const size_t   kNodeCount   = 12;
+	static const uint32_t kVertexCount = 600;
+
+	for (int shared = 0; shared < 2; shared++) {
+		MeshCache meshes;
+		size_t allocated = 0;
+
+		std::vector<std::shared_ptr<const Model>> prototypes;
+		std::vector<std::unique_ptr<Model>> tiles;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < kTileCount; i++) {
+			const size_t tileModel = i % kTileModels;
+			const Common::UString name = Common::String::format("tile%u", (uint) tileModel);
+
+			if (!shared) {
+				tiles.emplace_back(std::make_unique<TestModel>(name, kNodeCount, kVertexCount, meshes, allocated));
+				continue;
+			}
+
+			if (prototypes.size() <= tileModel)
+				prototypes.push_back(std::make_shared<TestModel>(name, kNodeCount, kVertexCount, meshes, allocated));
+
+			tiles.emplace_back(Model::createInstance(prototypes[tileModel]));
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+
+		size_t kept = 0;
+		for (MeshCache::const_iterator m = meshes.begin(); m != meshes.end(); ++m)
+			kept += getMeshSize(*m->second);
+
+		std::printf("%-9s: %8.2f ms, %8.2f MiB allocated, %6.2f MiB kept\n", shared ? "Instanced" : "Loaded",
+		            std::chrono::duration<double, std::milli>(end - start).count(),
+		            allocated / (1024.0 * 1024.0), kept / (1024.0 * 1024.0));
+	}
+}
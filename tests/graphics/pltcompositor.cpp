@@ -0,0 +1,223 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the PLT layer compositing.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+
+#include "src/graphics/aurora/pltcompositor.h"
+
+typedef Graphics::Aurora::PLTCompositor PLTCompositor;
+
+static const char * const kImplementationNames[] = { "Scalar", "AVX2" };
+
+static uint32_t randomByte(uint32_t &seed) {
+	seed = seed * 1664525 + 1013904223;
+	return seed >> 24;
+}
+
+/** A random PLT with its color table. */
+struct PLTImage {
+	size_t pixels;
+
+	std::vector<uint16_t> indices;
+	std::vector<uint32_t> colors;
+
+	PLTImage(size_t p) : pixels(p), indices(p), colors(PLTCompositor::kColorCount) {
+		uint32_t seed = 0xC0FFEE;
+
+		std::vector<byte> layers(pixels), intensities(pixels);
+		for (size_t i = 0; i < pixels; i++) {
+			layers     [i] = randomByte(seed) % PLTCompositor::kLayerCount;
+			intensities[i] = randomByte(seed);
+		}
+
+		PLTCompositor::makeIndices(indices.data(), layers.data(), intensities.data(), pixels);
+
+		for (size_t i = 0; i < colors.size(); i++)
+			colors[i] = (randomByte(seed) << 24) | (randomByte(seed) << 16) | (randomByte(seed) << 8) | randomByte(seed);
+	}
+
+	void compose(PLTCompositor::Implementation implementation, std::vector<byte> &dst) const {
+		dst.assign(pixels * 4, 0);
+
+		EXPECT_TRUE(PLTComp.setImplementation(implementation));
+		PLTComp.compose(dst.data(), indices.data(), colors.data(), pixels);
+	}
+};
+
+GTEST_TEST(PLTCompositor, makeIndices) {
+	const byte layers     [] = { 0, 1, 9, 10, 255 };
+	const byte intensities[] = { 0, 2, 255, 3, 4 };
+
+	uint16_t indices[ARRAYSIZE(layers)];
+	PLTCompositor::makeIndices(indices, layers, intensities, ARRAYSIZE(layers));
+
+	EXPECT_EQ(indices[0], 0);
+	EXPECT_EQ(indices[1], 256 + 2);
+	EXPECT_EQ(indices[2], 9 * 256 + 255);
+
+	// Invalid layers are clamped to the last one
+	EXPECT_EQ(indices[3], 9 * 256 + 3);
+	EXPECT_EQ(indices[4], 9 * 256 + 4);
+}
+
+GTEST_TEST(PLTCompositor, scalar) {
+	PLTImage image(37);
+
+	std::vector<byte> dst;
+	image.compose(PLTCompositor::kImplementationScalar, dst);
+
+	for (size_t i = 0; i < image.pixels; i++)
+		EXPECT_EQ(std::memcmp(dst.data() + i * 4, &image.colors[image.indices[i]], 4), 0) << "At pixel " << i;
+}
+
+GTEST_TEST(PLTCompositor, implementations) {
+	const PLTCompositor::Implementation oldImplementation = PLTComp.getImplementation();
+
+	// A size that leaves a tail for the scalar code
+	PLTImage image(64 * 64 + 5);
+
+	std::vector<byte> reference, result;
+	image.compose(PLTCompositor::kImplementationScalar, reference);
+
+	for (int i = PLTCompositor::kImplementationScalar; i <= PLTCompositor::kImplementationAVX2; i++) {
+		const PLTCompositor::Implementation implementation = (PLTCompositor::Implementation) i;
+		if (!PLTCompositor::hasImplementation(implementation))
+			continue;
+
+		image.compose(implementation, result);
+
+		EXPECT_EQ(result, reference) << kImplementationNames[i];
+	}
+
+	PLTComp.setImplementation(oldImplementation);
+}
+
+GTEST_TEST(PLTCompositor, cache) {
+	PLTComp.clearCache();
+	PLTComp.setBudget(1024);
+
+	uint8_t colors[PLTCompositor::kLayerCount] = { 0 };
+
+	EXPECT_FALSE(PLTComp.getCached("foo", colors));
+
+	PLTCompositor::Image image = PLTComp.addCached("foo", colors, std::vector<byte>(400, 1));
+	ASSERT_TRUE(image);
+
+	// Same name (ignoring case) and colors, same image
+	EXPECT_EQ(PLTComp.getCached("FOO", colors), image);
+
+	// Different colors, different image
+	colors[5] = 1;
+	EXPECT_FALSE(PLTComp.getCached("foo", colors));
+
+	// Adding the same image twice gives back the first one
+	PLTCompositor::Image image2 = PLTComp.addCached("foo", colors, std::vector<byte>(400, 2));
+	EXPECT_EQ(PLTComp.addCached("foo", colors, std::vector<byte>(400, 3)), image2);
+	EXPECT_EQ((*image2)[0], 2);
+
+	colors[5] = 0;
+	EXPECT_EQ(PLTComp.getCached("foo", colors), image);
+
+	// Over budget: the least recently used image, image2, is dropped
+	PLTComp.addCached("bar", colors, std::vector<byte>(400, 4));
+
+	EXPECT_TRUE(PLTComp.getCached("foo", colors));
+	EXPECT_TRUE(PLTComp.getCached("bar", colors));
+	colors[5] = 1;
+	EXPECT_FALSE(PLTComp.getCached("foo", colors));
+
+	const PLTCompositor::Stats stats = PLTComp.getStats();
+	EXPECT_EQ(stats.images, 2);
+	EXPECT_EQ(stats.size, 800);
+
+	// Images larger than the budget are never cached
+	PLTComp.addCached("baz", colors, std::vector<byte>(2048, 5));
+	EXPECT_FALSE(PLTComp.getCached("baz", colors));
+
+	PLTComp.clearCache();
+	EXPECT_EQ(PLTComp.getStats().images, 0);
+	EXPECT_EQ(PLTComp.getStats().size, 0);
+}
+
+/* Compositing benchmark of a 512x512 creature texture, for each implementation,
+ * and of getting it out of the cache instead.
+ *
+ * Run with --gtest_also_run_disabled_tests.
+ */
+GTEST_TEST(PLTCompositor, DISABLED_benchmark) {
+	typedef std::chrono::steady_clock Clock;
+
+	static const int kIterations = 500;
+
+	PLTImage image(512 * 512);
+
+	const PLTCompositor::Implementation oldImplementation = PLTComp.getImplementation();
+
+	std::vector<byte> dst(image.pixels * 4);
+	for (int i = PLTCompositor::kImplementationScalar; i <= PLTCompositor::kImplementationAVX2; i++) {
+		const PLTCompositor::Implementation implementation = (PLTCompositor::Implementation) i;
+		if (!PLTCompositor::hasImplementation(implementation))
+			continue;
+
+		PLTComp.setImplementation(implementation);
+
+		const Clock::time_point start = Clock::now();
+		for (int n = 0; n < kIterations; n++)
+			PLTComp.compose(dst.data(), image.indices.data(), image.colors.data(), image.pixels);
+
+		const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		std::printf("%s: %.3f ms per 512x512 texture\n", kImplementationNames[i], elapsed / kIterations);
+	}
+
+	PLTComp.setImplementation(oldImplementation);
+
+	PLTComp.clearCache();
+	PLTComp.setBudget(16 * 1024 * 1024);
+
+	uint8_t colors[PLTCompositor::kLayerCount] = { 0 };
+	PLTComp.addCached("benchmark", colors, std::vector<byte>(dst));
+
+	// A cache hit still copies the image into the texture's surface
+	const Clock::time_point start = Clock::now();
+	for (int n = 0; n < kIterations; n++) {
+		PLTCompositor::Image cached = PLTComp.getCached("benchmark", colors);
+		ASSERT_TRUE(cached);
+
+		std::memcpy(dst.data(), cached->data(), dst.size());
+	}
+
+	const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	std::printf("Cached: %.3f ms per 512x512 texture\n", elapsed / kIterations);
+
+	PLTComp.clearCache();
+}
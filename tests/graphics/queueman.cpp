@@ -0,0 +1,311 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the graphics queue manager.
+ */
+
+#include <cstdio>
+
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "src/graphics/queueman.h"
+#include "src/graphics/queueable.h"
+
+static const Graphics::QueueType kQueue = Graphics::kQueueWorldObject;
+
+class TestQueueable : public Graphics::Queueable {
+public:
+	TestQueueable(int distance = 0) : _distance(distance) {
+	}
+
+	bool operator<(const Graphics::Queueable &q) const {
+		return _distance < static_cast<const TestQueueable &>(q)._distance;
+	}
+
+	void setDistance(int distance) {
+		_distance = distance;
+	}
+
+	int getDistance() const {
+		return _distance;
+	}
+
+	bool isIn() const {
+		return isInQueue(kQueue);
+	}
+
+	void add() {
+		addToQueue(kQueue);
+	}
+
+	void remove() {
+		removeFromQueue(kQueue);
+	}
+
+private:
+	int _distance;
+};
+
+/** Generate a random number between min (inclusive) and max (exclusive). */
+static int getRandom(std::mt19937 &rng, int min, int max) {
+	return std::uniform_int_distribution<int>(min, max - 1)(rng);
+}
+
+/** Return the objects in the queue, skipping empty slots. */
+static std::vector<TestQueueable *> getObjects() {
+	std::vector<TestQueueable *> objects;
+
+	Graphics::QueueMan.lockQueue(kQueue);
+
+	const std::vector<Graphics::Queueable *> &queue = Graphics::QueueMan.getQueue(kQueue);
+	for (size_t i = 0; i < queue.size(); i++)
+		if (queue[i])
+			objects.push_back(static_cast<TestQueueable *>(queue[i]));
+
+	Graphics::QueueMan.unlockQueue(kQueue);
+
+	return objects;
+}
+
+GTEST_TEST(QueueManager, addRemove) {
+	TestQueueable a, b, c;
+
+	EXPECT_TRUE(Graphics::QueueMan.isQueueEmpty(kQueue));
+
+	a.add();
+	b.add();
+	c.add();
+
+	// Adding twice is a no-op
+	b.add();
+
+	EXPECT_TRUE(a.isIn());
+	EXPECT_EQ(Graphics::QueueMan.getQueueSize(kQueue), 3);
+	EXPECT_EQ(getObjects(), (std::vector<TestQueueable *>{ &a, &b, &c }));
+
+	b.remove();
+
+	EXPECT_FALSE(b.isIn());
+	EXPECT_EQ(Graphics::QueueMan.getQueueSize(kQueue), 2);
+	EXPECT_EQ(getObjects(), (std::vector<TestQueueable *>{ &a, &c }));
+
+	// Removing twice is a no-op
+	b.remove();
+	EXPECT_EQ(Graphics::QueueMan.getQueueSize(kQueue), 2);
+
+	Graphics::QueueMan.clearQueue(kQueue);
+
+	EXPECT_FALSE(a.isIn());
+	EXPECT_FALSE(c.isIn());
+	EXPECT_TRUE(Graphics::QueueMan.isQueueEmpty(kQueue));
+}
+
+GTEST_TEST(QueueManager, destructorRemoves) {
+	TestQueueable a;
+
+	a.add();
+
+	{
+		TestQueueable b;
+		b.add();
+
+		EXPECT_EQ(Graphics::QueueMan.getQueueSize(kQueue), 2);
+	}
+
+	EXPECT_EQ(Graphics::QueueMan.getQueueSize(kQueue), 1);
+	EXPECT_EQ(getObjects(), (std::vector<TestQueueable *>{ &a }));
+
+	a.remove();
+}
+
+GTEST_TEST(QueueManager, removeWhileIterating) {
+	TestQueueable a, b, c, d;
+
+	a.add();
+	b.add();
+	c.add();
+	d.add();
+
+	Graphics::QueueMan.lockQueue(kQueue);
+
+	const std::vector<Graphics::Queueable *> &queue = Graphics::QueueMan.getQueue(kQueue);
+
+	std::vector<TestQueueable *> seen;
+	for (size_t i = 0; i < queue.size(); i++) {
+		if (!queue[i])
+			continue;
+
+		TestQueueable *q = static_cast<TestQueueable *>(queue[i]);
+		seen.push_back(q);
+
+		// Remove the current and the following object
+		if (q == &b) {
+			b.remove();
+			c.remove();
+		}
+	}
+
+	Graphics::QueueMan.unlockQueue(kQueue);
+
+	EXPECT_EQ(seen, (std::vector<TestQueueable *>{ &a, &b, &d }));
+
+	Graphics::QueueMan.compactQueue(kQueue);
+	EXPECT_EQ(Graphics::QueueMan.getQueue(kQueue).size(), 2);
+
+	// The indices need to be still correct after the compaction
+	d.remove();
+	EXPECT_EQ(getObjects(), (std::vector<TestQueueable *>{ &a }));
+
+	a.remove();
+	EXPECT_TRUE(Graphics::QueueMan.isQueueEmpty(kQueue));
+}
+
+GTEST_TEST(QueueManager, sort) {
+	TestQueueable a(3), b(1), c(2), d(1);
+
+	a.add();
+	b.add();
+	c.add();
+	d.add();
+
+	Graphics::QueueMan.sortQueue(kQueue);
+	EXPECT_EQ(getObjects(), (std::vector<TestQueueable *>{ &b, &d, &c, &a }));
+
+	// Sorting only happens when requested
+	a.setDistance(0);
+	EXPECT_FALSE(Graphics::QueueMan.sortQueueIfUnsorted(kQueue));
+	EXPECT_EQ(getObjects(), (std::vector<TestQueueable *>{ &b, &d, &c, &a }));
+
+	Graphics::QueueMan.markQueueUnsorted(kQueue);
+	EXPECT_TRUE(Graphics::QueueMan.sortQueueIfUnsorted(kQueue));
+	EXPECT_EQ(getObjects(), (std::vector<TestQueueable *>{ &a, &b, &d, &c }));
+
+	// The indices need to be still correct after sorting
+	b.remove();
+	EXPECT_EQ(getObjects(), (std::vector<TestQueueable *>{ &a, &d, &c }));
+
+	Graphics::QueueMan.clearQueue(kQueue);
+}
+
+GTEST_TEST(QueueManager, sortReversed) {
+	// Enough objects to overrun the insertion sort's budget
+	std::vector<TestQueueable> objects(100);
+	for (size_t i = 0; i < objects.size(); i++) {
+		objects[i].setDistance(objects.size() - i);
+		objects[i].add();
+	}
+
+	Graphics::QueueMan.sortQueue(kQueue);
+
+	const std::vector<TestQueueable *> sorted = getObjects();
+	ASSERT_EQ(sorted.size(), objects.size());
+
+	for (size_t i = 0; i < sorted.size(); i++)
+		EXPECT_EQ(sorted[i]->getDistance(), i + 1);
+
+	Graphics::QueueMan.clearQueue(kQueue);
+}
+
+GTEST_TEST(QueueManager, randomMix) {
+	std::mt19937 rng(0x1234);
+
+	std::vector<TestQueueable> objects(200);
+	std::list<TestQueueable *> reference;
+
+	for (size_t n = 0; n < 5000; n++) {
+		TestQueueable &q = objects[getRandom(rng, 0, objects.size())];
+
+		const int action = getRandom(rng, 0, 10);
+		if (action < 5) {
+			if (!q.isIn())
+				reference.push_back(&q);
+
+			q.add();
+		} else if (action < 9) {
+			reference.remove(&q);
+			q.remove();
+		} else
+			Graphics::QueueMan.compactQueue(kQueue);
+
+		ASSERT_EQ(getObjects(), std::vector<TestQueueable *>(reference.begin(), reference.end()));
+	}
+
+	Graphics::QueueMan.clearQueue(kQueue);
+}
+
+/* Not run by default. Run with --gtest_also_run_disabled_tests to get
+ * timings of a mix of adding, removing, sorting and iterating. */
+GTEST_TEST(QueueManager, DISABLED_benchmark) {
+	static const size_t kObjectCount = 10000;
+	static const size_t kFrameCount  = 1000;
+
+	std::mt19937 rng(0x1234);
+
+	std::vector<TestQueueable> objects(kObjectCount);
+	for (size_t i = 0; i < objects.size(); i++) {
+		objects[i].setDistance(getRandom(rng, 0, 100000));
+		objects[i].add();
+	}
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	size_t visited = 0;
+	for (size_t frame = 0; frame < kFrameCount; frame++) {
+		// Some objects leave and enter the queue
+		for (size_t i = 0; i < 100; i++) {
+			objects[getRandom(rng, 0, kObjectCount)].remove();
+			objects[getRandom(rng, 0, kObjectCount)].add();
+		}
+
+		// Some objects move a bit
+		for (size_t i = 0; i < 1000; i++) {
+			TestQueueable &q = objects[getRandom(rng, 0, kObjectCount)];
+			q.setDistance(q.getDistance() + getRandom(rng, -10, 11));
+		}
+
+		Graphics::QueueMan.markQueueUnsorted(kQueue);
+		Graphics::QueueMan.compactQueue(kQueue);
+		Graphics::QueueMan.sortQueueIfUnsorted(kQueue);
+
+		Graphics::QueueMan.lockQueue(kQueue);
+
+		const std::vector<Graphics::Queueable *> &queue = Graphics::QueueMan.getQueue(kQueue);
+		for (size_t i = 0; i < queue.size(); i++)
+			if (queue[i])
+				visited++;
+
+		Graphics::QueueMan.unlockQueue(kQueue);
+	}
+
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+	std::printf("%u frames, %u objects visited: %.3f ms per frame\n",
+	            (uint)kFrameCount, (uint)visited, ms / kFrameCount);
+
+	Graphics::QueueMan.clearQueue(kQueue);
+}
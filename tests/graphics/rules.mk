@@ -0,0 +1,73 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+# Unit tests for the Graphics namespace.
+
+graphics_LIBS = \
+    $(test_LIBS) \
+    src/graphics/libgraphics.la \
+    src/common/libcommon.la \
+    tests/version/libversion.la \
+    $(LDADD)
+
+# Everything the Aurora models need
+graphics_aurora_LIBS = \
+    $(test_LIBS) \
+    src/graphics/libgraphics.la \
+    src/aurora/libaurora.la \
+    src/common/libcommon.la \
+    src/events/libevents.la \
+    tests/version/libversion.la \
+    external/imgui/libimgui.la \
+    $(LDADD)
+
+check_PROGRAMS                           += tests/graphics/test_meshoptimizer
+tests_graphics_test_meshoptimizer_SOURCES  = tests/graphics/meshoptimizer.cpp
+tests_graphics_test_meshoptimizer_LDADD    = $(graphics_LIBS)
+tests_graphics_test_meshoptimizer_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                           += tests/graphics/test_meshquantizer
+tests_graphics_test_meshquantizer_SOURCES  = tests/graphics/meshquantizer.cpp
+tests_graphics_test_meshquantizer_LDADD    = $(graphics_LIBS)
+tests_graphics_test_meshquantizer_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                           += tests/graphics/test_modelinstance
+tests_graphics_test_modelinstance_SOURCES  = tests/graphics/modelinstance.cpp
+tests_graphics_test_modelinstance_LDADD    = $(graphics_aurora_LIBS)
+tests_graphics_test_modelinstance_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                           += tests/graphics/test_pltcompositor
+tests_graphics_test_pltcompositor_SOURCES  = tests/graphics/pltcompositor.cpp
+tests_graphics_test_pltcompositor_LDADD    = $(graphics_LIBS)
+tests_graphics_test_pltcompositor_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/graphics/test_queueman
+tests_graphics_test_queueman_SOURCES  = tests/graphics/queueman.cpp
+tests_graphics_test_queueman_LDADD    = $(graphics_LIBS)
+tests_graphics_test_queueman_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                          += tests/graphics/test_texturecache
+tests_graphics_test_texturecache_SOURCES  = tests/graphics/texturecache.cpp
+tests_graphics_test_texturecache_LDADD    = $(graphics_LIBS)
+tests_graphics_test_texturecache_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                         += tests/graphics/test_yuv_to_rgb
+tests_graphics_test_yuv_to_rgb_SOURCES  = tests/graphics/yuv_to_rgb.cpp
+tests_graphics_test_yuv_to_rgb_LDADD    = $(graphics_LIBS)
+tests_graphics_test_yuv_to_rgb_CXXFLAGS = $(test_CXXFLAGS)
@@ -0,0 +1,147 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the disk cache for decoded images.
+ */
+
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/platform.h"
+#include "src/common/memreadstream.h"
+
+#include "src/graphics/images/decoder.h"
+#include "src/graphics/images/texturecache.h"
+
+static boost::filesystem::path kCachePath;
+
+/** A small image with two layers, two mip maps each, and a TXI. */
+class TestImage : public Graphics::ImageDecoder {
+public:
+	TestImage() {
+		_format    = Graphics::kPixelFormatRGBA;
+		_formatRaw = Graphics::kPixelFormatRGBA8;
+		_dataType  = Graphics::kPixelDataType8;
+		_hasAlpha  = true;
+
+		_layerCount = 2;
+
+		for (size_t i = 0; i < 4; i++) {
+			_mipMaps.emplace_back(std::make_unique<MipMap>(this));
+
+			MipMap &mipMap = *_mipMaps.back();
+
+			mipMap.width  = (i % 2) ? 1 : 3;
+			mipMap.height = (i % 2) ? 1 : 2;
+			mipMap.size   = mipMap.width * mipMap.height * 4;
+			mipMap.data   = std::make_unique<byte[]>(mipMap.size);
+
+			for (size_t j = 0; j < mipMap.size; j++)
+				mipMap.data[j] = (byte) (i * 32 + j);
+		}
+
+		static const char *kTXI = "decal 1\nblending additive\n";
+
+		Common::MemoryReadStream txi(kTXI);
+		_txi.load(txi);
+	}
+};
+
+class TextureCache : public ::testing::Test {
+protected:
+	static void SetUpTestCase() {
+		Common::Platform::init();
+
+		boost::filesystem::path tmpPath    = boost::filesystem::temp_directory_path();
+		boost::filesystem::path uniquePath = boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+		kCachePath = tmpPath / uniquePath;
+	}
+
+	static void TearDownTestCase() {
+		if (!kCachePath.empty())
+			boost::filesystem::remove_all(kCachePath);
+	}
+};
+
+
+GTEST_TEST_F(TextureCache, key) {
+	static const byte kData1[] = { 0x01, 0x02, 0x03, 0x04 };
+	static const byte kData2[] = { 0x01, 0x02, 0x03, 0x05 };
+
+	Common::MemoryReadStream stream1(kData1, sizeof(kData1));
+	Common::MemoryReadStream stream2(kData2, sizeof(kData2));
+
+	const uint64_t key = Graphics::TextureCache::getKey(stream1, 0);
+
+	EXPECT_EQ(stream1.pos(), 0);
+
+	EXPECT_EQ(Graphics::TextureCache::getKey(stream1, 0), key);
+	EXPECT_NE(Graphics::TextureCache::getKey(stream1, 1), key);
+	EXPECT_NE(Graphics::TextureCache::getKey(stream2, 0), key);
+}
+
+GTEST_TEST_F(TextureCache, miss) {
+	Graphics::TextureCache cache(kCachePath.generic_string());
+
+	EXPECT_EQ(cache.load(0x1234), static_cast<Graphics::ImageDecoder *>(0));
+}
+
+GTEST_TEST_F(TextureCache, roundtrip) {
+	Graphics::TextureCache cache(kCachePath.generic_string());
+
+	const TestImage image;
+	cache.save(0x5678, image);
+
+	std::unique_ptr<Graphics::ImageDecoder> cached(cache.load(0x5678));
+	ASSERT_TRUE(cached);
+
+	EXPECT_EQ(cached->getFormat()   , image.getFormat());
+	EXPECT_EQ(cached->getFormatRaw(), image.getFormatRaw());
+	EXPECT_EQ(cached->getDataType() , image.getDataType());
+
+	EXPECT_EQ(cached->isCompressed(), image.isCompressed());
+	EXPECT_EQ(cached->hasAlpha()    , image.hasAlpha());
+	EXPECT_EQ(cached->isCubeMap()   , image.isCubeMap());
+
+	ASSERT_EQ(cached->getLayerCount() , image.getLayerCount());
+	ASSERT_EQ(cached->getMipMapCount(), image.getMipMapCount());
+
+	for (size_t i = 0; i < image.getLayerCount(); i++) {
+		for (size_t j = 0; j < image.getMipMapCount(); j++) {
+			const Graphics::ImageDecoder::MipMap &mipMap1 = image.getMipMap(j, i);
+			const Graphics::ImageDecoder::MipMap &mipMap2 = cached->getMipMap(j, i);
+
+			EXPECT_EQ(mipMap2.width , mipMap1.width ) << "At " << i << "." << j;
+			EXPECT_EQ(mipMap2.height, mipMap1.height) << "At " << i << "." << j;
+			ASSERT_EQ(mipMap2.size  , mipMap1.size  ) << "At " << i << "." << j;
+
+			EXPECT_EQ(std::memcmp(mipMap2.data.get(), mipMap1.data.get(), mipMap1.size), 0) << "At " << i << "." << j;
+		}
+	}
+
+	EXPECT_TRUE(cached->getTXI().getFeatures().decal);
+	EXPECT_EQ(cached->getTXI().getFeatures().blending, Graphics::TXI::kBlendingAdditive);
+}
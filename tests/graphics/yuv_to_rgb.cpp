@@ -0,0 +1,220 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our YUV to RGB conversion.
+ */
+
+#include <cstdio>
+#include <chrono>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+
+#include "src/graphics/yuv_to_rgb.h"
+
+typedef Graphics::YUVToRGBManager YUVToRGB;
+
+static const YUVToRGB::Implementation kImplementations[] = {
+	YUVToRGB::kImplementationSSE2,
+	YUVToRGB::kImplementationAVX2
+};
+
+static const char * const kImplementationNames[] = { "Table", "SSE2", "AVX2" };
+
+struct YUVImage {
+	int width, height;
+	int yPitch, uvPitch;
+
+	std::vector<byte> y, u, v, a;
+
+	YUVImage(int w, int h, int pad) : width(w), height(h), yPitch(w + pad), uvPitch((w >> 1) + pad),
+		y(yPitch * h), u(uvPitch * (h >> 1)), v(uvPitch * (h >> 1)), a(yPitch * h) {
+	}
+
+	void convert(YUVToRGB::Implementation implementation, YUVToRGB::LuminanceScale scale,
+	             std::vector<byte> &dst, bool alpha) const {
+
+		dst.assign(width * height * 4, 0);
+
+		EXPECT_TRUE(YUVToRGBMan.setImplementation(implementation));
+
+		if (alpha)
+			YUVToRGBMan.convert420(scale, dst.data(), width * 4, y.data(), u.data(), v.data(), a.data(),
+			                       width, height, yPitch, uvPitch);
+		else
+			YUVToRGBMan.convert420(scale, dst.data(), width * 4, y.data(), u.data(), v.data(),
+			                       width, height, yPitch, uvPitch);
+	}
+
+	/** Compare the available SIMD implementations against the lookup tables. */
+	void compare(YUVToRGB::LuminanceScale scale, bool alpha) const {
+		const YUVToRGB::Implementation oldImplementation = YUVToRGBMan.getImplementation();
+
+		std::vector<byte> reference, result;
+		convert(YUVToRGB::kImplementationTable, scale, reference, alpha);
+
+		for (size_t i = 0; i < ARRAYSIZE(kImplementations); i++) {
+			if (!YUVToRGB::hasImplementation(kImplementations[i]))
+				continue;
+
+			convert(kImplementations[i], scale, result, alpha);
+
+			for (size_t j = 0; j < reference.size(); j++) {
+				ASSERT_EQ(result[j], reference[j]) << kImplementationNames[kImplementations[i]] <<
+					", scale " << scale << ", alpha " << alpha << ", pixel " << (j / 4) << ", channel " << (j % 4);
+			}
+		}
+
+		YUVToRGBMan.setImplementation(oldImplementation);
+	}
+};
+
+static uint32_t randomByte(uint32_t &seed) {
+	seed = seed * 1664525 + 1013904223;
+	return seed >> 24;
+}
+
+GTEST_TEST(YUVToRGB, tableAvailable) {
+	EXPECT_TRUE(YUVToRGB::hasImplementation(YUVToRGB::kImplementationTable));
+}
+
+GTEST_TEST(YUVToRGB, random) {
+	// An odd number of 16 pixel blocks and a width that leaves a tail for the table code
+	YUVImage image(110, 34, 6);
+
+	uint32_t seed = 0xC0FFEE;
+	for (size_t i = 0; i < image.y.size(); i++) {
+		image.y[i] = randomByte(seed);
+		image.a[i] = randomByte(seed);
+	}
+	for (size_t i = 0; i < image.u.size(); i++) {
+		image.u[i] = randomByte(seed);
+		image.v[i] = randomByte(seed);
+	}
+
+	image.compare(YUVToRGB::kScaleFull, false);
+	image.compare(YUVToRGB::kScaleFull, true);
+	image.compare(YUVToRGB::kScaleITU , false);
+	image.compare(YUVToRGB::kScaleITU , true);
+}
+
+GTEST_TEST(YUVToRGB, oddWidth) {
+	// The last column has no chroma partner, and nothing may be written past it
+	static const int kWidth = 37, kHeight = 4, kPitch = (kWidth + 1) * 4;
+
+	YUVImage image(kWidth, kHeight, 0);
+	for (size_t i = 0; i < image.y.size(); i++)
+		image.y[i] = 0x80;
+	for (size_t i = 0; i < image.u.size(); i++)
+		image.u[i] = image.v[i] = 0x80;
+
+	const YUVToRGB::Implementation oldImplementation = YUVToRGBMan.getImplementation();
+
+	for (int i = YUVToRGB::kImplementationTable; i <= YUVToRGB::kImplementationAVX2; i++) {
+		const YUVToRGB::Implementation implementation = (YUVToRGB::Implementation) i;
+		if (!YUVToRGB::hasImplementation(implementation))
+			continue;
+
+		YUVToRGBMan.setImplementation(implementation);
+
+		std::vector<byte> dst(kPitch * kHeight, 0xAB);
+		YUVToRGBMan.convert420(YUVToRGB::kScaleFull, dst.data(), kPitch, image.y.data(), image.u.data(),
+		                       image.v.data(), image.width, image.height, image.yPitch, image.uvPitch);
+
+		for (int y = 0; y < kHeight; y++) {
+			for (int x = kWidth - 1; x <= kWidth; x++)
+				for (int c = 0; c < 4; c++)
+					EXPECT_EQ(dst[y * kPitch + x * 4 + c], 0xAB) << kImplementationNames[i] <<
+						", row " << y << ", column " << x;
+
+			EXPECT_EQ(dst[y * kPitch + (kWidth - 2) * 4 + 3], 0xFF) << kImplementationNames[i] << ", row " << y;
+		}
+	}
+
+	YUVToRGBMan.setImplementation(oldImplementation);
+}
+
+GTEST_TEST(YUVToRGB, exhaustive) {
+	// One 2x2 block for each chroma pair
+	YUVImage image(512, 512, 0);
+
+	for (int i = 0; i < 256; i++) {
+		for (int j = 0; j < 256; j++) {
+			image.u[i * image.uvPitch + j] = i;
+			image.v[i * image.uvPitch + j] = j;
+		}
+	}
+
+	// Go through all luma values for every chroma pair, four at a time
+	for (int pass = 0; pass < 64; pass++) {
+		for (int i = 0; i < 512; i++)
+			for (int j = 0; j < 512; j++)
+				image.y[i * image.yPitch + j] = pass * 4 + ((i & 1) << 1) + (j & 1) + i + j;
+
+		image.compare(YUVToRGB::kScaleFull, false);
+		image.compare(YUVToRGB::kScaleITU , false);
+	}
+}
+
+/* Conversion benchmark of a 720p frame, for each implementation.
+ *
+ * Run with --gtest_also_run_disabled_tests.
+ */
+GTEST_TEST(YUVToRGB, DISABLED_benchmark) {
+	typedef std::chrono::steady_clock Clock;
+
+	static const int kIterations = 200;
+
+	YUVImage image(1280, 720, 0);
+
+	uint32_t seed = 0xC0FFEE;
+	for (size_t i = 0; i < image.y.size(); i++)
+		image.y[i] = randomByte(seed);
+	for (size_t i = 0; i < image.u.size(); i++) {
+		image.u[i] = randomByte(seed);
+		image.v[i] = randomByte(seed);
+	}
+
+	const YUVToRGB::Implementation oldImplementation = YUVToRGBMan.getImplementation();
+
+	std::vector<byte> dst(image.width * image.height * 4);
+	for (int i = YUVToRGB::kImplementationTable; i <= YUVToRGB::kImplementationAVX2; i++) {
+		const YUVToRGB::Implementation implementation = (YUVToRGB::Implementation) i;
+		if (!YUVToRGB::hasImplementation(implementation))
+			continue;
+
+		YUVToRGBMan.setImplementation(implementation);
+
+		const Clock::time_point start = Clock::now();
+		for (int n = 0; n < kIterations; n++)
+			YUVToRGBMan.convert420(YUVToRGB::kScaleITU, dst.data(), image.width * 4,
+			                       image.y.data(), image.u.data(), image.v.data(),
+			                       image.width, image.height, image.yPitch, image.uvPitch);
+
+		const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		std::printf("%s: %.3f ms per 1280x720 frame\n", kImplementationNames[i], elapsed / kIterations);
+	}
+
+	YUVToRGBMan.setImplementation(oldImplementation);
+}
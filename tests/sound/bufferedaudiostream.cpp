@@ -0,0 +1,146 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our BufferedAudioStream and DecoderThread classes.
+ */
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/sound/audiostream.h"
+#include "src/sound/bufferedaudiostream.h"
+#include "src/sound/decoderthread.h"
+
+/** A stereo test stream counting up. */
+class CountingStream : public Sound::AudioStream {
+public:
+	CountingStream(size_t length) : _length(length), _pos(0) {
+	}
+
+	size_t readBuffer(int16_t *buffer, const size_t numSamples) {
+		size_t n = 0;
+		for (; (n < numSamples) && (_pos < _length); n++, _pos++)
+			buffer[n] = (int16_t) _pos;
+
+		return n;
+	}
+
+	int getChannels() const { return 2; }
+	int getRate() const { return 22050; }
+
+	bool endOfData() const { return _pos >= _length; }
+
+private:
+	size_t _length;
+	size_t _pos;
+};
+
+GTEST_TEST(BufferedAudioStream, decode) {
+	Sound::BufferedAudioStream stream(new CountingStream(100), true, 64);
+
+	EXPECT_EQ(stream.getChannels(), 2);
+	EXPECT_EQ(stream.getRate(), 22050);
+
+	// Nothing decoded yet
+	EXPECT_TRUE(stream.endOfData());
+	EXPECT_FALSE(stream.endOfStream());
+
+	EXPECT_EQ(stream.decode(10), 10);
+	EXPECT_EQ(stream.decode(), 54);
+	EXPECT_EQ(stream.decode(), 0);
+
+	int16_t buffer[100];
+	ASSERT_EQ(stream.readBuffer(buffer, 100), 64);
+
+	EXPECT_EQ(stream.decode(), 36);
+	EXPECT_FALSE(stream.endOfStream());
+
+	ASSERT_EQ(stream.readBuffer(buffer + 64, 100), 36);
+	for (size_t i = 0; i < 100; i++)
+		EXPECT_EQ(buffer[i], (int16_t) i) << "At index " << i;
+
+	// All data has been read and the wrapped stream has ended
+	EXPECT_EQ(stream.decode(), 0);
+	EXPECT_TRUE(stream.endOfData());
+	EXPECT_TRUE(stream.endOfStream());
+}
+
+GTEST_TEST(BufferedAudioStream, stop) {
+	Sound::BufferedAudioStream stream(new CountingStream(100), true, 64);
+
+	EXPECT_EQ(stream.decode(20), 20);
+
+	stream.stop();
+	EXPECT_EQ(stream.decode(), 0);
+
+	// The already decoded data can still be read
+	EXPECT_FALSE(stream.endOfStream());
+
+	int16_t buffer[100];
+	EXPECT_EQ(stream.readBuffer(buffer, 100), 20);
+	EXPECT_TRUE(stream.endOfStream());
+}
+
+GTEST_TEST(DecoderThread, decode) {
+	static const size_t kLength = 200000;
+
+	Sound::DecoderThread decoder;
+	decoder.start();
+
+	std::shared_ptr<Sound::BufferedAudioStream> stream =
+		std::make_shared<Sound::BufferedAudioStream>(new CountingStream(kLength), true, 1024);
+
+	decoder.add(stream);
+
+	size_t read = 0, errors = 0;
+	int16_t buffer[512];
+
+	const std::chrono::steady_clock::time_point timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+
+	while (!stream->endOfStream() && (std::chrono::steady_clock::now() < timeout)) {
+		const size_t n = stream->readBuffer(buffer, 512);
+		if (n == 0) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		for (size_t i = 0; i < n; i++)
+			if (buffer[i] != (int16_t) (read + i))
+				errors++;
+
+		read += n;
+		decoder.wake();
+	}
+
+	decoder.remove(stream);
+	stream->stop();
+
+	decoder.stop();
+
+	EXPECT_EQ(read, kLength);
+	EXPECT_EQ(errors, 0);
+
+	EXPECT_EQ(decoder.getStats().samples, kLength);
+}
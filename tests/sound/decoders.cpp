@@ -0,0 +1,555 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests and throughput benchmarks for our sound decoders.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <functional>
+
+#include "gtest/gtest.h"
+
+#include "src/common/types.h"
+#include "src/common/util.h"
+#include "src/common/maths.h"
+#include "src/common/error.h"
+#include "src/common/ustring.h"
+#include "src/common/filepath.h"
+#include "src/common/filelist.h"
+#include "src/common/readfile.h"
+#include "src/common/memreadstream.h"
+
+#include "src/sound/audiostream.h"
+#include "src/sound/xactwavebank_binary.h"
+
+#include "src/sound/decoders/util.h"
+#include "src/sound/decoders/pcm.h"
+#include "src/sound/decoders/adpcm.h"
+#include "src/sound/decoders/asf.h"
+#include "src/sound/decoders/wwriffvorbis.h"
+#ifdef ENABLE_MAD
+#include "src/sound/decoders/mp3.h"
+#endif
+#ifdef ENABLE_VORBIS
+#include "src/sound/decoders/vorbis.h"
+#endif
+#ifdef ENABLE_FAAD
+#include "src/sound/decoders/aac.h"
+#endif
+
+// .--- Allocation counting
+
+/* Count all heap allocations in this test binary, so that the benchmarks
+ * can report how many allocations a decoder does. */
+
+static std::atomic<size_t> allocationCount(0);
+static std::atomic<size_t> allocationSize(0);
+
+/* Don't let the compiler inline the replaced operators. GCC would then see
+ * memory from operator new being handed to free() and warn about it. */
+#if defined(__GNUC__)
+	#define ALLOCATOR_NOINLINE __attribute__((noinline))
+#else
+	#define ALLOCATOR_NOINLINE
+#endif
+
+ALLOCATOR_NOINLINE void *operator new(std::size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocationSize.fetch_add(size, std::memory_order_relaxed);
+
+	void *ptr = std::malloc(size ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+ALLOCATOR_NOINLINE void *operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+ALLOCATOR_NOINLINE void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+
+ALLOCATOR_NOINLINE void operator delete[](void *ptr) noexcept {
+	std::free(ptr);
+}
+
+ALLOCATOR_NOINLINE void operator delete(void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+ALLOCATOR_NOINLINE void operator delete[](void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+// '---
+
+// .--- Generated input
+
+static const int kRate     = 44100;
+static const int kChannels = 2;
+
+/** Pseudo-random bytes, which are valid (if noisy) input for all ADPCM variants. */
+static std::vector<byte> randomData(size_t size) {
+	std::vector<byte> data(size);
+
+	// A simple, deterministic LCG, so that all runs decode the same data
+	uint32_t state = 0x12345678;
+	for (size_t i = 0; i < size; i++) {
+		state = state * 1664525 + 1013904223;
+		data[i] = state >> 24;
+	}
+
+	return data;
+}
+
+/** Return a stereo sine wave. */
+static std::vector<int16_t> sineWave(size_t length) {
+	std::vector<int16_t> samples(length * kChannels);
+
+	for (size_t i = 0; i < length; i++) {
+		samples[i * kChannels + 0] = (int16_t) (10000.0 * std::sin(2.0 * M_PI * 440.0 * i / kRate));
+		samples[i * kChannels + 1] = (int16_t) ( 8000.0 * std::sin(2.0 * M_PI * 660.0 * i / kRate));
+	}
+
+	return samples;
+}
+
+static const uint16_t kIMAStepTable[89] = {
+	    7,    8,    9,   10,   11,   12,   13,   14,
+	   16,   17,   19,   21,   23,   25,   28,   31,
+	   34,   37,   41,   45,   50,   55,   60,   66,
+	   73,   80,   88,   97,  107,  118,  130,  143,
+	  157,  173,  190,  209,  230,  253,  279,  307,
+	  337,  371,  408,  449,  494,  544,  598,  658,
+	  724,  796,  876,  963, 1060, 1166, 1282, 1411,
+	 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+	 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+	 7132, 7845, 8630, 9493,10442,11487,12635,13899,
+	15289,16818,18500,20350,22385,24623,27086,29794,
+	32767
+};
+
+/** The IMA ADPCM state of one channel. */
+struct IMAState {
+	int32_t last;
+	int32_t stepIndex;
+};
+
+static int32_t decodeIMA(IMAState &state, byte code) {
+	static const int8_t kAdjust[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+	const int32_t e = (2 * (code & 0x7) + 1) * kIMAStepTable[state.stepIndex] / 8;
+
+	state.last      = CLIP<int32_t>(state.last + ((code & 0x8) ? -e : e), -32768, 32767);
+	state.stepIndex = CLIP<int32_t>(state.stepIndex + kAdjust[code & 0x7], 0, 88);
+
+	return state.last;
+}
+
+/** Find the code that gets closest to the sample, and advance the state with it. */
+static byte encodeIMA(IMAState &state, int16_t sample) {
+	byte bestCode = 0;
+	int32_t bestError = INT32_MAX;
+
+	for (byte code = 0; code < 16; code++) {
+		IMAState test = state;
+
+		const int32_t error = ABS(decodeIMA(test, code) - sample);
+		if (error < bestError) {
+			bestError = error;
+			bestCode  = code;
+		}
+	}
+
+	decodeIMA(state, bestCode);
+	return bestCode;
+}
+
+/** Encode interleaved stereo samples into Microsoft IMA ADPCM blocks. */
+static std::vector<byte> encodeMSIMA(const std::vector<int16_t> &samples, uint32_t blockAlign) {
+	const size_t samplesPerBlock = ((blockAlign - 4 * kChannels) * 2) / kChannels;
+	const size_t blocks = (samples.size() / kChannels) / samplesPerBlock;
+
+	std::vector<byte> data;
+	data.reserve(blocks * blockAlign);
+
+	IMAState state[kChannels] = { { 0, 0 }, { 0, 0 } };
+
+	for (size_t b = 0; b < blocks; b++) {
+		const int16_t *block = samples.data() + b * samplesPerBlock * kChannels;
+
+		for (int c = 0; c < kChannels; c++) {
+			data.push_back( state[c].last       & 0xFF);
+			data.push_back((state[c].last >> 8) & 0xFF);
+			data.push_back( state[c].stepIndex);
+			data.push_back(0);
+		}
+
+		for (size_t i = 0; i < samplesPerBlock; i += 8) {
+			for (int c = 0; c < kChannels; c++) {
+				for (size_t j = 0; j < 8; j += 2) {
+					const byte low  = encodeIMA(state[c], block[(i + j    ) * kChannels + c]);
+					const byte high = encodeIMA(state[c], block[(i + j + 1) * kChannels + c]);
+
+					data.push_back(low | (high << 4));
+				}
+			}
+		}
+	}
+
+	return data;
+}
+
+// '---
+
+/** Read the stream into a null sink, returning the number of samples read. */
+static size_t drain(Sound::AudioStream &stream) {
+	static int16_t buffer[4096 * 6];
+
+	// Request whole sample frames, as some decoders insist on it
+	const size_t frame = MAX(stream.getChannels(), 1);
+	const size_t count = ARRAYSIZE(buffer) - (ARRAYSIZE(buffer) % frame);
+
+	size_t samples = 0;
+	while (!stream.endOfData()) {
+		const size_t n = stream.readBuffer(buffer, count);
+		if ((n == 0) || (n == Sound::AudioStream::kSizeInvalid))
+			break;
+
+		samples += n;
+	}
+
+	return samples;
+}
+
+static std::vector<int16_t> readAll(Sound::AudioStream &stream) {
+	std::vector<int16_t> samples;
+
+	int16_t buffer[1024];
+	while (!stream.endOfData()) {
+		const size_t n = stream.readBuffer(buffer, ARRAYSIZE(buffer));
+		if ((n == 0) || (n == Sound::AudioStream::kSizeInvalid))
+			break;
+
+		samples.insert(samples.end(), buffer, buffer + n);
+	}
+
+	return samples;
+}
+
+static Sound::RewindableAudioStream *makeADPCM(const std::vector<byte> &data, Sound::ADPCMTypes type,
+                                               uint32_t blockAlign) {
+
+	return Sound::makeADPCMStream(new Common::MemoryReadStream(data.data(), data.size()), true,
+	                              data.size(), type, kRate, kChannels, blockAlign);
+}
+
+GTEST_TEST(SoundDecoders, msIMARoundTrip) {
+	static const uint32_t kBlockAlign = 1024;
+
+	const std::vector<int16_t> input = sineWave(kRate);
+	const std::vector<byte> data = encodeMSIMA(input, kBlockAlign);
+
+	std::unique_ptr<Sound::RewindableAudioStream> stream(makeADPCM(data, Sound::kADPCMMSIma, kBlockAlign));
+	ASSERT_TRUE(stream);
+
+	const std::vector<int16_t> output = readAll(*stream);
+	ASSERT_EQ(output.size(), stream->getLength() * kChannels);
+	ASSERT_LE(output.size(), input.size());
+
+	double error = 0.0;
+	for (size_t i = 0; i < output.size(); i++)
+		error += ABS(output[i] - input[i]);
+
+	// A clean sine wave should come through IMA ADPCM with only a little noise
+	EXPECT_LT(error / output.size(), 100.0);
+}
+
+GTEST_TEST(SoundDecoders, adpcmLength) {
+	static const Sound::ADPCMTypes kTypes[]      = { Sound::kADPCMMSIma, Sound::kADPCMMS, Sound::kADPCMXbox };
+	static const uint32_t          kBlockAligns[] = { 1024, 1024, 36 };
+
+	// Whole blocks for all block sizes
+	const std::vector<byte> data = randomData(9216 * 2);
+
+	for (size_t i = 0; i < ARRAYSIZE(kTypes); i++) {
+		std::unique_ptr<Sound::RewindableAudioStream> stream(makeADPCM(data, kTypes[i], kBlockAligns[i]));
+		ASSERT_TRUE(stream);
+
+		EXPECT_EQ(drain(*stream), stream->getLength() * kChannels) << "ADPCM type " << kTypes[i];
+	}
+}
+
+GTEST_TEST(SoundDecoders, floatToInt16Interleave) {
+	static const float kValues[] = {
+		0.0f, -0.0f, 0.5f, -0.5f, 1.5f, -1.5f, 2.5f, -2.5f, 0.49999997f, -0.49999997f,
+		100.25f, -100.75f, 32766.5f, 32767.0f, 32767.5f, 32768.0f, 1.0e9f,
+		-32767.5f, -32768.0f, -32768.5f, -32769.0f, -1.0e9f, 1234.5f, -1234.5f, 0.75f
+	};
+
+	static const size_t kLength = ARRAYSIZE(kValues);
+
+	// Make the channels differ, and try all channel counts we special-case and then some
+	for (uint8_t channels = 1; channels <= 3; channels++) {
+		std::vector<float> planar(kLength * channels);
+		const float *src[3];
+
+		for (uint8_t c = 0; c < channels; c++) {
+			for (size_t i = 0; i < kLength; i++)
+				planar[c * kLength + i] = kValues[(i + c * 7) % kLength];
+
+			src[c] = planar.data() + c * kLength;
+		}
+
+		std::vector<int16_t> interleaved(kLength * channels);
+		Sound::floatToInt16Interleave(interleaved.data(), src, kLength, channels);
+
+		for (size_t i = 0; i < kLength; i++)
+			for (uint8_t c = 0; c < channels; c++)
+				EXPECT_EQ(interleaved[i * channels + c], Sound::floatToInt16(src[c][i]))
+					<< "At index " << i << ", channel " << (int) c << ", of " << (int) channels;
+	}
+}
+
+// .--- Benchmarks
+
+/** Decode whole streams, and print throughput (in sample frames) and allocation statistics.
+ *
+ *  makeStream is called until it returns 0, and all streams it returns are decoded.
+ */
+static void benchmark(const Common::UString &name, const std::function<Sound::AudioStream *(size_t)> &makeStream) {
+	typedef std::chrono::steady_clock Clock;
+
+	const size_t allocations = allocationCount.load();
+	const size_t allocated   = allocationSize.load();
+
+	const Clock::time_point start = Clock::now();
+
+	double frames   = 0.0;
+	double duration = 0.0;
+
+	try {
+		for (size_t i = 0; ; i++) {
+			std::unique_ptr<Sound::AudioStream> stream(makeStream(i));
+			if (!stream)
+				break;
+
+			const int channels = stream->getChannels();
+			const int rate     = stream->getRate();
+
+			const size_t samples = drain(*stream);
+			if ((channels <= 0) || (rate <= 0))
+				continue;
+
+			frames   += (double) samples / channels;
+			duration += (double) samples / channels / rate;
+		}
+
+	} catch (const Common::Exception &e) {
+		std::printf("%-32s: %s\n", name.c_str(), e.what());
+		return;
+	}
+
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	if ((frames <= 0.0) || (seconds <= 0.0)) {
+		std::printf("%-32s: No samples\n", name.c_str());
+		return;
+	}
+
+	std::printf("%-32s: %12.0f samples/s, %8.1fx realtime, %8zu allocations (%zu KiB)\n",
+	            name.c_str(), frames / seconds, duration / seconds,
+	            allocationCount.load() - allocations, (allocationSize.load() - allocated) / 1024);
+}
+
+/** Decode a single whole stream, and print throughput and allocation statistics. */
+static void benchmark(const Common::UString &name, const std::function<Sound::AudioStream *()> &makeStream) {
+	benchmark(name, [&makeStream](size_t i) {
+		return (i == 0) ? makeStream() : 0;
+	});
+}
+
+static Common::SeekableReadStream *openMemory(const std::vector<byte> &data) {
+	return new Common::MemoryReadStream(data.data(), data.size());
+}
+
+/* Throughput of the decoders we can feed with generated data: one minute
+ * of random stereo sound at 44.1kHz.
+ *
+ * Run with --gtest_also_run_disabled_tests.
+ */
+GTEST_TEST(SoundDecoders, DISABLED_benchmarkGenerated) {
+	static const size_t kLength = 60 * kRate;
+
+	const std::vector<byte> pcm   = randomData(kLength * kChannels * 2);
+	const std::vector<byte> adpcm = randomData(kLength * kChannels / 2);
+
+	benchmark("PCM", [&pcm]() {
+		return Sound::makePCMStream(openMemory(pcm), kRate, Sound::FLAG_16BITS | Sound::FLAG_LITTLE_ENDIAN, kChannels);
+	});
+
+	benchmark("ADPCM (Microsoft IMA)", [&adpcm]() {
+		return makeADPCM(adpcm, Sound::kADPCMMSIma, 1024);
+	});
+
+	benchmark("ADPCM (Microsoft)", [&adpcm]() {
+		return makeADPCM(adpcm, Sound::kADPCMMS, 1024);
+	});
+
+	benchmark("ADPCM (Apple)", [&adpcm]() {
+		return makeADPCM(adpcm, Sound::kADPCMApple, 34);
+	});
+
+	benchmark("ADPCM (Xbox)", [&adpcm]() {
+		return makeADPCM(adpcm, Sound::kADPCMXbox, 36);
+	});
+}
+
+#ifdef ENABLE_FAAD
+/** Decode a raw AAC file with ADTS headers, queueing its frames as packets. */
+static Sound::AudioStream *makeADTSStream(const std::vector<byte> &data) {
+	std::unique_ptr<Sound::PacketizedAudioStream> stream;
+
+	size_t pos = 0;
+	while ((pos + 7) <= data.size()) {
+		const byte *header = data.data() + pos;
+		if ((header[0] != 0xFF) || ((header[1] & 0xF0) != 0xF0))
+			throw Common::Exception("Invalid ADTS sync word");
+
+		const size_t headerSize = (header[1] & 0x01) ? 7 : 9;
+		const size_t frameSize  = ((header[3] & 0x03) << 11) | (header[4] << 3) | (header[5] >> 5);
+		if ((frameSize <= headerSize) || ((pos + frameSize) > data.size()))
+			break;
+
+		if (!stream) {
+			// Build the AudioSpecificConfig out of the first header
+			const byte objectType = ((header[2] >> 6) & 0x03) + 1;
+			const byte rateIndex  =  (header[2] >> 2) & 0x0F;
+			const byte channels   = ((header[2] & 0x01) << 2) | (header[3] >> 6);
+
+			const byte config[2] = {
+				(byte) ((objectType << 3) | (rateIndex >> 1)),
+				(byte) (((rateIndex & 0x01) << 7) | (channels << 3))
+			};
+
+			Common::MemoryReadStream extraData(config);
+			stream.reset(Sound::makeAACStream(extraData));
+		}
+
+		stream->queuePacket(new Common::MemoryReadStream(header + headerSize, frameSize - headerSize));
+		pos += frameSize;
+	}
+
+	if (!stream)
+		throw Common::Exception("No ADTS frames");
+
+	stream->finish();
+	return stream.release();
+}
+#endif
+
+/** Create a decoder for a sound file, by its extension. */
+static Sound::AudioStream *makeFileStream(const Common::UString &extension, const std::vector<byte> &data) {
+	if (extension.equalsIgnoreCase(".wma") || extension.equalsIgnoreCase(".asf"))
+		return Sound::makeASFStream(openMemory(data));
+
+	if (extension.equalsIgnoreCase(".wem"))
+		return Sound::makeWwRIFFVorbisStream(openMemory(data), true);
+
+#ifdef ENABLE_VORBIS
+	if (extension.equalsIgnoreCase(".ogg"))
+		return Sound::makeVorbisStream(openMemory(data), true);
+#endif
+
+#ifdef ENABLE_MAD
+	if (extension.equalsIgnoreCase(".mp3"))
+		return Sound::makeMP3Stream(openMemory(data), true);
+#endif
+
+#ifdef ENABLE_FAAD
+	if (extension.equalsIgnoreCase(".aac"))
+		return makeADTSStream(data);
+#endif
+
+	return 0;
+}
+
+/* Throughput of the decoders that need real sound files: WMA (in ASF),
+ * Wwise RIFF/RIFX Vorbis (.wem), Ogg Vorbis, MP3, AAC (raw, with ADTS
+ * headers) and binary XACT wavebanks (.xwb). Point the environment variable XOREOS_SOUND_SAMPLES at a
+ * directory of such files.
+ *
+ * Run with --gtest_also_run_disabled_tests.
+ */
+GTEST_TEST(SoundDecoders, DISABLED_benchmarkFiles) {
+	const char *directory = std::getenv("XOREOS_SOUND_SAMPLES");
+	if (!directory)
+		GTEST_SKIP() << "XOREOS_SOUND_SAMPLES not set";
+
+	Common::FileList files;
+	if (!files.addDirectory(directory))
+		GTEST_SKIP() << "Can't read directory \"" << directory << "\"";
+
+	files.sort(true);
+
+	for (Common::FileList::const_iterator f = files.begin(); f != files.end(); ++f) {
+		Common::ReadFile file(*f);
+
+		std::vector<byte> data(file.size());
+		if (file.read(data.data(), data.size()) != data.size())
+			continue;
+
+		const Common::UString extension = Common::FilePath::getExtension(*f);
+		const Common::UString name      = Common::FilePath::getFile(*f);
+
+		if (extension.equalsIgnoreCase(".xwb")) {
+			// All waves in an XACT wavebank, as found in the Xbox ports. Mostly WMA and Xbox ADPCM
+			std::unique_ptr<Sound::XACTWaveBank> bank;
+			try {
+				bank = std::make_unique<Sound::XACTWaveBank_Binary>(openMemory(data));
+			} catch (const Common::Exception &e) {
+				std::printf("%-32s: %s\n", name.c_str(), e.what());
+				continue;
+			}
+
+			benchmark(name, [&bank](size_t i) {
+				return (i < bank->getWaveCount()) ? bank->getWave(i) : 0;
+			});
+
+			continue;
+		}
+
+		benchmark(name, [&extension, &data]() {
+			return makeFileStream(extension, data);
+		});
+	}
+}
+
+// '---
@@ -0,0 +1,247 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our PCMCache class.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/sound/pcmcache.h"
+#include "src/sound/audiostream.h"
+
+/** A mono test stream counting up from a start value. */
+class RampStream : public Sound::RewindableAudioStream {
+public:
+	RampStream(size_t length, int16_t start = 0, int rate = 1000) :
+		_length(length), _start(start), _rate(rate), _pos(0) {
+	}
+
+	size_t readBuffer(int16_t *buffer, const size_t numSamples) {
+		size_t n = 0;
+		for (; (n < numSamples) && (_pos < _length); n++, _pos++)
+			buffer[n] = _start + _pos;
+
+		return n;
+	}
+
+	int getChannels() const { return 1; }
+	int getRate() const { return _rate; }
+
+	bool endOfData() const { return _pos >= _length; }
+
+	bool rewind() {
+		_pos = 0;
+		return true;
+	}
+
+	uint64_t getLength() const { return _length; }
+
+private:
+	size_t _length;
+	int16_t _start;
+	int _rate;
+
+	size_t _pos;
+};
+
+/** A test stream that can't be rewound and doesn't know its length. */
+class EndlessStream : public Sound::AudioStream {
+public:
+	size_t readBuffer(int16_t *buffer, const size_t numSamples) {
+		for (size_t i = 0; i < numSamples; i++)
+			buffer[i] = 0;
+
+		return numSamples;
+	}
+
+	int getChannels() const { return 1; }
+	int getRate() const { return 1000; }
+
+	bool endOfData() const { return false; }
+};
+
+static std::vector<int16_t> readAll(Sound::AudioStream &stream) {
+	std::vector<int16_t> samples;
+
+	int16_t buffer[7];
+	while (!stream.endOfData()) {
+		const size_t n = stream.readBuffer(buffer, 7);
+		if (n == 0)
+			break;
+
+		samples.insert(samples.end(), buffer, buffer + n);
+	}
+
+	return samples;
+}
+
+static void expectRamp(Sound::AudioStream &stream, size_t length, int16_t start = 0) {
+	const std::vector<int16_t> samples = readAll(stream);
+
+	ASSERT_EQ(samples.size(), length);
+	for (size_t i = 0; i < length; i++)
+		EXPECT_EQ(samples[i], start + (int16_t) i) << "At index " << i;
+}
+
+GTEST_TEST(PCMCache, add) {
+	Sound::PCMCache cache(1024, 1000);
+
+	std::unique_ptr<Sound::AudioStream> stream(cache.add("ramp", new RampStream(100)));
+	ASSERT_TRUE(stream);
+
+	EXPECT_EQ(stream->getChannels(), 1);
+	EXPECT_EQ(stream->getRate(), 1000);
+	expectRamp(*stream, 100);
+
+	const Sound::PCMCache::Stats stats = cache.getStats();
+	EXPECT_EQ(stats.count, 1);
+	EXPECT_EQ(stats.size, 200);
+	EXPECT_EQ(stats.uncacheable, 0);
+}
+
+GTEST_TEST(PCMCache, get) {
+	Sound::PCMCache cache(1024, 1000);
+
+	EXPECT_FALSE(cache.get("ramp"));
+
+	delete cache.add("ramp", new RampStream(100, 5));
+
+	std::unique_ptr<Sound::RewindableAudioStream> stream1(cache.get("ramp"));
+	std::unique_ptr<Sound::RewindableAudioStream> stream2(cache.get("RAMP"));
+	ASSERT_TRUE(stream1);
+	ASSERT_TRUE(stream2);
+
+	EXPECT_EQ(stream1->getLength(), 100);
+	EXPECT_EQ(stream1->getDuration(), 100);
+
+	// Streams on the same sound are independent
+	expectRamp(*stream1, 100, 5);
+	expectRamp(*stream2, 100, 5);
+
+	EXPECT_TRUE(stream1->rewind());
+	expectRamp(*stream1, 100, 5);
+
+	const Sound::PCMCache::Stats stats = cache.getStats();
+	EXPECT_EQ(stats.hits, 2);
+	EXPECT_EQ(stats.misses, 1);
+}
+
+GTEST_TEST(PCMCache, uncacheable) {
+	Sound::PCMCache cache(1024, 1000);
+
+	// Too long
+	RampStream *ramp1 = new RampStream(1001);
+	std::unique_ptr<Sound::AudioStream> stream1(cache.add("long", ramp1));
+	EXPECT_EQ(stream1.get(), ramp1);
+
+	// Too big
+	RampStream *ramp2 = new RampStream(600, 0, 1000000);
+	std::unique_ptr<Sound::AudioStream> stream2(cache.add("big", ramp2));
+	EXPECT_EQ(stream2.get(), ramp2);
+
+	// Unknown length
+	EndlessStream *endless = new EndlessStream;
+	std::unique_ptr<Sound::AudioStream> stream3(cache.add("endless", endless));
+	EXPECT_EQ(stream3.get(), endless);
+
+	// The streams have been left alone
+	expectRamp(*stream1, 1001);
+	expectRamp(*stream2, 600);
+
+	EXPECT_FALSE(cache.get("long"));
+	EXPECT_FALSE(cache.get("big"));
+	EXPECT_FALSE(cache.get("endless"));
+
+	const Sound::PCMCache::Stats stats = cache.getStats();
+	EXPECT_EQ(stats.uncacheable, 3);
+	EXPECT_EQ(stats.count, 0);
+	EXPECT_EQ(stats.size, 0);
+}
+
+GTEST_TEST(PCMCache, evict) {
+	Sound::PCMCache cache(600, 1000);
+
+	delete cache.add("a", new RampStream(100));
+	delete cache.add("b", new RampStream(100));
+	delete cache.add("c", new RampStream(100));
+
+	// Make "a" the most recently used sound
+	std::unique_ptr<Sound::RewindableAudioStream> streamA(cache.get("a"));
+	ASSERT_TRUE(streamA);
+
+	// Keep a stream of "b" around while it is being evicted
+	std::unique_ptr<Sound::RewindableAudioStream> streamB(cache.get("b"));
+	ASSERT_TRUE(streamB);
+
+	streamA.reset(cache.get("a"));
+
+	delete cache.add("d", new RampStream(100, 10));
+
+	EXPECT_FALSE(cache.get("c"));
+
+	std::unique_ptr<Sound::RewindableAudioStream> streamD(cache.get("d"));
+	ASSERT_TRUE(streamD);
+	expectRamp(*streamD, 100, 10);
+
+	// Shrinking the cache drops the least recently used sounds
+	cache.setMaxSize(400);
+
+	EXPECT_FALSE(cache.get("b"));
+	EXPECT_TRUE(std::unique_ptr<Sound::RewindableAudioStream>(cache.get("a")));
+	EXPECT_TRUE(std::unique_ptr<Sound::RewindableAudioStream>(cache.get("d")));
+
+	// The evicted sound is still playable
+	expectRamp(*streamB, 100);
+
+	const Sound::PCMCache::Stats stats = cache.getStats();
+	EXPECT_EQ(stats.evictions, 2);
+	EXPECT_EQ(stats.count, 2);
+	EXPECT_EQ(stats.size, 400);
+}
+
+GTEST_TEST(PCMCache, clear) {
+	Sound::PCMCache cache(1024, 1000);
+
+	delete cache.add("a", new RampStream(100));
+	delete cache.add("b", new RampStream(100));
+
+	cache.clear();
+
+	EXPECT_FALSE(cache.get("a"));
+	EXPECT_FALSE(cache.get("b"));
+
+	const Sound::PCMCache::Stats stats = cache.getStats();
+	EXPECT_EQ(stats.count, 0);
+	EXPECT_EQ(stats.size, 0);
+}
+
+GTEST_TEST(PCMCache, disabled) {
+	Sound::PCMCache cache(0, 1000);
+
+	RampStream *ramp = new RampStream(100);
+	std::unique_ptr<Sound::AudioStream> stream(cache.add("ramp", ramp));
+	EXPECT_EQ(stream.get(), ramp);
+
+	EXPECT_FALSE(cache.get("ramp"));
+}
@@ -0,0 +1,148 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our RingBuffer class.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/sound/ringbuffer.h"
+
+GTEST_TEST(RingBuffer, capacity) {
+	Sound::RingBuffer buffer1(100);
+	EXPECT_EQ(buffer1.getCapacity(), 100);
+
+	// Rounded down to a multiple of the granularity
+	Sound::RingBuffer buffer2(100, 6);
+	EXPECT_EQ(buffer2.getCapacity(), 96);
+
+	Sound::RingBuffer buffer3(4, 6);
+	EXPECT_EQ(buffer3.getCapacity(), 6);
+
+	EXPECT_EQ(buffer2.getAvailable(), 0);
+	EXPECT_EQ(buffer2.getFree(), 96);
+}
+
+GTEST_TEST(RingBuffer, readWrite) {
+	Sound::RingBuffer buffer(8);
+
+	const int16_t data[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+	EXPECT_EQ(buffer.write(data, 6), 6);
+	EXPECT_EQ(buffer.getAvailable(), 6);
+	EXPECT_EQ(buffer.getFree(), 2);
+
+	int16_t out[10];
+	ASSERT_EQ(buffer.read(out, 4), 4);
+	for (size_t i = 0; i < 4; i++)
+		EXPECT_EQ(out[i], data[i]) << "At index " << i;
+
+	// Wraps around the end, and doesn't write more than there's room for
+	EXPECT_EQ(buffer.write(data + 6, 4), 4);
+	EXPECT_EQ(buffer.write(data, 4), 2);
+	EXPECT_EQ(buffer.getFree(), 0);
+
+	const int16_t expected[] = { 5, 6, 7, 8, 9, 10, 1, 2 };
+
+	ASSERT_EQ(buffer.read(out, 10), 8);
+	for (size_t i = 0; i < 8; i++)
+		EXPECT_EQ(out[i], expected[i]) << "At index " << i;
+
+	EXPECT_EQ(buffer.read(out, 10), 0);
+}
+
+GTEST_TEST(RingBuffer, writeRegion) {
+	Sound::RingBuffer buffer(12, 3);
+
+	size_t count;
+	int16_t *region = buffer.getWriteRegion(count);
+	ASSERT_EQ(count, 12);
+
+	for (size_t i = 0; i < 9; i++)
+		region[i] = i;
+
+	buffer.commitWrite(9);
+
+	int16_t out[12];
+	ASSERT_EQ(buffer.read(out, 6), 6);
+
+	// Only the part up to the end of the buffer is contiguous
+	region = buffer.getWriteRegion(count);
+	ASSERT_EQ(count, 3);
+
+	buffer.commitWrite(3);
+
+	region = buffer.getWriteRegion(count);
+	EXPECT_EQ(count, 6);
+
+	buffer.clear();
+	EXPECT_EQ(buffer.getAvailable(), 0);
+	EXPECT_EQ(buffer.getFree(), 12);
+}
+
+GTEST_TEST(RingBuffer, threads) {
+	static const size_t kCount = 1000000;
+
+	Sound::RingBuffer buffer(1000);
+
+	std::thread producer([&buffer]() {
+		int16_t data[77];
+
+		size_t written = 0;
+		while (written < kCount) {
+			const size_t n = std::min<size_t>(77, kCount - written);
+			for (size_t i = 0; i < n; i++)
+				data[i] = (int16_t) (written + i);
+
+			size_t done = 0;
+			while (done < n) {
+				done += buffer.write(data + done, n - done);
+				if (done < n)
+					std::this_thread::yield();
+			}
+
+			written += n;
+		}
+	});
+
+	size_t read = 0, errors = 0;
+	int16_t data[101];
+
+	while (read < kCount) {
+		const size_t n = buffer.read(data, 101);
+		if (n == 0)
+			std::this_thread::yield();
+
+		for (size_t i = 0; i < n; i++)
+			if (data[i] != (int16_t) (read + i))
+				errors++;
+
+		read += n;
+	}
+
+	producer.join();
+
+	EXPECT_EQ(read, kCount);
+	EXPECT_EQ(errors, 0);
+}
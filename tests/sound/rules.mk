@@ -0,0 +1,47 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+# Unit tests for the Sound namespace.
+
+sound_LIBS = \
+    $(test_LIBS) \
+    src/sound/libsound.la \
+    src/common/libcommon.la \
+    tests/version/libversion.la \
+    $(LDADD)
+
+check_PROGRAMS                    += tests/sound/test_pcmcache
+tests_sound_test_pcmcache_SOURCES  = tests/sound/pcmcache.cpp
+tests_sound_test_pcmcache_LDADD    = $(sound_LIBS)
+tests_sound_test_pcmcache_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                      += tests/sound/test_ringbuffer
+tests_sound_test_ringbuffer_SOURCES  = tests/sound/ringbuffer.cpp
+tests_sound_test_ringbuffer_LDADD    = $(sound_LIBS)
+tests_sound_test_ringbuffer_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                               += tests/sound/test_bufferedaudiostream
+tests_sound_test_bufferedaudiostream_SOURCES  = tests/sound/bufferedaudiostream.cpp
+tests_sound_test_bufferedaudiostream_LDADD    = $(sound_LIBS)
+tests_sound_test_bufferedaudiostream_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                    += tests/sound/test_decoders
+tests_sound_test_decoders_SOURCES  = tests/sound/decoders.cpp
+tests_sound_test_decoders_LDADD    = $(sound_LIBS)
+tests_sound_test_decoders_CXXFLAGS = $(test_CXXFLAGS)
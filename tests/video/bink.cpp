@@ -0,0 +1,296 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the Bink video decoder.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/maths.h"
+#include "src/common/threads.h"
+#include "src/common/memreadstream.h"
+#include "src/common/readfile.h"
+
+#include "src/graphics/images/surface.h"
+
+#include "src/video/bink.h"
+
+/** Decodes the frames of a Bink video one by one, without a decoding thread. */
+class TestBink : public Video::Bink {
+public:
+	TestBink(Common::SeekableReadStream *bink) : Video::Bink(bink) {
+	}
+
+	bool decodeFrame() {
+		VideoTrackPtr track = findNextVideoTrack();
+		if (!track || track->endOfTrack())
+			return false;
+
+		decodeNextTrackFrame(*track);
+		return true;
+	}
+
+	const Graphics::Surface &getSurface() const {
+		return *_surface;
+	}
+};
+
+/** Creating a video decoder needs the main thread, to create its texture. */
+class ThreadsEnvironment : public ::testing::Environment {
+public:
+	void SetUp() {
+		Common::initThreads();
+	}
+};
+
+static ::testing::Environment * const kThreadsEnvironment = ::testing::AddGlobalTestEnvironment(new ThreadsEnvironment);
+
+/** Writes a bit stream in the order Bink reads it, LSB first out of 32-bit little-endian words. */
+class BitWriter {
+public:
+	void putBits(uint32_t value, size_t n) {
+		for (size_t i = 0; i < n; i++, _pos++) {
+			if ((_pos & 31) == 0)
+				_words.push_back(0);
+
+			_words.back() |= ((value >> i) & 1) << (_pos & 31);
+		}
+	}
+
+	void align() {
+		_pos = _words.size() * 32;
+	}
+
+	void write(std::vector<byte> &data) const {
+		for (std::vector<uint32_t>::const_iterator w = _words.begin(); w != _words.end(); ++w)
+			for (int i = 0; i < 4; i++)
+				data.push_back((*w >> (i * 8)) & 0xFF);
+	}
+
+	size_t size() const {
+		return _words.size() * 4;
+	}
+
+private:
+	std::vector<uint32_t> _words;
+	size_t _pos { 0 };
+};
+
+static int countLength(uint32_t count) {
+	return Common::intLog2(count + 511) + 1;
+}
+
+/** Write a plane where every 8x8 block is filled with a single color. */
+static void writeFilledPlane(BitWriter &bits, uint32_t videoWidth, uint32_t videoHeight, bool isChroma, byte color) {
+	const uint32_t blockWidth  = isChroma ? ((videoWidth  + 15) >> 4) : ((videoWidth  + 7) >> 3);
+	const uint32_t blockHeight = isChroma ? ((videoHeight + 15) >> 4) : ((videoHeight + 7) >> 3);
+	const uint32_t width       = MAX<uint32_t>(isChroma ? (videoWidth >> 1) : videoWidth, 8);
+
+	// Bundles: block types, sub-block types, colors, pattern, X/Y offsets, intra/inter DCs, runs
+	const int lengths[9] = {
+		countLength( width       >> 3),
+		countLength((width + 7)  >> 4),
+		countLength( blockWidth  * 64),
+		countLength( blockWidth  << 3),
+		countLength( width       >> 3),
+		countLength( width       >> 3),
+		countLength( width       >> 3),
+		countLength( width       >> 3),
+		countLength( blockWidth  * 48)
+	};
+
+	// All Huffman codebooks are the first one, which gives raw nibbles
+	for (int i = 0; i < 9; i++) {
+		if (i == 2)
+			for (int j = 0; j < 16; j++)
+				bits.putBits(0, 4);
+
+		if ((i != 6) && (i != 7))
+			bits.putBits(0, 4);
+	}
+
+	for (uint32_t y = 0; y < blockHeight; y++) {
+		// One fill block type for the whole row
+		bits.putBits(blockWidth, lengths[0]);
+		bits.putBits(1, 1);
+		bits.putBits(6, 4);
+
+		// An empty bundle stays empty for the rest of the plane
+		if (y == 0)
+			bits.putBits(0, lengths[1]);
+
+		// One color for the whole row
+		bits.putBits(blockWidth, lengths[2]);
+		bits.putBits(1, 1);
+		bits.putBits(color >> 4, 4);
+		bits.putBits(color & 15, 4);
+
+		if (y == 0)
+			for (int i = 3; i < 9; i++)
+				bits.putBits(0, lengths[i]);
+	}
+
+	bits.align();
+}
+
+static void writeUint32LE(std::vector<byte> &data, uint32_t value) {
+	for (int i = 0; i < 4; i++)
+		data.push_back((value >> (i * 8)) & 0xFF);
+}
+
+/** Create a version 'i' Bink video with alpha, its planes filled with the given colors per frame. */
+static std::vector<byte> createBink(uint32_t width, uint32_t height, const std::vector<std::vector<byte>> &frames) {
+	std::vector<std::vector<byte>> packets;
+	for (std::vector<std::vector<byte>>::const_iterator f = frames.begin(); f != frames.end(); ++f) {
+		packets.push_back(std::vector<byte>());
+
+		// Alpha, then luma, both prefixed with the size of their data, then the two chroma planes
+		BitWriter alpha, luma, chroma;
+
+		writeFilledPlane(alpha , width, height, false, (*f)[3]);
+		writeFilledPlane(luma  , width, height, false, (*f)[0]);
+		writeFilledPlane(chroma, width, height, true , (*f)[1]);
+		writeFilledPlane(chroma, width, height, true , (*f)[2]);
+
+		writeUint32LE(packets.back(), alpha.size());
+		alpha.write(packets.back());
+		writeUint32LE(packets.back(), luma.size());
+		luma.write(packets.back());
+		chroma.write(packets.back());
+	}
+
+	const uint32_t headerSize = 44 + 4 * packets.size();
+
+	uint32_t fileSize = headerSize, largestFrameSize = 0;
+	for (std::vector<std::vector<byte>>::const_iterator p = packets.begin(); p != packets.end(); ++p) {
+		fileSize        += p->size();
+		largestFrameSize = MAX<uint32_t>(largestFrameSize, p->size());
+	}
+
+	std::vector<byte> bink = { 'B', 'I', 'K', 'i' };
+
+	writeUint32LE(bink, fileSize - 8);
+	writeUint32LE(bink, packets.size());
+	writeUint32LE(bink, largestFrameSize);
+	writeUint32LE(bink, 0);
+	writeUint32LE(bink, width);
+	writeUint32LE(bink, height);
+	writeUint32LE(bink, 30);
+	writeUint32LE(bink, 1);
+	writeUint32LE(bink, 0x00100000); // Alpha
+	writeUint32LE(bink, 0);          // No audio tracks
+
+	uint32_t offset = headerSize;
+	for (std::vector<std::vector<byte>>::const_iterator p = packets.begin(); p != packets.end(); ++p) {
+		writeUint32LE(bink, offset | 1);
+		offset += p->size();
+	}
+
+	for (std::vector<std::vector<byte>>::const_iterator p = packets.begin(); p != packets.end(); ++p)
+		bink.insert(bink.end(), p->begin(), p->end());
+
+	return bink;
+}
+
+static bool compareSurfaces(const Graphics::Surface &a, const Graphics::Surface &b) {
+	return (a.getWidth() == b.getWidth()) && (a.getHeight() == b.getHeight()) &&
+	       (std::memcmp(a.getData(), b.getData(), a.getWidth() * a.getHeight() * 4) == 0);
+}
+
+GTEST_TEST(Bink, concurrentPlanes) {
+	static const uint32_t kWidth = 100, kHeight = 60;
+
+	// YUVA fill colors for each frame
+	const std::vector<std::vector<byte>> frames = {
+		{  16, 128, 128, 255 }, {  81,  90, 240, 128 }, { 145,  54,  34,   0 }, { 235, 128, 128,  64 }
+	};
+
+	const std::vector<byte> data = createBink(kWidth, kHeight, frames);
+
+	TestBink bink(new Common::MemoryReadStream(data.data(), data.size()));
+
+	/* The first frame is decoded serially, verifying the plane sizes. All
+	 * other frames decode their planes concurrently. They have to look
+	 * exactly like the same frame decoded serially as the only frame. */
+	for (size_t i = 0; i < frames.size(); i++) {
+		ASSERT_TRUE(bink.decodeFrame()) << "At frame " << i;
+
+		const std::vector<byte> single = createBink(kWidth, kHeight, { frames[i] });
+
+		TestBink serial(new Common::MemoryReadStream(single.data(), single.size()));
+		serial.setConcurrentDecoding(false);
+
+		ASSERT_TRUE(serial.decodeFrame()) << "At frame " << i;
+
+		EXPECT_TRUE(compareSurfaces(bink.getSurface(), serial.getSurface())) << "At frame " << i;
+
+		// The alpha plane is copied straight into the BGRA surface
+		EXPECT_EQ(bink.getSurface().getData()[3], frames[i][3]) << "At frame " << i;
+		EXPECT_EQ(bink.getSurface().getData()[((kHeight - 1) * bink.getSurface().getWidth() + kWidth - 1) * 4 + 3],
+		          frames[i][3]) << "At frame " << i;
+	}
+
+	EXPECT_FALSE(bink.decodeFrame());
+}
+
+/* Decoding speed of a real Bink video, with the planes decoded serially
+ * and concurrently. Give the path to the video as an argument.
+ *
+ * Run with --gtest_also_run_disabled_tests.
+ */
+GTEST_TEST(Bink, DISABLED_benchmark) {
+	typedef std::chrono::steady_clock Clock;
+
+	std::string path;
+
+	const std::vector<std::string> args = ::testing::internal::GetArgvs();
+	for (size_t i = 1; i < args.size(); i++)
+		if (!args[i].empty() && (args[i][0] != '-'))
+			path = args[i];
+
+	if (path.empty())
+		GTEST_SKIP() << "No Bink video given";
+
+	for (int concurrent = 0; concurrent < 2; concurrent++) {
+		TestBink bink(new Common::ReadFile(path));
+		bink.setConcurrentDecoding(concurrent != 0);
+
+		size_t frames = 0;
+
+		const Clock::time_point start = Clock::now();
+		while (bink.decodeFrame())
+			frames++;
+
+		const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		std::printf("%s: %u frames (%ux%u) in %.1f ms, %.2f ms per frame\n",
+		            concurrent ? "Concurrent" : "Serial", (uint) frames, bink.getWidth(), bink.getHeight(),
+		            elapsed, elapsed / MAX<size_t>(frames, 1));
+	}
+}
@@ -0,0 +1,147 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the Bink video IDCT.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/video/binkidct.h"
+
+static uint32_t random32(uint32_t &seed) {
+	seed = seed * 1664525 + 1013904223;
+	return seed;
+}
+
+/** Fill a block with coefficients, from mostly empty to full range. */
+static void fillBlock(int16_t *block, uint32_t &seed, int n) {
+	std::memset(block, 0, 64 * sizeof(int16_t));
+
+	const int count = (n % 4 == 0) ? 1 : ((n % 4 == 1) ? 6 : 64);
+	const int range = (n % 3 == 0) ? 2048 : 32768;
+
+	for (int i = 0; i < count; i++)
+		block[random32(seed) % 64] = (int16_t) (((int) (random32(seed) >> 16) % (2 * range)) - range);
+}
+
+static void fillPixels(byte *pixels, uint32_t &seed) {
+	for (int i = 0; i < 16 * 8; i++)
+		pixels[i] = random32(seed) >> 24;
+}
+
+GTEST_TEST(BinkIDCT, compare) {
+	if (!Video::hasBinkIDCTSIMD()) {
+		EXPECT_FALSE(Video::setBinkIDCTSIMD(true));
+		return;
+	}
+
+	uint32_t seed = 0xB1A4;
+
+	for (int n = 0; n < 5000; n++) {
+		int16_t coeffs[64];
+		fillBlock(coeffs, seed, n);
+
+		int16_t blockGeneric[64], blockSIMD[64];
+		byte pixelsGeneric[16 * 8], pixelsSIMD[16 * 8];
+
+		// IDCT
+		std::memcpy(blockGeneric, coeffs, sizeof(coeffs));
+		std::memcpy(blockSIMD   , coeffs, sizeof(coeffs));
+
+		EXPECT_TRUE(Video::setBinkIDCTSIMD(false));
+		Video::binkIDCT(blockGeneric);
+		EXPECT_TRUE(Video::setBinkIDCTSIMD(true));
+		Video::binkIDCT(blockSIMD);
+
+		for (int i = 0; i < 64; i++)
+			ASSERT_EQ(blockSIMD[i], blockGeneric[i]) << "IDCT, block " << n << ", coefficient " << i;
+
+		// IDCTPut, into a plane with a pitch of 16
+		fillPixels(pixelsGeneric, seed);
+		std::memcpy(pixelsSIMD, pixelsGeneric, sizeof(pixelsGeneric));
+
+		EXPECT_TRUE(Video::setBinkIDCTSIMD(false));
+		Video::binkIDCTPut(pixelsGeneric, 16, coeffs);
+		EXPECT_TRUE(Video::setBinkIDCTSIMD(true));
+		Video::binkIDCTPut(pixelsSIMD, 16, coeffs);
+
+		for (int i = 0; i < 16 * 8; i++)
+			ASSERT_EQ(pixelsSIMD[i], pixelsGeneric[i]) << "IDCTPut, block " << n << ", pixel " << i;
+
+		// IDCTAdd
+		std::memcpy(blockGeneric, coeffs, sizeof(coeffs));
+		std::memcpy(blockSIMD   , coeffs, sizeof(coeffs));
+
+		fillPixels(pixelsGeneric, seed);
+		std::memcpy(pixelsSIMD, pixelsGeneric, sizeof(pixelsGeneric));
+
+		EXPECT_TRUE(Video::setBinkIDCTSIMD(false));
+		Video::binkIDCTAdd(pixelsGeneric, 16, blockGeneric);
+		EXPECT_TRUE(Video::setBinkIDCTSIMD(true));
+		Video::binkIDCTAdd(pixelsSIMD, 16, blockSIMD);
+
+		for (int i = 0; i < 64; i++)
+			ASSERT_EQ(blockSIMD[i], blockGeneric[i]) << "IDCTAdd, block " << n << ", coefficient " << i;
+		for (int i = 0; i < 16 * 8; i++)
+			ASSERT_EQ(pixelsSIMD[i], pixelsGeneric[i]) << "IDCTAdd, block " << n << ", pixel " << i;
+	}
+}
+
+/* IDCT benchmark, generic against SIMD.
+ *
+ * Run with --gtest_also_run_disabled_tests.
+ */
+GTEST_TEST(BinkIDCT, DISABLED_benchmark) {
+	typedef std::chrono::steady_clock Clock;
+
+	static const int kBlocks = 4096, kIterations = 100;
+
+	uint32_t seed = 0xB1A4;
+
+	std::vector<int16_t> coeffs(kBlocks * 64);
+	for (int n = 0; n < kBlocks; n++)
+		fillBlock(&coeffs[n * 64], seed, n);
+
+	std::vector<byte> plane(64 * 8 * 8);
+
+	const bool oldSIMD = Video::hasBinkIDCTSIMD();
+
+	for (int simd = 0; simd < 2; simd++) {
+		if (!Video::setBinkIDCTSIMD(simd != 0))
+			continue;
+
+		const Clock::time_point start = Clock::now();
+		for (int n = 0; n < kIterations; n++)
+			for (int i = 0; i < kBlocks; i++)
+				Video::binkIDCTPut(&plane[(i % 64) * 8], 64 * 8, &coeffs[i * 64]);
+
+		const double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+		std::printf("%s: %.1f ns per IDCTPut\n", simd ? "SIMD" : "Generic", elapsed / (kIterations * kBlocks));
+	}
+
+	Video::setBinkIDCTSIMD(oldSIMD);
+}
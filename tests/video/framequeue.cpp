@@ -0,0 +1,229 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our FrameQueue class.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "src/graphics/images/surface.h"
+
+#include "src/video/framequeue.h"
+
+static void pushFrame(Video::FrameQueue &queue, uint32_t time, byte value) {
+	Graphics::Surface *frame = queue.getFreeFrame();
+	ASSERT_NE(frame, static_cast<Graphics::Surface *>(0));
+
+	std::memset(frame->getData(), value, frame->getPitch() * frame->getHeight());
+	queue.pushFrame(time);
+}
+
+GTEST_TEST(FrameQueue, getSize) {
+	Video::FrameQueue queue(3, 4, 4);
+
+	EXPECT_EQ(queue.getSize(), 3);
+	EXPECT_EQ(queue.getCount(), 0);
+	EXPECT_FALSE(queue.isFinished());
+}
+
+GTEST_TEST(FrameQueue, popFrame) {
+	Video::FrameQueue queue(3, 4, 4);
+	std::unique_ptr<Graphics::Surface> surface = std::make_unique<Graphics::Surface>(4, 4);
+
+	pushFrame(queue, 0, 0x10);
+	pushFrame(queue, 40, 0x20);
+	EXPECT_EQ(queue.getCount(), 2);
+
+	EXPECT_TRUE(queue.popFrame(0, surface));
+	EXPECT_EQ(surface->getData()[0], 0x10);
+
+	EXPECT_FALSE(queue.popFrame(39, surface));
+	EXPECT_EQ(surface->getData()[0], 0x10);
+
+	EXPECT_TRUE(queue.popFrame(40, surface));
+	EXPECT_EQ(surface->getData()[0], 0x20);
+
+	EXPECT_FALSE(queue.popFrame(1000, surface));
+	EXPECT_EQ(queue.getCount(), 0);
+	EXPECT_EQ(queue.getDroppedFrames(), 0);
+}
+
+GTEST_TEST(FrameQueue, popFrameLate) {
+	Video::FrameQueue queue(4, 4, 4);
+	std::unique_ptr<Graphics::Surface> surface = std::make_unique<Graphics::Surface>(4, 4);
+
+	pushFrame(queue,  0, 0x10);
+	pushFrame(queue, 40, 0x20);
+	pushFrame(queue, 80, 0x30);
+	pushFrame(queue, 120, 0x40);
+
+	// The two older frames are late and get skipped
+	EXPECT_TRUE(queue.popFrame(90, surface));
+	EXPECT_EQ(surface->getData()[0], 0x30);
+	EXPECT_EQ(queue.getDroppedFrames(), 2);
+	EXPECT_EQ(queue.getCount(), 1);
+
+	EXPECT_TRUE(queue.popFrame(120, surface));
+	EXPECT_EQ(surface->getData()[0], 0x40);
+}
+
+GTEST_TEST(FrameQueue, finish) {
+	Video::FrameQueue queue(2, 4, 4);
+	std::unique_ptr<Graphics::Surface> surface = std::make_unique<Graphics::Surface>(4, 4);
+
+	pushFrame(queue, 0, 0x10);
+	queue.finish();
+
+	// Still one frame left to show
+	EXPECT_FALSE(queue.isFinished());
+
+	uint32_t time = 0xFFFFFFFF;
+	EXPECT_TRUE(queue.waitFrame(surface, time));
+	EXPECT_EQ(time, 0);
+	EXPECT_EQ(surface->getData()[0], 0x10);
+
+	EXPECT_TRUE(queue.isFinished());
+	EXPECT_FALSE(queue.waitFrame(surface, time));
+}
+
+GTEST_TEST(FrameQueue, bounded) {
+	Video::FrameQueue queue(2, 4, 4);
+
+	std::thread producer([&queue]() {
+		for (uint32_t i = 0; i < 16; i++)
+			pushFrame(queue, i * 10, i);
+
+		queue.finish();
+	});
+
+	std::unique_ptr<Graphics::Surface> surface = std::make_unique<Graphics::Surface>(4, 4);
+
+	uint32_t frames = 0, time = 0;
+	while (queue.waitFrame(surface, time)) {
+		EXPECT_LE(queue.getCount(), 2);
+
+		EXPECT_EQ(time, frames * 10);
+		EXPECT_EQ(surface->getData()[0], frames);
+
+		frames++;
+	}
+
+	producer.join();
+
+	EXPECT_EQ(frames, 16);
+}
+
+GTEST_TEST(FrameQueue, abort) {
+	Video::FrameQueue queue(1, 4, 4);
+
+	pushFrame(queue, 0, 0x10);
+
+	// The queue is full, so the producer blocks until we abort
+	std::thread producer([&queue]() {
+		EXPECT_EQ(queue.getFreeFrame(), static_cast<Graphics::Surface *>(0));
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	queue.abort();
+
+	producer.join();
+
+	std::unique_ptr<Graphics::Surface> surface = std::make_unique<Graphics::Surface>(4, 4);
+	uint32_t time = 0;
+
+	EXPECT_TRUE(queue.isFinished());
+	EXPECT_FALSE(queue.waitFrame(surface, time));
+}
+
+/* Headless decoding benchmark: a producer thread stands in for a decoder,
+ * writing a 640x480 video into a 1024x512 surface as fast as possible and
+ * copying it into the queue, while the consumer takes the frames as soon as
+ * they are ready. Reports the throughput and the latency from the start of
+ * decoding a frame until the consumer gets hold of it.
+ *
+ * Run with --gtest_also_run_disabled_tests.
+ */
+GTEST_TEST(FrameQueue, DISABLED_benchmark) {
+	typedef std::chrono::steady_clock Clock;
+
+	static const uint32_t kFrameCount = 1000;
+	static const int kWidth = 640, kHeight = 480;
+
+	Video::FrameQueue queue(4, 1024, 512);
+
+	std::vector<Clock::time_point> decodeStart(kFrameCount);
+	std::vector<double> latency;
+	latency.reserve(kFrameCount);
+
+	const Clock::time_point start = Clock::now();
+
+	std::thread producer([&]() {
+		Graphics::Surface decoded(1024, 512);
+
+		for (uint32_t i = 0; i < kFrameCount; i++) {
+			decodeStart[i] = Clock::now();
+
+			byte *data = decoded.getData();
+			for (int y = 0; y < kHeight; y++, data += decoded.getPitch())
+				for (int x = 0; x < kWidth; x++) {
+					data[x * 4 + 0] = x + i;
+					data[x * 4 + 1] = y + i;
+					data[x * 4 + 2] = x ^ y;
+					data[x * 4 + 3] = 0xFF;
+				}
+
+			Graphics::Surface *frame = queue.getFreeFrame();
+			if (!frame)
+				break;
+
+			std::memcpy(frame->getData(), decoded.getData(), decoded.getPitch() * decoded.getHeight());
+			queue.pushFrame(i);
+		}
+
+		queue.finish();
+	});
+
+	std::unique_ptr<Graphics::Surface> surface = std::make_unique<Graphics::Surface>(1024, 512);
+
+	uint32_t time = 0;
+	while (queue.waitFrame(surface, time))
+		latency.push_back(std::chrono::duration<double, std::micro>(Clock::now() - decodeStart[time]).count());
+
+	const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+	producer.join();
+
+	ASSERT_EQ(latency.size(), kFrameCount);
+
+	std::sort(latency.begin(), latency.end());
+
+	std::printf("%u frames in %.3f s: %.1f frames/s\n", kFrameCount, elapsed, kFrameCount / elapsed);
+	std::printf("Latency: p50 %.1f us, p90 %.1f us, p99 %.1f us, max %.1f us\n",
+	            latency[latency.size() * 50 / 100], latency[latency.size() * 90 / 100],
+	            latency[latency.size() * 99 / 100], latency.back());
+}